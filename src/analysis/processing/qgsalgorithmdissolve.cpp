@@ -17,14 +17,181 @@
 
 #include "qgsalgorithmdissolve.h"
 
+#include <QtConcurrentMap>
+#include <cmath>
+
 ///@cond PRIVATE
 
 //
 // QgsCollectorAlgorithm
 //
 
+/**
+ * Returns the distance along a Hilbert curve of order 16 for the grid cell (\a x, \a y).
+ */
+static quint32 hilbertDistance( quint32 x, quint32 y )
+{
+  const quint32 n = 1 << 16;
+  quint32 d = 0;
+  for ( quint32 s = n / 2; s > 0; s /= 2 )
+  {
+    const quint32 rx = ( x & s ) > 0 ? 1 : 0;
+    const quint32 ry = ( y & s ) > 0 ? 1 : 0;
+    d += s * s * ( ( 3 * rx ) ^ ry );
+    if ( ry == 0 )
+    {
+      if ( rx == 1 )
+      {
+        x = n - 1 - x;
+        y = n - 1 - y;
+      }
+      std::swap( x, y );
+    }
+  }
+  return d;
+}
+
+/**
+ * Sorts \a geometries in place along a Hilbert curve covering their combined extent,
+ * using the center of each geometry's bounding box.
+ */
+static void hilbertSort( QVector< QgsGeometry > &geometries )
+{
+  if ( geometries.size() < 3 )
+    return;
+
+  QVector< QgsPointXY > centers;
+  centers.reserve( geometries.size() );
+  QgsRectangle extent;
+  extent.setMinimal();
+  for ( const QgsGeometry &g : qgis::as_const( geometries ) )
+  {
+    const QgsRectangle bbox = g.boundingBox();
+    centers << bbox.center();
+    extent.combineExtentWith( bbox );
+  }
+
+  const double maxCell = ( 1 << 16 ) - 1;
+  const double scaleX = extent.width() > 0 ? maxCell / extent.width() : 0;
+  const double scaleY = extent.height() > 0 ? maxCell / extent.height() : 0;
+
+  QVector< QPair< quint32, int > > keys;
+  keys.reserve( geometries.size() );
+  for ( int i = 0; i < centers.size(); ++i )
+  {
+    const quint32 x = static_cast< quint32 >( qBound( 0.0, ( centers.at( i ).x() - extent.xMinimum() ) * scaleX, maxCell ) );
+    const quint32 y = static_cast< quint32 >( qBound( 0.0, ( centers.at( i ).y() - extent.yMinimum() ) * scaleY, maxCell ) );
+    keys << qMakePair( hilbertDistance( x, y ), i );
+  }
+  std::sort( keys.begin(), keys.end() );
+
+  QVector< QgsGeometry > sorted;
+  sorted.reserve( geometries.size() );
+  for ( const QPair< quint32, int > &key : qgis::as_const( keys ) )
+    sorted << geometries.at( key.second );
+  geometries = sorted;
+}
+
+QVector< QgsGeometry > QgsCollectorAlgorithm::cascadedCollect( const QVector< QVector< QgsGeometry > > &groups,
+    const std::function<QgsGeometry( const QVector<QgsGeometry>& )> &collector,
+    QgsProcessingFeedback *feedback, int blockSize, QVector< QStringList > *errors )
+{
+  // a single block of work, i.e. up to blockSize neighboring geometries from one group
+  struct Block
+  {
+    int group;
+    QVector< QgsGeometry > parts;
+    QgsGeometry result;
+  };
+
+  // smaller blocks would never reduce the number of geometries
+  blockSize = std::max( 2, blockSize );
+
+  QVector< QVector< QgsGeometry > > pending = groups;
+  QVector< QgsGeometry > results( groups.size() );
+  QVector< bool > done( groups.size(), false );
+  if ( errors )
+    *errors = QVector< QStringList >( groups.size() );
+
+  // spatially sort the groups, so that blocks contain geometries which are close to each other
+  // and are likely to share boundaries
+  QtConcurrent::blockingMap( pending, []( QVector< QgsGeometry > &parts ) { hilbertSort( parts ); } );
+
+  // estimate the number of reduction levels, for progress reporting only
+  int largestGroup = 1;
+  for ( const QVector< QgsGeometry > &group : qgis::as_const( pending ) )
+    largestGroup = std::max( largestGroup, group.size() );
+  const int levels = 1 + static_cast< int >( std::ceil( std::log( largestGroup ) / std::log( blockSize ) ) );
+
+  for ( int level = 0; ; ++level )
+  {
+    if ( feedback && feedback->isCanceled() )
+      break;
+
+    QVector< Block > blocks;
+    for ( int group = 0; group < pending.size(); ++group )
+    {
+      if ( done.at( group ) )
+        continue;
+
+      const QVector< QgsGeometry > &parts = pending.at( group );
+      if ( parts.isEmpty() )
+      {
+        done[ group ] = true;
+        continue;
+      }
+
+      for ( int i = 0; i < parts.size(); i += blockSize )
+      {
+        blocks << Block { group, parts.mid( i, blockSize ), QgsGeometry() };
+      }
+    }
+
+    if ( blocks.isEmpty() )
+      break;
+
+    // the blocks are combined on this thread: GEOS calls all share QGIS' single GEOS context,
+    // which must not be used from several threads at once
+    for ( Block &block : blocks )
+    {
+      if ( feedback && feedback->isCanceled() )
+        break;
+      block.result = collector( block.parts );
+      block.parts.clear();
+      // errors of intermediate levels would be lost once the block result is combined again
+      if ( errors && !block.result.lastError().isEmpty() )
+        ( *errors )[ block.group ] << block.result.lastError();
+    }
+
+    // remaining work for each group is the results of its blocks, a group is finished
+    // once it was combined in a single block
+    QVector< QVector< QgsGeometry > > next( pending.size() );
+    for ( int i = 0; i < blocks.size(); ++i )
+    {
+      next[ blocks.at( i ).group ] << blocks.at( i ).result;
+    }
+    for ( int group = 0; group < pending.size(); ++group )
+    {
+      if ( done.at( group ) )
+        continue;
+
+      if ( next.at( group ).size() == 1 )
+      {
+        results[ group ] = next.at( group ).at( 0 );
+        done[ group ] = true;
+      }
+    }
+    pending = next;
+
+    if ( feedback )
+      feedback->setProgress( 50.0 + 50.0 * std::min( 1.0, ( level + 1.0 ) / levels ) );
+  }
+
+  return results;
+}
+
 QVariantMap QgsCollectorAlgorithm::processCollection( const QVariantMap &parameters, QgsProcessingContext &context, QgsProcessingFeedback *feedback,
-    const std::function<QgsGeometry( const QVector< QgsGeometry >& )> &collector, int maxQueueLength )
+    const std::function<QgsGeometry( const QVector< QgsGeometry >& )> &collector, int maxQueueLength, bool cascaded )
 {
   std::unique_ptr< QgsFeatureSource > source( parameterAsSource( parameters, QStringLiteral( "INPUT" ), context ) );
   if ( !source )
@@ -44,6 +211,11 @@ QVariantMap QgsCollectorAlgorithm::processCollection( const QVariantMap &paramet
   QgsFeatureIterator it = source->getFeatures();
 
   double step = count > 0 ? 100.0 / count : 1;
+  if ( cascaded && !fields.isEmpty() )
+  {
+    // reading features is only the first half of the work, the second is spent in cascadedCollect()
+    step /= 2;
+  }
   int current = 0;
 
   if ( fields.isEmpty() )
@@ -53,6 +225,8 @@ QVariantMap QgsCollectorAlgorithm::processCollection( const QVariantMap &paramet
     // we dissolve geometries in blocks using unaryUnion
     QVector< QgsGeometry > geomQueue;
     QgsFeature outputFeature;
+    QStringList errors;
+    QVector< QStringList > blockErrors;
 
     while ( it.nextFeature( f ) )
     {
@@ -73,7 +247,9 @@ QVariantMap QgsCollectorAlgorithm::processCollection( const QVariantMap &paramet
         if ( maxQueueLength > 0 && geomQueue.length() > maxQueueLength )
         {
           // queue too long, combine it
-          QgsGeometry tempOutputGeometry = collector( geomQueue );
+          QgsGeometry tempOutputGeometry = cascaded ? cascadedCollect( { geomQueue }, collector, nullptr, 64, &blockErrors ).at( 0 ) : collector( geomQueue );
+          if ( cascaded )
+            errors << blockErrors.at( 0 );
           geomQueue.clear();
           geomQueue << tempOutputGeometry;
         }
@@ -83,7 +259,16 @@ QVariantMap QgsCollectorAlgorithm::processCollection( const QVariantMap &paramet
       current++;
     }
 
-    outputFeature.setGeometry( collector( geomQueue ) );
+    const QgsGeometry collected = cascaded ? cascadedCollect( { geomQueue }, collector, nullptr, 64, &blockErrors ).at( 0 ) : collector( geomQueue );
+    if ( cascaded )
+    {
+      errors << blockErrors.at( 0 );
+      for ( const QString &error : qgis::as_const( errors ) )
+        feedback->reportError( error, true );
+      if ( !errors.isEmpty() && collected.isEmpty() )
+        throw QgsProcessingException( QObject::tr( "The algorithm returned no output." ) );
+    }
+    outputFeature.setGeometry( collected );
     sink->addFeature( outputFeature, QgsFeatureSink::FastInsert );
   }
   else
@@ -124,6 +309,39 @@ QVariantMap QgsCollectorAlgorithm::processCollection( const QVariantMap &paramet
       {
         geometryHash[ indexAttributes ].append( f.geometry() );
       }
+
+      if ( cascaded )
+      {
+        feedback->setProgress( current * step );
+        current++;
+      }
+    }
+
+    QHash< QVariant, QgsGeometry > collectedHash;
+    if ( cascaded && !feedback->isCanceled() )
+    {
+      QVector< QVariant > keys;
+      QVector< QVector< QgsGeometry > > groups;
+      keys.reserve( geometryHash.size() );
+      groups.reserve( geometryHash.size() );
+      for ( auto groupIt = geometryHash.constBegin(); groupIt != geometryHash.constEnd(); ++groupIt )
+      {
+        keys << groupIt.key();
+        groups << groupIt.value();
+      }
+      geometryHash.clear();
+
+      QVector< QStringList > errors;
+      const QVector< QgsGeometry > collected = cascadedCollect( groups, collector, feedback, 64, &errors );
+      for ( int i = 0; i < keys.size(); ++i )
+      {
+        const QgsGeometry &geom = collected.at( i );
+        for ( const QString &error : qgis::as_const( errors.at( i ) ) )
+          feedback->reportError( error, true );
+        if ( !errors.at( i ).isEmpty() && geom.isEmpty() )
+          throw QgsProcessingException( QObject::tr( "The algorithm returned no output." ) );
+        collectedHash.insert( keys.at( i ), geom );
+      }
     }
 
     int numberFeatures = attributeHash.count();
@@ -136,7 +354,16 @@ QVariantMap QgsCollectorAlgorithm::processCollection( const QVariantMap &paramet
       }
 
       QgsFeature outputFeature;
-      if ( geometryHash.contains( attrIt.key() ) )
+      if ( cascaded && collectedHash.contains( attrIt.key() ) )
+      {
+        QgsGeometry geom = collectedHash.value( attrIt.key() );
+        if ( !geom.isMultipart() )
+        {
+          geom.convertToMultiType();
+        }
+        outputFeature.setGeometry( geom );
+      }
+      else if ( !cascaded && geometryHash.contains( attrIt.key() ) )
       {
         QgsGeometry geom = collector( geometryHash.value( attrIt.key() ) );
         if ( !geom.isMultipart() )
@@ -148,8 +375,11 @@ QVariantMap QgsCollectorAlgorithm::processCollection( const QVariantMap &paramet
       outputFeature.setAttributes( attrIt.value() );
       sink->addFeature( outputFeature, QgsFeatureSink::FastInsert );
 
-      feedback->setProgress( current * 100.0 / numberFeatures );
-      current++;
+      if ( !cascaded )
+      {
+        feedback->setProgress( current * 100.0 / numberFeatures );
+        current++;
+      }
     }
   }
 
@@ -214,7 +444,8 @@ QgsDissolveAlgorithm *QgsDissolveAlgorithm::createInstance() const
 
 QVariantMap QgsDissolveAlgorithm::processAlgorithm( const QVariantMap &parameters, QgsProcessingContext &context, QgsProcessingFeedback *feedback )
 {
-  return processCollection( parameters, context, feedback, [ & ]( const QVector< QgsGeometry > &parts )->QgsGeometry
+  // errors are reported by processCollection, once the cascaded union is finished
+  return processCollection( parameters, context, feedback, [ feedback ]( const QVector< QgsGeometry > &parts )->QgsGeometry
   {
     QgsGeometry result( QgsGeometry::unaryUnion( parts ) );
     if ( QgsWkbTypes::geometryType( result.wkbType() ) == QgsWkbTypes::LineGeometry )
@@ -237,14 +468,8 @@ QVariantMap QgsDissolveAlgorithm::processAlgorithm( const QVariantMap &parameter
           return result;
       }
     }
-    if ( ! result.lastError().isEmpty() )
-    {
-      feedback->reportError( result.lastError(), true );
-      if ( result.isEmpty() )
-        throw QgsProcessingException( QObject::tr( "The algorithm returned no output." ) );
-    }
     return result;
-  }, 10000 );
+  }, 10000, true );
 }
 
 //
@@ -33,8 +33,37 @@ class QgsCollectorAlgorithm : public QgsProcessingAlgorithm
 {
   protected:
 
+    /**
+     * Collects the geometries from the INPUT source, grouped by the FIELD parameter values, using
+     * the specified \a collector function.
+     *
+     * If \a cascaded is TRUE, geometries are not combined in a single pass. Instead each group
+     * is sorted along a Hilbert curve and reduced in a tree of small blocks (see cascadedCollect()).
+     *
+     * When dissolving without fields, geometries are combined whenever more than \a maxQueueLength
+     * of them are waiting, so that memory use stays bounded.
+     */
     QVariantMap processCollection( const QVariantMap &parameters, QgsProcessingContext &context, QgsProcessingFeedback *feedback,
-                                   const std::function<QgsGeometry( const QVector<QgsGeometry>& )> &collector, int maxQueueLength = 0 );
+                                   const std::function<QgsGeometry( const QVector<QgsGeometry>& )> &collector, int maxQueueLength = 0,
+                                   bool cascaded = false );
+
+    /**
+     * Reduces each of the geometry \a groups to a single geometry using a tree reduction.
+     *
+     * Geometries of a group are first spatially sorted along a Hilbert curve, so that neighboring
+     * geometries end up in the same blocks of at most \a blockSize (at least 2) geometries. Each block
+     * is combined using \a collector, and the process is repeated on the block results until
+     * a single geometry remains per group.
+     *
+     * Returns one geometry per input group, in the same order as \a groups. If \a errors is specified,
+     * it is filled with the errors (QgsGeometry::lastError()) of all the block results of each group,
+     * including the ones of intermediate levels.
+     */
+    static QVector< QgsGeometry > cascadedCollect( const QVector< QVector< QgsGeometry > > &groups,
+        const std::function<QgsGeometry( const QVector<QgsGeometry>& )> &collector,
+        QgsProcessingFeedback *feedback, int blockSize = 64, QVector< QStringList > *errors = nullptr );
+
+    friend class TestQgsProcessingAlgs;
 };
 
 /**
@@ -17,6 +17,7 @@
 
 #include "qgsalgorithmextractbylocation.h"
 #include "qgsgeometryengine.h"
+#include "qgsinternalgeometryengine.h"
 #include "qgsvectorlayer.h"
 
 ///@cond PRIVATE
@@ -102,6 +103,7 @@ void QgsLocationBasedAlgorithm::process( const QgsProcessingContext &context, Qg
   int current = 0;
   QgsFeature f;
   std::unique_ptr< QgsGeometryEngine > engine;
+  std::unique_ptr< QgsPolygonPointLocator > pointLocator;
   while ( fIt.nextFeature( f ) )
   {
     if ( feedback->isCanceled() )
@@ -111,6 +113,8 @@ void QgsLocationBasedAlgorithm::process( const QgsProcessingContext &context, Qg
       continue;
 
     engine.reset();
+    pointLocator.reset();
+    const bool isPolygon = f.geometry().type() == QgsWkbTypes::PolygonGeometry;
 
     QgsRectangle bbox = f.geometry().boundingBox();
     request = QgsFeatureRequest().setFilterRect( bbox );
@@ -135,44 +139,74 @@ void QgsLocationBasedAlgorithm::process( const QgsProcessingContext &context, Qg
         continue;
       }
 
-      if ( !engine )
-      {
-        engine.reset( QgsGeometry::createGeometryEngine( f.geometry().constGet() ) );
-        engine->prepareGeometry();
-      }
+      // single points tested against a polygon don't need GEOS at all
+      const QgsPoint *testPoint = isPolygon ? qgsgeometry_cast< const QgsPoint * >( testFeature.geometry().constGet() ) : nullptr;
 
       for ( Predicate predicate : qgis::as_const( predicates ) )
       {
         bool isMatch = false;
-        switch ( predicate )
+        if ( testPoint && ( predicate == Intersects || predicate == Contains || predicate == Disjoint ) )
+        {
+          if ( !pointLocator )
+            pointLocator = qgis::make_unique< QgsPolygonPointLocator >( f.geometry().constGet() );
+
+          const QgsPolygonPointLocator::Location location = pointLocator->locate( testPoint->x(), testPoint->y() );
+          switch ( predicate )
+          {
+            case Intersects:
+              isMatch = location != QgsPolygonPointLocator::Exterior;
+              break;
+            case Contains:
+              isMatch = location == QgsPolygonPointLocator::Interior;
+              break;
+            case Disjoint:
+              if ( location != QgsPolygonPointLocator::Exterior )
+              {
+                disjointSet.remove( testFeature.id() );
+              }
+              break;
+            default:
+              break;
+          }
+        }
+        else
         {
-          case Intersects:
-            isMatch = engine->intersects( testFeature.geometry().constGet() );
-            break;
-          case Contains:
-            isMatch = engine->contains( testFeature.geometry().constGet() );
-            break;
-          case Disjoint:
-            if ( engine->intersects( testFeature.geometry().constGet() ) )
-            {
-              disjointSet.remove( testFeature.id() );
-            }
-            break;
-          case IsEqual:
-            isMatch = engine->isEqual( testFeature.geometry().constGet() );
-            break;
-          case Touches:
-            isMatch = engine->touches( testFeature.geometry().constGet() );
-            break;
-          case Overlaps:
-            isMatch = engine->overlaps( testFeature.geometry().constGet() );
-            break;
-          case Within:
-            isMatch = engine->within( testFeature.geometry().constGet() );
-            break;
-          case Crosses:
-            isMatch = engine->crosses( testFeature.geometry().constGet() );
-            break;
+          if ( !engine )
+          {
+            engine.reset( QgsGeometry::createGeometryEngine( f.geometry().constGet() ) );
+            engine->prepareGeometry();
+          }
+
+          switch ( predicate )
+          {
+            case Intersects:
+              isMatch = engine->intersects( testFeature.geometry().constGet() );
+              break;
+            case Contains:
+              isMatch = engine->contains( testFeature.geometry().constGet() );
+              break;
+            case Disjoint:
+              if ( engine->intersects( testFeature.geometry().constGet() ) )
+              {
+                disjointSet.remove( testFeature.id() );
+              }
+              break;
+            case IsEqual:
+              isMatch = engine->isEqual( testFeature.geometry().constGet() );
+              break;
+            case Touches:
+              isMatch = engine->touches( testFeature.geometry().constGet() );
+              break;
+            case Overlaps:
+              isMatch = engine->overlaps( testFeature.geometry().constGet() );
+              break;
+            case Within:
+              isMatch = engine->within( testFeature.geometry().constGet() );
+              break;
+            case Crosses:
+              isMatch = engine->crosses( testFeature.geometry().constGet() );
+              break;
+          }
         }
         if ( isMatch )
         {
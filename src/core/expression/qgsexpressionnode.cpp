@@ -15,6 +15,7 @@
 
 #include "qgsexpressionnode.h"
 #include "qgsexpression.h"
+#include "qgsgeometry.h"
 
 
 QVariant QgsExpressionNode::eval( QgsExpression *parent, const QgsExpressionContext *context )
@@ -36,7 +37,20 @@ bool QgsExpressionNode::prepare( QgsExpression *parent, const QgsExpressionConte
   {
     mCachedStaticValue = evalNode( parent, context );
     if ( !parent->hasEvalError() )
+    {
       mHasCachedValue = true;
+      if ( mCachedStaticValue.userType() == qMetaTypeId< QgsGeometry >() )
+      {
+        // a static geometry is typically tested against the geometry of every evaluated
+        // feature (e.g. intersects($geometry, geom_from_wkt(...))), so keep its prepared form around.
+        // Release the variant's reference first, so that the geometry is only detached if it is also
+        // shared elsewhere (e.g. with a context variable)
+        QgsGeometry geometry = mCachedStaticValue.value< QgsGeometry >();
+        mCachedStaticValue.clear();
+        geometry.setCachePreparedGeometry( true );
+        mCachedStaticValue = QVariant::fromValue( geometry );
+      }
+    }
     else
       mHasCachedValue = false;
     return true;
@@ -26,6 +26,7 @@ email                : marco.hugentobler at sourcepole dot com
 
 #ifndef SIP_RUN
 #include <nlohmann/json_fwd.hpp>
+#include "qgsallocationpool.h"
 using namespace nlohmann;
 #endif
 
@@ -147,6 +148,11 @@ class CORE_EXPORT QgsAbstractGeometry
     virtual ~QgsAbstractGeometry() = default;
     QgsAbstractGeometry( const QgsAbstractGeometry &geom );
     QgsAbstractGeometry &operator=( const QgsAbstractGeometry &geom );
+#ifndef SIP_RUN
+
+    // geometries are allocated through QgsAllocationPool, so that they can be recycled in bulk processing
+    QGS_POOLED_ALLOCATION
+#endif
 
     virtual bool operator==( const QgsAbstractGeometry &other ) const = 0;
     virtual bool operator!=( const QgsAbstractGeometry &other ) const = 0;
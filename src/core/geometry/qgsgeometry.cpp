@@ -18,6 +18,7 @@ email                : morb at ozemail dot com dot au
 #include <cstdio>
 #include <cmath>
 #include <nlohmann/json.hpp>
+#include <QMutex>
 
 #include "qgis.h"
 #include "qgsgeometry.h"
@@ -47,14 +48,182 @@ email                : morb at ozemail dot com dot au
 #include "qgslinestring.h"
 #include "qgscircle.h"
 #include "qgscurve.h"
+#include "qgswkbgeometryview.h"
+#include "qgsallocationpool.h"
+
+#include <atomic>
+
+///@cond PRIVATE
+
+/**
+ * Owns the geometry stored in a QgsGeometryPrivate.
+ *
+ * The geometry may be set to a WKB view, in which case the QgsAbstractGeometry
+ * is only created when it is first accessed. Until then (and for as long as the geometry
+ * is not modified) the view can be used to cheaply retrieve the geometry type, bounding
+ * box and WKB. The state required for this is allocated separately, and only for
+ * geometries created from a view, so other geometries only pay for an extra pointer.
+ *
+ * Mimics the std::unique_ptr interface, so that it can be used in place of one.
+ */
+class QgsGeometryHolder
+{
+  public:
+
+    QgsAbstractGeometry *get() const
+    {
+      materialize();
+      return mGeometry.get();
+    }
+
+    QgsAbstractGeometry *operator->() const { return get(); }
+
+    QgsAbstractGeometry &operator*() const { return *get(); }
+
+    // a valid WKB view always results in a non-null geometry, so there's no need to materialize here
+    explicit operator bool() const { return mLazy || mGeometry; }
+
+    QgsAbstractGeometry *release()
+    {
+      clearView();
+      return mGeometry.release();
+    }
+
+    void reset( QgsAbstractGeometry *geometry = nullptr )
+    {
+      mLazy.reset();
+      mGeometry.reset( geometry );
+    }
+
+    QgsGeometryHolder &operator=( std::unique_ptr< QgsAbstractGeometry > &&geometry )
+    {
+      mLazy.reset();
+      mGeometry = std::move( geometry );
+      return *this;
+    }
+
+    /**
+     * Sets the geometry to a lazily parsed WKB \a view, which must be valid.
+     */
+    void setView( const QgsWkbGeometryView &view )
+    {
+      mGeometry.reset();
+      mLazy = qgis::make_unique< LazyState >( view );
+    }
+
+    /**
+     * Returns the WKB view of the geometry, or nullptr if the geometry was not created from WKB
+     * or may have been modified since.
+     */
+    const QgsWkbGeometryView *view() const
+    {
+      return mLazy ? &mLazy->view : nullptr;
+    }
+
+    /**
+     * Discards the WKB view, creating the geometry if required. Must be called before the
+     * geometry is modified in place.
+     */
+    void clearView()
+    {
+      materialize();
+      mLazy.reset();
+    }
+
+  private:
+
+    //! State of a geometry created from a WKB view
+    struct LazyState
+    {
+      explicit LazyState( const QgsWkbGeometryView &view )
+        : view( view )
+      {}
+
+      QgsWkbGeometryView view;
+      //! TRUE until the geometry has been created from the view
+      std::atomic< bool > pending{ true };
+      QMutex mutex;
+    };
+
+    void materialize() const
+    {
+      // the lazy state itself is only ever replaced while the private data is not shared
+      if ( !mLazy || !mLazy->pending.load( std::memory_order_acquire ) )
+        return;
+
+      QMutexLocker locker( &mLazy->mutex );
+      if ( mLazy->pending.load( std::memory_order_relaxed ) )
+      {
+        mGeometry = mLazy->view.toGeometry();
+        mLazy->pending.store( false, std::memory_order_release );
+      }
+    }
+
+    mutable std::unique_ptr< QgsAbstractGeometry > mGeometry;
+    std::unique_ptr< LazyState > mLazy;
+};
+
+///@endcond
 
 struct QgsGeometryPrivate
 {
   QgsGeometryPrivate(): ref( 1 ) {}
+  QGS_POOLED_ALLOCATION
+
   QAtomicInt ref;
-  std::unique_ptr< QgsAbstractGeometry > geometry;
+  QgsGeometryHolder geometry;
+
+  /**
+   * TRUE if the prepared GEOS representation of the geometry should be cached. Only ever changed
+   * while the private data is not shared, so it can be read without locking.
+   */
+  bool cachePrepared = false;
+
+  /**
+   * Idle prepared geometry engines, only used if cachePrepared is TRUE. An engine is taken
+   * out of this list for the duration of a predicate test, so that no engine is ever used by two threads
+   * at once and predicates are not evaluated while holding the mutex. In practice this list holds one engine
+   * per thread which concurrently tests the geometry.
+   */
+  std::vector< std::unique_ptr< QgsGeometryEngine > > preparedEngines;
+  //! Guards preparedEngines
+  QMutex preparedEngineMutex;
 };
 
+/**
+ * Evaluates \a predicate using a cached prepared geometry engine of \a d, creating
+ * the engine if required, and stores the predicate result in \a result.
+ *
+ * Returns FALSE, without evaluating the predicate, if the prepared geometry cache
+ * is not enabled for \a d.
+ */
+static bool evaluatePrepared( QgsGeometryPrivate *d, bool &result, const std::function< bool( QgsGeometryEngine * ) > &predicate )
+{
+  if ( !d->cachePrepared || !d->geometry )
+    return false;
+
+  std::unique_ptr< QgsGeometryEngine > engine;
+  {
+    QMutexLocker locker( &d->preparedEngineMutex );
+    if ( !d->preparedEngines.empty() )
+    {
+      engine = std::move( d->preparedEngines.back() );
+      d->preparedEngines.pop_back();
+    }
+  }
+  if ( !engine )
+  {
+    engine.reset( QgsGeometry::createGeometryEngine( d->geometry.get() ) );
+    engine->prepareGeometry();
+  }
+
+  result = predicate( engine.get() );
+
+  QMutexLocker locker( &d->preparedEngineMutex );
+  d->preparedEngines.emplace_back( std::move( engine ) );
+  return true;
+}
+
 QgsGeometry::QgsGeometry()
   : d( new QgsGeometryPrivate() )
 {
@@ -103,10 +272,17 @@ QgsGeometry &QgsGeometry::operator=( QgsGeometry const &other )
 void QgsGeometry::detach()
 {
   if ( d->ref <= 1 )
+  {
+    // the geometry is about to be modified in place
+    d->preparedEngines.clear();
+    d->geometry.clearView();
     return;
+  }
 
   std::unique_ptr< QgsAbstractGeometry > cGeom;
-  if ( d->geometry )
+  if ( const QgsWkbGeometryView *view = d->geometry.view() )
+    cGeom = view->toGeometry();
+  else if ( d->geometry )
     cGeom.reset( d->geometry->clone() );
 
   reset( std::move( cGeom ) );
@@ -116,9 +292,12 @@ void QgsGeometry::reset( std::unique_ptr<QgsAbstractGeometry> newGeometry )
 {
   if ( d->ref > 1 )
   {
+    const bool cachePrepared = d->cachePrepared;
     ( void )d->ref.deref();
     d = new QgsGeometryPrivate();
+    d->cachePrepared = cachePrepared;
   }
+  d->preparedEngines.clear();
   d->geometry = std::move( newGeometry );
 }
 
@@ -328,6 +507,7 @@ QgsGeometry QgsGeometry::createWedgeBuffer( const QgsPoint &center, const double
 
 void QgsGeometry::fromWkb( unsigned char *wkb, int length )
 {
+  // the buffer is owned (and deleted) here, so a lazy view would need a copy of it: parse it right away instead
   QgsConstWkbPtr ptr( wkb, length );
   reset( QgsGeometryFactory::geomFromWkb( ptr ) );
   delete [] wkb;
@@ -335,6 +515,15 @@ void QgsGeometry::fromWkb( unsigned char *wkb, int length )
 
 void QgsGeometry::fromWkb( const QByteArray &wkb )
 {
+  // defer parsing of the WKB until the geometry is actually required
+  QgsWkbGeometryView view( wkb );
+  if ( view.isValid() )
+  {
+    reset( nullptr );
+    d->geometry.setView( view );
+    return;
+  }
+
   QgsConstWkbPtr ptr( wkb );
   reset( QgsGeometryFactory::geomFromWkb( ptr ) );
 }
@@ -345,6 +534,10 @@ QgsWkbTypes::Type QgsGeometry::wkbType() const
   {
     return QgsWkbTypes::Unknown;
   }
+  else if ( const QgsWkbGeometryView *view = d->geometry.view() )
+  {
+    return view->wkbType();
+  }
   else
   {
     return d->geometry->wkbType();
@@ -358,7 +551,7 @@ QgsWkbTypes::GeometryType QgsGeometry::type() const
   {
     return QgsWkbTypes::UnknownGeometry;
   }
-  return static_cast< QgsWkbTypes::GeometryType >( QgsWkbTypes::geometryType( d->geometry->wkbType() ) );
+  return static_cast< QgsWkbTypes::GeometryType >( QgsWkbTypes::geometryType( wkbType() ) );
 }
 
 bool QgsGeometry::isEmpty() const
@@ -377,7 +570,7 @@ bool QgsGeometry::isMultipart() const
   {
     return false;
   }
-  return QgsWkbTypes::isMultiType( d->geometry->wkbType() );
+  return QgsWkbTypes::isMultiType( wkbType() );
 }
 
 QgsPointXY QgsGeometry::closestVertex( const QgsPointXY &point, int &atVertex, int &beforeVertex, int &afterVertex, double &sqrDist ) const
@@ -943,7 +1136,11 @@ QgsGeometry QgsGeometry::makeDifference( const QgsGeometry &other ) const
 
 QgsRectangle QgsGeometry::boundingBox() const
 {
-  if ( d->geometry )
+  if ( const QgsWkbGeometryView *view = d->geometry.view() )
+  {
+    return view->boundingBox();
+  }
+  else if ( d->geometry )
   {
     return d->geometry->boundingBox();
   }
@@ -1129,6 +1326,18 @@ bool QgsGeometry::intersects( const QgsRectangle &r ) const
   if ( !boundingBoxIntersects( r ) )
     return false;
 
+  // fast case, the whole geometry is inside the rectangle
+  if ( r.contains( boundingBox() ) )
+    return true;
+
+  // testing against a rectangle doesn't need GEOS, unless we've already got a prepared geometry
+  if ( !d->cachePrepared )
+  {
+    mLastError.clear();
+    QgsInternalGeometryEngine engine( *this );
+    return engine.intersects( r );
+  }
+
   QgsGeometry g = fromRect( r );
   return intersects( g );
 }
@@ -1140,11 +1349,37 @@ bool QgsGeometry::intersects( const QgsGeometry &geometry ) const
     return false;
   }
 
-  QgsGeos geos( d->geometry.get() );
   mLastError.clear();
+  bool result = false;
+  if ( evaluatePrepared( d, result, [this, &geometry]( QgsGeometryEngine * engine ) { return engine->intersects( geometry.d->geometry.get(), &mLastError ); } ) )
+    return result;
+  // the predicate is symmetric, so the other geometry's prepared cache is just as good
+  if ( evaluatePrepared( geometry.d, result, [this]( QgsGeometryEngine * engine ) { return engine->intersects( d->geometry.get(), &mLastError ); } ) )
+    return result;
+
+  QgsGeos geos( d->geometry.get() );
   return geos.intersects( geometry.d->geometry.get(), &mLastError );
 }
 
+void QgsGeometry::setCachePreparedGeometry( bool enabled )
+{
+  if ( enabled == d->cachePrepared )
+    return;
+
+  // the setting belongs to this geometry only, so it must not leak into other implicitly shared copies
+  if ( d->ref > 1 )
+    detach();
+
+  d->cachePrepared = enabled;
+  if ( !enabled )
+    d->preparedEngines.clear();
+}
+
+bool QgsGeometry::cachePreparedGeometry() const
+{
+  return d->cachePrepared;
+}
+
 bool QgsGeometry::boundingBoxIntersects( const QgsRectangle &rectangle ) const
 {
   if ( !d->geometry )
@@ -1152,7 +1387,7 @@ bool QgsGeometry::boundingBoxIntersects( const QgsRectangle &rectangle ) const
     return false;
   }
 
-  return d->geometry->boundingBox().intersects( rectangle );
+  return boundingBox().intersects( rectangle );
 }
 
 bool QgsGeometry::boundingBoxIntersects( const QgsGeometry &geometry ) const
@@ -1162,7 +1397,7 @@ bool QgsGeometry::boundingBoxIntersects( const QgsGeometry &geometry ) const
     return false;
   }
 
-  return d->geometry->boundingBox().intersects( geometry.constGet()->boundingBox() );
+  return boundingBox().intersects( geometry.boundingBox() );
 }
 
 bool QgsGeometry::contains( const QgsPointXY *p ) const
@@ -1173,8 +1408,12 @@ bool QgsGeometry::contains( const QgsPointXY *p ) const
   }
 
   QgsPoint pt( p->x(), p->y() );
-  QgsGeos geos( d->geometry.get() );
   mLastError.clear();
+  bool result = false;
+  if ( evaluatePrepared( d, result, [this, &pt]( QgsGeometryEngine * engine ) { return engine->contains( &pt, &mLastError ); } ) )
+    return result;
+
+  QgsGeos geos( d->geometry.get() );
   return geos.contains( &pt, &mLastError );
 }
 
@@ -1185,8 +1424,15 @@ bool QgsGeometry::contains( const QgsGeometry &geometry ) const
     return false;
   }
 
-  QgsGeos geos( d->geometry.get() );
   mLastError.clear();
+  bool result = false;
+  if ( evaluatePrepared( d, result, [this, &geometry]( QgsGeometryEngine * engine ) { return engine->contains( geometry.d->geometry.get(), &mLastError ); } ) )
+    return result;
+  // a contains b is equivalent to b within a
+  if ( evaluatePrepared( geometry.d, result, [this]( QgsGeometryEngine * engine ) { return engine->within( d->geometry.get(), &mLastError ); } ) )
+    return result;
+
+  QgsGeos geos( d->geometry.get() );
   return geos.contains( geometry.d->geometry.get(), &mLastError );
 }
 
@@ -1197,8 +1443,15 @@ bool QgsGeometry::disjoint( const QgsGeometry &geometry ) const
     return false;
   }
 
-  QgsGeos geos( d->geometry.get() );
   mLastError.clear();
+  bool result = false;
+  if ( evaluatePrepared( d, result, [this, &geometry]( QgsGeometryEngine * engine ) { return engine->disjoint( geometry.d->geometry.get(), &mLastError ); } ) )
+    return result;
+  // the predicate is symmetric, so the other geometry's prepared cache is just as good
+  if ( evaluatePrepared( geometry.d, result, [this]( QgsGeometryEngine * engine ) { return engine->disjoint( d->geometry.get(), &mLastError ); } ) )
+    return result;
+
+  QgsGeos geos( d->geometry.get() );
   return geos.disjoint( geometry.d->geometry.get(), &mLastError );
 }
 
@@ -1224,8 +1477,15 @@ bool QgsGeometry::touches( const QgsGeometry &geometry ) const
     return false;
   }
 
-  QgsGeos geos( d->geometry.get() );
   mLastError.clear();
+  bool result = false;
+  if ( evaluatePrepared( d, result, [this, &geometry]( QgsGeometryEngine * engine ) { return engine->touches( geometry.d->geometry.get(), &mLastError ); } ) )
+    return result;
+  // the predicate is symmetric, so the other geometry's prepared cache is just as good
+  if ( evaluatePrepared( geometry.d, result, [this]( QgsGeometryEngine * engine ) { return engine->touches( d->geometry.get(), &mLastError ); } ) )
+    return result;
+
+  QgsGeos geos( d->geometry.get() );
   return geos.touches( geometry.d->geometry.get(), &mLastError );
 }
 
@@ -1236,8 +1496,15 @@ bool QgsGeometry::overlaps( const QgsGeometry &geometry ) const
     return false;
   }
 
-  QgsGeos geos( d->geometry.get() );
   mLastError.clear();
+  bool result = false;
+  if ( evaluatePrepared( d, result, [this, &geometry]( QgsGeometryEngine * engine ) { return engine->overlaps( geometry.d->geometry.get(), &mLastError ); } ) )
+    return result;
+  // the predicate is symmetric, so the other geometry's prepared cache is just as good
+  if ( evaluatePrepared( geometry.d, result, [this]( QgsGeometryEngine * engine ) { return engine->overlaps( d->geometry.get(), &mLastError ); } ) )
+    return result;
+
+  QgsGeos geos( d->geometry.get() );
   return geos.overlaps( geometry.d->geometry.get(), &mLastError );
 }
 
@@ -1248,8 +1515,15 @@ bool QgsGeometry::within( const QgsGeometry &geometry ) const
     return false;
   }
 
-  QgsGeos geos( d->geometry.get() );
   mLastError.clear();
+  bool result = false;
+  if ( evaluatePrepared( d, result, [this, &geometry]( QgsGeometryEngine * engine ) { return engine->within( geometry.d->geometry.get(), &mLastError ); } ) )
+    return result;
+  // a within b is equivalent to b contains a
+  if ( evaluatePrepared( geometry.d, result, [this]( QgsGeometryEngine * engine ) { return engine->contains( d->geometry.get(), &mLastError ); } ) )
+    return result;
+
+  QgsGeos geos( d->geometry.get() );
   return geos.within( geometry.d->geometry.get(), &mLastError );
 }
 
@@ -1260,8 +1534,15 @@ bool QgsGeometry::crosses( const QgsGeometry &geometry ) const
     return false;
   }
 
-  QgsGeos geos( d->geometry.get() );
   mLastError.clear();
+  bool result = false;
+  if ( evaluatePrepared( d, result, [this, &geometry]( QgsGeometryEngine * engine ) { return engine->crosses( geometry.d->geometry.get(), &mLastError ); } ) )
+    return result;
+  // the predicate is symmetric, so the other geometry's prepared cache is just as good
+  if ( evaluatePrepared( geometry.d, result, [this]( QgsGeometryEngine * engine ) { return engine->crosses( d->geometry.get(), &mLastError ); } ) )
+    return result;
+
+  QgsGeos geos( d->geometry.get() );
   return geos.crosses( geometry.d->geometry.get(), &mLastError );
 }
 
@@ -2327,6 +2608,10 @@ QgsGeometry QgsGeometry::extrude( double x, double y )
 
 QByteArray QgsGeometry::asWkb() const
 {
+  const QgsWkbGeometryView *view = d->geometry.view();
+  if ( view && view->isNativeEndian() )
+    return view->wkb();
+
   return d->geometry ? d->geometry->asWkb() : QByteArray();
 }
 
@@ -299,6 +299,11 @@ class CORE_EXPORT QgsGeometry
 
     /**
      * Set the geometry, feeding in the buffer containing OGC Well-Known Binary
+     *
+     * For linear geometry types the WKB is not parsed until the geometry is first
+     * accessed. Until then, wkbType(), boundingBox() and asWkb() are retrieved directly
+     * from the WKB buffer.
+     *
      * \since QGIS 3.0
      */
     void fromWkb( const QByteArray &wkb );
@@ -994,8 +999,9 @@ class CORE_EXPORT QgsGeometry
      * Returns TRUE if this geometry exactly intersects with a \a rectangle. This test is exact
      * and can be slow for complex geometries.
      *
-     * The GEOS library is used to perform the intersection test. Geometries which are not
-     * valid may return incorrect results.
+     * Since QGIS 3.10 the test is performed directly on the geometry's coordinates, unless
+     * the prepared GEOS geometry is cached (see setCachePreparedGeometry()), in which case
+     * the GEOS library is used. Geometries which are not valid may return incorrect results.
      *
      * \see boundingBoxIntersects()
      */
@@ -1012,6 +1018,35 @@ class CORE_EXPORT QgsGeometry
      */
     bool intersects( const QgsGeometry &geometry ) const;
 
+    /**
+     * Sets whether the prepared GEOS representation of the geometry should be cached.
+     *
+     * When enabled, the first spatial predicate test (such as intersects(), contains() or within())
+     * converts the geometry to GEOS and prepares it, and all subsequent predicate tests reuse
+     * this prepared representation. This is much faster when the same geometry is tested against
+     * many other geometries, at the cost of the extra memory used by the cached GEOS geometry.
+     * The setting only applies to this geometry: implicitly shared copies made before the call are
+     * detached from it, while copies made afterwards share the cache. The cache is discarded whenever
+     * the geometry is modified. Predicate tests may be run concurrently from several threads, in which
+     * case each thread uses its own prepared representation.
+     *
+     * \warning The cache is not invalidated when the geometry is modified through a pointer
+     * obtained by a call to get() prior to the predicate tests.
+     *
+     * \see cachePreparedGeometry()
+     * \since QGIS 3.10
+     */
+    void setCachePreparedGeometry( bool enabled );
+
+    /**
+     * Returns TRUE if the prepared GEOS representation of the geometry is cached and reused
+     * for spatial predicate tests.
+     *
+     * \see setCachePreparedGeometry()
+     * \since QGIS 3.10
+     */
+    bool cachePreparedGeometry() const;
+
     /**
      * Returns TRUE if the bounding box of this geometry intersects with a \a rectangle. Since this
      * test only considers the bounding box of the geometry, is is very fast to calculate and handles invalid
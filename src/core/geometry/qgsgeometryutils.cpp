@@ -19,6 +19,7 @@ email                : marco.hugentobler at sourcepole dot com
 #include "qgscurvepolygon.h"
 #include "qgsgeometrycollection.h"
 #include "qgslinestring.h"
+#include "qgsrectangle.h"
 #include "qgswkbptr.h"
 #include "qgslogger.h"
 
@@ -315,6 +316,52 @@ bool QgsGeometryUtils::segmentIntersection( const QgsPoint &p1, const QgsPoint &
 
 }
 
+bool QgsGeometryUtils::segmentsIntersect( double x1, double y1, double x2, double y2, double x3, double y3, double x4, double y4 )
+{
+  // orientations of each segment's end points relative to the other segment
+  const double d1 = ( x4 - x3 ) * ( y1 - y3 ) - ( y4 - y3 ) * ( x1 - x3 );
+  const double d2 = ( x4 - x3 ) * ( y2 - y3 ) - ( y4 - y3 ) * ( x2 - x3 );
+  const double d3 = ( x2 - x1 ) * ( y3 - y1 ) - ( y2 - y1 ) * ( x3 - x1 );
+  const double d4 = ( x2 - x1 ) * ( y4 - y1 ) - ( y2 - y1 ) * ( x4 - x1 );
+
+  if ( ( ( d1 > 0 && d2 < 0 ) || ( d1 < 0 && d2 > 0 ) ) && ( ( d3 > 0 && d4 < 0 ) || ( d3 < 0 && d4 > 0 ) ) )
+    return true;
+
+  // collinear end point, check whether it lies within the other segment
+  auto onSegment = []( double ax, double ay, double bx, double by, double px, double py )
+  {
+    return px >= std::min( ax, bx ) && px <= std::max( ax, bx ) && py >= std::min( ay, by ) && py <= std::max( ay, by );
+  };
+  return ( qgsDoubleNear( d1, 0.0, 0.0 ) && onSegment( x3, y3, x4, y4, x1, y1 ) )
+         || ( qgsDoubleNear( d2, 0.0, 0.0 ) && onSegment( x3, y3, x4, y4, x2, y2 ) )
+         || ( qgsDoubleNear( d3, 0.0, 0.0 ) && onSegment( x1, y1, x2, y2, x3, y3 ) )
+         || ( qgsDoubleNear( d4, 0.0, 0.0 ) && onSegment( x1, y1, x2, y2, x4, y4 ) );
+}
+
+bool QgsGeometryUtils::segmentIntersectsRectangle( double x1, double y1, double x2, double y2, const QgsRectangle &rectangle )
+{
+  const double xMin = rectangle.xMinimum();
+  const double yMin = rectangle.yMinimum();
+  const double xMax = rectangle.xMaximum();
+  const double yMax = rectangle.yMaximum();
+
+  // separating axis test: the x and y axes...
+  if ( std::max( x1, x2 ) < xMin || std::min( x1, x2 ) > xMax || std::max( y1, y2 ) < yMin || std::min( y1, y2 ) > yMax )
+    return false;
+
+  // ...and the segment normal, i.e. all rectangle corners strictly on the same side of the segment
+  const double dx = x2 - x1;
+  const double dy = y2 - y1;
+  const double c1 = dx * ( yMin - y1 ) - dy * ( xMin - x1 );
+  const double c2 = dx * ( yMin - y1 ) - dy * ( xMax - x1 );
+  const double c3 = dx * ( yMax - y1 ) - dy * ( xMax - x1 );
+  const double c4 = dx * ( yMax - y1 ) - dy * ( xMin - x1 );
+  if ( ( c1 > 0 && c2 > 0 && c3 > 0 && c4 > 0 ) || ( c1 < 0 && c2 < 0 && c3 < 0 && c4 < 0 ) )
+    return false;
+
+  return true;
+}
+
 bool QgsGeometryUtils::lineCircleIntersection( const QgsPointXY &center, const double radius,
     const QgsPointXY &linePoint1, const QgsPointXY &linePoint2,
     QgsPointXY &intersection )
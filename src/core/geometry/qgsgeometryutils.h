@@ -141,6 +141,28 @@ class CORE_EXPORT QgsGeometryUtils
      */
     static bool segmentIntersection( const QgsPoint &p1, const QgsPoint &p2, const QgsPoint &q1, const QgsPoint &q2, QgsPoint &intersectionPoint SIP_OUT, bool &isIntersection SIP_OUT, double tolerance = 1e-8, bool acceptImproperIntersection = false );
 
+    /**
+     * Returns TRUE if the segment from (\a x1, \a y1) to (\a x2, \a y2) intersects the segment
+     * from (\a x3, \a y3) to (\a x4, \a y4). Touching end points and collinear overlapping
+     * segments are considered as intersecting.
+     *
+     * Unlike segmentIntersection(), the intersection point is not calculated, which makes this
+     * test cheaper when only a boolean result is required.
+     *
+     * \see segmentIntersectsRectangle()
+     * \since QGIS 3.10
+     */
+    static bool segmentsIntersect( double x1, double y1, double x2, double y2, double x3, double y3, double x4, double y4 );
+
+    /**
+     * Returns TRUE if the segment from (\a x1, \a y1) to (\a x2, \a y2) intersects
+     * the \a rectangle, including its boundary.
+     *
+     * \see segmentsIntersect()
+     * \since QGIS 3.10
+     */
+    static bool segmentIntersectsRectangle( double x1, double y1, double x2, double y2, const QgsRectangle &rectangle );
+
     /**
      * \brief Compute the intersection of a line and a circle.
      * If the intersection has two solutions (points),
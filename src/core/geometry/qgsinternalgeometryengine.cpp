@@ -19,6 +19,8 @@
 #include "qgslinestring.h"
 #include "qgsmultipolygon.h"
 #include "qgspolygon.h"
+#include "qgscurvepolygon.h"
+#include "qgsgeometrycollection.h"
 #include "qgsmulticurve.h"
 #include "qgsgeometry.h"
 #include "qgsgeometryutils.h"
@@ -1036,3 +1038,291 @@ QgsGeometry QgsInternalGeometryEngine::variableWidthBufferByM( int segments ) co
 
   return variableWidthBuffer( segments, widthByM );
 }
+
+/**
+ * Calls \a function for every linear ring of the polygonal parts of \a geometry. Curved rings are segmentized.
+ */
+static void forEachPolygonRing( const QgsAbstractGeometry *geometry, const std::function< void( const QgsLineString *ring ) > &function )
+{
+  if ( !geometry )
+    return;
+
+  auto handleRing = [&function]( const QgsCurve * ring )
+  {
+    if ( !ring )
+      return;
+
+    if ( const QgsLineString *line = qgsgeometry_cast< const QgsLineString * >( ring ) )
+    {
+      function( line );
+    }
+    else
+    {
+      std::unique_ptr< QgsLineString > segmentized( ring->curveToLine() );
+      function( segmentized.get() );
+    }
+  };
+
+  if ( const QgsCurvePolygon *polygon = qgsgeometry_cast< const QgsCurvePolygon * >( geometry ) )
+  {
+    handleRing( polygon->exteriorRing() );
+    for ( int i = 0; i < polygon->numInteriorRings(); ++i )
+      handleRing( polygon->interiorRing( i ) );
+  }
+  else if ( const QgsGeometryCollection *collection = qgsgeometry_cast< const QgsGeometryCollection * >( geometry ) )
+  {
+    for ( int i = 0; i < collection->numGeometries(); ++i )
+      forEachPolygonRing( collection->geometryN( i ), function );
+  }
+}
+
+/**
+ * Tests the point (\a px, \a py) against the edge from (\a x1, \a y1) to (\a x2, \a y2), incrementing
+ * \a crossings if a ray extending from the point in the positive x direction crosses the edge, and
+ * setting \a onEdge if the point lies on the edge.
+ *
+ * The body is kept free of branches and divisions so that compilers can vectorize loops calling it.
+ */
+static inline void testEdge( double x1, double y1, double x2, double y2, double px, double py, int &crossings, int &onEdge )
+{
+  const double dx = x2 - x1;
+  const double dy = y2 - y1;
+  // > 0 if the point is left of the edge
+  const double side = dx * ( py - y1 ) - dy * ( px - x1 );
+
+  // the ray crosses edges spanning its y, where the point is left of upward edges or right of downward edges
+  const bool straddles = ( y1 > py ) != ( y2 > py );
+  crossings += straddles & ( dy > 0 ? side > 0 : side < 0 );
+
+  onEdge |= ( side == 0 ) & ( px >= std::min( x1, x2 ) ) & ( px <= std::max( x1, x2 ) )
+            & ( py >= std::min( y1, y2 ) ) & ( py <= std::max( y1, y2 ) );
+}
+
+/**
+ * Tests the point (\a px, \a py) against \a count edges, stored as separate coordinate arrays.
+ *
+ * Returns -1 if the point lies on one of the edges, or otherwise the number of edges crossed
+ * by a ray extending from the point in the positive x direction.
+ */
+static int edgeCrossings( const double *x1, const double *y1, const double *x2, const double *y2, int count, double px, double py )
+{
+  int crossings = 0;
+  int onEdge = 0;
+  for ( int i = 0; i < count; ++i )
+    testEdge( x1[i], y1[i], x2[i], y2[i], px, py, crossings, onEdge );
+  return onEdge ? -1 : crossings;
+}
+
+/**
+ * Tests the point (\a px, \a py) against the \a count edges whose positions in the coordinate arrays
+ * are listed in \a indices, and adds the results to \a crossings and \a onEdge.
+ */
+static void indexedEdgeCrossings( const double *x1, const double *y1, const double *x2, const double *y2, const int *indices, int count, double px, double py, int &crossings, int &onEdge )
+{
+  for ( int i = 0; i < count; ++i )
+  {
+    const int edge = indices[i];
+    testEdge( x1[edge], y1[edge], x2[edge], y2[edge], px, py, crossings, onEdge );
+  }
+}
+
+/**
+ * Returns TRUE if the point (\a px, \a py) is inside or on the boundary of the polygonal parts of \a geometry.
+ */
+static bool polygonIntersectsPoint( const QgsAbstractGeometry *geometry, double px, double py )
+{
+  int crossings = 0;
+  bool onBoundary = false;
+  forEachPolygonRing( geometry, [&]( const QgsLineString * ring )
+  {
+    if ( onBoundary || ring->numPoints() < 2 )
+      return;
+
+    const int n = ring->numPoints() - 1;
+    const double *x = ring->xData();
+    const double *y = ring->yData();
+    const int ringCrossings = edgeCrossings( x, y, x + 1, y + 1, n, px, py );
+    if ( ringCrossings < 0 )
+      onBoundary = true;
+    else
+      crossings += ringCrossings;
+  } );
+  return onBoundary || crossings % 2 == 1;
+}
+
+/**
+ * Returns TRUE if any part of \a geometry intersects \a rectangle.
+ */
+static bool geometryIntersectsRectangle( const QgsAbstractGeometry *geometry, const QgsRectangle &rectangle )
+{
+  if ( !geometry || !geometry->boundingBox().intersects( rectangle ) )
+    return false;
+
+  if ( const QgsPoint *point = qgsgeometry_cast< const QgsPoint * >( geometry ) )
+  {
+    return rectangle.contains( QgsPointXY( point->x(), point->y() ) );
+  }
+  else if ( const QgsCurve *curve = qgsgeometry_cast< const QgsCurve * >( geometry ) )
+  {
+    std::unique_ptr< QgsLineString > segmentized;
+    const QgsLineString *line = qgsgeometry_cast< const QgsLineString * >( curve );
+    if ( !line )
+    {
+      segmentized.reset( curve->curveToLine() );
+      line = segmentized.get();
+    }
+
+    const int n = line->numPoints();
+    const double *x = line->xData();
+    const double *y = line->yData();
+    if ( n == 1 )
+      return rectangle.contains( QgsPointXY( x[0], y[0] ) );
+    for ( int i = 0; i < n - 1; ++i )
+    {
+      if ( QgsGeometryUtils::segmentIntersectsRectangle( x[i], y[i], x[i + 1], y[i + 1], rectangle ) )
+        return true;
+    }
+    return false;
+  }
+  else if ( const QgsCurvePolygon *polygon = qgsgeometry_cast< const QgsCurvePolygon * >( geometry ) )
+  {
+    // either a ring crosses the rectangle or lies inside it...
+    if ( geometryIntersectsRectangle( polygon->exteriorRing(), rectangle ) )
+      return true;
+    for ( int i = 0; i < polygon->numInteriorRings(); ++i )
+    {
+      if ( geometryIntersectsRectangle( polygon->interiorRing( i ), rectangle ) )
+        return true;
+    }
+    // ...or the rectangle is completely inside the polygon (or completely inside a hole)
+    const QgsPointXY center = rectangle.center();
+    return polygonIntersectsPoint( polygon, center.x(), center.y() );
+  }
+  else if ( const QgsGeometryCollection *collection = qgsgeometry_cast< const QgsGeometryCollection * >( geometry ) )
+  {
+    for ( int i = 0; i < collection->numGeometries(); ++i )
+    {
+      if ( geometryIntersectsRectangle( collection->geometryN( i ), rectangle ) )
+        return true;
+    }
+  }
+  return false;
+}
+
+bool QgsInternalGeometryEngine::intersects( const QgsRectangle &rectangle ) const
+{
+  return geometryIntersectsRectangle( mGeometry, rectangle );
+}
+
+//
+// QgsPolygonPointLocator
+//
+
+QgsPolygonPointLocator::QgsPolygonPointLocator( const QgsAbstractGeometry *geometry )
+{
+  mExtent.setMinimal();
+  forEachPolygonRing( geometry, [&]( const QgsLineString * ring )
+  {
+    const int n = ring->numPoints();
+    const double *x = ring->xData();
+    const double *y = ring->yData();
+    for ( int i = 0; i < n - 1; ++i )
+    {
+      mX1 << x[i];
+      mY1 << y[i];
+      mX2 << x[i + 1];
+      mY2 << y[i + 1];
+    }
+    if ( n > 1 )
+      mExtent.combineExtentWith( ring->boundingBox() );
+  } );
+
+  const int edgeCount = mX1.size();
+  if ( edgeCount == 0 || mExtent.height() <= 0 )
+    return;
+
+  // aim for a handful of edges per band
+  mBandCount = std::max( 1, std::min( 1 << 14, edgeCount / 4 ) );
+  mBandHeight = mExtent.height() / mBandCount;
+
+  // edges are only stored once, and each band lists the indices of the edges it contains. Edges which span
+  // many bands (e.g. the long sides of a polygon made of a few long edges and many short ones) are kept in
+  // a separate list which is tested for every point, rather than being referenced by each of their bands
+  mBandOffsets.fill( 0, mBandCount + 1 );
+  qint64 references = 0;
+  for ( int i = 0; i < edgeCount; ++i )
+  {
+    const int first = bandIndex( std::min( mY1.at( i ), mY2.at( i ) ) );
+    const int last = bandIndex( std::max( mY1.at( i ), mY2.at( i ) ) );
+    if ( last - first >= MAX_EDGE_BAND_SPAN )
+    {
+      mLongEdges << i;
+      continue;
+    }
+    for ( int band = first; band <= last; ++band )
+      mBandOffsets[ band + 1 ]++;
+    references += last - first + 1;
+  }
+
+  // if the edges aren't spread out vertically the bands don't prune much, so a plain scan of all edges is just as fast
+  if ( references > static_cast< qint64 >( MAX_EDGE_DUPLICATION ) * edgeCount || mLongEdges.size() > edgeCount / MAX_EDGE_DUPLICATION )
+  {
+    mBandCount = 0;
+    mBandHeight = 0;
+    mBandOffsets.clear();
+    mLongEdges.clear();
+    return;
+  }
+
+  for ( int band = 0; band < mBandCount; ++band )
+    mBandOffsets[ band + 1 ] += mBandOffsets.at( band );
+
+  mBandEdges.resize( static_cast< int >( references ) );
+  QVector< int > next = mBandOffsets;
+  for ( int i = 0; i < edgeCount; ++i )
+  {
+    const int first = bandIndex( std::min( mY1.at( i ), mY2.at( i ) ) );
+    const int last = bandIndex( std::max( mY1.at( i ), mY2.at( i ) ) );
+    if ( last - first >= MAX_EDGE_BAND_SPAN )
+      continue;
+    for ( int band = first; band <= last; ++band )
+      mBandEdges[ next[ band ]++ ] = i;
+  }
+}
+
+int QgsPolygonPointLocator::bandIndex( double y ) const
+{
+  if ( mBandHeight <= 0 )
+    return 0;
+  return qBound( 0, static_cast< int >( ( y - mExtent.yMinimum() ) / mBandHeight ), mBandCount - 1 );
+}
+
+QgsPolygonPointLocator::Location QgsPolygonPointLocator::locate( double x, double y ) const
+{
+  if ( !isValid() || !mExtent.contains( QgsPointXY( x, y ) ) )
+    return Exterior;
+
+  int crossings = 0;
+  if ( mBandCount == 0 )
+  {
+    crossings = edgeCrossings( mX1.constData(), mY1.constData(), mX2.constData(), mY2.constData(), mX1.size(), x, y );
+  }
+  else
+  {
+    // a horizontal ray from the point only ever crosses edges which span the point's y, and these are all either
+    // in its band or in the long edge list
+    const int band = bandIndex( y );
+    const int start = mBandOffsets.at( band );
+    int onEdge = 0;
+    indexedEdgeCrossings( mX1.constData(), mY1.constData(), mX2.constData(), mY2.constData(),
+                          mBandEdges.constData() + start, mBandOffsets.at( band + 1 ) - start, x, y, crossings, onEdge );
+    indexedEdgeCrossings( mX1.constData(), mY1.constData(), mX2.constData(), mY2.constData(),
+                          mLongEdges.constData(), mLongEdges.size(), x, y, crossings, onEdge );
+    if ( onEdge )
+      crossings = -1;
+  }
+
+  if ( crossings < 0 )
+    return Boundary;
+  return crossings % 2 == 1 ? Interior : Exterior;
+}
@@ -0,0 +1,317 @@
+/***************************************************************************
+                         qgswkbgeometryview.cpp
+                         ----------------------
+    begin                : October 2026
+    copyright            : (C) 2026 by agent
+    email                : agent at local
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qgswkbgeometryview.h"
+#include "qgsapplication.h"
+#include "qgsabstractgeometry.h"
+#include "qgsgeometryfactory.h"
+#include "qgswkbptr.h"
+
+#include <cstring>
+#include <limits>
+
+///@cond PRIVATE
+
+//! Maximum nesting depth of geometry collections accepted by the view
+static const int MAX_COLLECTION_DEPTH = 32;
+
+typedef std::function< void( double x, double y ) > VertexVisitor;
+
+/**
+ * Minimal bounds checked WKB reader, which honors the byte order
+ * specified in the most recently read geometry header.
+ */
+class QgsWkbViewReader
+{
+  public:
+
+    QgsWkbViewReader( const char *data, int size )
+      : mStart( data )
+      , mP( data )
+      , mEnd( data + size )
+    {}
+
+    int position() const { return static_cast< int >( mP - mStart ); }
+
+    bool isSwapped() const { return mSwap; }
+
+    bool readHeader( QgsWkbTypes::Type &type )
+    {
+      if ( mEnd - mP < 5 )
+        return false;
+
+      const char endian = *mP++;
+      if ( endian != QgsApplication::XDR && endian != QgsApplication::NDR )
+        return false;
+      mSwap = endian != QgsApplication::endian();
+
+      quint32 wkbType;
+      read( wkbType );
+      type = static_cast< QgsWkbTypes::Type >( wkbType );
+      return true;
+    }
+
+    bool readCount( int &count )
+    {
+      if ( mEnd - mP < static_cast< int >( sizeof( quint32 ) ) )
+        return false;
+
+      qint32 value;
+      read( value );
+      count = value;
+      return count >= 0;
+    }
+
+    bool canReadDoubles( int count, int dimensions ) const
+    {
+      return static_cast< qint64 >( count ) * dimensions * static_cast< qint64 >( sizeof( double ) ) <= mEnd - mP;
+    }
+
+    double readDouble()
+    {
+      double value;
+      read( value );
+      return value;
+    }
+
+    void skipDoubles( int count )
+    {
+      mP += count * sizeof( double );
+    }
+
+  private:
+
+    template<typename T> void read( T &value )
+    {
+      memcpy( &value, mP, sizeof( T ) );
+      mP += sizeof( T );
+      if ( mSwap )
+      {
+        char *data = reinterpret_cast<char *>( &value );
+        for ( std::size_t i = 0, n = sizeof( T ); i < n / 2; ++i )
+          std::swap( data[i], data[n - 1 - i] );
+      }
+    }
+
+    const char *mStart = nullptr;
+    const char *mP = nullptr;
+    const char *mEnd = nullptr;
+    bool mSwap = false;
+};
+
+struct QgsWkbViewScanResult
+{
+  QgsRectangle boundingBox;
+  int vertexCount = 0;
+  bool nativeEndian = true;
+};
+
+/**
+ * Reads a sequence of \a count vertices. If \a boundingBox is set it is filled
+ * with the extent of the vertices, calculated in the same way as QgsLineString does.
+ */
+static bool scanVertices( QgsWkbViewReader &reader, int count, int dimensions, QgsRectangle *boundingBox, const VertexVisitor *visitor )
+{
+  if ( !reader.canReadDoubles( count, dimensions ) )
+    return false;
+
+  double xmin = std::numeric_limits<double>::max();
+  double ymin = std::numeric_limits<double>::max();
+  double xmax = -std::numeric_limits<double>::max();
+  double ymax = -std::numeric_limits<double>::max();
+  for ( int i = 0; i < count; ++i )
+  {
+    const double x = reader.readDouble();
+    const double y = reader.readDouble();
+    reader.skipDoubles( dimensions - 2 );
+
+    if ( x < xmin )
+      xmin = x;
+    if ( x > xmax )
+      xmax = x;
+    if ( y < ymin )
+      ymin = y;
+    if ( y > ymax )
+      ymax = y;
+
+    if ( visitor )
+      ( *visitor )( x, y );
+  }
+
+  if ( boundingBox )
+    *boundingBox = QgsRectangle( xmin, ymin, xmax, ymax );
+  return true;
+}
+
+/**
+ * Scans a single geometry (including all its parts) from \a reader.
+ *
+ * If \a requiredType is not QgsWkbTypes::Unknown then the geometry must be of exactly this type.
+ */
+static bool scanGeometry( QgsWkbViewReader &reader, int depth, QgsWkbTypes::Type requiredType, QgsWkbTypes::Type &type,
+                          QgsWkbViewScanResult &result, const VertexVisitor *visitor )
+{
+  if ( depth > MAX_COLLECTION_DEPTH )
+    return false;
+
+  if ( !reader.readHeader( type ) )
+    return false;
+
+  if ( requiredType != QgsWkbTypes::Unknown && type != requiredType )
+    return false;
+
+  result.nativeEndian = result.nativeEndian && !reader.isSwapped();
+
+  const QgsWkbTypes::Type flatType = QgsWkbTypes::flatType( type );
+  const bool hasZ = QgsWkbTypes::hasZ( type );
+  const bool hasM = QgsWkbTypes::hasM( type );
+  const int dimensions = 2 + hasZ + hasM;
+
+  switch ( flatType )
+  {
+    case QgsWkbTypes::Point:
+    {
+      if ( !reader.canReadDoubles( 1, dimensions ) )
+        return false;
+
+      const double x = reader.readDouble();
+      const double y = reader.readDouble();
+      reader.skipDoubles( dimensions - 2 );
+      result.boundingBox = QgsRectangle( x, y, x, y );
+      result.vertexCount += 1;
+      if ( visitor )
+        ( *visitor )( x, y );
+      return true;
+    }
+
+    case QgsWkbTypes::LineString:
+    {
+      int count = 0;
+      if ( !reader.readCount( count ) || !scanVertices( reader, count, dimensions, &result.boundingBox, visitor ) )
+        return false;
+
+      result.vertexCount += count;
+      return true;
+    }
+
+    case QgsWkbTypes::Polygon:
+    {
+      int ringCount = 0;
+      if ( !reader.readCount( ringCount ) )
+        return false;
+
+      // polygon extents are taken from the exterior ring only
+      result.boundingBox = QgsRectangle();
+      for ( int ring = 0; ring < ringCount; ++ring )
+      {
+        int count = 0;
+        if ( !reader.readCount( count ) || !scanVertices( reader, count, dimensions, ring == 0 ? &result.boundingBox : nullptr, visitor ) )
+          return false;
+
+        result.vertexCount += count;
+      }
+      return true;
+    }
+
+    case QgsWkbTypes::MultiPoint:
+    case QgsWkbTypes::MultiLineString:
+    case QgsWkbTypes::MultiPolygon:
+    case QgsWkbTypes::GeometryCollection:
+    {
+      QgsWkbTypes::Type partType = QgsWkbTypes::Unknown;
+      if ( flatType != QgsWkbTypes::GeometryCollection )
+      {
+        // typed collections take their Z/M type from their first part when parsed, so
+        // only accept those where this is guaranteed to match the WKB type (e.g. no 25D types)
+        if ( type != QgsWkbTypes::zmType( flatType, hasZ, hasM ) )
+          return false;
+        partType = QgsWkbTypes::singleType( type );
+      }
+
+      int partCount = 0;
+      if ( !reader.readCount( partCount ) )
+        return false;
+
+      QgsRectangle boundingBox;
+      for ( int part = 0; part < partCount; ++part )
+      {
+        QgsWkbTypes::Type partWkbType = QgsWkbTypes::Unknown;
+        if ( !scanGeometry( reader, depth + 1, partType, partWkbType, result, visitor ) )
+          return false;
+
+        if ( part == 0 )
+          boundingBox = result.boundingBox;
+        else
+          boundingBox.combineExtentWith( result.boundingBox );
+      }
+      result.boundingBox = boundingBox;
+      return true;
+    }
+
+    default:
+      // curved and other geometry types are not supported
+      return false;
+  }
+}
+
+///@endcond
+
+QgsWkbGeometryView::QgsWkbGeometryView( const QByteArray &wkb )
+  : mWkb( wkb )
+{
+  if ( mWkb.isEmpty() )
+    return;
+
+  QgsWkbViewReader reader( mWkb.constData(), mWkb.size() );
+  QgsWkbViewScanResult result;
+  QgsWkbTypes::Type type = QgsWkbTypes::Unknown;
+  if ( !scanGeometry( reader, 0, QgsWkbTypes::Unknown, type, result, nullptr ) )
+    return;
+
+  mValid = true;
+  mSize = reader.position();
+  mWkbType = type;
+  mVertexCount = result.vertexCount;
+  mNativeEndian = result.nativeEndian;
+  mBoundingBox = result.boundingBox;
+}
+
+QByteArray QgsWkbGeometryView::wkb() const
+{
+  if ( !mValid )
+    return QByteArray();
+
+  return mSize == mWkb.size() ? mWkb : mWkb.left( mSize );
+}
+
+void QgsWkbGeometryView::visitVertices( const std::function<void ( double, double )> &visitor ) const
+{
+  if ( !mValid )
+    return;
+
+  QgsWkbViewReader reader( mWkb.constData(), mSize );
+  QgsWkbViewScanResult result;
+  QgsWkbTypes::Type type = QgsWkbTypes::Unknown;
+  scanGeometry( reader, 0, QgsWkbTypes::Unknown, type, result, &visitor );
+}
+
+std::unique_ptr<QgsAbstractGeometry> QgsWkbGeometryView::toGeometry() const
+{
+  if ( !mValid )
+    return nullptr;
+
+  QgsConstWkbPtr ptr( reinterpret_cast< const unsigned char * >( mWkb.constData() ), mSize );
+  return QgsGeometryFactory::geomFromWkb( ptr );
+}
@@ -0,0 +1,133 @@
+/***************************************************************************
+                         qgswkbgeometryview.h
+                         ---------------------
+    begin                : October 2026
+    copyright            : (C) 2026 by agent
+    email                : agent at local
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef QGSWKBGEOMETRYVIEW_H
+#define QGSWKBGEOMETRYVIEW_H
+
+#define SIP_NO_FILE
+
+#include "qgis_core.h"
+#include "qgswkbtypes.h"
+#include "qgsrectangle.h"
+
+#include <QByteArray>
+#include <functional>
+#include <memory>
+
+class QgsAbstractGeometry;
+
+/**
+ * \ingroup core
+ * \class QgsWkbGeometryView
+ * \brief A read-only view of a geometry stored as a WKB buffer.
+ *
+ * The view validates the WKB and calculates the geometry's type, vertex count and
+ * bounding box in a single pass over the buffer, without creating a QgsAbstractGeometry.
+ * This allows consumers which only need this information (or the raw WKB itself, e.g.
+ * for exporting features) to avoid the cost of building the full geometry tree.
+ * A QgsAbstractGeometry can be created from the view on demand by calling toGeometry().
+ *
+ * The WKB buffer is implicitly shared with the QByteArray passed to the constructor.
+ *
+ * Only linear geometry types (points, linestrings, polygons, their multi-part types
+ * and geometry collections of these) are supported. Views created for any other WKB
+ * (including curved geometries or malformed buffers) are invalid.
+ *
+ * \note not available in Python bindings
+ * \since QGIS 3.10
+ */
+class CORE_EXPORT QgsWkbGeometryView
+{
+  public:
+
+    /**
+     * Constructor for an invalid QgsWkbGeometryView.
+     */
+    QgsWkbGeometryView() = default;
+
+    /**
+     * Constructor for a QgsWkbGeometryView of the specified \a wkb buffer.
+     *
+     * The buffer is scanned immediately, and isValid() can be used to determine whether
+     * the WKB was valid and of a supported geometry type.
+     */
+    explicit QgsWkbGeometryView( const QByteArray &wkb );
+
+    /**
+     * Returns TRUE if the view's WKB is valid and of a supported geometry type.
+     */
+    bool isValid() const { return mValid; }
+
+    /**
+     * Returns the WKB for the geometry, excluding any trailing bytes present in the
+     * original buffer.
+     */
+    QByteArray wkb() const;
+
+    /**
+     * Returns the size of the geometry's WKB in bytes.
+     */
+    int wkbSize() const { return mSize; }
+
+    /**
+     * Returns the WKB type of the geometry.
+     */
+    QgsWkbTypes::Type wkbType() const { return mWkbType; }
+
+    /**
+     * Returns TRUE if all parts of the WKB are stored in the native byte order of the
+     * current platform, i.e. if the WKB is identical to the WKB which would be
+     * created by QgsAbstractGeometry::asWkb() for the geometry.
+     */
+    bool isNativeEndian() const { return mNativeEndian; }
+
+    /**
+     * Returns the total number of vertices in the geometry.
+     */
+    int vertexCount() const { return mVertexCount; }
+
+    /**
+     * Returns the bounding box of the geometry. The returned rectangle is identical
+     * to the one which QgsAbstractGeometry::boundingBox() would return for the
+     * geometry.
+     */
+    QgsRectangle boundingBox() const { return mBoundingBox; }
+
+    /**
+     * Calls \a visitor for the x and y coordinates of every vertex in the geometry, in
+     * the order they are stored in the WKB.
+     */
+    void visitVertices( const std::function< void( double x, double y ) > &visitor ) const;
+
+    /**
+     * Creates a new QgsAbstractGeometry for the view's WKB.
+     *
+     * Returns nullptr if the view is not valid.
+     */
+    std::unique_ptr< QgsAbstractGeometry > toGeometry() const;
+
+  private:
+
+    QByteArray mWkb;
+    bool mValid = false;
+    bool mNativeEndian = true;
+    int mSize = 0;
+    int mVertexCount = 0;
+    QgsWkbTypes::Type mWkbType = QgsWkbTypes::Unknown;
+    QgsRectangle mBoundingBox;
+
+};
+
+#endif // QGSWKBGEOMETRYVIEW_H
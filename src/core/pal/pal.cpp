@@ -99,9 +99,11 @@ typedef struct _featCbackCtx
   RTree<LabelPosition *, double, 2, double> *candidates;
   QList<LabelPosition *> *positionsWithNoCandidates;
   const GEOSPreparedGeometry *mapBoundary = nullptr;
+  const Pal::CandidateSeedFunction *candidateSeedFunction = nullptr;
 } FeatCallBackCtx;
 
-
+//! Minimum number of labeled features for which the problem is solved as independent parts
+static const int PARTITIONED_SOLVE_MIN_FEATURES = 1000;
 
 /*
  * Callback function
@@ -125,8 +127,23 @@ bool extractFeatCallback( FeaturePart *ft_ptr, void *ctx )
     }
   }
 
+  QList< LabelPosition * > lPos;
+
+  // parts with a seeded position get it as their preferred candidate, in addition to the usual candidates, so that
+  // another position can still be picked if the seeded one conflicts with other labels
+  if ( context->candidateSeedFunction && *context->candidateSeedFunction )
+  {
+    if ( LabelPosition *seed = ( *context->candidateSeedFunction )( ft_ptr ) )
+    {
+      // seeds have a lower cost than any generated candidate, so they sort first
+      seed->setCost( 0.0 );
+      seed->insertIntoIndex( context->candidates );
+      lPos << seed;
+    }
+  }
+
   // generate candidates for the feature part
-  const QList< LabelPosition * > lPos = ft_ptr->createCandidates( context->mapBoundary, ft_ptr, context->candidates );
+  lPos.append( ft_ptr->createCandidates( context->mapBoundary, ft_ptr, context->candidates ) );
   if ( !lPos.empty() )
   {
     // valid features are added to fFeats
@@ -235,6 +252,7 @@ std::unique_ptr<Problem> Pal::extract( const QgsRectangle &extent, const QgsGeom
   context.candidates = prob->candidates;
   context.positionsWithNoCandidates = prob->positionsWithNoCandidates();
   context.mapBoundary = mapBoundaryPrepared.get();
+  context.candidateSeedFunction = &mCandidateSeedFunction;
 
   ObstacleCallBackCtx obstacleContext;
   obstacleContext.obstacles = &obstacles;
@@ -417,6 +435,11 @@ void Pal::registerCancellationCallback( Pal::FnIsCanceled fnCanceled, void *cont
   fnIsCanceledContext = context;
 }
 
+void Pal::setCandidateSeedFunction( const Pal::CandidateSeedFunction &function )
+{
+  mCandidateSeedFunction = function;
+}
+
 std::unique_ptr<Problem> Pal::extractProblem( const QgsRectangle &extent, const QgsGeometry &mapBoundary )
 {
   return extract( extent, mapBoundary );
@@ -431,7 +454,11 @@ QList<LabelPosition *> Pal::solveProblem( Problem *prob, bool displayAll, QList<
 
   try
   {
-    prob->chain_search();
+    // large problems are split into independent parts, which are solved separately
+    if ( prob->nbft >= PARTITIONED_SOLVE_MIN_FEATURES )
+      prob->chainSearchPartitioned();
+    else
+      prob->chain_search();
   }
   catch ( InternalException::Empty & )
   {
@@ -42,6 +42,7 @@
 #include <ctime>
 #include <QMutex>
 #include <QStringList>
+#include <functional>
 
 // TODO ${MAJOR} ${MINOR} etc instead of 0.2
 
@@ -49,6 +50,7 @@ class QgsAbstractLabelProvider;
 
 namespace pal
 {
+  class FeaturePart;
   class Layer;
   class LabelPosition;
   class PalStat;
@@ -134,6 +136,22 @@ namespace pal
       //! Check whether the job has been canceled
       inline bool isCanceled() { return fnIsCanceled ? fnIsCanceled( fnIsCanceledContext ) : false; }
 
+      /**
+       * Function which returns a preferred label position for a feature part, or nullptr if
+       * the part has none. Ownership of the returned position is transferred to PAL.
+       */
+      typedef std::function< LabelPosition *( FeaturePart *part ) > CandidateSeedFunction;
+
+      /**
+       * Sets a \a function which is used to seed feature parts with a preferred label position, e.g. from
+       * a previous labeling solution. The returned position is added to the part's candidates with the
+       * lowest possible cost, so it is used unless it conflicts with other labels. The function is called
+       * from the thread calling extractProblem().
+       *
+       * \since QGIS 3.10
+       */
+      void setCandidateSeedFunction( const CandidateSeedFunction &function );
+
       /**
        * Extracts the labeling problem for the specified map \a extent - only features within this
        * extent will be considered. The \a mapBoundary argument specifies the actual geometry of the map
@@ -251,6 +269,9 @@ namespace pal
       //! Application-specific context for the cancellation check function
       void *fnIsCanceledContext = nullptr;
 
+      //! Optional function for seeding feature parts with a fixed candidate
+      CandidateSeedFunction mCandidateSeedFunction;
+
       /**
        * Creates a Problem, by extracting labels and generating candidates from the given \a extent.
        * The \a mapBoundary geometry specifies the actual visible region of the map, and is used
@@ -40,6 +40,7 @@
 #include "internalexception.h"
 #include <cfloat>
 #include <limits> //for std::numeric_limits<int>::max()
+#include <numeric>
 
 #include "qgslabelingengine.h"
 
@@ -816,6 +817,182 @@ void Problem::chain_search()
   delete[] ok;
 }
 
+//! Minimum number of features solved together in a partitioned chain search
+static const int SUB_PROBLEM_MIN_FEATURES = 256;
+
+typedef struct
+{
+  LabelPosition *lp = nullptr;
+  std::vector< int > *parents = nullptr;
+} ComponentContext;
+
+static int findComponentRoot( std::vector< int > &parents, int feature )
+{
+  while ( parents[feature] != feature )
+  {
+    parents[feature] = parents[parents[feature]];
+    feature = parents[feature];
+  }
+  return feature;
+}
+
+bool componentCallback( LabelPosition *lp, void *context )
+{
+  ComponentContext *ctx = reinterpret_cast< ComponentContext * >( context );
+
+  if ( ctx->lp->isInConflict( lp ) )
+  {
+    const int root1 = findComponentRoot( *ctx->parents, ctx->lp->getProblemFeatureId() );
+    const int root2 = findComponentRoot( *ctx->parents, lp->getProblemFeatureId() );
+    // the lowest feature index is always the root, so that components are deterministic
+    if ( root1 < root2 )
+      ( *ctx->parents )[root2] = root1;
+    else if ( root2 < root1 )
+      ( *ctx->parents )[root1] = root2;
+  }
+  return true;
+}
+
+QVector< QVector< int > > Problem::conflictComponents()
+{
+  std::vector< int > parents( nbft );
+  std::iota( parents.begin(), parents.end(), 0 );
+
+  ComponentContext context;
+  context.parents = &parents;
+
+  double amin[2];
+  double amax[2];
+  for ( int i = 0; i < nbft; i++ )
+  {
+    for ( int j = 0; j < featNbLp[i]; j++ )
+    {
+      LabelPosition *lp = mLabelPositions.at( featStartId[i] + j );
+      // overlap counts are kept up to date by reduce(), so candidates without overlaps can be skipped
+      if ( lp->getNumOverlaps() == 0 )
+        continue;
+
+      lp->getBoundingBox( amin, amax );
+      context.lp = lp;
+      candidates->Search( amin, amax, componentCallback, reinterpret_cast< void * >( &context ) );
+    }
+  }
+
+  QVector< QVector< int > > components;
+  std::vector< int > componentIndex( nbft, -1 );
+  for ( int i = 0; i < nbft; i++ )
+  {
+    const int root = findComponentRoot( parents, i );
+    if ( componentIndex[root] < 0 )
+    {
+      componentIndex[root] = components.size();
+      components.append( QVector< int >() );
+    }
+    components[ componentIndex[root] ].append( i );
+  }
+  return components;
+}
+
+void Problem::solveSubProblem( const QVector< int > &features )
+{
+  // the sub problem shares the candidates of this problem, renumbered to be contiguous
+  Problem subProblem;
+  subProblem.pal = pal;
+  subProblem.displayAll = displayAll;
+  subProblem.nbft = features.size();
+  subProblem.featStartId = new int[subProblem.nbft];
+  subProblem.featNbLp = new int[subProblem.nbft];
+  subProblem.inactiveCost = new double[subProblem.nbft];
+
+  for ( int i = 0; i < subProblem.nbft; i++ )
+  {
+    const int feature = features.at( i );
+    subProblem.featStartId[i] = subProblem.nblp;
+    subProblem.featNbLp[i] = featNbLp[feature];
+    subProblem.inactiveCost[i] = inactiveCost[feature];
+
+    for ( int j = 0; j < featNbLp[feature]; j++ )
+    {
+      LabelPosition *lp = mLabelPositions.at( featStartId[feature] + j );
+      lp->setProblemIds( i, subProblem.nblp++ );
+      lp->insertIntoIndex( subProblem.candidates );
+      subProblem.mLabelPositions.append( lp );
+    }
+  }
+  subProblem.all_nblp = subProblem.nblp;
+
+  try
+  {
+    subProblem.chain_search();
+  }
+  catch ( InternalException::Empty & )
+  {
+  }
+
+  for ( int i = 0; i < subProblem.nbft; i++ )
+  {
+    const int feature = features.at( i );
+    if ( subProblem.sol && subProblem.sol->s[i] >= 0 )
+      sol->s[feature] = featStartId[feature] + subProblem.sol->s[i] - subProblem.featStartId[i];
+
+    // restore the original numbering
+    for ( int j = 0; j < featNbLp[feature]; j++ )
+      mLabelPositions.at( featStartId[feature] + j )->setProblemIds( feature, featStartId[feature] + j );
+  }
+
+  // candidates are owned by this problem
+  subProblem.mLabelPositions.clear();
+}
+
+void Problem::chainSearchPartitioned()
+{
+  if ( nbft == 0 )
+    return;
+
+  // batch small components together, to avoid the overhead of many tiny sub problems
+  QVector< QVector< int > > subProblems;
+  const QVector< QVector< int > > components = conflictComponents();
+  for ( const QVector< int > &component : components )
+  {
+    if ( subProblems.isEmpty() || subProblems.constLast().size() >= SUB_PROBLEM_MIN_FEATURES )
+      subProblems.append( component );
+    else
+      subProblems.last() += component;
+  }
+
+  if ( subProblems.size() == 1 )
+  {
+    chain_search();
+    return;
+  }
+
+  init_sol_empty();
+
+  // sub problems are solved one after the other: conflict checks use the shared GEOS context
+  // and the lazily built GEOS geometries of the candidates, neither of which is thread safe
+  for ( const QVector< int > &features : qgis::as_const( subProblems ) )
+  {
+    if ( pal->isCanceled() )
+      break;
+
+    solveSubProblem( features );
+  }
+
+  double amin[2];
+  double amax[2];
+  for ( int i = 0; i < nbft; i++ )
+  {
+    if ( sol->s[i] >= 0 )
+    {
+      LabelPosition *lp = mLabelPositions.at( sol->s[i] );
+      lp->getBoundingBox( amin, amax );
+      candidates_sol->Insert( amin, amax, lp );
+    }
+  }
+
+  solution_cost();
+}
+
 bool Problem::compareLabelArea( pal::LabelPosition *l1, pal::LabelPosition *l2 )
 {
   return l1->getWidth() * l1->getHeight() > l2->getWidth() * l2->getHeight();
@@ -36,6 +36,7 @@
 #include "qgis_core.h"
 #include <list>
 #include <QList>
+#include <QVector>
 #include "rtree.hpp"
 
 namespace pal
@@ -111,6 +112,19 @@ namespace pal
        */
       void chain_search();
 
+      /**
+       * Runs chain_search() on independent sub-problems.
+       *
+       * Features are grouped into the connected components of the candidate conflict graph. Since
+       * the candidates of features in different components never conflict, each component can be
+       * solved in isolation, which keeps the search neighborhoods and indexes small. Small components are batched together into a single sub-problem, and
+       * the sub-problem solutions are merged back into this problem in feature order, so the
+       * result is deterministic.
+       *
+       * \since QGIS 3.10
+       */
+      void chainSearchPartitioned();
+
       /**
        * Solves the labeling problem, selecting the best candidate locations for all labels and returns a list of these
        * calculated label positions.
@@ -204,6 +218,18 @@ namespace pal
 
       Chain *chain( int seed );
 
+      /**
+       * Returns the connected components of the candidate conflict graph, as lists of
+       * feature indices. Components are ordered by their first feature.
+       */
+      QVector< QVector< int > > conflictComponents();
+
+      /**
+       * Solves the sub-problem consisting of the specified \a features, storing the
+       * chosen candidates in this problem's solution.
+       */
+      void solveSubProblem( const QVector< int > &features );
+
       Pal *pal = nullptr;
 
       void solution_cost();
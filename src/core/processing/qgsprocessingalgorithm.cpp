@@ -29,6 +29,7 @@
 #include "qgsprocessingfeedback.h"
 #include "qgsmeshlayer.h"
 #include "qgsexpressioncontextutils.h"
+#include "qgsallocationpool.h"
 
 
 QgsProcessingAlgorithm::~QgsProcessingAlgorithm()
@@ -918,6 +919,8 @@ QVariantMap QgsProcessingFeatureBasedAlgorithm::processAlgorithm( const QVariant
 
   double step = count > 0 ? 100.0 / count : 1;
   int current = 0;
+  // the geometries and features created while processing each feature are short lived, so recycle them
+  QgsAllocationPoolScope poolScope;
   while ( it.nextFeature( f ) )
   {
     if ( feedback->isCanceled() )
@@ -50,6 +50,29 @@ QgsMemoryFeatureIterator::QgsMemoryFeatureIterator( QgsMemoryFeatureSource *sour
     mSubsetExpression->prepare( &mSource->mExpressionContext );
   }
 
+  // only read the requested attributes, plus any required for filtering and ordering
+  mFetchAllAttributes = !( mRequest.flags() & QgsFeatureRequest::SubsetOfAttributes );
+  if ( !mFetchAllAttributes )
+  {
+    QSet< int > attributeIndexes = mRequest.subsetOfAttributes().toSet();
+    auto addReferencedAttributes = [this, &attributeIndexes]( const QgsExpression & expression )
+    {
+      if ( expression.referencedColumns().contains( QgsFeatureRequest::ALL_ATTRIBUTES ) )
+        mFetchAllAttributes = true;
+      else
+        attributeIndexes += expression.referencedAttributeIndexes( mSource->mFields );
+    };
+
+    if ( mRequest.filterType() == QgsFeatureRequest::FilterExpression )
+      addReferencedAttributes( *mRequest.filterExpression() );
+    if ( mSubsetExpression )
+      addReferencedAttributes( *mSubsetExpression );
+    if ( !mRequest.orderBy().isEmpty() )
+      attributeIndexes += mRequest.orderBy().usedAttributeIndices( mSource->mFields );
+
+    mAttributeIndexes = attributeIndexes.toList();
+  }
+
   if ( !mFilterRect.isNull() && mRequest.flags() & QgsFeatureRequest::ExactIntersect )
   {
     mSelectRectGeom = QgsGeometry::fromRect( mFilterRect );
@@ -68,8 +91,7 @@ QgsMemoryFeatureIterator::QgsMemoryFeatureIterator( QgsMemoryFeatureSource *sour
   else if ( mRequest.filterType() == QgsFeatureRequest::FilterFid )
   {
     mUsingFeatureIdList = true;
-    QgsFeatureMap::const_iterator it = mSource->mFeatures.constFind( mRequest.filterFid() );
-    if ( it != mSource->mFeatures.constEnd() )
+    if ( mSource->mFeatures.rowForId( mRequest.filterFid() ) >= 0 )
       mFeatureIdList.append( mRequest.filterFid() );
   }
   else if ( mRequest.filterType() == QgsFeatureRequest::FilterFids )
@@ -106,122 +128,66 @@ bool QgsMemoryFeatureIterator::fetchFeature( QgsFeature &feature )
 
 bool QgsMemoryFeatureIterator::nextFeatureUsingList( QgsFeature &feature )
 {
-  bool hasFeature = false;
-
   // option 1: we have a list of features to traverse
-  QgsFeature candidate;
   while ( mFeatureIdListIterator != mFeatureIdList.constEnd() )
   {
-    candidate = mSource->mFeatures.value( *mFeatureIdListIterator );
-    if ( !mFilterRect.isNull() )
-    {
-      if ( mRequest.flags() & QgsFeatureRequest::ExactIntersect )
-      {
-        // do exact check in case we're doing intersection
-        if ( candidate.hasGeometry() && mSelectRectEngine->intersects( candidate.geometry().constGet() ) )
-          hasFeature = true;
-      }
-      else if ( mSource->mSpatialIndex )
-      {
-        // using a spatial index - so we already know that the bounding box intersects correctly
-        hasFeature = true;
-      }
-      else
-      {
-        // do bounding box check if we aren't using a spatial index
-        if ( candidate.hasGeometry() && candidate.geometry().boundingBoxIntersects( mFilterRect ) )
-          hasFeature = true;
-      }
-    }
-    else
-      hasFeature = true;
-
-    if ( hasFeature && mSubsetExpression )
-    {
-      mSource->mExpressionContext.setFeature( candidate );
-      if ( !mSubsetExpression->evaluate( &mSource->mExpressionContext ).toBool() )
-        hasFeature = false;
-    }
-
-    if ( hasFeature )
-      break;
-
+    const int row = mSource->mFeatures.rowForId( *mFeatureIdListIterator );
     ++mFeatureIdListIterator;
-  }
-
-  // copy feature
-  if ( hasFeature )
-  {
-    feature = candidate;
-    ++mFeatureIdListIterator;
-  }
-  else
-    close();
 
-  if ( hasFeature )
-  {
-    feature.setFields( mSource->mFields ); // allow name-based attribute lookups
-    geometryToDestinationCrs( feature, mTransform );
+    if ( row >= 0 && readRowIfMatching( row, feature ) )
+      return true;
   }
 
-  return hasFeature;
+  close();
+  return false;
 }
 
 
 bool QgsMemoryFeatureIterator::nextFeatureTraverseAll( QgsFeature &feature )
 {
-  bool hasFeature = false;
-
   // option 2: traversing the whole layer
-  while ( mSelectIterator != mSource->mFeatures.constEnd() )
+  const QgsMemoryFeatureStore &features = mSource->mFeatures;
+  const int rowCount = features.rowCount();
+  while ( mSelectRow < rowCount )
   {
-    if ( mFilterRect.isNull() )
-    {
-      // selection rect empty => using all features
-      hasFeature = true;
-    }
-    else
-    {
-      if ( mRequest.flags() & QgsFeatureRequest::ExactIntersect )
-      {
-        // using exact test when checking for intersection
-        if ( mSelectIterator->hasGeometry() && mSelectRectEngine->intersects( mSelectIterator->geometry().constGet() ) )
-          hasFeature = true;
-      }
-      else
-      {
-        // check just bounding box against rect when not using intersection
-        if ( mSelectIterator->hasGeometry() && mSelectIterator->geometry().boundingBox().intersects( mFilterRect ) )
-          hasFeature = true;
-      }
-    }
+    const int row = mSelectRow++;
+    if ( !features.isDeleted( row ) && readRowIfMatching( row, feature ) )
+      return true;
+  }
 
-    if ( mSubsetExpression )
-    {
-      mSource->mExpressionContext.setFeature( *mSelectIterator );
-      if ( !mSubsetExpression->evaluate( &mSource->mExpressionContext ).toBool() )
-        hasFeature = false;
-    }
+  close();
+  return false;
+}
 
-    if ( hasFeature )
-      break;
+bool QgsMemoryFeatureIterator::readRowIfMatching( int row, QgsFeature &feature )
+{
+  const QgsMemoryFeatureStore &features = mSource->mFeatures;
+  if ( !mFilterRect.isNull() )
+  {
+    // null geometries have a minimal bounding box, which never intersects the filter rect
+    if ( !features.boundingBox( row ).intersects( mFilterRect ) )
+      return false;
 
-    ++mSelectIterator;
+    // do exact check in case we're doing intersection
+    if ( mRequest.flags() & QgsFeatureRequest::ExactIntersect && !mSelectRectEngine->intersects( features.geometry( row ).constGet() ) )
+      return false;
   }
 
-  // copy feature
-  if ( hasFeature )
+  features.readFeature( row, feature, mFetchAllAttributes ? nullptr : &mAttributeIndexes );
+
+  if ( mSubsetExpression )
   {
-    feature = mSelectIterator.value();
-    ++mSelectIterator;
-    feature.setValid( true );
-    feature.setFields( mSource->mFields ); // allow name-based attribute lookups
-    geometryToDestinationCrs( feature, mTransform );
+    mSource->mExpressionContext.setFeature( feature );
+    if ( !mSubsetExpression->evaluate( &mSource->mExpressionContext ).toBool() )
+    {
+      feature.setValid( false );
+      return false;
+    }
   }
-  else
-    close();
 
-  return hasFeature;
+  feature.setFields( mSource->mFields ); // allow name-based attribute lookups
+  geometryToDestinationCrs( feature, mTransform );
+  return true;
 }
 
 bool QgsMemoryFeatureIterator::rewind()
@@ -232,7 +198,7 @@ bool QgsMemoryFeatureIterator::rewind()
   if ( mUsingFeatureIdList )
     mFeatureIdListIterator = mFeatureIdList.constBegin();
   else
-    mSelectIterator = mSource->mFeatures.constBegin();
+    mSelectRow = 0;
 
   return true;
 }
@@ -21,13 +21,12 @@
 #include "qgsexpressioncontext.h"
 #include "qgsfields.h"
 #include "qgsgeometry.h"
+#include "qgsmemoryfeaturestore.h"
 
 ///@cond PRIVATE
 
 class QgsMemoryProvider;
 
-typedef QMap<QgsFeatureId, QgsFeature> QgsFeatureMap;
-
 class QgsSpatialIndex;
 
 
@@ -40,7 +39,7 @@ class QgsMemoryFeatureSource : public QgsAbstractFeatureSource
 
   private:
     QgsFields mFields;
-    QgsFeatureMap mFeatures;
+    QgsMemoryFeatureStore mFeatures;
     std::unique_ptr< QgsSpatialIndex > mSpatialIndex;
     QString mSubsetString;
     QgsExpressionContext mExpressionContext;
@@ -68,14 +67,19 @@ class QgsMemoryFeatureIterator : public QgsAbstractFeatureIteratorFromSource<Qgs
     bool nextFeatureUsingList( QgsFeature &feature );
     bool nextFeatureTraverseAll( QgsFeature &feature );
 
+    //! Reads the feature at \a row into \a feature, if it matches the request's filter rectangle and the subset string
+    bool readRowIfMatching( int row, QgsFeature &feature );
+
     QgsGeometry mSelectRectGeom;
     std::unique_ptr< QgsGeometryEngine > mSelectRectEngine;
     QgsRectangle mFilterRect;
-    QgsFeatureMap::const_iterator mSelectIterator;
+    int mSelectRow = 0;
     bool mUsingFeatureIdList = false;
     QList<QgsFeatureId> mFeatureIdList;
     QList<QgsFeatureId>::const_iterator mFeatureIdListIterator;
     std::unique_ptr< QgsExpression > mSubsetExpression;
+    bool mFetchAllAttributes = true;
+    QgsAttributeList mAttributeIndexes;
     QgsCoordinateTransform mTransform;
 
 };
@@ -0,0 +1,210 @@
+/***************************************************************************
+    qgsmemoryfeaturestore.cpp
+    ---------------------
+    begin                : October 2026
+    copyright            : (C) 2026 by agent
+    email                : agent at local
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qgsmemoryfeaturestore.h"
+
+#include <algorithm>
+
+///@cond PRIVATE
+
+//! Minimum number of deleted rows before the store is compacted
+static const int MIN_DELETED_ROWS_FOR_COMPACTION = 64;
+
+int QgsMemoryFeatureStore::rowForId( QgsFeatureId id ) const
+{
+  const QgsFeatureId offset = id - mFirstId;
+  if ( offset < 0 || offset >= mRowForId.size() )
+    return -1;
+
+  return mRowForId.at( static_cast< int >( offset ) );
+}
+
+void QgsMemoryFeatureStore::readFeature( int row, QgsFeature &feature, const QgsAttributeList *attributeIndexes ) const
+{
+  feature.setId( mIds.at( row ) );
+  feature.setGeometry( mGeometries.at( row ) );
+
+  const int fieldCount = mColumns.size();
+  QgsAttributes attributes( fieldCount );
+  if ( !attributeIndexes )
+  {
+    for ( int field = 0; field < fieldCount; ++field )
+      attributes[field] = mColumns.at( field ).at( row );
+  }
+  else
+  {
+    for ( int field : *attributeIndexes )
+    {
+      if ( field >= 0 && field < fieldCount )
+        attributes[field] = mColumns.at( field ).at( row );
+    }
+  }
+  feature.setAttributes( attributes );
+  feature.setValid( true );
+}
+
+QgsRectangle QgsMemoryFeatureStore::extent() const
+{
+  QgsRectangle extent;
+  extent.setMinimal();
+  const int rows = mIds.size();
+  for ( int row = 0; row < rows; ++row )
+  {
+    if ( !isDeleted( row ) )
+      extent.combineExtentWith( mBoundingBoxes.at( row ) );
+  }
+  return extent;
+}
+
+bool QgsMemoryFeatureStore::addFeature( const QgsFeature &feature )
+{
+  const QgsFeatureId id = feature.id();
+  if ( mRowForId.isEmpty() )
+    mFirstId = id;
+  else if ( id - mFirstId < mRowForId.size() )
+    return false;
+
+  const int row = mIds.size();
+  const int oldSize = mRowForId.size();
+  mRowForId.resize( static_cast< int >( id - mFirstId + 1 ) );
+  std::fill( mRowForId.begin() + oldSize, mRowForId.end() - 1, -1 );
+  mRowForId.last() = row;
+
+  mIds.append( id );
+  const QgsGeometry geometry = feature.geometry();
+  mGeometries.append( geometry );
+  if ( geometry.isNull() )
+  {
+    QgsRectangle bounds;
+    bounds.setMinimal();
+    mBoundingBoxes.append( bounds );
+  }
+  else
+  {
+    mBoundingBoxes.append( geometry.boundingBox() );
+  }
+
+  const QgsAttributes attributes = feature.attributes();
+  for ( int field = 0; field < mColumns.size(); ++field )
+    mColumns[field].append( attributes.value( field ) );
+
+  return true;
+}
+
+bool QgsMemoryFeatureStore::deleteFeature( QgsFeatureId id )
+{
+  const int row = rowForId( id );
+  if ( row < 0 )
+    return false;
+
+  mIds[row] = FID_NULL;
+  mRowForId[ static_cast< int >( id - mFirstId )] = -1;
+  mDeletedCount++;
+
+  compactIfRequired();
+  return true;
+}
+
+bool QgsMemoryFeatureStore::setAttribute( int row, int field, const QVariant &value )
+{
+  if ( field < 0 || field >= mColumns.size() )
+    return false;
+
+  mColumns[field][row] = value;
+  return true;
+}
+
+void QgsMemoryFeatureStore::setGeometry( int row, const QgsGeometry &geometry )
+{
+  mGeometries[row] = geometry;
+  if ( geometry.isNull() )
+    mBoundingBoxes[row].setMinimal();
+  else
+    mBoundingBoxes[row] = geometry.boundingBox();
+}
+
+void QgsMemoryFeatureStore::addAttribute()
+{
+  mColumns.append( QVector< QVariant >( mIds.size() ) );
+}
+
+void QgsMemoryFeatureStore::deleteAttribute( int field )
+{
+  if ( field >= 0 && field < mColumns.size() )
+    mColumns.remove( field );
+}
+
+void QgsMemoryFeatureStore::clear()
+{
+  mIds.clear();
+  mGeometries.clear();
+  mBoundingBoxes.clear();
+  for ( QVector< QVariant > &column : mColumns )
+    column.clear();
+  mRowForId.clear();
+  mFirstId = 0;
+  mDeletedCount = 0;
+}
+
+void QgsMemoryFeatureStore::compactIfRequired()
+{
+  if ( mDeletedCount < MIN_DELETED_ROWS_FOR_COMPACTION || mDeletedCount * 2 < mIds.size() )
+    return;
+
+  if ( mDeletedCount == mIds.size() )
+  {
+    clear();
+    return;
+  }
+
+  QVector< QgsFeatureId > ids;
+  QVector< QgsGeometry > geometries;
+  QVector< QgsRectangle > boundingBoxes;
+  QVector< QVector< QVariant > > columns( mColumns.size() );
+  const int liveRows = mIds.size() - mDeletedCount;
+  ids.reserve( liveRows );
+  geometries.reserve( liveRows );
+  boundingBoxes.reserve( liveRows );
+  for ( QVector< QVariant > &column : columns )
+    column.reserve( liveRows );
+
+  for ( int row = 0; row < mIds.size(); ++row )
+  {
+    if ( isDeleted( row ) )
+      continue;
+
+    ids.append( mIds.at( row ) );
+    geometries.append( mGeometries.at( row ) );
+    boundingBoxes.append( mBoundingBoxes.at( row ) );
+    for ( int field = 0; field < mColumns.size(); ++field )
+      columns[field].append( mColumns.at( field ).at( row ) );
+  }
+
+  // features are stored in ID order, so the lookup table can start at the first remaining feature
+  const QgsFeatureId firstId = ids.first();
+  QVector< int > rowForId( static_cast< int >( ids.last() - firstId + 1 ), -1 );
+  for ( int row = 0; row < ids.size(); ++row )
+    rowForId[ static_cast< int >( ids.at( row ) - firstId )] = row;
+
+  mIds = ids;
+  mGeometries = geometries;
+  mBoundingBoxes = boundingBoxes;
+  mColumns = columns;
+  mRowForId = rowForId;
+  mFirstId = firstId;
+  mDeletedCount = 0;
+}
+
+///@endcond
@@ -0,0 +1,155 @@
+/***************************************************************************
+    qgsmemoryfeaturestore.h
+    ---------------------
+    begin                : October 2026
+    copyright            : (C) 2026 by agent
+    email                : agent at local
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef QGSMEMORYFEATURESTORE_H
+#define QGSMEMORYFEATURESTORE_H
+
+#define SIP_NO_FILE
+
+#include "qgsfeature.h"
+#include "qgsgeometry.h"
+#include "qgsrectangle.h"
+
+#include <QVector>
+
+///@cond PRIVATE
+
+/**
+ * Column oriented storage for the features of a memory provider.
+ *
+ * Features are stored as rows, in the order in which they were added. Feature IDs,
+ * geometries, geometry bounding boxes and the values of each attribute are each held in
+ * their own contiguous vector, and feature IDs are mapped to rows through a dense
+ * lookup table. Deleted rows are left as tombstones until enough of them accumulate,
+ * at which point the store is compacted.
+ *
+ * All vectors are implicitly shared, so copying a store is cheap and gives an
+ * independent snapshot of its contents. Only the vectors which are subsequently modified
+ * are detached from the snapshot.
+ *
+ * Feature IDs must be added in increasing order.
+ */
+class QgsMemoryFeatureStore
+{
+  public:
+
+    /**
+     * Returns the number of (non-deleted) features in the store.
+     */
+    long featureCount() const { return mIds.size() - mDeletedCount; }
+
+    /**
+     * Returns the number of rows in the store, including deleted rows.
+     */
+    int rowCount() const { return mIds.size(); }
+
+    /**
+     * Returns the row containing the feature with matching \a id, or -1 if no
+     * such feature exists.
+     */
+    int rowForId( QgsFeatureId id ) const;
+
+    /**
+     * Returns TRUE if the specified \a row has been deleted.
+     */
+    bool isDeleted( int row ) const { return FID_IS_NULL( mIds.at( row ) ); }
+
+    /**
+     * Returns the ID of the feature at the specified \a row.
+     */
+    QgsFeatureId id( int row ) const { return mIds.at( row ); }
+
+    /**
+     * Returns the geometry of the feature at the specified \a row.
+     */
+    const QgsGeometry &geometry( int row ) const { return mGeometries.at( row ); }
+
+    /**
+     * Returns the bounding box of the geometry at the specified \a row. The bounding box
+     * of a null geometry is a minimal rectangle, which does not intersect any other rectangle.
+     */
+    const QgsRectangle &boundingBox( int row ) const { return mBoundingBoxes.at( row ); }
+
+    /**
+     * Reads the feature at the specified \a row into \a feature.
+     *
+     * If \a attributeIndexes is specified, only the listed attributes are read and all
+     * other attributes are left as invalid variants.
+     */
+    void readFeature( int row, QgsFeature &feature, const QgsAttributeList *attributeIndexes = nullptr ) const;
+
+    /**
+     * Returns the combined bounding box of all geometries in the store.
+     */
+    QgsRectangle extent() const;
+
+    /**
+     * Appends a \a feature to the store. Attributes beyond the current field count
+     * are discarded, and missing attributes are stored as invalid variants.
+     *
+     * The feature's ID must be greater than the IDs of all previously added features.
+     */
+    bool addFeature( const QgsFeature &feature );
+
+    /**
+     * Deletes the feature with matching \a id. Returns FALSE if no such feature exists.
+     */
+    bool deleteFeature( QgsFeatureId id );
+
+    /**
+     * Sets the \a value of the attribute at index \a field for the feature at the specified \a row.
+     */
+    bool setAttribute( int row, int field, const QVariant &value );
+
+    /**
+     * Sets the \a geometry of the feature at the specified \a row.
+     */
+    void setGeometry( int row, const QgsGeometry &geometry );
+
+    /**
+     * Appends a new attribute column, with all values set to invalid variants.
+     */
+    void addAttribute();
+
+    /**
+     * Removes the attribute column at index \a field.
+     */
+    void deleteAttribute( int field );
+
+    /**
+     * Removes all features from the store, keeping its attribute columns.
+     */
+    void clear();
+
+  private:
+
+    //! Removes deleted rows, if they make up a large enough proportion of the store
+    void compactIfRequired();
+
+    QVector< QgsFeatureId > mIds;
+    QVector< QgsGeometry > mGeometries;
+    QVector< QgsRectangle > mBoundingBoxes;
+    QVector< QVector< QVariant > > mColumns;
+
+    //! Row for each feature ID, offset by mFirstId. Deleted features map to -1.
+    QVector< int > mRowForId;
+    QgsFeatureId mFirstId = 0;
+
+    int mDeletedCount = 0;
+};
+
+///@endcond
+
+#endif // QGSMEMORYFEATURESTORE_H
@@ -290,18 +290,13 @@ QgsFeatureIterator QgsMemoryProvider::getFeatures( const QgsFeatureRequest &requ
 
 QgsRectangle QgsMemoryProvider::extent() const
 {
-  if ( mExtent.isEmpty() && !mFeatures.isEmpty() )
+  if ( mExtent.isEmpty() && mFeatures.featureCount() > 0 )
   {
     mExtent.setMinimal();
     if ( mSubsetString.isEmpty() )
     {
-      // fast way - iterate through all features
-      const auto constMFeatures = mFeatures;
-      for ( const QgsFeature &feat : constMFeatures )
-      {
-        if ( feat.hasGeometry() )
-          mExtent.combineExtentWith( feat.geometry().boundingBox() );
-      }
+      // fast way - combine the stored bounding boxes of all features
+      mExtent = mFeatures.extent();
     }
     else
     {
@@ -314,7 +309,7 @@ QgsRectangle QgsMemoryProvider::extent() const
       }
     }
   }
-  else if ( mFeatures.isEmpty() )
+  else if ( mFeatures.featureCount() == 0 )
   {
     mExtent.setMinimal();
   }
@@ -330,7 +325,7 @@ QgsWkbTypes::Type QgsMemoryProvider::wkbType() const
 long QgsMemoryProvider::featureCount() const
 {
   if ( mSubsetString.isEmpty() )
-    return mFeatures.count();
+    return mFeatures.featureCount();
 
   // subset string set, no alternative but testing each feature
   QgsFeatureIterator fit = QgsFeatureIterator( new QgsMemoryFeatureIterator( new QgsMemoryFeatureSource( this ), true,  QgsFeatureRequest().setNoAttributes() ) );
@@ -375,7 +370,7 @@ bool QgsMemoryProvider::addFeatures( QgsFeatureList &flist, Flags )
 {
   bool result = true;
   // whether or not to update the layer extent on the fly as we add features
-  bool updateExtent = mFeatures.isEmpty() || !mExtent.isEmpty();
+  bool updateExtent = mFeatures.featureCount() == 0 || !mExtent.isEmpty();
 
   int fieldCount = mFields.count();
 
@@ -417,7 +412,7 @@ bool QgsMemoryProvider::addFeatures( QgsFeatureList &flist, Flags )
       continue;
     }
 
-    mFeatures.insert( mNextFeatureId, *it );
+    mFeatures.addFeature( *it );
 
     if ( it->hasGeometry() )
     {
@@ -440,17 +435,21 @@ bool QgsMemoryProvider::deleteFeatures( const QgsFeatureIds &id )
 {
   for ( QgsFeatureIds::const_iterator it = id.begin(); it != id.end(); ++it )
   {
-    QgsFeatureMap::iterator fit = mFeatures.find( *it );
+    const int row = mFeatures.rowForId( *it );
 
     // check whether such feature exists
-    if ( fit == mFeatures.end() )
+    if ( row < 0 )
       continue;
 
     // update spatial index
     if ( mSpatialIndex )
-      mSpatialIndex->deleteFeature( *fit );
+    {
+      QgsFeature feature( *it );
+      feature.setGeometry( mFeatures.geometry( row ) );
+      mSpatialIndex->deleteFeature( feature );
+    }
 
-    mFeatures.erase( fit );
+    mFeatures.deleteFeature( *it );
   }
 
   updateExtents();
@@ -483,14 +482,7 @@ bool QgsMemoryProvider::addAttributes( const QList<QgsField> &attributes )
     }
     // add new field as a last one
     mFields.append( *it );
-
-    for ( QgsFeatureMap::iterator fit = mFeatures.begin(); fit != mFeatures.end(); ++fit )
-    {
-      QgsFeature &f = fit.value();
-      QgsAttributes attr = f.attributes();
-      attr.append( QVariant() );
-      f.setAttributes( attr );
-    }
+    mFeatures.addAttribute();
   }
   return true;
 }
@@ -529,14 +521,7 @@ bool QgsMemoryProvider::deleteAttributes( const QgsAttributeIds &attributes )
   {
     int idx = *it;
     mFields.remove( idx );
-
-    for ( QgsFeatureMap::iterator fit = mFeatures.begin(); fit != mFeatures.end(); ++fit )
-    {
-      QgsFeature &f = fit.value();
-      QgsAttributes attr = f.attributes();
-      attr.remove( idx );
-      f.setAttributes( attr );
-    }
+    mFeatures.deleteAttribute( idx );
   }
   clearMinMaxCache();
   return true;
@@ -546,13 +531,13 @@ bool QgsMemoryProvider::changeAttributeValues( const QgsChangedAttributesMap &at
 {
   for ( QgsChangedAttributesMap::const_iterator it = attr_map.begin(); it != attr_map.end(); ++it )
   {
-    QgsFeatureMap::iterator fit = mFeatures.find( it.key() );
-    if ( fit == mFeatures.end() )
+    const int row = mFeatures.rowForId( it.key() );
+    if ( row < 0 )
       continue;
 
     const QgsAttributeMap &attrs = it.value();
     for ( QgsAttributeMap::const_iterator it2 = attrs.constBegin(); it2 != attrs.constEnd(); ++it2 )
-      fit->setAttribute( it2.key(), it2.value() );
+      mFeatures.setAttribute( row, it2.key(), it2.value() );
   }
   clearMinMaxCache();
   return true;
@@ -562,19 +547,27 @@ bool QgsMemoryProvider::changeGeometryValues( const QgsGeometryMap &geometry_map
 {
   for ( QgsGeometryMap::const_iterator it = geometry_map.begin(); it != geometry_map.end(); ++it )
   {
-    QgsFeatureMap::iterator fit = mFeatures.find( it.key() );
-    if ( fit == mFeatures.end() )
+    const int row = mFeatures.rowForId( it.key() );
+    if ( row < 0 )
       continue;
 
+    QgsFeature feature( it.key() );
+
     // update spatial index
     if ( mSpatialIndex )
-      mSpatialIndex->deleteFeature( *fit );
+    {
+      feature.setGeometry( mFeatures.geometry( row ) );
+      mSpatialIndex->deleteFeature( feature );
+    }
 
-    fit->setGeometry( it.value() );
+    mFeatures.setGeometry( row, it.value() );
 
     // update spatial index
     if ( mSpatialIndex )
-      mSpatialIndex->addFeature( *fit );
+    {
+      feature.setGeometry( it.value() );
+      mSpatialIndex->addFeature( feature );
+    }
   }
 
   updateExtents();
@@ -616,9 +609,13 @@ bool QgsMemoryProvider::createSpatialIndex()
     mSpatialIndex = new QgsSpatialIndex();
 
     // add existing features to index
-    for ( QgsFeatureMap::iterator it = mFeatures.begin(); it != mFeatures.end(); ++it )
+    const int rowCount = mFeatures.rowCount();
+    for ( int row = 0; row < rowCount; ++row )
     {
-      mSpatialIndex->addFeature( *it );
+      if ( mFeatures.isDeleted( row ) || mFeatures.geometry( row ).isNull() )
+        continue;
+
+      mSpatialIndex->addFeature( mFeatures.id( row ), mFeatures.boundingBox( row ) );
     }
   }
   return true;
@@ -0,0 +1,158 @@
+/***************************************************************************
+                         qgsallocationpool.cpp
+                         ---------------------
+    begin                : October 2026
+    copyright            : (C) 2026 by agent
+    email                : agent at local
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qgsallocationpool.h"
+#include "qgsconfig.h"
+
+#include <new>
+
+#if !defined(USE_THREAD_LOCAL) || defined(Q_OS_WIN)
+#include <QThreadStorage>
+#endif
+
+///@cond PRIVATE
+
+//! Granularity of the pool's size classes, in bytes
+static const std::size_t POOL_GRANULARITY = 16;
+//! Number of size classes. Larger blocks bypass the pool.
+static const int POOL_SIZE_CLASSES = 16;
+//! Maximum number of blocks cached per size class and thread
+static const int POOL_MAX_CACHED_BLOCKS = 4096;
+
+struct QgsPoolFreeBlock
+{
+  QgsPoolFreeBlock *next;
+};
+
+/**
+ * Per-thread pool state. This must remain trivially destructible, as blocks may be
+ * released during thread shutdown. No blocks are cached unless a scope is active.
+ */
+struct QgsPoolThreadCache
+{
+  int activeScopes;
+  QgsPoolFreeBlock *freeLists[POOL_SIZE_CLASSES];
+  int freeCounts[POOL_SIZE_CLASSES];
+
+  void releaseAll()
+  {
+    for ( int sizeClass = 0; sizeClass < POOL_SIZE_CLASSES; ++sizeClass )
+    {
+      QgsPoolFreeBlock *block = freeLists[sizeClass];
+      while ( block )
+      {
+        QgsPoolFreeBlock *next = block->next;
+        ::operator delete( block );
+        block = next;
+      }
+      freeLists[sizeClass] = nullptr;
+      freeCounts[sizeClass] = 0;
+    }
+  }
+};
+
+#if defined(USE_THREAD_LOCAL) && !defined(Q_OS_WIN)
+static thread_local QgsPoolThreadCache sThreadCache;
+
+static QgsPoolThreadCache *threadCache()
+{
+  return &sThreadCache;
+}
+#else
+static QThreadStorage< QgsPoolThreadCache * > sThreadCache;
+
+static QgsPoolThreadCache *threadCache()
+{
+  if ( !sThreadCache.hasLocalData() )
+    sThreadCache.setLocalData( new QgsPoolThreadCache() );
+  return sThreadCache.localData();
+}
+#endif
+
+///@endcond
+
+void *QgsAllocationPool::allocate( std::size_t size )
+{
+  if ( size == 0 || size > POOL_GRANULARITY * POOL_SIZE_CLASSES )
+    return ::operator new( size );
+
+  const int sizeClass = static_cast< int >( ( size - 1 ) / POOL_GRANULARITY );
+  QgsPoolThreadCache *cache = threadCache();
+  if ( cache->activeScopes > 0 )
+  {
+    if ( QgsPoolFreeBlock *block = cache->freeLists[sizeClass] )
+    {
+      cache->freeLists[sizeClass] = block->next;
+      cache->freeCounts[sizeClass]--;
+      return block;
+    }
+  }
+
+  // always allocate the full size class, so that the block can be recycled for any
+  // object of the same class
+  return ::operator new( ( sizeClass + 1 ) * POOL_GRANULARITY );
+}
+
+void QgsAllocationPool::deallocate( void *block, std::size_t size )
+{
+  if ( !block )
+    return;
+
+  if ( size == 0 || size > POOL_GRANULARITY * POOL_SIZE_CLASSES )
+  {
+    ::operator delete( block );
+    return;
+  }
+
+  const int sizeClass = static_cast< int >( ( size - 1 ) / POOL_GRANULARITY );
+  QgsPoolThreadCache *cache = threadCache();
+  if ( cache->activeScopes > 0 && cache->freeCounts[sizeClass] < POOL_MAX_CACHED_BLOCKS )
+  {
+    QgsPoolFreeBlock *freeBlock = static_cast< QgsPoolFreeBlock * >( block );
+    freeBlock->next = cache->freeLists[sizeClass];
+    cache->freeLists[sizeClass] = freeBlock;
+    cache->freeCounts[sizeClass]++;
+    return;
+  }
+
+  ::operator delete( block );
+}
+
+bool QgsAllocationPool::isActive()
+{
+  return threadCache()->activeScopes > 0;
+}
+
+void QgsAllocationPool::beginScope()
+{
+  threadCache()->activeScopes++;
+}
+
+void QgsAllocationPool::endScope()
+{
+  QgsPoolThreadCache *cache = threadCache();
+  if ( --cache->activeScopes == 0 )
+    cache->releaseAll();
+}
+
+QgsAllocationPoolScope::QgsAllocationPoolScope()
+{
+  QgsAllocationPool::beginScope();
+}
+
+QgsAllocationPoolScope::~QgsAllocationPoolScope()
+{
+  QgsAllocationPool::endScope();
+}
@@ -0,0 +1,117 @@
+/***************************************************************************
+                         qgsallocationpool.h
+                         -------------------
+    begin                : October 2026
+    copyright            : (C) 2026 by agent
+    email                : agent at local
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef QGSALLOCATIONPOOL_H
+#define QGSALLOCATIONPOOL_H
+
+#define SIP_NO_FILE
+
+#include "qgis_core.h"
+
+#include <cstddef>
+
+/**
+ * \ingroup core
+ * \class QgsAllocationPool
+ * \brief Thread local recycling pool for the small, short lived objects created while
+ * processing features, such as geometries and feature data.
+ *
+ * Objects which use the pool (e.g. all QgsAbstractGeometry subclasses) always allocate
+ * their memory through allocate() and release it through deallocate(). While a
+ * QgsAllocationPoolScope is alive on the current thread, released blocks are kept in
+ * per-thread free lists and handed out again by subsequent allocations of the same size
+ * class, avoiding contention on the global heap when many threads create and destroy
+ * features in parallel. All cached blocks are returned to the heap when the outermost
+ * scope on the thread ends.
+ *
+ * Blocks are ordinary heap allocations, so objects created inside a scope remain valid
+ * after the scope ends and may be freely moved between threads.
+ *
+ * \note not available in Python bindings
+ * \since QGIS 3.10
+ */
+class CORE_EXPORT QgsAllocationPool
+{
+  public:
+
+    /**
+     * Allocates a block of at least \a size bytes, reusing a cached block from the
+     * current thread's pool if possible.
+     */
+    static void *allocate( std::size_t size );
+
+    /**
+     * Releases a block of \a size bytes which was allocated by allocate(). The
+     * \a size must match the size requested when the block was allocated.
+     */
+    static void deallocate( void *block, std::size_t size );
+
+    /**
+     * Returns TRUE if a QgsAllocationPoolScope is active on the current thread.
+     */
+    static bool isActive();
+
+  private:
+
+    static void beginScope();
+    static void endScope();
+
+    friend class QgsAllocationPoolScope;
+};
+
+/**
+ * \ingroup core
+ * \class QgsAllocationPoolScope
+ * \brief RAII class which enables block recycling by QgsAllocationPool on the current thread
+ * for its lifetime.
+ *
+ * Scopes may be nested. Cached blocks are released when the outermost scope is destroyed.
+ *
+ * \code{.cpp}
+ * QgsAllocationPoolScope poolScope;
+ * QgsFeature f;
+ * while ( it.nextFeature( f ) )
+ * {
+ *   // geometries and features created and destroyed here are recycled
+ * }
+ * \endcode
+ *
+ * \note not available in Python bindings
+ * \since QGIS 3.10
+ */
+class CORE_EXPORT QgsAllocationPoolScope
+{
+  public:
+
+    QgsAllocationPoolScope();
+    ~QgsAllocationPoolScope();
+
+    //! QgsAllocationPoolScope cannot be copied
+    QgsAllocationPoolScope( const QgsAllocationPoolScope &other ) = delete;
+    //! QgsAllocationPoolScope cannot be copied
+    QgsAllocationPoolScope &operator=( const QgsAllocationPoolScope &other ) = delete;
+};
+
+/**
+ * Declares class specific allocation functions which route all heap allocations of
+ * the class (and its subclasses) through QgsAllocationPool.
+ */
+#define QGS_POOLED_ALLOCATION \
+  static void *operator new( std::size_t size ) { return QgsAllocationPool::allocate( size ); } \
+  static void operator delete( void *block, std::size_t size ) { QgsAllocationPool::deallocate( block, size ); } \
+  static void *operator new( std::size_t, void *place ) noexcept { return place; } \
+  static void operator delete( void *, void * ) noexcept {}
+
+#endif // QGSALLOCATIONPOOL_H
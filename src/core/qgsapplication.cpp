@@ -53,6 +53,7 @@
 #include "qgslayoutrendercontext.h"
 #include "qgssqliteutils.h"
 #include "qgsstyle.h"
+#include "qgstextrenderer_p.h"
 #include "qgsprojutils.h"
 #include "qgsvaliditycheckregistry.h"
 #include "qgsnewsfeedparser.h"
@@ -1265,6 +1266,8 @@ void QgsApplication::exitQgis()
 
   QgsStyle::cleanDefaultStyle();
 
+  QgsTextPathCache::clear();
+
   // tear-down GDAL/OGR
   OGRCleanupAll();
   GDALDestroyDriverManager();
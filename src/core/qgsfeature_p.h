@@ -34,6 +34,7 @@ email                : nyall dot dawson at gmail dot com
  ****************************************************************************/
 
 #include "qgsfields.h"
+#include "qgsallocationpool.h"
 
 #include "qgsgeometry.h"
 
@@ -61,6 +62,8 @@ class QgsFeaturePrivate : public QSharedData
     {
     }
 
+    QGS_POOLED_ALLOCATION
+
     //! Feature ID
     QgsFeatureId fid;
 
@@ -19,6 +19,7 @@
 #include "qgslogger.h"
 #include "qgssettings.h"
 #include "qgis.h"
+#include "qgstextrenderer_p.h"
 
 #include <QApplication>
 #include <QFile>
@@ -282,6 +283,10 @@ bool QgsFontUtils::loadStandardTestFonts( const QStringList &loadstyles )
     }
   }
 
+  // text which previously fell back to another font may now render with the loaded fonts
+  if ( fontsLoaded )
+    QgsTextPathCache::clear();
+
   return fontsLoaded;
 }
 
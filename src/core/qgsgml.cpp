@@ -40,6 +40,86 @@ static const char NS_SEPARATOR = '?';
 static const char *GML_NAMESPACE = "http://www.opengis.net/gml";
 static const char *GML32_NAMESPACE = "http://www.opengis.net/gml/3.2";
 
+//! Powers of ten which are exactly representable as doubles
+static const double EXACT_POWERS_OF_TEN[] =
+{
+  1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+  1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+/**
+ * Converts the number in [begin, end) to a double, without any intermediate copy.
+ *
+ * Plain decimal numbers with at most 15 significant digits and a small exponent
+ * (i.e. nearly all coordinates) are converted directly, with correct rounding, since
+ * both the mantissa and the power of ten are exact doubles. Anything else is
+ * handed over to the (locale independent) QByteArray conversion.
+ */
+static bool parseCoordinate( const char *begin, const char *end, double &value )
+{
+  const char *ptr = begin;
+  bool negative = false;
+  if ( ptr != end && ( *ptr == '-' || *ptr == '+' ) )
+  {
+    negative = *ptr == '-';
+    ++ptr;
+  }
+
+  quint64 mantissa = 0;
+  int digits = 0;
+  int exponent = 0;
+  bool fastPath = true;
+  for ( ; ptr != end && *ptr >= '0' && *ptr <= '9'; ++ptr, ++digits )
+    mantissa = mantissa * 10 + static_cast< quint64 >( *ptr - '0' );
+  if ( ptr != end && *ptr == '.' )
+  {
+    ++ptr;
+    for ( ; ptr != end && *ptr >= '0' && *ptr <= '9'; ++ptr, ++digits, --exponent )
+      mantissa = mantissa * 10 + static_cast< quint64 >( *ptr - '0' );
+  }
+  if ( ptr != end && ( *ptr == 'e' || *ptr == 'E' ) )
+  {
+    ++ptr;
+    bool negativeExponent = false;
+    if ( ptr != end && ( *ptr == '-' || *ptr == '+' ) )
+    {
+      negativeExponent = *ptr == '-';
+      ++ptr;
+    }
+    if ( ptr == end )
+      fastPath = false;
+    int explicitExponent = 0;
+    for ( ; ptr != end && *ptr >= '0' && *ptr <= '9'; ++ptr )
+    {
+      if ( explicitExponent < 10000 )
+        explicitExponent = explicitExponent * 10 + ( *ptr - '0' );
+    }
+    exponent += negativeExponent ? -explicitExponent : explicitExponent;
+  }
+
+  if ( fastPath && ptr == end && digits > 0 && digits <= 15 && exponent >= -22 && exponent <= 22 )
+  {
+    value = static_cast< double >( mantissa );
+    if ( exponent < 0 )
+      value /= EXACT_POWERS_OF_TEN[-exponent];
+    else
+      value *= EXACT_POWERS_OF_TEN[exponent];
+    if ( negative )
+      value = -value;
+    return true;
+  }
+
+  bool ok = false;
+  value = QByteArray( begin, static_cast< int >( end - begin ) ).toDouble( &ok );
+  return ok;
+}
+
+//! Returns TRUE if \a c is an XML white space character
+static inline bool isXmlSpace( char c )
+{
+  return c == ' ' || c == '\n' || c == '\t' || c == '\r';
+}
+
 QgsGml::QgsGml(
   const QString &typeName,
   const QString &geometryAttribute,
@@ -519,13 +599,13 @@ void QgsGmlStreamingParser::startElement( const XML_Char *el, const XML_Char **a
   {
     mParseModeStack.push( Coordinate );
     mCoorMode = QgsGmlStreamingParser::Coordinate;
-    mStringCash.clear();
-    mCoordinateSeparator = readAttribute( QStringLiteral( "cs" ), attr );
+    mCoordinateCash.clear();
+    mCoordinateSeparator = readAttribute( QStringLiteral( "cs" ), attr ).toUtf8();
     if ( mCoordinateSeparator.isEmpty() )
     {
       mCoordinateSeparator = ',';
     }
-    mTupleSeparator = readAttribute( QStringLiteral( "ts" ), attr );
+    mTupleSeparator = readAttribute( QStringLiteral( "ts" ), attr ).toUtf8();
     if ( mTupleSeparator.isEmpty() )
     {
       mTupleSeparator = ' ';
@@ -536,7 +616,7 @@ void QgsGmlStreamingParser::startElement( const XML_Char *el, const XML_Char **a
   {
     mParseModeStack.push( QgsGmlStreamingParser::PosList );
     mCoorMode = QgsGmlStreamingParser::PosList;
-    mStringCash.clear();
+    mCoordinateCash.clear();
     if ( elDimension == 0 )
     {
       QString srsDimension = readAttribute( QStringLiteral( "srsDimension" ), attr );
@@ -580,13 +660,13 @@ void QgsGmlStreamingParser::startElement( const XML_Char *el, const XML_Char **a
             isGMLNS && LOCALNAME_EQUALS( "lowerCorner" ) )
   {
     mParseModeStack.push( QgsGmlStreamingParser::LowerCorner );
-    mStringCash.clear();
+    mCoordinateCash.clear();
   }
   else if ( parseMode == Envelope &&
             isGMLNS && LOCALNAME_EQUALS( "upperCorner" ) )
   {
     mParseModeStack.push( QgsGmlStreamingParser::UpperCorner );
-    mStringCash.clear();
+    mCoordinateCash.clear();
   }
   else if ( parseMode == None && !mTypeNamePtr &&
             LOCALNAME_EQUALS( "Tuple" ) )
@@ -906,10 +986,10 @@ void QgsGmlStreamingParser::endElement( const XML_Char *el )
   }
   else if ( parseMode == BoundingBox && isGMLNS && LOCALNAME_EQUALS( "boundedBy" ) )
   {
-    //create bounding box from mStringCash
+    //create bounding box from mCoordinateCash
     if ( mCurrentExtent.isNull() &&
          !mBoundedByNullFound &&
-         !createBBoxFromCoordinateString( mCurrentExtent, mStringCash ) )
+         !createBBoxFromCoordinateString( mCurrentExtent, mCoordinateCash ) )
     {
       QgsDebugMsg( QStringLiteral( "creation of bounding box failed" ) );
     }
@@ -932,23 +1012,23 @@ void QgsGmlStreamingParser::endElement( const XML_Char *el )
   }
   else if ( parseMode == LowerCorner && isGMLNS && LOCALNAME_EQUALS( "lowerCorner" ) )
   {
-    QList<QgsPointXY> points;
-    pointsFromPosListString( points, mStringCash, 2 );
-    if ( points.size() == 1 )
+    mCoordinates.clear();
+    pointsFromPosListString( mCoordinates, mCoordinateCash, 2 );
+    if ( mCoordinates.size() == 2 )
     {
-      mCurrentExtent.setXMinimum( points[0].x() );
-      mCurrentExtent.setYMinimum( points[0].y() );
+      mCurrentExtent.setXMinimum( mCoordinates[0] );
+      mCurrentExtent.setYMinimum( mCoordinates[1] );
     }
     mParseModeStack.pop();
   }
   else if ( parseMode == UpperCorner && isGMLNS && LOCALNAME_EQUALS( "upperCorner" ) )
   {
-    QList<QgsPointXY> points;
-    pointsFromPosListString( points, mStringCash, 2 );
-    if ( points.size() == 1 )
+    mCoordinates.clear();
+    pointsFromPosListString( mCoordinates, mCoordinateCash, 2 );
+    if ( mCoordinates.size() == 2 )
     {
-      mCurrentExtent.setXMaximum( points[0].x() );
-      mCurrentExtent.setYMaximum( points[0].y() );
+      mCurrentExtent.setXMaximum( mCoordinates[0] );
+      mCurrentExtent.setYMaximum( mCoordinates[1] );
     }
     mParseModeStack.pop();
   }
@@ -988,19 +1068,18 @@ void QgsGmlStreamingParser::endElement( const XML_Char *el )
   }
   else if ( isGMLNS && LOCALNAME_EQUALS( "Point" ) )
   {
-    QList<QgsPointXY> pointList;
-    if ( pointsFromString( pointList, mStringCash ) != 0 )
+    if ( pointsFromString() != 0 )
     {
       //error
     }
 
-    if ( pointList.isEmpty() )
+    if ( mCoordinates.empty() )
       return;  // error
 
     if ( parseMode == QgsGmlStreamingParser::Geometry )
     {
       //directly add WKB point to the feature
-      if ( getPointWKB( mCurrentWKB, *( pointList.constBegin() ) ) != 0 )
+      if ( getPointWKB( mCurrentWKB, mCoordinates[0], mCoordinates[1] ) != 0 )
       {
         //error
       }
@@ -1013,7 +1092,7 @@ void QgsGmlStreamingParser::endElement( const XML_Char *el )
     else //multipoint, add WKB as fragment
     {
       QgsWkbPtr wkbPtr( nullptr, 0 );
-      if ( getPointWKB( wkbPtr, *( pointList.constBegin() ) ) != 0 )
+      if ( getPointWKB( wkbPtr, mCoordinates[0], mCoordinates[1] ) != 0 )
       {
         //error
       }
@@ -1032,14 +1111,13 @@ void QgsGmlStreamingParser::endElement( const XML_Char *el )
   {
     //add WKB point to the feature
 
-    QList<QgsPointXY> pointList;
-    if ( pointsFromString( pointList, mStringCash ) != 0 )
+    if ( pointsFromString() != 0 )
     {
       //error
     }
     if ( parseMode == QgsGmlStreamingParser::Geometry )
     {
-      if ( getLineWKB( mCurrentWKB, pointList ) != 0 )
+      if ( getLineWKB( mCurrentWKB, mCoordinates ) != 0 )
       {
         //error
       }
@@ -1052,7 +1130,7 @@ void QgsGmlStreamingParser::endElement( const XML_Char *el )
     else //multiline, add WKB as fragment
     {
       QgsWkbPtr wkbPtr( nullptr, 0 );
-      if ( getLineWKB( wkbPtr, pointList ) != 0 )
+      if ( getLineWKB( wkbPtr, mCoordinates ) != 0 )
       {
         //error
       }
@@ -1070,14 +1148,13 @@ void QgsGmlStreamingParser::endElement( const XML_Char *el )
   else if ( ( parseMode == Geometry || parseMode == MultiPolygon ) &&
             isGMLNS && LOCALNAME_EQUALS( "LinearRing" ) )
   {
-    QList<QgsPointXY> pointList;
-    if ( pointsFromString( pointList, mStringCash ) != 0 )
+    if ( pointsFromString() != 0 )
     {
       //error
     }
 
     QgsWkbPtr wkbPtr( nullptr, 0 );
-    if ( getRingWKB( wkbPtr, pointList ) != 0 )
+    if ( getRingWKB( wkbPtr, mCoordinates ) != 0 )
     {
       //error
     }
@@ -1147,7 +1224,7 @@ void QgsGmlStreamingParser::endElement( const XML_Char *el )
 
 void QgsGmlStreamingParser::characters( const XML_Char *chars, int len )
 {
-  //save chars in mStringCash attribute mode or coordinate mode
+  //save chars in mStringCash in attribute mode, or in mCoordinateCash in coordinate mode
   if ( mParseModeStack.isEmpty() )
   {
     return;
@@ -1159,13 +1236,17 @@ void QgsGmlStreamingParser::characters( const XML_Char *chars, int len )
   }
 
   QgsGmlStreamingParser::ParseMode parseMode = mParseModeStack.top();
-  if ( parseMode == QgsGmlStreamingParser::Attribute ||
-       parseMode == QgsGmlStreamingParser::AttributeTuple ||
-       parseMode == QgsGmlStreamingParser::Coordinate ||
+  if ( parseMode == QgsGmlStreamingParser::Coordinate ||
        parseMode == QgsGmlStreamingParser::PosList ||
        parseMode == QgsGmlStreamingParser::LowerCorner ||
-       parseMode == QgsGmlStreamingParser::UpperCorner ||
-       parseMode == QgsGmlStreamingParser::ExceptionText )
+       parseMode == QgsGmlStreamingParser::UpperCorner )
+  {
+    // coordinates are tokenized directly from the UTF-8 data
+    mCoordinateCash.append( chars, len );
+  }
+  else if ( parseMode == QgsGmlStreamingParser::Attribute ||
+            parseMode == QgsGmlStreamingParser::AttributeTuple ||
+            parseMode == QgsGmlStreamingParser::ExceptionText )
   {
     mStringCash.append( QString::fromUtf8( chars, len ) );
   }
@@ -1276,140 +1357,179 @@ QString QgsGmlStreamingParser::readAttribute( const QString &attributeName, cons
   return QString();
 }
 
-bool QgsGmlStreamingParser::createBBoxFromCoordinateString( QgsRectangle &r, const QString &coordString ) const
+bool QgsGmlStreamingParser::createBBoxFromCoordinateString( QgsRectangle &r, const QByteArray &coordString ) const
 {
-  QList<QgsPointXY> points;
-  if ( pointsFromCoordinateString( points, coordString ) != 0 )
+  std::vector<double> coordinates;
+  if ( pointsFromCoordinateString( coordinates, coordString ) != 0 )
   {
     return false;
   }
 
-  if ( points.size() < 2 )
+  if ( coordinates.size() < 4 )
   {
     return false;
   }
 
-  r.set( points[0], points[1] );
+  r.set( QgsPointXY( coordinates[0], coordinates[1] ), QgsPointXY( coordinates[2], coordinates[3] ) );
 
   return true;
 }
 
-int QgsGmlStreamingParser::pointsFromCoordinateString( QList<QgsPointXY> &points, const QString &coordString ) const
+int QgsGmlStreamingParser::pointsFromCoordinateString( std::vector<double> &coordinates, const QByteArray &coordString ) const
 {
   //tuples are separated by space, x/y by ','
-  QStringList tuples = coordString.split( mTupleSeparator, QString::SkipEmptyParts );
-  QStringList tuples_coordinates;
-  double x, y;
-  bool conversionSuccess;
-
-  QStringList::const_iterator tupleIterator;
-  for ( tupleIterator = tuples.constBegin(); tupleIterator != tuples.constEnd(); ++tupleIterator )
-  {
-    tuples_coordinates = tupleIterator->split( mCoordinateSeparator, QString::SkipEmptyParts );
-    if ( tuples_coordinates.size() < 2 )
+  const char *tupleSeparator = mTupleSeparator.constData();
+  const int tupleSeparatorLen = mTupleSeparator.size();
+  const bool spaceSeparatedTuples = mTupleSeparator == " ";
+  const char *coordinateSeparator = mCoordinateSeparator.constData();
+  const int coordinateSeparatorLen = mCoordinateSeparator.size();
+
+  const char *ptr = coordString.constData();
+  const char *end = ptr + coordString.size();
+  while ( ptr < end )
+  {
+    // find the end of the tuple
+    const char *tupleEnd = ptr;
+    while ( tupleEnd < end &&
+            !( spaceSeparatedTuples ? isXmlSpace( *tupleEnd ) :
+               ( end - tupleEnd >= tupleSeparatorLen && memcmp( tupleEnd, tupleSeparator, tupleSeparatorLen ) == 0 ) ) )
+      ++tupleEnd;
+
+    // split the first two coordinates of the tuple, skipping empty parts
+    const char *coordinateStart[2] = { nullptr, nullptr };
+    const char *coordinateEnd[2] = { nullptr, nullptr };
+    int coordinateCount = 0;
+    const char *tuplePtr = ptr;
+    while ( tuplePtr < tupleEnd && coordinateCount < 2 )
     {
-      continue;
-    }
-    x = tuples_coordinates.at( 0 ).toDouble( &conversionSuccess );
-    if ( !conversionSuccess )
-    {
-      continue;
+      const char *partEnd = tuplePtr;
+      while ( partEnd < tupleEnd &&
+              !( tupleEnd - partEnd >= coordinateSeparatorLen && memcmp( partEnd, coordinateSeparator, coordinateSeparatorLen ) == 0 ) )
+        ++partEnd;
+      if ( partEnd > tuplePtr )
+      {
+        coordinateStart[coordinateCount] = tuplePtr;
+        coordinateEnd[coordinateCount] = partEnd;
+        ++coordinateCount;
+      }
+      tuplePtr = partEnd + coordinateSeparatorLen;
     }
-    y = tuples_coordinates.at( 1 ).toDouble( &conversionSuccess );
-    if ( !conversionSuccess )
+
+    double x, y;
+    if ( coordinateCount == 2 &&
+         parseCoordinate( coordinateStart[0], coordinateEnd[0], x ) &&
+         parseCoordinate( coordinateStart[1], coordinateEnd[1], y ) )
     {
-      continue;
+      coordinates.push_back( mInvertAxisOrientation ? y : x );
+      coordinates.push_back( mInvertAxisOrientation ? x : y );
     }
-    points.push_back( ( mInvertAxisOrientation ) ? QgsPointXY( y, x ) : QgsPointXY( x, y ) );
+
+    ptr = tupleEnd + ( spaceSeparatedTuples ? 1 : tupleSeparatorLen );
   }
   return 0;
 }
 
-int QgsGmlStreamingParser::pointsFromPosListString( QList<QgsPointXY> &points, const QString &coordString, int dimension ) const
+int QgsGmlStreamingParser::pointsFromPosListString( std::vector<double> &coordinates, const QByteArray &coordString, int dimension ) const
 {
-  // coordinates separated by spaces
-  QStringList coordinates = coordString.split( ' ', QString::SkipEmptyParts );
+  // coordinates separated by white space. Each tuple is read in place, and only
+  // its first two coordinates are converted
+  const char *ptr = coordString.constData();
+  const char *end = ptr + coordString.size();
+  const char *tupleStart[2] = { nullptr, nullptr };
+  const char *tupleEnd[2] = { nullptr, nullptr };
+  int tokenIndex = 0;
+  int tokenCount = 0;
+  while ( true )
+  {
+    while ( ptr < end && isXmlSpace( *ptr ) )
+      ++ptr;
+    if ( ptr == end )
+      break;
 
-  if ( coordinates.size() % dimension != 0 )
-  {
-    QgsDebugMsg( QStringLiteral( "Wrong number of coordinates" ) );
-  }
+    const char *tokenStart = ptr;
+    while ( ptr < end && !isXmlSpace( *ptr ) )
+      ++ptr;
+    ++tokenCount;
 
-  int ncoor = coordinates.size() / dimension;
-  for ( int i = 0; i < ncoor; i++ )
-  {
-    bool conversionSuccess;
-    double x = coordinates.value( i * dimension ).toDouble( &conversionSuccess );
-    if ( !conversionSuccess )
+    if ( tokenIndex < 2 )
     {
-      continue;
+      tupleStart[tokenIndex] = tokenStart;
+      tupleEnd[tokenIndex] = ptr;
     }
-    double y = coordinates.value( i * dimension + 1 ).toDouble( &conversionSuccess );
-    if ( !conversionSuccess )
-    {
+    if ( ++tokenIndex < dimension )
       continue;
+
+    tokenIndex = 0;
+    double x, y;
+    if ( parseCoordinate( tupleStart[0], tupleEnd[0], x ) &&
+         parseCoordinate( tupleStart[1], tupleEnd[1], y ) )
+    {
+      coordinates.push_back( mInvertAxisOrientation ? y : x );
+      coordinates.push_back( mInvertAxisOrientation ? x : y );
     }
-    points.append( ( mInvertAxisOrientation ) ? QgsPointXY( y, x ) : QgsPointXY( x, y ) );
+  }
+
+  if ( tokenCount % dimension != 0 )
+  {
+    QgsDebugMsg( QStringLiteral( "Wrong number of coordinates" ) );
   }
   return 0;
 }
 
-int QgsGmlStreamingParser::pointsFromString( QList<QgsPointXY> &points, const QString &coordString ) const
+int QgsGmlStreamingParser::pointsFromString()
 {
+  mCoordinates.clear();
   if ( mCoorMode == QgsGmlStreamingParser::Coordinate )
   {
-    return pointsFromCoordinateString( points, coordString );
+    return pointsFromCoordinateString( mCoordinates, mCoordinateCash );
   }
   else if ( mCoorMode == QgsGmlStreamingParser::PosList )
   {
-    return pointsFromPosListString( points, coordString, mDimension ? mDimension : 2 );
+    return pointsFromPosListString( mCoordinates, mCoordinateCash, mDimension ? mDimension : 2 );
   }
   return 1;
 }
 
-int QgsGmlStreamingParser::getPointWKB( QgsWkbPtr &wkbPtr, const QgsPointXY &point ) const
+int QgsGmlStreamingParser::getPointWKB( QgsWkbPtr &wkbPtr, double x, double y ) const
 {
   int wkbSize = 1 + sizeof( int ) + 2 * sizeof( double );
   wkbPtr = QgsWkbPtr( new unsigned char[wkbSize], wkbSize );
 
   QgsWkbPtr fillPtr( wkbPtr );
-  fillPtr << mEndian << QgsWkbTypes::Point << point.x() << point.y();
+  fillPtr << mEndian << QgsWkbTypes::Point << x << y;
 
   return 0;
 }
 
-int QgsGmlStreamingParser::getLineWKB( QgsWkbPtr &wkbPtr, const QList<QgsPointXY> &lineCoordinates ) const
+int QgsGmlStreamingParser::getLineWKB( QgsWkbPtr &wkbPtr, const std::vector<double> &lineCoordinates ) const
 {
-  int wkbSize = 1 + 2 * sizeof( int ) + lineCoordinates.size() * 2 * sizeof( double );
+  const int pointCount = static_cast< int >( lineCoordinates.size() / 2 );
+  int wkbSize = 1 + 2 * sizeof( int ) + pointCount * 2 * sizeof( double );
   wkbPtr = QgsWkbPtr( new unsigned char[wkbSize], wkbSize );
 
   QgsWkbPtr fillPtr( wkbPtr );
 
-  fillPtr << mEndian << QgsWkbTypes::LineString << lineCoordinates.size();
+  fillPtr << mEndian << QgsWkbTypes::LineString << pointCount;
 
-  QList<QgsPointXY>::const_iterator iter;
-  for ( iter = lineCoordinates.constBegin(); iter != lineCoordinates.constEnd(); ++iter )
-  {
-    fillPtr << iter->x() << iter->y();
-  }
+  // coordinates are in native endianness, as is the WKB, so they can be copied at once
+  if ( pointCount > 0 )
+    memcpy( fillPtr, lineCoordinates.data(), pointCount * 2 * sizeof( double ) );
 
   return 0;
 }
 
-int QgsGmlStreamingParser::getRingWKB( QgsWkbPtr &wkbPtr, const QList<QgsPointXY> &ringCoordinates ) const
+int QgsGmlStreamingParser::getRingWKB( QgsWkbPtr &wkbPtr, const std::vector<double> &ringCoordinates ) const
 {
-  int wkbSize = sizeof( int ) + ringCoordinates.size() * 2 * sizeof( double );
+  const int pointCount = static_cast< int >( ringCoordinates.size() / 2 );
+  int wkbSize = sizeof( int ) + pointCount * 2 * sizeof( double );
   wkbPtr = QgsWkbPtr( new unsigned char[wkbSize], wkbSize );
 
   QgsWkbPtr fillPtr( wkbPtr );
 
-  fillPtr << ringCoordinates.size();
+  fillPtr << pointCount;
 
-  QList<QgsPointXY>::const_iterator iter;
-  for ( iter = ringCoordinates.constBegin(); iter != ringCoordinates.constEnd(); ++iter )
-  {
-    fillPtr << iter->x() << iter->y();
-  }
+  if ( pointCount > 0 )
+    memcpy( fillPtr, ringCoordinates.data(), pointCount * 2 * sizeof( double ) );
 
   return 0;
 }
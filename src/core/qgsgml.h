@@ -31,6 +31,7 @@
 #include <QVector>
 
 #include <string>
+#include <vector>
 
 class QgsCoordinateReferenceSystem;
 
@@ -204,30 +205,31 @@ class CORE_EXPORT QgsGmlStreamingParser
        \returns attribute value or an empty string if no such attribute
       */
     QString readAttribute( const QString &attributeName, const XML_Char **attr ) const;
-    //! Creates a rectangle from a coordinate string.
-    bool createBBoxFromCoordinateString( QgsRectangle &bb, const QString &coordString ) const;
+    //! Creates a rectangle from a (UTF-8) coordinate string.
+    bool createBBoxFromCoordinateString( QgsRectangle &bb, const QByteArray &coordString ) const;
 
     /**
-     * Creates a set of points from a coordinate string.
-       \param points list that will contain the created points
-       \param coordString the text containing the coordinates
+     * Reads the points of a gml:coordinates string.
+       \param coordinates flat list of x and y values to which the points are appended
+       \param coordString the UTF-8 text containing the coordinates
        \returns 0 in case of success
       */
-    int pointsFromCoordinateString( QList<QgsPointXY> &points, const QString &coordString ) const;
+    int pointsFromCoordinateString( std::vector<double> &coordinates, const QByteArray &coordString ) const;
 
     /**
-     * Creates a set of points from a gml:posList or gml:pos coordinate string.
-       \param points list that will contain the created points
-       \param coordString the text containing the coordinates
+     * Reads the points of a gml:posList or gml:pos coordinate string.
+       \param coordinates flat list of x and y values to which the points are appended
+       \param coordString the UTF-8 text containing the coordinates
        \param dimension number of dimensions
        \returns 0 in case of success
       */
-    int pointsFromPosListString( QList<QgsPointXY> &points, const QString &coordString, int dimension ) const;
+    int pointsFromPosListString( std::vector<double> &coordinates, const QByteArray &coordString, int dimension ) const;
 
-    int pointsFromString( QList<QgsPointXY> &points, const QString &coordString ) const;
-    int getPointWKB( QgsWkbPtr &wkbPtr, const QgsPointXY & ) const;
-    int getLineWKB( QgsWkbPtr &wkbPtr, const QList<QgsPointXY> &lineCoordinates ) const;
-    int getRingWKB( QgsWkbPtr &wkbPtr, const QList<QgsPointXY> &ringCoordinates ) const;
+    //! Reads the points of mCoordinateCash into mCoordinates, according to the current coordinate mode
+    int pointsFromString();
+    int getPointWKB( QgsWkbPtr &wkbPtr, double x, double y ) const;
+    int getLineWKB( QgsWkbPtr &wkbPtr, const std::vector<double> &lineCoordinates ) const;
+    int getRingWKB( QgsWkbPtr &wkbPtr, const std::vector<double> &ringCoordinates ) const;
 
     /**
      * Creates a multiline from the information in mCurrentWKBFragments and
@@ -288,6 +290,10 @@ class CORE_EXPORT QgsGmlStreamingParser
     QStack<ParseMode> mParseModeStack;
     //! This contains the character data if an important element has been encountered
     QString mStringCash;
+    //! Raw UTF-8 character data of coordinate elements, which is tokenized without conversion to QString
+    QByteArray mCoordinateCash;
+    //! Flat list of x and y values of the last parsed coordinate element. Reused between geometries to avoid reallocations.
+    std::vector<double> mCoordinates;
     QgsFeature *mCurrentFeature = nullptr;
     QVector<QVariant> mCurrentAttributes; //attributes of current feature
     QString mCurrentFeatureId;
@@ -305,10 +311,10 @@ class CORE_EXPORT QgsGmlStreamingParser
     QList< QList<QgsWkbPtr> > mCurrentWKBFragments;
     QString mAttributeName;
     char mEndian;
-    //! Coordinate separator for coordinate strings. Usually ","
-    QString mCoordinateSeparator;
-    //! Tuple separator for coordinate strings. Usually " "
-    QString mTupleSeparator;
+    //! Coordinate separator for coordinate strings (UTF-8). Usually ","
+    QByteArray mCoordinateSeparator;
+    //! Tuple separator for coordinate strings (UTF-8). Usually " "
+    QByteArray mTupleSeparator;
     //! Keep track about number of dimensions in pos or posList
     QStack<int> mDimensionStack;
     //! Number of dimensions in pos or posList for the current geometry
@@ -28,6 +28,7 @@
 #include "qgssymbol.h"
 #include "qgsexpressioncontextutils.h"
 #include "qgsvectorlayerlabelprovider.h"
+#include "qgslabelplacementcache.h"
 
 // helper function for checking for job cancellation within PAL
 static bool _palIsCanceled( void *ctx )
@@ -35,6 +36,19 @@ static bool _palIsCanceled( void *ctx )
   return ( reinterpret_cast< QgsRenderContext * >( ctx ) )->renderingStopped();
 }
 
+// helper function for identifying a label provider within the label placement cache
+static QString _placementCacheProviderKey( const QgsAbstractLabelProvider *provider )
+{
+  return provider->layerId() + ':' + provider->providerId();
+}
+
+// helper function for checking whether a cached placement fits the current size of a feature's label
+static bool _placementSizeMatches( const QgsLabelPlacementCache::Placement &placement, const QSizeF &size )
+{
+  return qgsDoubleNear( placement.width, size.width(), placement.width * 1e-9 )
+         && qgsDoubleNear( placement.height, size.height(), placement.height * 1e-9 );
+}
+
 /**
  * \ingroup core
  * \class QgsLabelSorter
@@ -344,6 +358,65 @@ void QgsLabelingEngine::solve( QgsRenderContext &context )
 
   mPal->registerCancellationCallback( &_palIsCanceled, reinterpret_cast< void * >( &context ) );
 
+  // reuse the positions of labels from the previous render which are fully visible in both the
+  // previous and current map extent. Only labels near the newly exposed parts of the map are placed from scratch.
+  QString cacheKey;
+  QHash< QString, QgsLabelPlacementCache::ProviderPlacements > cachedPlacements;
+  QgsRectangle reusableExtent;
+  if ( mPlacementCache && canCachePlacements() )
+  {
+    cacheKey = placementCacheKey();
+    QgsRectangle cachedExtent;
+    cachedPlacements = mPlacementCache->placements( cacheKey, cachedExtent );
+    reusableExtent = cachedExtent.intersect( extent );
+  }
+
+  if ( !cachedPlacements.isEmpty() && !reusableExtent.isEmpty() )
+  {
+    mPal->setCandidateSeedFunction( [&cachedPlacements, reusableExtent]( pal::FeaturePart *part ) -> pal::LabelPosition *
+    {
+      // curved labels are made up of multiple parts, so can't be restored from a single placement
+      if ( part->layer()->isCurved() )
+        return nullptr;
+
+      QgsLabelFeature *lf = part->feature();
+      auto providerIt = cachedPlacements.find( _placementCacheProviderKey( lf->provider() ) );
+      if ( providerIt == cachedPlacements.end() )
+        return nullptr;
+
+      auto featureIt = providerIt->find( lf->id() );
+      if ( featureIt == providerIt->end() )
+        return nullptr;
+
+      double amin[2], amax[2];
+      part->getBoundingBox( amin, amax );
+      const QgsRectangle partBounds( amin[0], amin[1], amax[0], amax[1] );
+
+      QVector< QgsLabelPlacementCache::Placement > &placements = featureIt.value();
+      for ( int i = 0; i < placements.size(); ++i )
+      {
+        const QgsLabelPlacementCache::Placement &placement = placements.at( i );
+        if ( !reusableExtent.contains( placement.boundingBox ) )
+          continue;
+
+        // multipart features have a placement per labeled part, so match placements to the nearby part
+        if ( !partBounds.buffered( std::max( placement.width, placement.height ) + lf->distLabel() ).intersects( placement.boundingBox ) )
+          continue;
+
+        // the label text (and accordingly size) may have changed since the placement was solved
+        if ( !_placementSizeMatches( placement, lf->size( 0 ) ) && !_placementSizeMatches( placement, lf->size( M_PI_2 ) ) )
+          continue;
+
+        pal::LabelPosition *seed = new pal::LabelPosition( 0, placement.x, placement.y, placement.width, placement.height, placement.angle, 0.0,
+            part, placement.reversed, static_cast< pal::LabelPosition::Quadrant >( placement.quadrant ) );
+        // each placement can only be claimed by a single part
+        placements.remove( i );
+        return seed;
+      }
+      return nullptr;
+    } );
+  }
+
   QTime t;
   t.start();
 
@@ -351,6 +424,8 @@ void QgsLabelingEngine::solve( QgsRenderContext &context )
   try
   {
     mProblem = mPal->extractProblem( extent, mapBoundaryGeom );
+    // the seed function refers to local state
+    mPal->setCandidateSeedFunction( pal::Pal::CandidateSeedFunction() );
   }
   catch ( std::exception &e )
   {
@@ -396,6 +471,9 @@ void QgsLabelingEngine::solve( QgsRenderContext &context )
   // find the solution
   mLabels = mPal->solveProblem( mProblem.get(), settings.testFlag( QgsLabelingEngineSettings::UseAllLabels ), settings.testFlag( QgsLabelingEngineSettings::DrawUnplacedLabels ) ? &mUnlabeled : nullptr );
 
+  if ( !cacheKey.isEmpty() && !context.renderingStopped() )
+    storePlacements( cacheKey, extent );
+
   // sort labels
   std::sort( mLabels.begin(), mLabels.end(), QgsLabelSorter( mMapSettings ) );
 
@@ -534,6 +612,81 @@ QgsLabelingResults *QgsLabelingEngine::takeResults()
   return mResults.release();
 }
 
+bool QgsLabelingEngine::canCachePlacements() const
+{
+  // placements are stored in unrotated map coordinates and are only checked against the
+  // rectangular map extent
+  return qgsDoubleNear( mMapSettings.rotation(), 0.0 )
+         && mMapSettings.labelBoundaryGeometry().isNull()
+         && mMapSettings.labelBlockingRegions().isEmpty();
+}
+
+QString QgsLabelingEngine::placementCacheKey() const
+{
+  const QgsLabelingEngineSettings &settings = mMapSettings.labelingEngineSettings();
+  int candPoint, candLine, candPolygon;
+  settings.numCandidatePositions( candPoint, candLine, candPolygon );
+  Q_NOWARN_DEPRECATED_PUSH
+  const QgsLabelingEngineSettings::Search searchMethod = settings.searchMethod();
+  Q_NOWARN_DEPRECATED_POP
+
+  // everything which affects the generated candidates or the solution must be part of the key
+  return QStringLiteral( "%1|%2|%3|%4|%5|%6|%7|%8|%9" ).arg( qgsDoubleToString( mMapSettings.mapUnitsPerPixel() ),
+         mMapSettings.destinationCrs().authid(),
+         qgsDoubleToString( mMapSettings.outputDpi() ),
+         qgsDoubleToString( mMapSettings.devicePixelRatio() ),
+         qgsDoubleToString( mMapSettings.segmentationTolerance() ) )
+         .arg( static_cast< int >( mMapSettings.segmentationToleranceType() ) )
+         .arg( static_cast< int >( mMapSettings.textRenderFormat() ) )
+         .arg( static_cast< int >( settings.flags() ) )
+         .arg( static_cast< int >( searchMethod ) )
+         + QStringLiteral( "|%1|%2|%3" ).arg( candPoint ).arg( candLine ).arg( candPolygon );
+}
+
+void QgsLabelingEngine::storePlacements( const QString &cacheKey, const QgsRectangle &extent )
+{
+  QHash< QString, QgsLabelPlacementCache::ProviderPlacements > placements;
+  QHash< QString, QgsMapLayer * > providerLayers;
+
+  for ( pal::LabelPosition *label : qgis::as_const( mLabels ) )
+  {
+    pal::FeaturePart *part = label->getFeaturePart();
+    if ( !part || label->getNextPart() || part->layer()->isCurved() )
+      continue;
+
+    QgsLabelFeature *lf = part->feature();
+    const QString providerKey = _placementCacheProviderKey( lf->provider() );
+
+    QgsLabelPlacementCache::Placement placement;
+    // store the label's original position, so that upside-down labels are flipped identically when restored
+    if ( label->getUpsideDown() )
+    {
+      placement.x = label->getX( 2 );
+      placement.y = label->getY( 2 );
+      placement.angle = label->getAlpha() > 3 * M_PI_2 ? label->getAlpha() - M_PI : label->getAlpha() + M_PI;
+    }
+    else
+    {
+      placement.x = label->getX();
+      placement.y = label->getY();
+      placement.angle = label->getAlpha();
+    }
+    placement.width = label->getWidth();
+    placement.height = label->getHeight();
+    placement.reversed = label->getReversed();
+    placement.quadrant = static_cast< int >( label->getQuadrant() );
+
+    double amin[2], amax[2];
+    label->getBoundingBox( amin, amax );
+    placement.boundingBox = QgsRectangle( amin[0], amin[1], amax[0], amax[1] );
+
+    placements[ providerKey ][ lf->id() ].append( placement );
+    providerLayers.insert( providerKey, lf->provider()->layer() );
+  }
+
+  mPlacementCache->setPlacements( cacheKey, extent, placements, providerLayers );
+}
+
 
 //
 //  QgsDefaultLabelingEngine
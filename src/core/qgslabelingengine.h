@@ -26,6 +26,7 @@
 #include "pal.h"
 
 class QgsLabelingEngine;
+class QgsLabelPlacementCache;
 
 
 /**
@@ -261,6 +262,27 @@ class CORE_EXPORT QgsLabelingEngine
     //! For internal use by the providers
     QgsLabelingResults *results() const { return mResults.get(); }
 
+    /**
+     * Sets a label placement \a cache to use when solving the labeling problem. Labels placed
+     * by a previous engine which used the same cache will be kept at their previous positions
+     * when they remain fully visible and the map scale and settings are unchanged, and the new
+     * solution is stored in the cache for use by subsequent engines.
+     *
+     * Ownership of \a cache is not transferred. Set to nullptr to disable placement caching.
+     *
+     * \see placementCache()
+     * \since QGIS 3.10
+     */
+    void setPlacementCache( QgsLabelPlacementCache *cache ) { mPlacementCache = cache; }
+
+    /**
+     * Returns the label placement cache used by the engine, or nullptr if not set.
+     *
+     * \see setPlacementCache()
+     * \since QGIS 3.10
+     */
+    QgsLabelPlacementCache *placementCache() const { return mPlacementCache; }
+
   protected:
     void processProvider( QgsAbstractLabelProvider *provider, QgsRenderContext &context, pal::Pal &p );
 
@@ -318,6 +340,20 @@ class CORE_EXPORT QgsLabelingEngine
     QList<pal::LabelPosition *> mUnlabeled;
     QList<pal::LabelPosition *> mLabels;
 
+    //! Optional cache of label positions from previous renders
+    QgsLabelPlacementCache *mPlacementCache = nullptr;
+
+  private:
+
+    //! Returns TRUE if placements can be reused between renders using the current map settings
+    bool canCachePlacements() const;
+
+    //! Returns a key identifying the map settings which affect label placements
+    QString placementCacheKey() const;
+
+    //! Stores the current labeling solution in the placement cache
+    void storePlacements( const QString &cacheKey, const QgsRectangle &extent );
+
 };
 
 /**
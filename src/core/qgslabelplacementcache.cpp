@@ -0,0 +1,109 @@
+/***************************************************************************
+  qgslabelplacementcache.cpp
+  --------------------------------------
+  Date                 : October 2026
+  Copyright            : (C) 2026 by agent
+  Email                : agent at local
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qgslabelplacementcache.h"
+
+QgsLabelPlacementCache::QgsLabelPlacementCache()
+{
+  clear();
+}
+
+void QgsLabelPlacementCache::clear()
+{
+  QMutexLocker lock( &mMutex );
+  disconnectLayers();
+  mContextKey.clear();
+  mExtent.setMinimal();
+  mPlacements.clear();
+  mProviderLayers.clear();
+}
+
+QHash<QString, QgsLabelPlacementCache::ProviderPlacements> QgsLabelPlacementCache::placements( const QString &contextKey, QgsRectangle &extent ) const
+{
+  QMutexLocker lock( &mMutex );
+  if ( contextKey != mContextKey )
+  {
+    extent.setMinimal();
+    return QHash< QString, ProviderPlacements >();
+  }
+
+  extent = mExtent;
+  return mPlacements;
+}
+
+void QgsLabelPlacementCache::setPlacements( const QString &contextKey, const QgsRectangle &extent, const QHash<QString, QgsLabelPlacementCache::ProviderPlacements> &placements, const QHash<QString, QgsMapLayer *> &providerLayers )
+{
+  QMutexLocker lock( &mMutex );
+  disconnectLayers();
+
+  mContextKey = contextKey;
+  mExtent = extent;
+  mPlacements = placements;
+  mProviderLayers.clear();
+
+  // connect to the layers to listen to their repaintRequested() signals
+  for ( auto it = providerLayers.constBegin(); it != providerLayers.constEnd(); ++it )
+  {
+    QgsMapLayer *layer = it.value();
+    if ( !layer )
+    {
+      // can't track changes to the provider's features, so don't keep its placements
+      mPlacements.remove( it.key() );
+      continue;
+    }
+
+    mProviderLayers.insert( it.key(), layer );
+    if ( !mConnectedLayers.contains( QgsWeakMapLayerPointer( layer ) ) )
+    {
+      connect( layer, &QgsMapLayer::repaintRequested, this, &QgsLabelPlacementCache::layerRequestedRepaint );
+      connect( layer, &QgsMapLayer::willBeDeleted, this, &QgsLabelPlacementCache::layerRequestedRepaint );
+      mConnectedLayers << layer;
+    }
+  }
+}
+
+void QgsLabelPlacementCache::layerRequestedRepaint()
+{
+  QgsMapLayer *layer = qobject_cast<QgsMapLayer *>( sender() );
+  if ( !layer )
+    return;
+
+  QMutexLocker lock( &mMutex );
+  for ( auto it = mProviderLayers.begin(); it != mProviderLayers.end(); )
+  {
+    if ( !it.value() || it.value().data() == layer )
+    {
+      mPlacements.remove( it.key() );
+      it = mProviderLayers.erase( it );
+    }
+    else
+    {
+      ++it;
+    }
+  }
+}
+
+void QgsLabelPlacementCache::disconnectLayers()
+{
+  for ( const QgsWeakMapLayerPointer &layer : qgis::as_const( mConnectedLayers ) )
+  {
+    if ( layer.data() )
+    {
+      disconnect( layer.data(), &QgsMapLayer::repaintRequested, this, &QgsLabelPlacementCache::layerRequestedRepaint );
+      disconnect( layer.data(), &QgsMapLayer::willBeDeleted, this, &QgsLabelPlacementCache::layerRequestedRepaint );
+    }
+  }
+  mConnectedLayers.clear();
+}
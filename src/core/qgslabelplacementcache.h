@@ -0,0 +1,130 @@
+/***************************************************************************
+  qgslabelplacementcache.h
+  --------------------------------------
+  Date                 : October 2026
+  Copyright            : (C) 2026 by agent
+  Email                : agent at local
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef QGSLABELPLACEMENTCACHE_H
+#define QGSLABELPLACEMENTCACHE_H
+
+#define SIP_NO_FILE
+
+#include "qgis_core.h"
+#include "qgsfeatureid.h"
+#include "qgsmaplayer.h"
+#include "qgsrectangle.h"
+
+#include <QHash>
+#include <QMutex>
+#include <QObject>
+#include <QSet>
+#include <QVector>
+
+/**
+ * \ingroup core
+ * \class QgsLabelPlacementCache
+ * \brief Stores the label positions solved by a QgsLabelingEngine, so that they can be reused
+ * by subsequent renders of an overlapping map extent at the same scale.
+ *
+ * When a labeling engine is given a placement cache, labels from the previous solution which
+ * lie entirely within both the previous and the current map extent are kept at their previous
+ * position, and only the remaining labels (e.g. those near newly exposed areas of the map) are
+ * placed from scratch. This makes panning much cheaper and keeps labels stable while panning.
+ *
+ * Cached placements are discarded when the map scale, CRS, rotation or labeling engine settings
+ * change, and all placements for a layer are discarded when the layer requests a repaint.
+ *
+ * The cache is thread safe.
+ *
+ * \note not available in Python bindings
+ * \since QGIS 3.10
+ */
+class CORE_EXPORT QgsLabelPlacementCache : public QObject
+{
+    Q_OBJECT
+
+  public:
+
+    //! A single solved label position, in map coordinates
+    struct Placement
+    {
+      //! X coordinate of the label's bottom left corner, before any upside-down correction
+      double x = 0;
+      //! Y coordinate of the label's bottom left corner, before any upside-down correction
+      double y = 0;
+      //! Label width
+      double width = 0;
+      //! Label height
+      double height = 0;
+      //! Label angle in radians, before any upside-down correction
+      double angle = 0;
+      //! TRUE if the label is reversed
+      bool reversed = false;
+      //! Relative position of label to feature (a pal::LabelPosition::Quadrant value)
+      int quadrant = 0;
+      //! Label bounding box
+      QgsRectangle boundingBox;
+    };
+
+    //! Placements of a provider's labels, by feature ID
+    typedef QHash< QgsFeatureId, QVector< Placement > > ProviderPlacements;
+
+    //! Constructor for QgsLabelPlacementCache
+    QgsLabelPlacementCache();
+
+    /**
+     * Removes all cached placements.
+     */
+    void clear();
+
+    /**
+     * Returns the cached placements for all providers, by provider key, if they were solved
+     * using the specified \a contextKey. An empty hash is returned if there are no compatible
+     * cached placements.
+     *
+     * \param contextKey identifies the map settings affecting label placement
+     * \param extent will be set to the map extent which the placements were solved for
+     */
+    QHash< QString, ProviderPlacements > placements( const QString &contextKey, QgsRectangle &extent ) const;
+
+    /**
+     * Replaces the contents of the cache with a new labeling solution.
+     *
+     * \param contextKey identifies the map settings affecting label placement
+     * \param extent map extent which the placements were solved for
+     * \param placements solved placements, by provider key
+     * \param providerLayers layers associated with each provider key. Placements for a provider
+     * are discarded whenever its layer requests a repaint.
+     */
+    void setPlacements( const QString &contextKey, const QgsRectangle &extent,
+                        const QHash< QString, ProviderPlacements > &placements,
+                        const QHash< QString, QgsMapLayer * > &providerLayers );
+
+  private slots:
+
+    //! Removes placements for the layer that emitted the signal
+    void layerRequestedRepaint();
+
+  private:
+
+    //! Disconnects from all layers (without locking)
+    void disconnectLayers();
+
+    mutable QMutex mMutex;
+    QString mContextKey;
+    QgsRectangle mExtent;
+    QHash< QString, ProviderPlacements > mPlacements;
+    QHash< QString, QgsWeakMapLayerPointer > mProviderLayers;
+    QSet< QgsWeakMapLayerPointer > mConnectedLayers;
+};
+
+#endif // QGSLABELPLACEMENTCACHE_H
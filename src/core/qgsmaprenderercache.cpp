@@ -17,6 +17,21 @@
 
 #include "qgsmaplayer.h"
 #include "qgsmaplayerlistutils.h"
+#include "qgsvectorlayer.h"
+#include "qgsvectorlayereditbuffer.h"
+#include "qgsrendercontext.h"
+#include "qgscsexception.h"
+#include "qgsrenderer.h"
+#include "qgscategorizedsymbolrenderer.h"
+#include "qgsgraduatedsymbolrenderer.h"
+#include "qgsrulebasedrenderer.h"
+#include "qgssymbol.h"
+#include "qgssymbollayer.h"
+#include "qgspainteffect.h"
+#include "qgsexpression.h"
+#include "qgsexpressionfunction.h"
+
+#include <cmath>
 
 QgsMapRendererCache::QgsMapRendererCache()
 {
@@ -41,11 +56,22 @@ void QgsMapRendererCache::clearInternal()
     if ( layer.data() )
     {
       disconnect( layer.data(), &QgsMapLayer::repaintRequested, this, &QgsMapRendererCache::layerRequestedRepaint );
-      disconnect( layer.data(), &QgsMapLayer::willBeDeleted, this, &QgsMapRendererCache::layerRequestedRepaint );
+      disconnect( layer.data(), &QgsMapLayer::willBeDeleted, this, &QgsMapRendererCache::layerChanged );
+      if ( QgsVectorLayer *vl = qobject_cast< QgsVectorLayer * >( layer.data() ) )
+        disconnect( vl, &QgsVectorLayer::editingStarted, this, &QgsMapRendererCache::layerChanged );
     }
   }
+  for ( const QgsWeakMapLayerPointer &layer : qgis::as_const( mEditTrackedLayers ) )
+  {
+    if ( layer.data() )
+      disconnectEditSignals( layer.data() );
+  }
   mCachedImages.clear();
   mConnectedLayers.clear();
+  mEditTrackedLayers.clear();
+  mLayersWithPendingEdits.clear();
+  mEditedFeatureBounds.clear();
+  mRenderedFeatureBounds.clear();
 }
 
 void QgsMapRendererCache::dropUnusedConnections()
@@ -58,11 +84,32 @@ void QgsMapRendererCache::dropUnusedConnections()
     if ( layer.data() )
     {
       disconnect( layer.data(), &QgsMapLayer::repaintRequested, this, &QgsMapRendererCache::layerRequestedRepaint );
-      disconnect( layer.data(), &QgsMapLayer::willBeDeleted, this, &QgsMapRendererCache::layerRequestedRepaint );
+      disconnect( layer.data(), &QgsMapLayer::willBeDeleted, this, &QgsMapRendererCache::layerChanged );
+      if ( QgsVectorLayer *vl = qobject_cast< QgsVectorLayer * >( layer.data() ) )
+        disconnect( vl, &QgsVectorLayer::editingStarted, this, &QgsMapRendererCache::layerChanged );
     }
   }
 
   mConnectedLayers = stillDepends;
+
+  // stop tracking edits to layers without any edit tracking image
+  QSet< QgsWeakMapLayerPointer > stillTracked;
+  for ( auto it = mCachedImages.constBegin(); it != mCachedImages.constEnd(); ++it )
+  {
+    if ( it.value().tracksEdits && !it.value().dependentLayers.isEmpty() && it.value().dependentLayers.at( 0 ).data() )
+      stillTracked << it.value().dependentLayers.at( 0 );
+  }
+  const QSet< QgsWeakMapLayerPointer > untracked = mEditTrackedLayers.subtract( stillTracked );
+  for ( const QgsWeakMapLayerPointer &layer : untracked )
+  {
+    if ( layer.data() )
+    {
+      disconnectEditSignals( layer.data() );
+      mEditedFeatureBounds.remove( layer->id() );
+      mRenderedFeatureBounds.remove( layer->id() );
+    }
+  }
+  mEditTrackedLayers = stillTracked;
 }
 
 QSet<QgsWeakMapLayerPointer > QgsMapRendererCache::dependentLayers() const
@@ -85,6 +132,9 @@ bool QgsMapRendererCache::init( const QgsRectangle &extent, double scale )
 {
   QMutexLocker lock( &mMutex );
 
+  // edits made since the previous render have already been accounted for
+  mLayersWithPendingEdits.clear();
+
   // check whether the params are the same
   if ( extent == mExtent &&
        qgsDoubleNear( scale, mScale ) )
@@ -116,7 +166,10 @@ void QgsMapRendererCache::setCacheImage( const QString &cacheKey, const QImage &
       if ( !mConnectedLayers.contains( QgsWeakMapLayerPointer( layer ) ) )
       {
         connect( layer, &QgsMapLayer::repaintRequested, this, &QgsMapRendererCache::layerRequestedRepaint );
-        connect( layer, &QgsMapLayer::willBeDeleted, this, &QgsMapRendererCache::layerRequestedRepaint );
+        connect( layer, &QgsMapLayer::willBeDeleted, this, &QgsMapRendererCache::layerChanged );
+        // images of vector layers are not kept up to date with edits, unless they are edit tracked
+        if ( QgsVectorLayer *vl = qobject_cast< QgsVectorLayer * >( layer ) )
+          connect( vl, &QgsVectorLayer::editingStarted, this, &QgsMapRendererCache::layerChanged );
         mConnectedLayers << layer;
       }
     }
@@ -125,6 +178,169 @@ void QgsMapRendererCache::setCacheImage( const QString &cacheKey, const QImage &
   mCachedImages[cacheKey] = params;
 }
 
+void QgsMapRendererCache::setVectorLayerCacheImage( const QString &cacheKey, const QImage &image, QgsVectorLayer *layer, const QgsRenderContext &context )
+{
+  if ( !layer )
+  {
+    setCacheImage( cacheKey, image );
+    return;
+  }
+
+  QMutexLocker lock( &mMutex );
+
+  CacheParameters params;
+  params.cachedImage = image;
+  params.dependentLayers << layer;
+  params.tracksEdits = true;
+  params.transform = context.coordinateTransform();
+  params.mapToPixel = context.mapToPixel();
+
+  if ( !mConnectedLayers.contains( QgsWeakMapLayerPointer( layer ) ) )
+  {
+    connect( layer, &QgsMapLayer::repaintRequested, this, &QgsMapRendererCache::layerRequestedRepaint );
+    connect( layer, &QgsMapLayer::willBeDeleted, this, &QgsMapRendererCache::layerChanged );
+    connect( layer, &QgsVectorLayer::editingStarted, this, &QgsMapRendererCache::layerChanged );
+    mConnectedLayers << layer;
+  }
+  if ( !mEditTrackedLayers.contains( QgsWeakMapLayerPointer( layer ) ) )
+  {
+    connectEditSignals( layer );
+  }
+
+  mCachedImages[cacheKey] = params;
+}
+
+void QgsMapRendererCache::addRenderedFeatureBounds( QgsVectorLayer *layer, const QMap<QgsFeatureId, QgsRectangle> &bounds )
+{
+  if ( !layer )
+    return;
+
+  QMutexLocker lock( &mMutex );
+  if ( !mEditTrackedLayers.contains( QgsWeakMapLayerPointer( layer ) ) )
+    return;
+
+  QHash< QgsFeatureId, QgsRectangle > &renderedBounds = mRenderedFeatureBounds[ layer->id() ];
+  for ( auto it = bounds.constBegin(); it != bounds.constEnd(); ++it )
+    renderedBounds.insert( it.key(), it.value() );
+}
+
+///@cond PRIVATE
+
+//! Returns TRUE if \a expression calls an aggregate function, i.e. depends on other features
+static bool usesAggregates( const QString &expression )
+{
+  if ( expression.isEmpty() )
+    return false;
+
+  const QSet< QString > functions = QgsExpression( expression ).referencedFunctions();
+  for ( const QString &function : functions )
+  {
+    const int index = QgsExpression::functionIndex( function );
+    if ( index >= 0 && QgsExpression::Functions().at( index )->groups().contains( QStringLiteral( "Aggregates" ) ) )
+      return true;
+  }
+  return false;
+}
+
+/**
+ * Returns the maximum distance (in painter units) by which \a symbol extends beyond the
+ * bounding box of a feature, or -1 if the rendering of the symbol can't be predicted.
+ */
+static double symbolBleed( QgsSymbol *symbol, const QgsRenderContext &context )
+{
+  double bleed = 0;
+  const QgsSymbolLayerList layers = symbol->symbolLayers();
+  for ( QgsSymbolLayer *layer : layers )
+  {
+    if ( layer->layerType() == QLatin1String( "GeometryGenerator" )
+         || ( layer->paintEffect() && layer->paintEffect()->enabled() )
+         || layer->dataDefinedProperties().hasActiveProperties() )
+      return -1;
+
+    double layerBleed = layer->estimateMaxBleed( context );
+    if ( const QgsMarkerSymbolLayer *marker = dynamic_cast< const QgsMarkerSymbolLayer * >( layer ) )
+    {
+      // allow for any marker rotation
+      layerBleed += context.convertToPainterUnits( marker->size(), marker->sizeUnit(), marker->sizeMapUnitScale() ) * M_SQRT2 / 2.0
+                    + context.convertToPainterUnits( std::sqrt( marker->offset().x() * marker->offset().x() + marker->offset().y() * marker->offset().y() ),
+                        marker->offsetUnit(), marker->offsetMapUnitScale() );
+    }
+    else if ( const QgsLineSymbolLayer *line = dynamic_cast< const QgsLineSymbolLayer * >( layer ) )
+    {
+      layerBleed = std::max( layerBleed, context.convertToPainterUnits( line->width() / 2.0, line->widthUnit(), line->widthMapUnitScale() )
+                             + context.convertToPainterUnits( std::fabs( line->offset() ), line->offsetUnit(), line->offsetMapUnitScale() ) );
+    }
+
+    if ( QgsSymbol *subSymbol = layer->subSymbol() )
+    {
+      const double subSymbolBleed = symbolBleed( subSymbol, context );
+      if ( subSymbolBleed < 0 )
+        return -1;
+      layerBleed += subSymbolBleed;
+    }
+
+    bleed = std::max( bleed, layerBleed );
+  }
+  return bleed;
+}
+
+///@endcond
+
+bool QgsMapRendererCache::canTrackEdits( QgsVectorLayer *layer, const QgsRenderContext &context )
+{
+  QgsFeatureRenderer *renderer = layer ? layer->renderer() : nullptr;
+  if ( !renderer )
+    return false;
+
+  // renderers which draw features depending on other features
+  const QString type = renderer->type();
+  if ( type == QLatin1String( "pointCluster" ) || type == QLatin1String( "pointDisplacement" )
+       || type == QLatin1String( "heatmapRenderer" ) || type == QLatin1String( "invertedPolygonRenderer" ) )
+    return false;
+
+  if ( renderer->paintEffect() && renderer->paintEffect()->enabled() )
+    return false;
+
+  if ( usesAggregates( renderer->filter( layer->fields() ) ) )
+    return false;
+  if ( const QgsCategorizedSymbolRenderer *categorized = dynamic_cast< const QgsCategorizedSymbolRenderer * >( renderer ) )
+  {
+    if ( usesAggregates( categorized->classAttribute() ) )
+      return false;
+  }
+  else if ( const QgsGraduatedSymbolRenderer *graduated = dynamic_cast< const QgsGraduatedSymbolRenderer * >( renderer ) )
+  {
+    if ( usesAggregates( graduated->classAttribute() ) )
+      return false;
+  }
+  else if ( QgsRuleBasedRenderer *ruleBased = dynamic_cast< QgsRuleBasedRenderer * >( renderer ) )
+  {
+    const QgsRuleBasedRenderer::RuleList rules = ruleBased->rootRule()->descendants();
+    for ( const QgsRuleBasedRenderer::Rule *rule : rules )
+    {
+      if ( usesAggregates( rule->filterExpression() ) )
+        return false;
+    }
+  }
+
+  // the dirty tiles must cover the whole symbol of edited features
+  QgsRenderContext symbolContext( context );
+  const QgsSymbolList symbols = renderer->symbols( symbolContext );
+  for ( QgsSymbol *symbol : symbols )
+  {
+    const double bleed = symbolBleed( symbol, symbolContext );
+    if ( bleed < 0 || bleed > DIRTY_TILE_SIZE )
+      return false;
+  }
+  return true;
+}
+
+QRegion QgsMapRendererCache::cacheImageDirtyRegion( const QString &cacheKey ) const
+{
+  QMutexLocker lock( &mMutex );
+  return mCachedImages.value( cacheKey ).dirtyRegion;
+}
+
 bool QgsMapRendererCache::hasCacheImage( const QString &cacheKey ) const
 {
   return mCachedImages.contains( cacheKey );
@@ -153,6 +369,96 @@ void QgsMapRendererCache::layerRequestedRepaint()
 
   QMutexLocker lock( &mMutex );
 
+  if ( mLayersWithPendingEdits.contains( QgsWeakMapLayerPointer( layer ) ) )
+  {
+    // the repaint follows edits, which have already invalidated the affected parts of the
+    // edit tracking images. Only the remaining images depending on the layer must be cleared
+    mLayersWithPendingEdits.remove( QgsWeakMapLayerPointer( layer ) );
+    for ( auto it = mCachedImages.begin(); it != mCachedImages.end(); )
+    {
+      if ( it.value().tracksEdits || !it.value().dependentLayers.contains( layer ) )
+      {
+        ++it;
+        continue;
+      }
+
+      it = mCachedImages.erase( it );
+    }
+    dropUnusedConnections();
+    return;
+  }
+
+  invalidateLayer( layer );
+}
+
+void QgsMapRendererCache::layerChanged()
+{
+  QgsMapLayer *layer = qobject_cast<QgsMapLayer *>( sender() );
+  if ( !layer )
+    return;
+
+  QMutexLocker lock( &mMutex );
+  invalidateLayer( layer );
+}
+
+void QgsMapRendererCache::layerGeometryChanged( QgsFeatureId fid, const QgsGeometry &geometry )
+{
+  QgsVectorLayer *layer = qobject_cast<QgsVectorLayer *>( sender() );
+  if ( !layer )
+    return;
+
+  QgsRectangle bounds;
+  if ( previousFeatureBounds( layer, fid, bounds ) )
+    markDirty( layer, bounds );
+  if ( !geometry.isNull() )
+    markDirty( layer, geometry.boundingBox() );
+  setFeatureBounds( layer, fid, geometry );
+}
+
+void QgsMapRendererCache::layerFeatureAdded( QgsFeatureId fid )
+{
+  QgsVectorLayer *layer = qobject_cast<QgsVectorLayer *>( sender() );
+  if ( !layer )
+    return;
+
+  // added features are always held by the edit buffer
+  const QgsFeature feature = layer->editBuffer() ? layer->editBuffer()->addedFeatures().value( fid ) : QgsFeature();
+  if ( !feature.hasGeometry() )
+    return;
+
+  markDirty( layer, feature.geometry().boundingBox() );
+  setFeatureBounds( layer, fid, feature.geometry() );
+}
+
+void QgsMapRendererCache::layerFeatureDeleted( QgsFeatureId fid )
+{
+  QgsVectorLayer *layer = qobject_cast<QgsVectorLayer *>( sender() );
+  if ( !layer )
+    return;
+
+  QgsRectangle bounds;
+  if ( previousFeatureBounds( layer, fid, bounds ) )
+    markDirty( layer, bounds );
+  setFeatureBounds( layer, fid, QgsGeometry() );
+}
+
+void QgsMapRendererCache::layerAttributeValueChanged( QgsFeatureId fid )
+{
+  QgsVectorLayer *layer = qobject_cast<QgsVectorLayer *>( sender() );
+  if ( !layer )
+    return;
+
+  // the feature's symbol may change, but its geometry is unchanged. Features which were
+  // not drawn may have been filtered out by the renderer, and become visible
+  QgsRectangle bounds;
+  if ( previousFeatureBounds( layer, fid, bounds ) )
+    markDirty( layer, bounds );
+  else
+    markAllDirty( layer );
+}
+
+void QgsMapRendererCache::invalidateLayer( QgsMapLayer *layer )
+{
   // check through all cached images to clear any which depend on this layer
   QMap<QString, CacheParameters>::iterator it = mCachedImages.begin();
   for ( ; it != mCachedImages.end(); )
@@ -165,9 +471,158 @@ void QgsMapRendererCache::layerRequestedRepaint()
 
     it = mCachedImages.erase( it );
   }
+  mLayersWithPendingEdits.remove( QgsWeakMapLayerPointer( layer ) );
   dropUnusedConnections();
 }
 
+void QgsMapRendererCache::markDirty( QgsMapLayer *layer, const QgsRectangle &bounds )
+{
+  QMutexLocker lock( &mMutex );
+
+  for ( auto it = mCachedImages.begin(); it != mCachedImages.end(); ++it )
+  {
+    CacheParameters &params = it.value();
+    if ( !params.tracksEdits || !params.dependentLayers.contains( layer ) )
+      continue;
+
+    const QRect imageRect( QPoint( 0, 0 ), params.cachedImage.size() / params.cachedImage.devicePixelRatio() );
+
+    QgsRectangle mapBounds = bounds;
+    if ( params.transform.isValid() )
+    {
+      try
+      {
+        mapBounds = params.transform.transformBoundingBox( bounds );
+      }
+      catch ( QgsCsException & )
+      {
+        params.dirtyRegion = QRegion( imageRect );
+        continue;
+      }
+    }
+
+    const QgsPointXY topLeft = params.mapToPixel.transform( mapBounds.xMinimum(), mapBounds.yMaximum() );
+    const QgsPointXY bottomRight = params.mapToPixel.transform( mapBounds.xMaximum(), mapBounds.yMinimum() );
+    if ( bottomRight.x() < -DIRTY_TILE_SIZE || bottomRight.y() < -DIRTY_TILE_SIZE
+         || topLeft.x() > imageRect.width() + DIRTY_TILE_SIZE || topLeft.y() > imageRect.height() + DIRTY_TILE_SIZE )
+      continue;
+
+    // symbols extend beyond the bounding box of their feature, so the neighboring tiles are invalidated too
+    const int left = static_cast< int >( std::floor( std::max( topLeft.x(), -1.0 ) / DIRTY_TILE_SIZE ) ) - 1;
+    const int top = static_cast< int >( std::floor( std::max( topLeft.y(), -1.0 ) / DIRTY_TILE_SIZE ) ) - 1;
+    const int right = static_cast< int >( std::floor( std::min( bottomRight.x(), imageRect.width() + 1.0 ) / DIRTY_TILE_SIZE ) ) + 1;
+    const int bottom = static_cast< int >( std::floor( std::min( bottomRight.y(), imageRect.height() + 1.0 ) / DIRTY_TILE_SIZE ) ) + 1;
+    const QRect tiles( left * DIRTY_TILE_SIZE, top * DIRTY_TILE_SIZE, ( right - left + 1 ) * DIRTY_TILE_SIZE, ( bottom - top + 1 ) * DIRTY_TILE_SIZE );
+    params.dirtyRegion += tiles.intersected( imageRect );
+  }
+
+  mLayersWithPendingEdits << layer;
+}
+
+void QgsMapRendererCache::markAllDirty( QgsMapLayer *layer )
+{
+  QMutexLocker lock( &mMutex );
+
+  for ( auto it = mCachedImages.begin(); it != mCachedImages.end(); ++it )
+  {
+    CacheParameters &params = it.value();
+    if ( params.tracksEdits && params.dependentLayers.contains( layer ) )
+      params.dirtyRegion = QRegion( QRect( QPoint( 0, 0 ), params.cachedImage.size() / params.cachedImage.devicePixelRatio() ) );
+  }
+
+  mLayersWithPendingEdits << layer;
+}
+
+bool QgsMapRendererCache::previousFeatureBounds( QgsVectorLayer *layer, QgsFeatureId fid, QgsRectangle &bounds ) const
+{
+  QMutexLocker lock( &mMutex );
+
+  // bounds of edited features are kept up to date by the edit signals, while the bounds
+  // recorded when rendering are only valid for features which were not edited since
+  const QHash< QgsFeatureId, QgsRectangle > editedBounds = mEditedFeatureBounds.value( layer->id() );
+  auto it = editedBounds.constFind( fid );
+  if ( it != editedBounds.constEnd() )
+  {
+    bounds = it.value();
+    return true;
+  }
+
+  const QHash< QgsFeatureId, QgsRectangle > renderedBounds = mRenderedFeatureBounds.value( layer->id() );
+  it = renderedBounds.constFind( fid );
+  if ( it != renderedBounds.constEnd() )
+  {
+    bounds = it.value();
+    return true;
+  }
+
+  return false;
+}
+
+void QgsMapRendererCache::setFeatureBounds( QgsVectorLayer *layer, QgsFeatureId fid, const QgsGeometry &geometry )
+{
+  QMutexLocker lock( &mMutex );
+  if ( !mEditTrackedLayers.contains( QgsWeakMapLayerPointer( layer ) ) )
+    return;
+
+  if ( geometry.isNull() )
+  {
+    mEditedFeatureBounds[ layer->id() ].remove( fid );
+    mRenderedFeatureBounds[ layer->id() ].remove( fid );
+  }
+  else
+  {
+    mEditedFeatureBounds[ layer->id() ].insert( fid, geometry.boundingBox() );
+  }
+}
+
+void QgsMapRendererCache::connectEditSignals( QgsVectorLayer *layer )
+{
+  connect( layer, &QgsVectorLayer::geometryChanged, this, &QgsMapRendererCache::layerGeometryChanged );
+  connect( layer, &QgsVectorLayer::featureAdded, this, &QgsMapRendererCache::layerFeatureAdded );
+  connect( layer, &QgsVectorLayer::featureDeleted, this, &QgsMapRendererCache::layerFeatureDeleted );
+  connect( layer, &QgsVectorLayer::attributeValueChanged, this, &QgsMapRendererCache::layerAttributeValueChanged );
+  // changes which affect all features
+  connect( layer, &QgsVectorLayer::selectionChanged, this, &QgsMapRendererCache::layerChanged );
+  connect( layer, &QgsMapLayer::styleChanged, this, &QgsMapRendererCache::layerChanged );
+  connect( layer, &QgsVectorLayer::editingStopped, this, &QgsMapRendererCache::layerChanged );
+  mEditTrackedLayers << layer;
+
+  // features which were edited before tracking started
+  mRenderedFeatureBounds.remove( layer->id() );
+  QHash< QgsFeatureId, QgsRectangle > &bounds = mEditedFeatureBounds[ layer->id() ];
+  bounds.clear();
+  if ( const QgsVectorLayerEditBuffer *buffer = layer->editBuffer() )
+  {
+    const QgsGeometryMap changedGeometries = buffer->changedGeometries();
+    for ( auto it = changedGeometries.constBegin(); it != changedGeometries.constEnd(); ++it )
+    {
+      if ( !it.value().isNull() )
+        bounds.insert( it.key(), it.value().boundingBox() );
+    }
+    const QgsFeatureMap addedFeatures = buffer->addedFeatures();
+    for ( auto it = addedFeatures.constBegin(); it != addedFeatures.constEnd(); ++it )
+    {
+      if ( it.value().hasGeometry() )
+        bounds.insert( it.key(), it.value().geometry().boundingBox() );
+    }
+  }
+}
+
+void QgsMapRendererCache::disconnectEditSignals( QgsMapLayer *layer )
+{
+  QgsVectorLayer *vl = qobject_cast< QgsVectorLayer * >( layer );
+  if ( !vl )
+    return;
+
+  disconnect( vl, &QgsVectorLayer::geometryChanged, this, &QgsMapRendererCache::layerGeometryChanged );
+  disconnect( vl, &QgsVectorLayer::featureAdded, this, &QgsMapRendererCache::layerFeatureAdded );
+  disconnect( vl, &QgsVectorLayer::featureDeleted, this, &QgsMapRendererCache::layerFeatureDeleted );
+  disconnect( vl, &QgsVectorLayer::attributeValueChanged, this, &QgsMapRendererCache::layerAttributeValueChanged );
+  disconnect( vl, &QgsVectorLayer::selectionChanged, this, &QgsMapRendererCache::layerChanged );
+  disconnect( vl, &QgsMapLayer::styleChanged, this, &QgsMapRendererCache::layerChanged );
+  disconnect( vl, &QgsVectorLayer::editingStopped, this, &QgsMapRendererCache::layerChanged );
+}
+
 void QgsMapRendererCache::clearCacheImage( const QString &cacheKey )
 {
   QMutexLocker lock( &mMutex );
@@ -20,9 +20,17 @@
 #include <QMap>
 #include <QImage>
 #include <QMutex>
+#include <QRegion>
 
 #include "qgsrectangle.h"
 #include "qgsmaplayer.h"
+#include "qgscoordinatetransform.h"
+#include "qgsmaptopixel.h"
+#include "qgsfeatureid.h"
+#include "qgsgeometry.h"
+
+class QgsVectorLayer;
+class QgsRenderContext;
 
 
 /**
@@ -35,6 +43,12 @@
  * If triggered, the cache removes the rendered image (and disconnects from the
  * layers).
  *
+ * Images of vector layers stored using setVectorLayerCacheImage() are not
+ * discarded when the layer is edited. Instead, only the tiles of the image
+ * which are affected by the edited features are marked as dirty (see
+ * cacheImageDirtyRegion()), so that a subsequent render only needs to
+ * redraw these parts of the layer.
+ *
  * The class is thread-safe (multiple classes can access the same instance safely).
  *
  * \since QGIS 2.4
@@ -69,6 +83,71 @@ class CORE_EXPORT QgsMapRendererCache : public QObject
      */
     void setCacheImage( const QString &cacheKey, const QImage &image, const QList< QgsMapLayer * > &dependentLayers = QList< QgsMapLayer * >() );
 
+    /**
+     * Set the cached \a image for a particular \a cacheKey, which is a render of
+     * a vector \a layer using the specified render \a context.
+     *
+     * Unlike setCacheImage(), edits to the layer's features do not discard the
+     * image. Instead, the tiles of the image covering the previous and new
+     * bounding boxes of the edited features are marked as dirty, and must be
+     * redrawn before the image is used (see cacheImageDirtyRegion()). Any other
+     * repaint request from the layer discards the image.
+     *
+     * The \a context must not be rotated, and the layer's symbology must allow
+     * edit tracking (see canTrackEdits()).
+     *
+     * The bounding boxes of the features drawn into the image should be passed
+     * to addRenderedFeatureBounds(), so that the previous location of edited
+     * features is known without fetching them from the layer's data provider.
+     *
+     * \see setCacheImage()
+     * \see addRenderedFeatureBounds()
+     * \since QGIS 3.10
+     */
+    void setVectorLayerCacheImage( const QString &cacheKey, const QImage &image, QgsVectorLayer *layer, const QgsRenderContext &context );
+
+    /**
+     * Records the bounding boxes \a bounds (in layer CRS, by feature ID) of features of a vector
+     * \a layer which were drawn into its edit tracking images.
+     *
+     * When such a feature is edited, the tiles covering its recorded bounds are marked
+     * as dirty. Edits to features without recorded bounds only invalidate the tiles
+     * covering their new location, as they were not drawn into the image.
+     *
+     * \see setVectorLayerCacheImage()
+     * \since QGIS 3.10
+     */
+    void addRenderedFeatureBounds( QgsVectorLayer *layer, const QMap< QgsFeatureId, QgsRectangle > &bounds );
+
+    /**
+     * Returns TRUE if the cached images of a vector \a layer rendered with the specified
+     * \a context can be partially invalidated when the layer is edited.
+     *
+     * This requires that each feature only affects the tiles around its own bounding
+     * box. Renderers which draw features depending on other features (e.g. point cluster,
+     * point displacement, heatmap and inverted polygon renderers, or renderers using
+     * aggregate expressions), symbology with paint effects, geometry generators or data
+     * defined properties, and symbols extending more than DIRTY_TILE_SIZE pixels beyond
+     * their feature's bounding box do not qualify.
+     *
+     * \see setVectorLayerCacheImage()
+     * \since QGIS 3.10
+     */
+    static bool canTrackEdits( QgsVectorLayer *layer, const QgsRenderContext &context );
+
+    /**
+     * Returns the region of the cached image for the specified \a cacheKey which
+     * is outdated, in logical pixels (i.e. not accounting for the image's device
+     * pixel ratio).
+     *
+     * The region is always empty for images which were not set using
+     * setVectorLayerCacheImage(), or which are not affected by any edit.
+     *
+     * \see setVectorLayerCacheImage()
+     * \since QGIS 3.10
+     */
+    QRegion cacheImageDirtyRegion( const QString &cacheKey ) const;
+
     /**
      * Returns TRUE if the cache contains an image with the specified \a cacheKey.
      * \see cacheImage()
@@ -97,9 +176,25 @@ class CORE_EXPORT QgsMapRendererCache : public QObject
      */
     void clearCacheImage( const QString &cacheKey );
 
+    /**
+     * Size of the tiles by which cached vector layer images are invalidated, in logical pixels.
+     *
+     * Symbols of edit tracked layers extend at most by this size beyond the bounding box
+     * of their feature.
+     *
+     * \since QGIS 3.10
+     */
+    static const int DIRTY_TILE_SIZE = 128;
+
   private slots:
-    //! Remove layer (that emitted the signal) from the cache
+    //! Remove layer (that emitted the signal) from the cache, unless the repaint follows edits which have already been tracked
     void layerRequestedRepaint();
+    //! Remove layer (that emitted the signal) from the cache
+    void layerChanged();
+    void layerGeometryChanged( QgsFeatureId fid, const QgsGeometry &geometry );
+    void layerFeatureAdded( QgsFeatureId fid );
+    void layerFeatureDeleted( QgsFeatureId fid );
+    void layerAttributeValueChanged( QgsFeatureId fid );
 
   private:
 
@@ -107,6 +202,15 @@ class CORE_EXPORT QgsMapRendererCache : public QObject
     {
       QImage cachedImage;
       QgsWeakMapLayerPointerList dependentLayers;
+
+      //! TRUE if edits to the dependent layer only invalidate parts of the image
+      bool tracksEdits = false;
+      //! Transform from layer CRS to map CRS used for the render
+      QgsCoordinateTransform transform;
+      //! Map to pixel transform used for the render
+      QgsMapToPixel mapToPixel;
+      //! Outdated region of the image
+      QRegion dirtyRegion;
     };
 
     //! Invalidate cache contents (without locking)
@@ -117,6 +221,30 @@ class CORE_EXPORT QgsMapRendererCache : public QObject
 
     QSet< QgsWeakMapLayerPointer > dependentLayers() const;
 
+    //! Removes all images depending on \a layer (without locking)
+    void invalidateLayer( QgsMapLayer *layer );
+
+    //! Marks the parts of edit tracking images of \a layer covering \a bounds (in layer CRS) as dirty
+    void markDirty( QgsMapLayer *layer, const QgsRectangle &bounds );
+
+    //! Marks the whole edit tracking images of \a layer as dirty
+    void markAllDirty( QgsMapLayer *layer );
+
+    /**
+     * Retrieves the bounding box of a feature prior to the current edit, returning
+     * FALSE if the feature was not drawn into the edit tracking images.
+     */
+    bool previousFeatureBounds( QgsVectorLayer *layer, QgsFeatureId fid, QgsRectangle &bounds ) const;
+
+    //! Sets the current bounding box of a feature of an edit tracked layer
+    void setFeatureBounds( QgsVectorLayer *layer, QgsFeatureId fid, const QgsGeometry &geometry );
+
+    //! Connects to the edit signals of a layer (without locking)
+    void connectEditSignals( QgsVectorLayer *layer );
+
+    //! Disconnects from the edit signals of a layer (without locking)
+    void disconnectEditSignals( QgsMapLayer *layer );
+
     mutable QMutex mMutex;
     QgsRectangle mExtent;
     double mScale = 0;
@@ -125,6 +253,14 @@ class CORE_EXPORT QgsMapRendererCache : public QObject
     QMap<QString, CacheParameters> mCachedImages;
     //! List of all layers on which this cache is currently connected
     QSet< QgsWeakMapLayerPointer > mConnectedLayers;
+    //! List of all layers whose edit signals are currently connected
+    QSet< QgsWeakMapLayerPointer > mEditTrackedLayers;
+    //! Layers which have been edited since the last init() call
+    QSet< QgsWeakMapLayerPointer > mLayersWithPendingEdits;
+    //! Current bounding boxes of features edited since the cache started tracking edits, by layer ID
+    QHash< QString, QHash< QgsFeatureId, QgsRectangle > > mEditedFeatureBounds;
+    //! Bounding boxes of features drawn into the edit tracking images, by layer ID
+    QHash< QString, QHash< QgsFeatureId, QgsRectangle > > mRenderedFeatureBounds;
 };
 
 
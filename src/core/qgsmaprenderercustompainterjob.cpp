@@ -301,7 +301,8 @@ void QgsMapRendererCustomPainterJob::doRender()
       QTime layerTime;
       layerTime.start();
 
-      if ( job.img )
+      // keep any valid content of a partially cached image
+      if ( job.img && !job.imageInitialized )
       {
         job.img->fill( 0 );
         job.imageInitialized = true;
@@ -66,6 +66,11 @@ void QgsMapRendererJob::setCache( QgsMapRendererCache *cache )
   mCache = cache;
 }
 
+void QgsMapRendererJob::setLabelPlacementCache( QgsLabelPlacementCache *cache )
+{
+  mLabelPlacementCache = cache;
+}
+
 QHash<QgsMapLayer *, int> QgsMapRendererJob::perLayerRenderingTime() const
 {
   QHash<QgsMapLayer *, int> result;
@@ -277,19 +282,6 @@ LayerRenderJobs QgsMapRendererJob::prepareJobs( QPainter *painter, QgsLabelingEn
       continue;
     }
 
-    // Force render of layers that are being edited
-    // or if there's a labeling engine that needs the layer to register features
-    if ( mCache && ml->type() == QgsMapLayerType::VectorLayer )
-    {
-      QgsVectorLayer *vl = qobject_cast<QgsVectorLayer *>( ml );
-      bool requiresLabeling = false;
-      requiresLabeling = ( labelingEngine2 && QgsPalLabeling::staticWillUseLayer( vl ) ) && requiresLabelRedraw;
-      if ( vl->isEditable() || requiresLabeling )
-      {
-        mCache->clearCacheImage( ml->id() );
-      }
-    }
-
     layerJobs.append( LayerRenderJob() );
     LayerRenderJob &job = layerJobs.last();
     job.cached = false;
@@ -312,6 +304,20 @@ LayerRenderJobs QgsMapRendererJob::prepareJobs( QPainter *painter, QgsLabelingEn
     if ( mSettings.layerStyleOverrides().contains( ml->id() ) )
       styleOverride.setOverrideStyle( mSettings.layerStyleOverrides().value( ml->id() ) );
 
+    // Force render of layers that are being edited (unless the cache tracks their edits)
+    // or if there's a labeling engine that needs the layer to register features
+    if ( mCache && ml->type() == QgsMapLayerType::VectorLayer )
+    {
+      QgsVectorLayer *vl = qobject_cast<QgsVectorLayer *>( ml );
+      job.tracksEdits = vl->isEditable() && canTrackEdits() && QgsMapRendererCache::canTrackEdits( vl, job.context );
+      bool requiresLabeling = false;
+      requiresLabeling = ( labelingEngine2 && QgsPalLabeling::staticWillUseLayer( vl ) ) && requiresLabelRedraw;
+      if ( ( vl->isEditable() && !job.tracksEdits ) || requiresLabeling )
+      {
+        mCache->clearCacheImage( ml->id() );
+      }
+    }
+
     job.blendMode = ml->blendMode();
     job.opacity = 1.0;
     if ( QgsVectorLayer *vl = qobject_cast<QgsVectorLayer *>( ml ) )
@@ -320,21 +326,61 @@ LayerRenderJobs QgsMapRendererJob::prepareJobs( QPainter *painter, QgsLabelingEn
     }
 
     // if we can use the cache, let's do it and avoid rendering!
+    bool partiallyCached = false;
     if ( mCache && mCache->hasCacheImage( ml->id() ) )
     {
-      job.cached = true;
-      job.imageInitialized = true;
+      const QRegion dirtyRegion = mCache->cacheImageDirtyRegion( ml->id() );
+      if ( dirtyRegion.isEmpty() )
+      {
+        job.cached = true;
+        job.imageInitialized = true;
+        job.img = new QImage( mCache->cacheImage( ml->id() ) );
+        job.img->setDevicePixelRatio( static_cast<qreal>( mSettings.devicePixelRatio() ) );
+        job.renderer = nullptr;
+        job.context.setPainter( nullptr );
+        continue;
+      }
+
+      // only parts of the layer were edited since the image was cached, so just redraw
+      // the outdated tiles on top of the cached image
       job.img = new QImage( mCache->cacheImage( ml->id() ) );
       job.img->setDevicePixelRatio( static_cast<qreal>( mSettings.devicePixelRatio() ) );
-      job.renderer = nullptr;
-      job.context.setPainter( nullptr );
-      continue;
+      job.imageInitialized = true;
+      QPainter *mypPainter = new QPainter( job.img );
+      mypPainter->setCompositionMode( QPainter::CompositionMode_Clear );
+      for ( const QRect &rect : dirtyRegion )
+        mypPainter->fillRect( rect, Qt::transparent );
+      mypPainter->setCompositionMode( QPainter::CompositionMode_SourceOver );
+      mypPainter->setClipRegion( dirtyRegion );
+      mypPainter->setRenderHint( QPainter::Antialiasing, mSettings.testFlag( QgsMapSettings::Antialiasing ) );
+      job.context.setPainter( mypPainter );
+
+      const QRect dirtyRect = dirtyRegion.boundingRect();
+      const QgsPointXY dirtyMin = mSettings.mapToPixel().toMapCoordinates( dirtyRect.left(), dirtyRect.bottom() + 1 );
+      const QgsPointXY dirtyMax = mSettings.mapToPixel().toMapCoordinates( dirtyRect.right() + 1, dirtyRect.top() );
+      QgsRectangle dirtyExtent( dirtyMin, dirtyMax );
+      // features outside of the dirty tiles still draw into them, by up to the symbol bleed
+      // allowed by QgsMapRendererCache::canTrackEdits()
+      dirtyExtent.grow( std::max( mSettings.extentBuffer(), QgsMapRendererCache::DIRTY_TILE_SIZE * mSettings.mapUnitsPerPixel() ) );
+      if ( ct.isValid() )
+      {
+        try
+        {
+          dirtyExtent = ct.transformBoundingBox( dirtyExtent, QgsCoordinateTransform::ReverseTransform );
+        }
+        catch ( QgsCsException & )
+        {
+          dirtyExtent = r1;
+        }
+      }
+      job.context.setExtent( dirtyExtent );
+      partiallyCached = true;
     }
 
     // If we are drawing with an alternative blending mode then we need to render to a separate image
     // before compositing this on the map. This effectively flattens the layer and prevents
     // blending occurring between objects on the layer
-    if ( mCache || ( !painter && !deferredPainterSet ) || needTemporaryImage( ml ) )
+    if ( !partiallyCached && ( mCache || ( !painter && !deferredPainterSet ) || needTemporaryImage( ml ) ) )
     {
       // Flattened image for drawing when a blending mode is set
       QImage *mypFlattenedImage = new QImage( mSettings.deviceOutputSize(),
@@ -357,6 +403,12 @@ LayerRenderJobs QgsMapRendererJob::prepareJobs( QPainter *painter, QgsLabelingEn
     QTime layerTime;
     layerTime.start();
     job.renderer = ml->createMapRenderer( job.context );
+    if ( job.tracksEdits )
+    {
+      // the cache needs the location of the drawn features to invalidate the image when they are edited
+      if ( QgsVectorLayerRenderer *vlRenderer = dynamic_cast< QgsVectorLayerRenderer * >( job.renderer ) )
+        vlRenderer->setCollectFeatureBounds( true );
+    }
     job.renderingTime = layerTime.elapsed(); // include job preparation time in layer rendering time
   } // while (li.hasPrevious())
 
@@ -372,6 +424,9 @@ LabelRenderJob QgsMapRendererJob::prepareLabelingJob( QPainter *painter, QgsLabe
   job.context.setExtent( mSettings.visibleExtent() );
   job.context.setFeatureFilterProvider( mFeatureFilterProvider );
 
+  if ( labelingEngine2 )
+    labelingEngine2->setPlacementCache( mLabelPlacementCache );
+
   // if we can use the cache, let's do it and avoid rendering!
   bool hasCache = canUseLabelCache && mCache && mCache->hasCacheImage( LABEL_CACHE_ID );
   if ( hasCache )
@@ -420,7 +475,15 @@ void QgsMapRendererJob::cleanupJobs( LayerRenderJobs &jobs )
       if ( mCache && !job.cached && !job.context.renderingStopped() && job.layer )
       {
         QgsDebugMsgLevel( QStringLiteral( "caching image for %1" ).arg( job.layerId ), 2 );
-        mCache->setCacheImage( job.layerId, *job.img, QList< QgsMapLayer * >() << job.layer );
+        QgsVectorLayer *vl = qobject_cast< QgsVectorLayer * >( job.layer.data() );
+        if ( vl && job.tracksEdits )
+        {
+          mCache->setVectorLayerCacheImage( job.layerId, *job.img, vl, job.context );
+          if ( QgsVectorLayerRenderer *vlRenderer = dynamic_cast< QgsVectorLayerRenderer * >( job.renderer ) )
+            mCache->addRenderedFeatureBounds( vl, vlRenderer->renderedFeatureBounds() );
+        }
+        else
+          mCache->setCacheImage( job.layerId, *job.img, QList< QgsMapLayer * >() << job.layer );
       }
 
       delete job.img;
@@ -543,6 +606,11 @@ void QgsMapRendererJob::logRenderingTime( const LayerRenderJobs &jobs, const Lab
   QgsMessageLog::logMessage( QStringLiteral( "---" ), tr( "Rendering" ) );
 }
 
+bool QgsMapRendererJob::canTrackEdits() const
+{
+  return qgsDoubleNear( mSettings.rotation(), 0.0 );
+}
+
 bool QgsMapRendererJob::needTemporaryImage( QgsMapLayer *ml )
 {
   switch ( ml->type() )
@@ -33,6 +33,7 @@ class QgsLabelingEngine;
 class QgsLabelingResults;
 class QgsMapLayerRenderer;
 class QgsMapRendererCache;
+class QgsLabelPlacementCache;
 class QgsFeatureFilterProvider;
 
 #ifndef SIP_RUN
@@ -59,6 +60,8 @@ struct LayerRenderJob
   double opacity;
   //! If TRUE, img already contains cached image from previous rendering
   bool cached;
+  //! TRUE if the cached image of the layer is only partially invalidated when the layer is edited
+  bool tracksEdits = false;
   QgsWeakMapLayerPointer layer;
   int renderingTime; //!< Time it took to render the layer in ms (it is -1 if not rendered or still rendering)
   QStringList errors; //!< Rendering errors
@@ -216,6 +219,14 @@ class CORE_EXPORT QgsMapRendererJob : public QObject
      */
     void setCache( QgsMapRendererCache *cache );
 
+    /**
+     * Assign a cache to be used for reusing label placements between renders of
+     * overlapping map extents. Does not take ownership of the object.
+     * \note not available in Python bindings
+     * \since QGIS 3.10
+     */
+    void setLabelPlacementCache( QgsLabelPlacementCache *cache ) SIP_SKIP;
+
     /**
      * Returns the total time it took to finish the job (in milliseconds).
      * \see perLayerRenderingTime()
@@ -264,6 +275,8 @@ class CORE_EXPORT QgsMapRendererJob : public QObject
 
     QgsMapRendererCache *mCache = nullptr;
 
+    QgsLabelPlacementCache *mLabelPlacementCache = nullptr;
+
     int mRenderingTime = 0;
 
     //! Render time (in ms) per layer, by layer ID
@@ -340,6 +353,12 @@ class CORE_EXPORT QgsMapRendererJob : public QObject
 
     bool needTemporaryImage( QgsMapLayer *ml );
 
+    /**
+     * Returns TRUE if cached vector layer images can be partially invalidated when
+     * the layer is edited, which requires an unrotated map.
+     */
+    bool canTrackEdits() const;
+
     const QgsFeatureFilterProvider *mFeatureFilterProvider = nullptr;
 };
 
@@ -251,7 +251,8 @@ void QgsMapRendererParallelJob::renderLayerStatic( LayerRenderJob &job )
   if ( job.cached )
     return;
 
-  if ( job.img )
+  // partially cached images already contain the valid parts of the layer
+  if ( job.img && !job.imageInitialized )
   {
     job.img->fill( 0 );
     job.imageInitialized = true;
@@ -111,7 +111,7 @@ bool QgsMapRendererStagedRenderJob::renderCurrentPart( QPainter *painter )
       painter->setCompositionMode( job.blendMode );
     }
 
-    if ( job.img )
+    if ( job.img && !job.imageInitialized )
     {
       job.img->fill( 0 );
       job.imageInitialized = true;
@@ -0,0 +1,223 @@
+/***************************************************************************
+  qgspointpyramid.cpp
+  --------------------------------------
+  Date                 : October 2026
+  Copyright            : (C) 2026 by agent
+  Email                : agent at local
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qgspointpyramid.h"
+#include "qgsfeatureiterator.h"
+#include "qgsfeedback.h"
+#include "qgsgeometry.h"
+#include "qgspoint.h"
+
+#include <QtConcurrentRun>
+#include <cmath>
+
+std::unique_ptr<QgsPointPyramid> QgsPointPyramid::build( QgsFeatureIterator &iterator, const QgsRectangle &extent, QgsFeedback *feedback )
+{
+  if ( extent.isNull() || !extent.isFinite() )
+    return nullptr;
+
+  const double size = std::max( extent.width(), extent.height() );
+  if ( size <= 0 )
+    return nullptr;
+
+  std::unique_ptr< QgsPointPyramid > pyramid = qgis::make_unique< QgsPointPyramid >();
+  pyramid->mOrigin = QgsPointXY( extent.xMinimum(), extent.yMinimum() );
+
+  Level level;
+  level.cellSize = size / BASE_RESOLUTION;
+
+  QgsFeature feature;
+  while ( iterator.nextFeature( feature ) )
+  {
+    if ( feedback && feedback->isCanceled() )
+      return nullptr;
+
+    if ( !feature.hasGeometry() )
+      continue;
+
+    const QgsPoint *point = qgsgeometry_cast< const QgsPoint * >( feature.geometry().constGet() );
+    if ( !point )
+      continue;
+
+    // points outside of a stale layer extent are added to the border cells
+    const int column = qBound( 0, static_cast< int >( std::floor( ( point->x() - pyramid->mOrigin.x() ) / level.cellSize ) ), BASE_RESOLUTION );
+    const int row = qBound( 0, static_cast< int >( std::floor( ( point->y() - pyramid->mOrigin.y() ) / level.cellSize ) ), BASE_RESOLUTION );
+
+    Cell &cell = level.cells[ cellKey( column, row ) ];
+    if ( cell.count == 0 )
+      cell.representativeId = feature.id();
+    cell.count++;
+    pyramid->mPointCount++;
+  }
+
+  // merge each group of 2x2 cells to form the next coarser level
+  while ( true )
+  {
+    if ( pyramid->mPointCount >= level.cells.size() * MIN_AGGREGATION_RATIO )
+      pyramid->mLevels << level;
+
+    if ( level.cells.size() <= 1 )
+      break;
+
+    Level coarser;
+    coarser.cellSize = level.cellSize * 2;
+    coarser.cells.reserve( level.cells.size() / 2 );
+    for ( auto it = level.cells.constBegin(); it != level.cells.constEnd(); ++it )
+    {
+      const int column = static_cast< int >( it.key() >> 32 );
+      const int row = static_cast< int >( static_cast< quint32 >( it.key() & 0xffffffff ) );
+      Cell &cell = coarser.cells[ cellKey( column / 2, row / 2 ) ];
+      if ( cell.count == 0 )
+        cell.representativeId = it.value().representativeId;
+      cell.count += it.value().count;
+    }
+    level = std::move( coarser );
+  }
+
+  return pyramid;
+}
+
+double QgsPointPyramid::cellSize( int level ) const
+{
+  return mLevels.value( level ).cellSize;
+}
+
+int QgsPointPyramid::levelForCellSize( double maximumCellSize ) const
+{
+  for ( int level = mLevels.size() - 1; level >= 0; --level )
+  {
+    if ( mLevels.at( level ).cellSize <= maximumCellSize )
+      return level;
+  }
+  return -1;
+}
+
+QVector<QgsPointPyramid::Cell> QgsPointPyramid::cells( int level, const QgsRectangle &extent ) const
+{
+  QVector< Cell > result;
+  if ( level < 0 || level >= mLevels.size() )
+    return result;
+
+  const Level &l = mLevels.at( level );
+  const double minColumn = std::floor( ( extent.xMinimum() - mOrigin.x() ) / l.cellSize );
+  const double maxColumn = std::floor( ( extent.xMaximum() - mOrigin.x() ) / l.cellSize );
+  const double minRow = std::floor( ( extent.yMinimum() - mOrigin.y() ) / l.cellSize );
+  const double maxRow = std::floor( ( extent.yMaximum() - mOrigin.y() ) / l.cellSize );
+  if ( maxColumn < 0 || maxRow < 0 || minColumn > BASE_RESOLUTION || minRow > BASE_RESOLUTION )
+    return result;
+
+  const int column0 = static_cast< int >( std::max( minColumn, 0.0 ) );
+  const int column1 = static_cast< int >( std::min( maxColumn, static_cast< double >( BASE_RESOLUTION ) ) );
+  const int row0 = static_cast< int >( std::max( minRow, 0.0 ) );
+  const int row1 = static_cast< int >( std::min( maxRow, static_cast< double >( BASE_RESOLUTION ) ) );
+
+  const qint64 rangeSize = static_cast< qint64 >( column1 - column0 + 1 ) * ( row1 - row0 + 1 );
+  if ( rangeSize > l.cells.size() )
+  {
+    // cheaper to scan all non-empty cells
+    for ( auto it = l.cells.constBegin(); it != l.cells.constEnd(); ++it )
+    {
+      const int column = static_cast< int >( it.key() >> 32 );
+      const int row = static_cast< int >( static_cast< quint32 >( it.key() & 0xffffffff ) );
+      if ( column >= column0 && column <= column1 && row >= row0 && row <= row1 )
+        result << it.value();
+    }
+  }
+  else
+  {
+    for ( int column = column0; column <= column1; ++column )
+    {
+      for ( int row = row0; row <= row1; ++row )
+      {
+        auto it = l.cells.constFind( cellKey( column, row ) );
+        if ( it != l.cells.constEnd() )
+          result << it.value();
+      }
+    }
+  }
+  return result;
+}
+
+std::shared_ptr<const QgsPointPyramid> QgsPointPyramidStore::pyramid( int &generation ) const
+{
+  QMutexLocker locker( &mMutex );
+  generation = mGeneration;
+  return mPyramid;
+}
+
+void QgsPointPyramidStore::setPyramid( std::shared_ptr<const QgsPointPyramid> pyramid, int generation )
+{
+  QMutexLocker locker( &mMutex );
+  if ( generation != mGeneration )
+    return;
+
+  mPyramid = pyramid;
+}
+
+void QgsPointPyramidStore::buildInBackground( QgsAbstractFeatureSource *source, const QgsRectangle &extent )
+{
+  std::shared_ptr< QgsAbstractFeatureSource > featureSource( source );
+
+  QMutexLocker locker( &mMutex );
+  if ( mPyramid || mBuildGeneration == mGeneration )
+    return;
+
+  const int generation = mGeneration;
+  std::shared_ptr< QgsFeedback > feedback = std::make_shared< QgsFeedback >();
+  mBuildGeneration = generation;
+  mBuildFeedback = feedback;
+
+  // the task keeps the store alive until it is complete
+  std::shared_ptr< QgsPointPyramidStore > store = shared_from_this();
+  mBuild = QtConcurrent::run( [store, featureSource, extent, generation, feedback]
+  {
+    QgsFeatureIterator it = featureSource->getFeatures( QgsFeatureRequest().setNoAttributes() );
+    it.setInterruptionChecker( feedback.get() );
+    std::shared_ptr< const QgsPointPyramid > pyramid = QgsPointPyramid::build( it, extent, feedback.get() );
+    store->finishBuild( pyramid, generation );
+  } );
+}
+
+void QgsPointPyramidStore::finishBuild( std::shared_ptr<const QgsPointPyramid> pyramid, int generation )
+{
+  QMutexLocker locker( &mMutex );
+  if ( generation == mBuildGeneration )
+  {
+    mBuildGeneration = -1;
+    mBuildFeedback.reset();
+  }
+  if ( pyramid && generation == mGeneration )
+    mPyramid = pyramid;
+}
+
+void QgsPointPyramidStore::waitForBuild()
+{
+  QFuture< void > build;
+  {
+    QMutexLocker locker( &mMutex );
+    build = mBuild;
+  }
+  build.waitForFinished();
+}
+
+void QgsPointPyramidStore::invalidate()
+{
+  QMutexLocker locker( &mMutex );
+  mGeneration++;
+  mPyramid.reset();
+  if ( mBuildFeedback )
+    mBuildFeedback->cancel();
+  mBuildFeedback.reset();
+  mBuildGeneration = -1;
+}
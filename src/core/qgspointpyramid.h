@@ -0,0 +1,194 @@
+/***************************************************************************
+  qgspointpyramid.h
+  --------------------------------------
+  Date                 : October 2026
+  Copyright            : (C) 2026 by agent
+  Email                : agent at local
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef QGSPOINTPYRAMID_H
+#define QGSPOINTPYRAMID_H
+
+#define SIP_NO_FILE
+
+#include "qgis_core.h"
+#include "qgsfeatureid.h"
+#include "qgspointxy.h"
+#include "qgsrectangle.h"
+
+#include <QHash>
+#include <QMutex>
+#include <QVector>
+#include <QFuture>
+#include <memory>
+
+class QgsFeatureIterator;
+class QgsFeedback;
+class QgsAbstractFeatureSource;
+
+/**
+ * \ingroup core
+ * \class QgsPointPyramid
+ * \brief A multi-resolution aggregation of the features of a point layer.
+ *
+ * Each level of the pyramid divides the layer extent into a regular grid of square cells,
+ * with the cell size doubling from one level to the next. Each non-empty cell stores the
+ * number of points it contains, together with a single representative feature.
+ *
+ * When a layer is rendered at a scale where many points fall within the same pixel, only
+ * the representative features of a level with cells no larger than a pixel need to be
+ * fetched and rendered.
+ *
+ * Only levels which reduce the number of points by at least MIN_AGGREGATION_RATIO are stored.
+ *
+ * \note not available in Python bindings
+ * \since QGIS 3.10
+ */
+class CORE_EXPORT QgsPointPyramid
+{
+  public:
+
+    //! Number of cells along the larger dimension of the layer extent in the finest level
+    static const int BASE_RESOLUTION = 4096;
+
+    //! Minimum ratio of points to cells for a level to be stored
+    static const int MIN_AGGREGATION_RATIO = 2;
+
+    //! An aggregated cell
+    struct Cell
+    {
+      //! ID of the feature representing the cell
+      QgsFeatureId representativeId = 0;
+      //! Number of points within the cell
+      int count = 0;
+    };
+
+    /**
+     * Builds a pyramid from the point features returned by an \a iterator, which
+     * should return all features of the layer, with geometries in the layer CRS.
+     * The \a extent must contain all points.
+     *
+     * Returns nullptr if the build was canceled via \a feedback or if \a extent is empty.
+     * The returned pyramid has no levels if the points are too sparse to be aggregated.
+     */
+    static std::unique_ptr< QgsPointPyramid > build( QgsFeatureIterator &iterator, const QgsRectangle &extent, QgsFeedback *feedback = nullptr );
+
+    /**
+     * Returns the total number of points in the pyramid.
+     */
+    int pointCount() const { return mPointCount; }
+
+    /**
+     * Returns the number of stored levels.
+     */
+    int levelCount() const { return mLevels.size(); }
+
+    /**
+     * Returns the cell size for the specified \a level, in layer units.
+     */
+    double cellSize( int level ) const;
+
+    /**
+     * Returns the index of the coarsest level with cells no larger than \a maximumCellSize
+     * (in layer units), or -1 if all levels have larger cells.
+     */
+    int levelForCellSize( double maximumCellSize ) const;
+
+    /**
+     * Returns the cells from the specified \a level which intersect \a extent.
+     */
+    QVector< Cell > cells( int level, const QgsRectangle &extent ) const;
+
+  private:
+
+    struct Level
+    {
+      double cellSize = 0;
+      QHash< qint64, Cell > cells;
+    };
+
+    static qint64 cellKey( int column, int row ) { return ( static_cast< qint64 >( column ) << 32 ) | static_cast< quint32 >( row ); }
+
+    QgsPointXY mOrigin;
+    int mPointCount = 0;
+    QVector< Level > mLevels;
+};
+
+/**
+ * \ingroup core
+ * \class QgsPointPyramidStore
+ * \brief Thread safe storage for the QgsPointPyramid of a layer.
+ *
+ * Pyramids are built on demand in a background thread, so the store tracks
+ * a generation number which is incremented whenever the layer's data changes.
+ * Pyramids built from an older generation of the data are discarded.
+ *
+ * Stores must be managed by a std::shared_ptr.
+ *
+ * \note not available in Python bindings
+ * \since QGIS 3.10
+ */
+class CORE_EXPORT QgsPointPyramidStore : public std::enable_shared_from_this< QgsPointPyramidStore >
+{
+  public:
+
+    /**
+     * Returns the current pyramid, or nullptr if it has not been built yet. The
+     * current data \a generation is stored in the corresponding argument.
+     */
+    std::shared_ptr< const QgsPointPyramid > pyramid( int &generation ) const;
+
+    /**
+     * Stores a \a pyramid which was built from the specified data \a generation.
+     * The pyramid is discarded if the data has changed since.
+     */
+    void setPyramid( std::shared_ptr< const QgsPointPyramid > pyramid, int generation );
+
+    /**
+     * Starts building a pyramid from the features of a \a source in a background thread,
+     * unless the current pyramid is up to date or is already being built. The \a extent
+     * must contain all points of the source.
+     *
+     * The pyramid is stored once it is complete, unless the data has changed since.
+     * Ownership of \a source is transferred.
+     *
+     * \see waitForBuild()
+     */
+    void buildInBackground( QgsAbstractFeatureSource *source, const QgsRectangle &extent );
+
+    /**
+     * Blocks until any pyramid being built in the background is complete.
+     * \see buildInBackground()
+     */
+    void waitForBuild();
+
+    /**
+     * Discards the current pyramid, e.g. after the layer's data has changed, and
+     * cancels any pyramid being built.
+     */
+    void invalidate();
+
+  private:
+
+    //! Stores a \a pyramid built in the background from the specified data \a generation
+    void finishBuild( std::shared_ptr< const QgsPointPyramid > pyramid, int generation );
+
+    mutable QMutex mMutex;
+    std::shared_ptr< const QgsPointPyramid > mPyramid;
+    int mGeneration = 0;
+
+    //! Data generation of the pyramid being built, or -1 if none is being built
+    int mBuildGeneration = -1;
+    //! Feedback used to cancel the pyramid being built
+    std::shared_ptr< QgsFeedback > mBuildFeedback;
+    QFuture< void > mBuild;
+};
+
+#endif // QGSPOINTPYRAMID_H
@@ -0,0 +1,202 @@
+/***************************************************************************
+    qgsprefetchingfeatureiterator.cpp
+    ---------------------
+    begin                : October 2026
+    copyright            : (C) 2026 by agent
+    email                : agent at local
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qgsprefetchingfeatureiterator.h"
+#include "qgsexception.h"
+#include "qgslogger.h"
+
+#include <QThreadPool>
+#include <QtConcurrentRun>
+
+//! Thread pool for the background fetches, kept apart from the global pool so that prefetching never competes with (or waits on) rendering tasks
+static QThreadPool *prefetchThreadPool()
+{
+  static QThreadPool sPool;
+  return &sPool;
+}
+
+QgsPrefetchingFeatureIterator::QgsPrefetchingFeatureIterator( QgsAbstractFeatureSource *source, bool ownSource, const QgsFeatureRequest &request, int batchSize, int maxQueuedBatches )
+  : QgsAbstractFeatureIteratorFromSource<QgsAbstractFeatureSource>( source, ownSource, QgsFeatureRequest() )
+  , mPrefetchRequest( request )
+  , mBatchSize( std::max( 1, batchSize ) )
+  , mMaxQueuedBatches( std::max( 1, maxQueuedBatches ) )
+{
+  // the filters, limit and ordering of the request are all handled by the source's iterator,
+  // so the base class is given an empty request and just passes the features through
+}
+
+QgsPrefetchingFeatureIterator::~QgsPrefetchingFeatureIterator()
+{
+  close();
+}
+
+bool QgsPrefetchingFeatureIterator::fetchFeature( QgsFeature &feature )
+{
+  feature.setValid( false );
+
+  if ( mClosed )
+    return false;
+
+  if ( mCurrentIndex >= mCurrentBatch.size() )
+  {
+    // fetching is started lazily, so that an interruption checker set after construction is used
+    if ( !mPrefetching )
+      startPrefetching();
+
+    QMutexLocker locker( &mMutex );
+    while ( mBatches.isEmpty() && !mFinished )
+      mBatchQueued.wait( &mMutex );
+
+    if ( mBatches.isEmpty() )
+      return false;
+
+    mCurrentBatch = mBatches.dequeue();
+    mCurrentIndex = 0;
+    mBatchTaken.wakeAll();
+  }
+
+  feature = mCurrentBatch.at( mCurrentIndex++ );
+  return true;
+}
+
+bool QgsPrefetchingFeatureIterator::rewind()
+{
+  if ( mClosed )
+    return false;
+
+  stopPrefetching();
+  return true;
+}
+
+bool QgsPrefetchingFeatureIterator::close()
+{
+  if ( mClosed )
+    return false;
+
+  stopPrefetching();
+
+  iteratorClosed();
+
+  mClosed = true;
+  return true;
+}
+
+void QgsPrefetchingFeatureIterator::setInterruptionChecker( QgsFeedback *interruptionChecker )
+{
+  // picked up by the background thread before fetching the next feature
+  mInterruptionChecker.storeRelease( interruptionChecker );
+}
+
+void QgsPrefetchingFeatureIterator::startPrefetching()
+{
+  mFinished = false;
+  mStopRequested = false;
+  mPrefetching = true;
+  mFuture = QtConcurrent::run( prefetchThreadPool(), [this] { prefetch(); } );
+}
+
+void QgsPrefetchingFeatureIterator::stopPrefetching()
+{
+  if ( mPrefetching )
+  {
+    {
+      QMutexLocker locker( &mMutex );
+      mStopRequested = true;
+      mBatchTaken.wakeAll();
+    }
+    mFuture.waitForFinished();
+    mPrefetching = false;
+  }
+
+  mBatches.clear();
+  mCurrentBatch.clear();
+  mCurrentIndex = 0;
+}
+
+void QgsPrefetchingFeatureIterator::prefetch()
+{
+  try
+  {
+    // the source's iterator lives (and dies) in this thread
+    QgsFeatureIterator it = mSource->getFeatures( mPrefetchRequest );
+    QgsFeedback *interruptionChecker = nullptr;
+
+    QgsFeatureList batch;
+    batch.reserve( mBatchSize );
+    QgsFeature feature;
+    bool stopped = false;
+    while ( true )
+    {
+      // forward an interruption checker set while prefetching
+      QgsFeedback *currentInterruptionChecker = mInterruptionChecker.loadAcquire();
+      if ( currentInterruptionChecker != interruptionChecker )
+      {
+        interruptionChecker = currentInterruptionChecker;
+        it.setInterruptionChecker( interruptionChecker );
+      }
+
+      if ( !it.nextFeature( feature ) )
+        break;
+
+      batch << feature;
+      if ( batch.size() >= mBatchSize )
+      {
+        if ( !queueBatch( batch ) )
+        {
+          stopped = true;
+          break;
+        }
+        batch.clear();
+        batch.reserve( mBatchSize );
+      }
+    }
+
+    if ( !stopped && !batch.isEmpty() )
+      queueBatch( batch );
+  }
+  catch ( QgsException &e )
+  {
+    Q_UNUSED( e )
+    QgsDebugMsg( "Caught unhandled QgsException: " + e.what() );
+  }
+  catch ( std::exception &e )
+  {
+    Q_UNUSED( e )
+    QgsDebugMsg( "Caught unhandled std::exception: " + QString::fromLatin1( e.what() ) );
+  }
+  catch ( ... )
+  {
+    QgsDebugMsg( QStringLiteral( "Caught unhandled unknown exception" ) );
+  }
+
+  // even if the source failed, the consumer must not wait for more features
+  QMutexLocker locker( &mMutex );
+  mFinished = true;
+  mBatchQueued.wakeAll();
+}
+
+bool QgsPrefetchingFeatureIterator::queueBatch( const QgsFeatureList &batch )
+{
+  QMutexLocker locker( &mMutex );
+  while ( mBatches.size() >= mMaxQueuedBatches && !mStopRequested )
+    mBatchTaken.wait( &mMutex );
+
+  if ( mStopRequested )
+    return false;
+
+  mBatches.enqueue( batch );
+  mBatchQueued.wakeAll();
+  return true;
+}
@@ -0,0 +1,115 @@
+/***************************************************************************
+    qgsprefetchingfeatureiterator.h
+    ---------------------
+    begin                : October 2026
+    copyright            : (C) 2026 by agent
+    email                : agent at local
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef QGSPREFETCHINGFEATUREITERATOR_H
+#define QGSPREFETCHINGFEATUREITERATOR_H
+
+#define SIP_NO_FILE
+
+#include "qgis_core.h"
+#include "qgsfeature.h"
+#include "qgsfeatureiterator.h"
+
+#include <QAtomicPointer>
+#include <QFuture>
+#include <QMutex>
+#include <QQueue>
+#include <QWaitCondition>
+
+/**
+ * \ingroup core
+ * A feature iterator which fetches features from a source on a background thread.
+ *
+ * The features matching the request are read from the source's own iterator in a
+ * separate thread, and handed over in batches through a bounded queue. This lets
+ * the time spent waiting on the source (e.g. network latency for database or web service
+ * providers) overlap with the processing of previously fetched features.
+ *
+ * The source's iterator is created, used and destroyed entirely in the background
+ * thread, so the source must be safe to iterate from a thread other than the one it was
+ * created in (as is the case for the sources used for map rendering, such as QgsVectorLayerFeatureSource).
+ * The source must not be used for other iterations while this iterator is active.
+ *
+ * An interruption checker set on this iterator is forwarded to the source's iterator,
+ * including while features are being prefetched. If the source's iterator throws an
+ * exception, the iteration ends early.
+ *
+ * \note Not available in Python bindings
+ * \since QGIS 3.10
+ */
+class CORE_EXPORT QgsPrefetchingFeatureIterator : public QgsAbstractFeatureIteratorFromSource<QgsAbstractFeatureSource>
+{
+  public:
+
+    /**
+     * Constructor for QgsPrefetchingFeatureIterator, iterating over the features from a \a source which
+     * match a \a request. If \a ownSource is TRUE, the iterator takes ownership of the source.
+     *
+     * Features are fetched in batches of \a batchSize features, with up to \a maxQueuedBatches batches
+     * fetched ahead of the features being read from this iterator.
+     */
+    QgsPrefetchingFeatureIterator( QgsAbstractFeatureSource *source, bool ownSource, const QgsFeatureRequest &request,
+                                   int batchSize = 100, int maxQueuedBatches = 4 );
+
+    ~QgsPrefetchingFeatureIterator() override;
+
+    bool rewind() override;
+    bool close() override;
+    void setInterruptionChecker( QgsFeedback *interruptionChecker ) override;
+
+  protected:
+
+    bool fetchFeature( QgsFeature &feature ) override;
+
+  private:
+
+    //! Starts fetching features in the background
+    void startPrefetching();
+
+    //! Stops fetching features in the background, and discards any fetched features
+    void stopPrefetching();
+
+    //! Fetches the features from the source. Runs in the background thread.
+    void prefetch();
+
+    /**
+     * Adds a \a batch of features to the queue, waiting for room if the queue is full.
+     * Returns FALSE if prefetching should stop. Called from the background thread.
+     */
+    bool queueBatch( const QgsFeatureList &batch );
+
+    QgsFeatureRequest mPrefetchRequest;
+    int mBatchSize = 100;
+    int mMaxQueuedBatches = 4;
+    //! Set from the consumer thread, read by the background thread
+    QAtomicPointer< QgsFeedback > mInterruptionChecker;
+
+    QFuture< void > mFuture;
+    bool mPrefetching = false;
+
+    //! Protects the queue and the flags shared with the background thread
+    QMutex mMutex;
+    QWaitCondition mBatchQueued;
+    QWaitCondition mBatchTaken;
+    QQueue< QgsFeatureList > mBatches;
+    bool mFinished = false;
+    bool mStopRequested = false;
+
+    //! Batch currently being read from the iterator
+    QgsFeatureList mCurrentBatch;
+    int mCurrentIndex = 0;
+};
+
+#endif // QGSPREFETCHINGFEATUREITERATOR_H
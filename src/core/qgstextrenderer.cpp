@@ -28,6 +28,8 @@
 #include "qgspallabeling.h"
 #include <QFontDatabase>
 #include <QDesktopWidget>
+#include <QCache>
+#include <QMutex>
 
 Q_GUI_EXPORT extern int qt_defaultDpiX();
 Q_GUI_EXPORT extern int qt_defaultDpiY();
@@ -2598,24 +2600,15 @@ void QgsTextRenderer::drawBuffer( QgsRenderContext &context, const QgsTextRender
   double penSize = context.convertToPainterUnits( buffer.size(), buffer.sizeUnit(), buffer.sizeMapUnitScale() );
 
   QPainterPath path;
-  path.setFillRule( Qt::WindingFill );
   switch ( orientation )
   {
     case QgsTextFormat::HorizontalOrientation:
-      path.addText( 0, 0, format.scaledFont( context ), component.text );
+      path = QgsTextPathCache::horizontalTextPath( format.scaledFont( context ), component.text );
       break;
     case QgsTextFormat::VerticalOrientation:
     case QgsTextFormat::RotationBasedOrientation:
-      double letterSpacing = format.scaledFont( context ).letterSpacing();
-      double labelWidth = fontMetrics->maxWidth();
-      const QStringList parts = QgsPalLabeling::splitToGraphemes( component.text );
-      double partYOffset = 0.0;
-      for ( const auto &part : parts )
-      {
-        double partXOffset = ( labelWidth - ( fontMetrics->width( part ) - letterSpacing ) ) / 2;
-        path.addText( partXOffset, partYOffset, format.scaledFont( context ), part );
-        partYOffset += fontMetrics->ascent() + letterSpacing;
-      }
+      path = QgsTextPathCache::verticalTextPath( format.scaledFont( context ), component.text, *fontMetrics );
+      break;
   }
 
   QColor bufferColor = buffer.color();
@@ -3457,9 +3450,7 @@ void QgsTextRenderer::drawTextInternal( TextPart drawType,
         else
         {
           // draw text, QPainterPath method
-          QPainterPath path;
-          path.setFillRule( Qt::WindingFill );
-          path.addText( 0, 0, format.scaledFont( context ), subComponent.text );
+          const QPainterPath path = QgsTextPathCache::horizontalTextPath( format.scaledFont( context ), subComponent.text );
 
           // store text's drawing in QPicture for drop shadow call
           QPicture textPict;
@@ -3638,16 +3629,7 @@ void QgsTextRenderer::drawTextInternal( TextPart drawType,
         else
         {
           // draw text, QPainterPath method
-          QPainterPath path;
-          path.setFillRule( Qt::WindingFill );
-          const QStringList parts = QgsPalLabeling::splitToGraphemes( subComponent.text );
-          double partYOffset = 0.0;
-          for ( const auto &part : parts )
-          {
-            double partXOffset = ( labelWidth - ( fontMetrics->width( part ) - letterSpacing ) ) / 2;
-            path.addText( partXOffset, partYOffset, format.scaledFont( context ), part );
-            partYOffset += fontMetrics->ascent() + letterSpacing;
-          }
+          const QPainterPath path = QgsTextPathCache::verticalTextPath( format.scaledFont( context ), subComponent.text, *fontMetrics );
 
           // store text's drawing in QPicture for drop shadow call
           QPicture textPict;
@@ -3713,6 +3695,126 @@ void QgsTextRenderer::drawTextInternal( TextPart drawType,
 }
 
 
+///@cond PRIVATE
+
+//
+// QgsTextPathCache
+//
+
+//! Maximum total number of path elements held by the text path cache
+static const int TEXT_PATH_CACHE_MAX_ELEMENTS = 1000000;
+
+//! Text longer than this is never cached
+static const int TEXT_PATH_CACHE_MAX_TEXT_LENGTH = 200;
+
+struct QgsTextPathCacheData
+{
+  QgsTextPathCacheData()
+    : paths( TEXT_PATH_CACHE_MAX_ELEMENTS )
+  {}
+
+  QMutex mutex;
+  QCache< QString, QPainterPath > paths;
+};
+
+static QgsTextPathCacheData *textPathCacheData()
+{
+  static QgsTextPathCacheData sData;
+  return &sData;
+}
+
+QPainterPath QgsTextPathCache::horizontalTextPath( const QFont &font, const QString &text )
+{
+  const bool canCache = text.length() <= TEXT_PATH_CACHE_MAX_TEXT_LENGTH;
+  QString key;
+  QPainterPath path;
+  if ( canCache )
+  {
+    key = QStringLiteral( "h|%1|%2" ).arg( fontKey( font ), text );
+    if ( cachedPath( key, path ) )
+      return path;
+  }
+
+  path.setFillRule( Qt::WindingFill );
+  path.addText( 0, 0, font, text );
+
+  if ( canCache )
+    cachePath( key, path );
+  return path;
+}
+
+QPainterPath QgsTextPathCache::verticalTextPath( const QFont &font, const QString &text, const QFontMetricsF &fontMetrics )
+{
+  const double letterSpacing = font.letterSpacing();
+  const double labelWidth = fontMetrics.maxWidth();
+
+  const bool canCache = text.length() <= TEXT_PATH_CACHE_MAX_TEXT_LENGTH;
+  QString key;
+  QPainterPath path;
+  if ( canCache )
+  {
+    // the layout depends on the metrics of the paint device
+    key = QStringLiteral( "v|%1|%2|%3|%4" ).arg( fontKey( font ), qgsDoubleToString( labelWidth ), qgsDoubleToString( fontMetrics.ascent() ), text );
+    if ( cachedPath( key, path ) )
+      return path;
+  }
+
+  path.setFillRule( Qt::WindingFill );
+  const QStringList parts = QgsPalLabeling::splitToGraphemes( text );
+  double partYOffset = 0.0;
+  for ( const auto &part : parts )
+  {
+    double partXOffset = ( labelWidth - ( fontMetrics.width( part ) - letterSpacing ) ) / 2;
+    path.addText( partXOffset, partYOffset, font, part );
+    partYOffset += fontMetrics.ascent() + letterSpacing;
+  }
+
+  if ( canCache )
+    cachePath( key, path );
+  return path;
+}
+
+void QgsTextPathCache::clear()
+{
+  QgsTextPathCacheData *data = textPathCacheData();
+  QMutexLocker locker( &data->mutex );
+  data->paths.clear();
+}
+
+QString QgsTextPathCache::fontKey( const QFont &font )
+{
+  // QFont::toString() doesn't include spacing or capitalization
+  return QStringLiteral( "%1|%2|%3|%4|%5|%6|%7|%8" ).arg( font.toString(),
+         qgsDoubleToString( font.pixelSize() > 0 ? font.pixelSize() : font.pointSizeF() ),
+         qgsDoubleToString( font.letterSpacing() ),
+         QString::number( static_cast< int >( font.letterSpacingType() ) ),
+         qgsDoubleToString( font.wordSpacing() ),
+         QString::number( static_cast< int >( font.capitalization() ) ),
+         QString::number( font.kerning() ),
+         QString::number( font.stretch() ) );
+}
+
+bool QgsTextPathCache::cachedPath( const QString &key, QPainterPath &path )
+{
+  QgsTextPathCacheData *data = textPathCacheData();
+  QMutexLocker locker( &data->mutex );
+  if ( const QPainterPath *cached = data->paths.object( key ) )
+  {
+    path = *cached;
+    return true;
+  }
+  return false;
+}
+
+void QgsTextPathCache::cachePath( const QString &key, const QPainterPath &path )
+{
+  QgsTextPathCacheData *data = textPathCacheData();
+  QMutexLocker locker( &data->mutex );
+  data->paths.insert( key, new QPainterPath( path ), std::max( 1, path.elementCount() ) );
+}
+
+///@endcond
+
 //
 // QgsTextRendererUtils
 //
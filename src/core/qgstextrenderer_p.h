@@ -27,6 +27,7 @@
 #include "qgspainteffect.h"
 #include <QSharedData>
 #include <QPainter>
+#include <QPainterPath>
 
 /// @cond
 
@@ -241,6 +242,46 @@ class QgsTextSettingsPrivate : public QSharedData
 
 };
 
+/**
+ * Thread safe cache of the outlines used to render text, shared by all text renders.
+ *
+ * Converting text to a painter path is one of the most expensive parts of rendering text,
+ * and label text often repeats many times in a single render (e.g. road names or house
+ * numbers). The same outlines are used for drawing the text itself, its buffer and any
+ * text or buffer shadows.
+ */
+class CORE_EXPORT QgsTextPathCache
+{
+  public:
+
+    /**
+     * Returns the outline of \a text rendered horizontally in the specified \a font,
+     * with the baseline starting at the origin.
+     */
+    static QPainterPath horizontalTextPath( const QFont &font, const QString &text );
+
+    /**
+     * Returns the outline of \a text rendered vertically in the specified \a font,
+     * with each grapheme centered within the font's maximum character width.
+     */
+    static QPainterPath verticalTextPath( const QFont &font, const QString &text, const QFontMetricsF &fontMetrics );
+
+    /**
+     * Removes all cached outlines.
+     *
+     * This is called when application fonts are loaded (since text which previously fell back to a
+     * different font may render differently afterwards) and on QGIS exit.
+     */
+    static void clear();
+
+  private:
+
+    static QString fontKey( const QFont &font );
+    static bool cachedPath( const QString &key, QPainterPath &path );
+    static void cachePath( const QString &key, const QPainterPath &path );
+};
+
+
 
 
 
@@ -17,45 +17,360 @@
 
 #include "qgsnetworkaccessmanager.h"
 #include "qgsapplication.h"
+#include "qgssettings.h"
+#include "qgssqliteutils.h"
+#include "qgslogger.h"
 #include <QAbstractNetworkCache>
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
 #include <QImage>
+#include <QSet>
+#include <QStandardPaths>
+#include <sqlite3.h>
 
-QCache<QUrl, QImage> QgsTileCache::sTileCache( 256 );
+QCache<QUrl, QImage> QgsTileCache::sTileCache( 64 * 1024 );
+QCache<QUrl, QByteArray> QgsTileCache::sCompressedTileCache( 32 * 1024 );
 QMutex QgsTileCache::sTileCacheMutex;
+QMutex QgsTileCache::sDiskCacheMutex;
+bool QgsTileCache::sInitialized = false;
 
+// default expiry of the tiles stored in the disk cache, in seconds, protected by sTileCacheMutex
+static qint64 sDefaultTileExpiry = 24 * 60 * 60;
 
-void QgsTileCache::insertTile( const QUrl &url, const QImage &image )
+// disk cache state, protected by sDiskCacheMutex
+static QString sDiskCachePath;
+static qint64 sDiskCacheMaxSize = 0;
+static qint64 sDiskCacheSize = 0;
+static sqlite3_database_unique_ptr sDiskCache;
+
+//! Returns the cost of a decoded image in the in-memory cache, in kilobytes
+static int imageCost( const QImage &image )
 {
-  QMutexLocker locker( &sTileCacheMutex );
-  sTileCache.insert( url, new QImage( image ) );
+  return std::max( 1, image.byteCount() / 1024 );
+}
+
+//! Returns the cost of encoded tile data in the in-memory cache, in kilobytes
+static int dataCost( const QByteArray &data )
+{
+  return std::max( 1, data.size() / 1024 );
+}
+
+void QgsTileCache::initialize()
+{
+  if ( sInitialized )
+    return;
+
+  sInitialized = true;
+
+  QgsSettings settings;
+  sTileCache.setMaxCost( settings.value( QStringLiteral( "qgis/tileCache/memoryCacheSize" ), 64 ).toInt() * 1024 );
+  sCompressedTileCache.setMaxCost( settings.value( QStringLiteral( "qgis/tileCache/compressedMemoryCacheSize" ), 32 ).toInt() * 1024 );
+  sDefaultTileExpiry = settings.value( QStringLiteral( "qgis/defaultTileExpiry" ), "24" ).toInt() * 60 * 60;
+
+  if ( settings.value( QStringLiteral( "qgis/tileCache/diskCacheEnabled" ), false ).toBool() )
+  {
+    QMutexLocker locker( &sDiskCacheMutex );
+    sDiskCachePath = settings.value( QStringLiteral( "qgis/tileCache/diskCachePath" ) ).toString();
+    if ( sDiskCachePath.isEmpty() )
+    {
+      QString cacheDirectory = settings.value( QStringLiteral( "cache/directory" ) ).toString();
+      if ( cacheDirectory.isEmpty() )
+        cacheDirectory = QStandardPaths::writableLocation( QStandardPaths::CacheLocation );
+      sDiskCachePath = QDir( cacheDirectory ).filePath( QStringLiteral( "tilecache.sqlite" ) );
+    }
+    sDiskCacheMaxSize = settings.value( QStringLiteral( "qgis/tileCache/diskCacheSize" ), 256 ).toLongLong() * 1024 * 1024;
+    openDiskCache();
+  }
+}
+
+void QgsTileCache::openDiskCache()
+{
+  sDiskCache.reset();
+  sDiskCacheSize = 0;
+  if ( sDiskCachePath.isEmpty() )
+    return;
+
+  QDir().mkpath( QFileInfo( sDiskCachePath ).absolutePath() );
+
+  sqlite3_database_unique_ptr database;
+  if ( database.open_v2( sDiskCachePath, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, nullptr ) != SQLITE_OK )
+  {
+    QgsDebugMsg( QStringLiteral( "Cannot open tile disk cache %1: %2" ).arg( sDiskCachePath, database.errorMessage() ) );
+    return;
+  }
+
+  int result = 0;
+  int version = 0;
+  sqlite3_statement_unique_ptr statement = database.prepare( QStringLiteral( "PRAGMA user_version" ), result );
+  if ( result == SQLITE_OK && statement.step() == SQLITE_ROW )
+    version = static_cast< int >( statement.columnAsInt64( 0 ) );
+  statement.reset();
+
+  // all the tiles are stored in a single table (as in MBTiles), keyed by their URL.
+  // Tiles of the first version of the cache have no expiry date, and are discarded.
+  QString errorMessage;
+  if ( version < 1 &&
+       database.exec( QStringLiteral( "DROP TABLE IF EXISTS tiles;"
+                                      "CREATE TABLE tiles (url TEXT PRIMARY KEY, tile_data BLOB NOT NULL, last_access INTEGER NOT NULL, expires INTEGER NOT NULL);"
+                                      "CREATE INDEX tiles_last_access ON tiles(last_access);"
+                                      "CREATE INDEX tiles_expires ON tiles(expires);"
+                                      "PRAGMA user_version=1;" ), errorMessage ) != SQLITE_OK )
+  {
+    QgsDebugMsg( QStringLiteral( "Cannot create tile disk cache %1: %2" ).arg( sDiskCachePath, errorMessage ) );
+    return;
+  }
+
+  if ( database.exec( QStringLiteral( "PRAGMA journal_mode=WAL; PRAGMA synchronous=NORMAL;" ), errorMessage ) != SQLITE_OK )
+  {
+    QgsDebugMsg( QStringLiteral( "Cannot configure tile disk cache %1: %2" ).arg( sDiskCachePath, errorMessage ) );
+    return;
+  }
+
+  statement = database.prepare( QStringLiteral( "SELECT SUM(LENGTH(tile_data)) FROM tiles" ), result );
+  if ( result == SQLITE_OK && statement.step() == SQLITE_ROW )
+    sDiskCacheSize = statement.columnAsInt64( 0 );
+  statement.reset();
+
+  sDiskCache = std::move( database );
+}
+
+QByteArray QgsTileCache::diskTile( const QUrl &url )
+{
+  QMutexLocker locker( &sDiskCacheMutex );
+  if ( !sDiskCache )
+    return QByteArray();
+
+  const QByteArray key = url.toEncoded();
+  int result = 0;
+  sqlite3_statement_unique_ptr statement = sDiskCache.prepare( QStringLiteral( "SELECT tile_data, expires FROM tiles WHERE url = ?" ), result );
+  if ( result != SQLITE_OK )
+    return QByteArray();
+
+  sqlite3_bind_text( statement.get(), 1, key.constData(), key.size(), SQLITE_TRANSIENT );
+  if ( statement.step() != SQLITE_ROW )
+    return QByteArray();
+
+  const QByteArray data( static_cast< const char * >( sqlite3_column_blob( statement.get(), 0 ) ), sqlite3_column_bytes( statement.get(), 0 ) );
+  const qint64 now = QDateTime::currentSecsSinceEpoch();
+  if ( statement.columnAsInt64( 1 ) < now )
+  {
+    // expired tiles must be downloaded again, so there's no point keeping them
+    statement = sDiskCache.prepare( QStringLiteral( "DELETE FROM tiles WHERE url = ?" ), result );
+    if ( result == SQLITE_OK )
+    {
+      sqlite3_bind_text( statement.get(), 1, key.constData(), key.size(), SQLITE_TRANSIENT );
+      if ( statement.step() == SQLITE_DONE )
+        sDiskCacheSize -= data.size();
+    }
+    return QByteArray();
+  }
+
+  // only record accesses to the minute, to avoid writing to the database for every lookup
+  statement = sDiskCache.prepare( QStringLiteral( "UPDATE tiles SET last_access = ? WHERE url = ? AND last_access < ?" ), result );
+  if ( result == SQLITE_OK )
+  {
+    sqlite3_bind_int64( statement.get(), 1, now );
+    sqlite3_bind_text( statement.get(), 2, key.constData(), key.size(), SQLITE_TRANSIENT );
+    sqlite3_bind_int64( statement.get(), 3, now - 60 );
+    statement.step();
+  }
+
+  return data;
+}
+
+void QgsTileCache::insertDiskTile( const QUrl &url, const QByteArray &encodedData, qint64 expiry )
+{
+  QMutexLocker locker( &sDiskCacheMutex );
+  if ( !sDiskCache )
+    return;
+
+  const QByteArray key = url.toEncoded();
+  int result = 0;
+  sqlite3_statement_unique_ptr statement = sDiskCache.prepare( QStringLiteral( "INSERT OR REPLACE INTO tiles (url, tile_data, last_access, expires) VALUES (?, ?, ?, ?)" ), result );
+  if ( result != SQLITE_OK )
+    return;
+
+  sqlite3_bind_text( statement.get(), 1, key.constData(), key.size(), SQLITE_TRANSIENT );
+  sqlite3_bind_blob( statement.get(), 2, encodedData.constData(), encodedData.size(), SQLITE_TRANSIENT );
+  sqlite3_bind_int64( statement.get(), 3, QDateTime::currentSecsSinceEpoch() );
+  sqlite3_bind_int64( statement.get(), 4, expiry );
+  if ( statement.step() != SQLITE_DONE )
+  {
+    QgsDebugMsg( QStringLiteral( "Cannot store tile in disk cache: %1" ).arg( sDiskCache.errorMessage() ) );
+    return;
+  }
+
+  // replaced tiles are counted twice, which only makes the cache pruned a little early
+  sDiskCacheSize += encodedData.size();
+  if ( sDiskCacheSize > sDiskCacheMaxSize )
+    pruneDiskCache();
+}
+
+void QgsTileCache::pruneDiskCache()
+{
+  // keep the most recently used tiles which fit in 90% of the maximum size. At most a batch
+  // of tiles is removed at once, so that storing a tile never stalls for long: a cache which
+  // is much too large is pruned over several insertions
+  const qint64 targetSize = sDiskCacheMaxSize / 10 * 9;
+  const int batchSize = 100;
+
+  QSet<QString> urls;
+  qint64 removedSize = 0;
+
+  // expired tiles go first, then the least recently used ones
+  const QStringList queries
+  {
+    QStringLiteral( "SELECT url, LENGTH(tile_data) FROM tiles WHERE expires < %1 LIMIT %2" ).arg( QDateTime::currentSecsSinceEpoch() ).arg( batchSize ),
+    QStringLiteral( "SELECT url, LENGTH(tile_data) FROM tiles ORDER BY last_access, rowid LIMIT %1" ).arg( batchSize )
+  };
+  for ( const QString &query : queries )
+  {
+    int result = 0;
+    sqlite3_statement_unique_ptr statement = sDiskCache.prepare( query, result );
+    if ( result != SQLITE_OK )
+      return;
+
+    while ( urls.size() < batchSize && sDiskCacheSize - removedSize > targetSize && statement.step() == SQLITE_ROW )
+    {
+      const QString url = statement.columnAsText( 0 );
+      if ( urls.contains( url ) )
+        continue;
+      urls.insert( url );
+      removedSize += statement.columnAsInt64( 1 );
+    }
+  }
+
+  int result = 0;
+  sqlite3_statement_unique_ptr statement = sDiskCache.prepare( QStringLiteral( "DELETE FROM tiles WHERE url = ?" ), result );
+  if ( result != SQLITE_OK )
+    return;
+
+  QString errorMessage;
+  ( void )sDiskCache.exec( QStringLiteral( "BEGIN" ), errorMessage );
+  for ( const QString &url : qgis::as_const( urls ) )
+  {
+    const QByteArray key = url.toUtf8();
+    sqlite3_reset( statement.get() );
+    sqlite3_bind_text( statement.get(), 1, key.constData(), key.size(), SQLITE_TRANSIENT );
+    if ( statement.step() != SQLITE_DONE )
+    {
+      QgsDebugMsg( QStringLiteral( "Cannot prune tile disk cache: %1" ).arg( sDiskCache.errorMessage() ) );
+      ( void )sDiskCache.exec( QStringLiteral( "ROLLBACK" ), errorMessage );
+      return;
+    }
+  }
+  ( void )sDiskCache.exec( QStringLiteral( "COMMIT" ), errorMessage );
+
+  sDiskCacheSize -= removedSize;
+}
+
+void QgsTileCache::insertTile( const QUrl &url, const QImage &image, const QByteArray &encodedData, const QDateTime &expiry )
+{
+  qint64 diskExpiry = 0;
+  {
+    QMutexLocker locker( &sTileCacheMutex );
+    initialize();
+
+    sTileCache.insert( url, new QImage( image ), imageCost( image ) );
+    if ( encodedData.isEmpty() )
+      return;
+
+    if ( sCompressedTileCache.maxCost() > 0 )
+      sCompressedTileCache.insert( url, new QByteArray( encodedData ), dataCost( encodedData ) );
+    diskExpiry = expiry.isValid() ? expiry.toSecsSinceEpoch() : QDateTime::currentSecsSinceEpoch() + sDefaultTileExpiry;
+  }
+
+  // the in-memory caches are not locked while writing to the disk
+  insertDiskTile( url, encodedData, diskExpiry );
 }
 
 bool QgsTileCache::tile( const QUrl &url, QImage &image )
 {
-  QMutexLocker locker( &sTileCacheMutex );
-  bool success = false;
-  if ( QImage *i = sTileCache.object( url ) )
+  QByteArray imageData;
+  bool inCompressedCache = false;
   {
-    image = *i;
-    success = true;
+    QMutexLocker locker( &sTileCacheMutex );
+    initialize();
+
+    if ( QImage *i = sTileCache.object( url ) )
+    {
+      image = *i;
+      return true;
+    }
+
+    if ( QByteArray *data = sCompressedTileCache.object( url ) )
+    {
+      imageData = *data;
+      inCompressedCache = true;
+    }
   }
-  else if ( QgsNetworkAccessManager::instance()->cache()->metaData( url ).isValid() )
+
+  // no decoded image, so look for the encoded tile data in the other tiers. The in-memory
+  // caches are not locked meanwhile, so that lookups from other threads are not blocked by disk reads
+  if ( imageData.isEmpty() )
+    imageData = diskTile( url );
+
+  if ( imageData.isEmpty() && QgsNetworkAccessManager::instance()->cache()->metaData( url ).isValid() )
   {
     if ( QIODevice *data = QgsNetworkAccessManager::instance()->cache()->data( url ) )
     {
-      QByteArray imageData = data->readAll();
+      imageData = data->readAll();
       delete data;
-
-      image = QImage::fromData( imageData );
-
-      // cache it as well (mutex is already locked)
-      // Check for null because it could be a redirect (see: https://github.com/qgis/QGIS/issues/24336 )
-      if ( ! image.isNull( ) )
-      {
-        sTileCache.insert( url, new QImage( image ) );
-        success = true;
-      }
     }
   }
-  return success;
+
+  if ( imageData.isEmpty() )
+    return false;
+
+  image = QImage::fromData( imageData );
+
+  // Check for null because it could be a redirect (see: https://github.com/qgis/QGIS/issues/24336 )
+  if ( image.isNull() )
+    return false;
+
+  // cache it as well
+  QMutexLocker locker( &sTileCacheMutex );
+  sTileCache.insert( url, new QImage( image ), imageCost( image ) );
+  if ( !inCompressedCache && sCompressedTileCache.maxCost() > 0 )
+    sCompressedTileCache.insert( url, new QByteArray( imageData ), dataCost( imageData ) );
+  return true;
+}
+
+int QgsTileCache::totalCost()
+{
+  QMutexLocker locker( &sTileCacheMutex );
+  initialize();
+  return sTileCache.totalCost();
+}
+
+int QgsTileCache::maxCost()
+{
+  QMutexLocker locker( &sTileCacheMutex );
+  initialize();
+  return sTileCache.maxCost();
+}
+
+void QgsTileCache::setMaxCost( int kilobytes )
+{
+  QMutexLocker locker( &sTileCacheMutex );
+  initialize();
+  sTileCache.setMaxCost( kilobytes );
+}
+
+void QgsTileCache::setMaxCompressedCost( int kilobytes )
+{
+  QMutexLocker locker( &sTileCacheMutex );
+  initialize();
+  sCompressedTileCache.setMaxCost( kilobytes );
+}
+
+void QgsTileCache::setDiskCache( const QString &path, int megabytes )
+{
+  QMutexLocker locker( &sTileCacheMutex );
+  initialize();
+  QMutexLocker diskLocker( &sDiskCacheMutex );
+  sDiskCachePath = path;
+  sDiskCacheMaxSize = static_cast< qint64 >( megabytes ) * 1024 * 1024;
+  openDiskCache();
 }
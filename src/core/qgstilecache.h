@@ -19,17 +19,33 @@
 #include "qgis_core.h"
 #include <QCache>
 #include <QMutex>
+#include <QByteArray>
 
 class QImage;
 class QUrl;
+class QDateTime;
 
 #define SIP_NO_FILE
 
 /**
  * A simple tile cache implementation. Tiles are cached according to their URL.
- * There is a small in-memory cache and a secondary caching in the local disk.
- * The in-memory cache is there to save CPU time otherwise wasted to read and
- * uncompress data saved on the disk.
+ *
+ * Tiles are looked up in several tiers:
+ *
+ * - an in-memory cache of decoded images, limited by the total size of the images,
+ * - an optional in-memory cache of the encoded (PNG, JPEG...) tile data, which
+ *   holds many more tiles than the decoded cache for the same memory use,
+ * - an optional disk cache, storing the encoded tile data of all tiles in a
+ *   single SQLite database,
+ * - the network disk cache.
+ *
+ * The encoded tiers are only filled for tiles inserted along with their encoded data.
+ * The in-memory caches are there to save CPU time otherwise wasted to read and
+ * uncompress data saved on the disk. Tiles stored in the disk cache expire, like
+ * the ones of the network disk cache.
+ *
+ * The sizes of the tiers and the location of the disk cache are initially read from the
+ * "qgis/tileCache/..." settings.
  *
  * The class is thread safe (its methods can be called from any thread).
  *
@@ -41,8 +57,15 @@ class CORE_EXPORT QgsTileCache
 {
   public:
 
-    //! Add a tile image with given URL to the cache
-    static void insertTile( const QUrl &url, const QImage &image );
+    /**
+     * Add a tile image with given URL to the cache.
+     *
+     * If the \a encodedData the image was decoded from is specified, it is also stored in
+     * the compressed in-memory cache and in the disk cache (since QGIS 3.10), until
+     * the \a expiry date. If no expiry date is specified, the tile expires after the
+     * "qgis/defaultTileExpiry" setting (in hours).
+     */
+    static void insertTile( const QUrl &url, const QImage &image, const QByteArray &encodedData = QByteArray(), const QDateTime &expiry = QDateTime() );
 
     /**
      * Try to access a tile and load it into "image" argument
@@ -50,16 +73,61 @@ class CORE_EXPORT QgsTileCache
      */
     static bool tile( const QUrl &url, QImage &image );
 
-    //! how many tiles are stored in the in-memory cache
-    static int totalCost() { QMutexLocker locker( &sTileCacheMutex ); return sTileCache.totalCost(); }
-    //! how many tiles can be stored in the in-memory cache
-    static int maxCost() { QMutexLocker locker( &sTileCacheMutex ); return sTileCache.maxCost(); }
+    //! total size (in kilobytes) of the decoded tiles stored in the in-memory cache
+    static int totalCost();
+    //! maximum total size (in kilobytes) of the decoded tiles stored in the in-memory cache
+    static int maxCost();
+
+    /**
+     * Sets the maximum total size (in \a kilobytes) of the decoded tiles stored in the in-memory cache.
+     * \since QGIS 3.10
+     */
+    static void setMaxCost( int kilobytes );
+
+    /**
+     * Sets the maximum total size (in \a kilobytes) of the encoded tile data stored in
+     * the compressed in-memory cache. A size of 0 disables the compressed cache.
+     * \since QGIS 3.10
+     */
+    static void setMaxCompressedCost( int kilobytes );
+
+    /**
+     * Sets the \a path of the disk cache database, and the maximum size (in \a megabytes)
+     * of the tile data stored in it. An empty path disables the disk cache.
+     * \since QGIS 3.10
+     */
+    static void setDiskCache( const QString &path, int megabytes );
 
   private:
-    //! in-memory cache
+
+    //! Reads the cache sizes from the settings, if not done yet. Must be called with the mutex locked.
+    static void initialize();
+
+    //! Opens the disk cache database, if it is enabled. Must be called with the disk cache mutex locked.
+    static void openDiskCache();
+
+    //! Reads the encoded data of a tile from the disk cache, unless it has expired.
+    static QByteArray diskTile( const QUrl &url );
+
+    //! Stores the encoded data of a tile in the disk cache, until the \a expiry date (in seconds since epoch).
+    static void insertDiskTile( const QUrl &url, const QByteArray &encodedData, qint64 expiry );
+
+    /**
+     * Removes a batch of expired, then least recently used tiles from the disk cache if it is too large.
+     * Must be called with the disk cache mutex locked.
+     */
+    static void pruneDiskCache();
+
+    //! in-memory cache of decoded images
     static QCache<QUrl, QImage> sTileCache;
-    //! mutex to protect the in-memory cache
+    //! in-memory cache of encoded tile data
+    static QCache<QUrl, QByteArray> sCompressedTileCache;
+    //! mutex to protect the in-memory caches
     static QMutex sTileCacheMutex;
+    //! mutex to protect the disk cache, so that disk I/O does not block in-memory cache lookups
+    static QMutex sDiskCacheMutex;
+
+    static bool sInitialized;
 };
 
 #endif // QGSTILECACHE_H
@@ -35,6 +35,9 @@
 #include "qgsgeometryengine.h"
 #include "qgsproviderregistry.h"
 #include "qgsexpressioncontextutils.h"
+#include "qgsallocationpool.h"
+#include "qgsprefetchingfeatureiterator.h"
+#include "qgsvectorlayerfeatureiterator.h"
 
 #include <QFile>
 #include <QFileInfo>
@@ -2741,7 +2744,8 @@ QgsVectorFileWriter::WriterError QgsVectorFileWriter::prepareWriteAsVectorFormat
     details.filterRectEngine.reset( QgsGeometry::createGeometryEngine( details.filterRectGeometry.constGet() ) );
     details.filterRectEngine->prepareGeometry();
   }
-  details.sourceFeatureIterator = layer->getFeatures( req );
+  // read the features on a background thread, so that fetching them from the source overlaps with writing them
+  details.sourceFeatureIterator = QgsFeatureIterator( new QgsPrefetchingFeatureIterator( new QgsVectorLayerFeatureSource( layer ), true, req ) );
 
   return NoError;
 }
@@ -2876,6 +2880,8 @@ QgsVectorFileWriter::WriterError QgsVectorFileWriter::writeAsVectorFormat( Prepa
   // write all features
   long saved = 0;
   int initialProgress = lastProgressReport;
+  // recycle the geometries and features created for each written feature
+  QgsAllocationPoolScope poolScope;
   while ( details.sourceFeatureIterator.nextFeature( fet ) )
   {
     if ( options.feedback && options.feedback->isCanceled() )
@@ -96,6 +96,7 @@
 #include "qgsauxiliarystorage.h"
 #include "qgsgeometryoptions.h"
 #include "qgsexpressioncontextutils.h"
+#include "qgspointpyramid.h"
 
 #include "diagram/qgsdiagram.h"
 
@@ -178,6 +179,15 @@ QgsVectorLayer::QgsVectorLayer( const QString &vectorLayerPath,
 
   connect( this, &QgsVectorLayer::subsetStringChanged, this, &QgsMapLayer::configChanged );
 
+  // discard the aggregated points whenever the layer's features may have changed
+  mPointPyramidStore = std::make_shared< QgsPointPyramidStore >();
+  connect( this, &QgsVectorLayer::dataChanged, this, [ = ] { mPointPyramidStore->invalidate(); } );
+  connect( this, &QgsVectorLayer::subsetStringChanged, this, [ = ] { mPointPyramidStore->invalidate(); } );
+  connect( this, &QgsVectorLayer::editingStopped, this, [ = ] { mPointPyramidStore->invalidate(); } );
+  connect( this, &QgsMapLayer::dataSourceChanged, this, [ = ] { mPointPyramidStore->invalidate(); } );
+  // cancels any pyramid being built
+  connect( this, &QgsMapLayer::willBeDeleted, this, [ = ] { mPointPyramidStore->invalidate(); } );
+
   // Default simplify drawing settings
   QgsSettings settings;
   mSimplifyMethod.setSimplifyHints( settings.flagValue( QStringLiteral( "qgis/simplifyDrawingHints" ), mSimplifyMethod.simplifyHints(), QgsSettings::NoSection ) );
@@ -267,6 +277,7 @@ QgsVectorLayer *QgsVectorLayer::clone() const
   layer->setLabelsEnabled( labelsEnabled() );
 
   layer->setSimplifyMethod( simplifyMethod() );
+  layer->setPointAggregationScale( pointAggregationScale() );
 
   if ( diagramRenderer() )
   {
@@ -2309,6 +2320,8 @@ bool QgsVectorLayer::readStyle( const QDomNode &node, QString &errorMessage,
       mSimplifyMethod.setThreshold( e.attribute( QStringLiteral( "simplifyDrawingTol" ), QStringLiteral( "1" ) ).toFloat() );
       mSimplifyMethod.setForceLocalOptimization( e.attribute( QStringLiteral( "simplifyLocal" ), QStringLiteral( "1" ) ).toInt() );
       mSimplifyMethod.setMaximumScale( e.attribute( QStringLiteral( "simplifyMaxScale" ), QStringLiteral( "1" ) ).toFloat() );
+
+      mPointAggregationScale = e.attribute( QStringLiteral( "pointAggregationScale" ), QStringLiteral( "0" ) ).toDouble();
     }
 
     //diagram renderer and diagram layer settings
@@ -2591,6 +2604,7 @@ bool QgsVectorLayer::writeStyle( QDomNode &node, QDomDocument &doc, QString &err
       mapLayerNode.setAttribute( QStringLiteral( "simplifyDrawingTol" ), QString::number( mSimplifyMethod.threshold() ) );
       mapLayerNode.setAttribute( QStringLiteral( "simplifyLocal" ), mSimplifyMethod.forceLocalOptimization() ? 1 : 0 );
       mapLayerNode.setAttribute( QStringLiteral( "simplifyMaxScale" ), QString::number( mSimplifyMethod.maximumScale() ) );
+      mapLayerNode.setAttribute( QStringLiteral( "pointAggregationScale" ), qgsDoubleToString( mPointAggregationScale ) );
     }
 
     //save customproperties
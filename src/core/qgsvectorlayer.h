@@ -47,6 +47,7 @@ class QPainter;
 class QImage;
 
 class QgsAbstractGeometrySimplifier;
+class QgsPointPyramidStore;
 class QgsActionManager;
 class QgsConditionalLayerStyles;
 class QgsCurve;
@@ -2005,6 +2006,33 @@ class CORE_EXPORT QgsVectorLayer : public QgsMapLayer, public QgsExpressionConte
      */
     inline const QgsVectorSimplifyMethod &simplifyMethod() const { return mSimplifyMethod; }
 
+    /**
+     * Sets the map \a scale beyond which a point layer is rendered from an aggregated
+     * point pyramid, i.e. the layer is rendered by drawing a single representative
+     * feature for all points which fall within the same pixel.
+     *
+     * The pyramid is built in a background thread the first time the layer is rendered beyond
+     * this scale, and is rebuilt whenever the layer's data changes. The layer is rendered normally
+     * until the pyramid is complete. It is only used for single symbol,
+     * heatmap and point cluster renderers, and only when the layer is not being edited and
+     * has no selected features, labels or diagrams.
+     *
+     * A \a scale of 0 disables point aggregation.
+     *
+     * \see pointAggregationScale()
+     * \since QGIS 3.10
+     */
+    void setPointAggregationScale( double scale ) { mPointAggregationScale = scale; }
+
+    /**
+     * Returns the map scale beyond which a point layer is rendered from an aggregated
+     * point pyramid, or 0 if point aggregation is disabled.
+     *
+     * \see setPointAggregationScale()
+     * \since QGIS 3.10
+     */
+    double pointAggregationScale() const { return mPointAggregationScale; }
+
     /**
      * Returns whether the VectorLayer can apply the specified simplification hint
      * \note Do not use in 3rd party code - may be removed in future version!
@@ -2586,6 +2614,12 @@ class CORE_EXPORT QgsVectorLayer : public QgsMapLayer, public QgsExpressionConte
     //! Simplification object which holds the information about how to simplify the features for fast rendering
     QgsVectorSimplifyMethod mSimplifyMethod;
 
+    //! Map scale beyond which points are rendered from an aggregated point pyramid
+    double mPointAggregationScale = 0;
+
+    //! Aggregated point pyramid, built on demand by the layer's renderers
+    std::shared_ptr< QgsPointPyramidStore > mPointPyramidStore;
+
     //! Labeling configuration
     QgsAbstractVectorLayerLabeling *mLabeling = nullptr;
 
@@ -2661,6 +2695,8 @@ class CORE_EXPORT QgsVectorLayer : public QgsMapLayer, public QgsExpressionConte
     QgsStoredExpressionManager *mStoredExpressionManager = nullptr;
 
     friend class QgsVectorLayerFeatureSource;
+    friend class QgsVectorLayerRenderer;
+    friend class TestQgsPointPyramid;
 
     //! To avoid firing multiple time dataChanged signal on circular layer circular dependencies
     bool mDataChangedFired = false;
@@ -38,6 +38,7 @@
 #include "qgssettings.h"
 #include "qgsexpressioncontextutils.h"
 #include "qgsrenderedfeaturehandlerinterface.h"
+#include "qgspointpyramid.h"
 
 #include <QPicture>
 
@@ -94,6 +95,17 @@ QgsVectorLayerRenderer::QgsVectorLayerRenderer( QgsVectorLayer *layer, QgsRender
 
   mVertexMarkerSize = settings.value( QStringLiteral( "qgis/digitizing/marker_size_mm" ), 2.0 ).toDouble();
 
+  if ( layer->pointAggregationScale() > 0 && mContext.rendererScale() > layer->pointAggregationScale()
+       && QgsWkbTypes::flatType( layer->wkbType() ) == QgsWkbTypes::Point
+       && mRenderer && mRenderer->canRenderAggregatedPoints() && !layer->isEditable() )
+  {
+    int generation = 0;
+    mPointPyramid = layer->mPointPyramidStore->pyramid( generation );
+    // the layer is rendered normally until the pyramid has been built
+    if ( !mPointPyramid )
+      layer->mPointPyramidStore->buildInBackground( new QgsVectorLayerFeatureSource( layer ), layer->extent() );
+  }
+
   if ( !mRenderer )
     return;
 
@@ -171,6 +183,17 @@ bool QgsVectorLayerRenderer::render()
 
   QString rendererFilter = mRenderer->filter( mFields );
 
+  if ( drawAggregatedPoints( rendererFilter ) )
+  {
+    if ( usingEffect )
+    {
+      mRenderer->paintEffect()->end( mContext );
+    }
+
+    mInterruptionChecker.reset();
+    return true;
+  }
+
   QgsRectangle requestExtent = mContext.extent();
   mRenderer->modifyRequestExtent( requestExtent, mContext );
 
@@ -314,6 +337,9 @@ void QgsVectorLayerRenderer::drawRenderer( QgsFeatureIterator &fit )
       if ( !fet.hasGeometry() || fet.geometry().isEmpty() )
         continue; // skip features without geometry
 
+      if ( mCollectFeatureBounds )
+        mRenderedFeatureBounds.insert( fet.id(), fet.geometry().boundingBox() );
+
       mContext.expressionContext().setFeature( fet );
 
       bool sel = mContext.showSelection() && mSelectedFeatureIds.contains( fet.id() );
@@ -396,6 +422,9 @@ void QgsVectorLayerRenderer::drawRendererLevels( QgsFeatureIterator &fit )
     if ( !fet.hasGeometry() )
       continue; // skip features without geometry
 
+    if ( mCollectFeatureBounds )
+      mRenderedFeatureBounds.insert( fet.id(), fet.geometry().boundingBox() );
+
     mContext.expressionContext().setFeature( fet );
     QgsSymbol *sym = mRenderer->symbolForFeature( fet, mContext );
     if ( !sym )
@@ -524,6 +553,107 @@ void QgsVectorLayerRenderer::stopRenderer( QgsSingleSymbolRenderer *selRenderer
 
 
 
+bool QgsVectorLayerRenderer::drawAggregatedPoints( const QString &rendererFilter )
+{
+  if ( !mPointPyramid )
+    return false;
+
+  // every point must be drawn the same way, regardless of its selection or editing state
+  if ( mDrawVertexMarkers || !mSelectedFeatureIds.isEmpty() || mLabelProvider || mDiagramProvider )
+    return false;
+
+  // and no point may be skipped
+  if ( mContext.featureFilterProvider() || mContext.hasRenderedFeatureHandlers() || mCollectFeatureBounds
+       || ( !rendererFilter.isEmpty() && rendererFilter != QLatin1String( "TRUE" ) )
+       || mRenderer->orderByEnabled()
+       || ( ( mRenderer->capabilities() & QgsFeatureRenderer::SymbolLevels ) && mRenderer->usingSymbolLevels() ) )
+    return false;
+
+  // size of a pixel in layer units
+  double pixelSize = mContext.mapToPixel().mapUnitsPerPixel();
+  const QgsCoordinateTransform ct = mContext.coordinateTransform();
+  if ( ct.isValid() && !ct.isShortCircuited() )
+  {
+    try
+    {
+      const QgsPointXY center = mContext.extent().center();
+      const QgsPointXY mapCenter = ct.transform( center );
+      const QgsPointXY offset = ct.transform( mapCenter.x() + pixelSize, mapCenter.y() + pixelSize, QgsCoordinateTransform::ReverseTransform );
+      pixelSize = std::min( std::fabs( offset.x() - center.x() ), std::fabs( offset.y() - center.y() ) );
+    }
+    catch ( QgsCsException &cse )
+    {
+      QgsDebugMsg( QStringLiteral( "Could not determine pixel size for point aggregation: %1" ).arg( cse.what() ) );
+      return false;
+    }
+  }
+
+  const int level = mPointPyramid->levelForCellSize( pixelSize );
+  if ( level < 0 )
+    return false;
+
+  const QVector< QgsPointPyramid::Cell > cells = mPointPyramid->cells( level, mContext.extent() );
+  QHash< QgsFeatureId, int > counts;
+  counts.reserve( cells.size() );
+  for ( const QgsPointPyramid::Cell &cell : cells )
+    counts.insert( cell.representativeId, cell.count );
+
+  QgsExpressionContextScope *symbolScope = QgsExpressionContextUtils::updateSymbolScope( nullptr, new QgsExpressionContextScope() );
+  mContext.expressionContext().appendScope( symbolScope );
+
+  // there may be a representative feature per pixel, so they are requested in batches
+  // to keep the size of each request (e.g. of SQL IN clauses) bounded
+  const int batchSize = 10000;
+  for ( int batchStart = 0; batchStart < cells.size() && !mContext.renderingStopped(); batchStart += batchSize )
+  {
+    QgsFeatureIds ids;
+    const int batchEnd = std::min( batchStart + batchSize, cells.size() );
+    ids.reserve( batchEnd - batchStart );
+    for ( int i = batchStart; i < batchEnd; ++i )
+      ids.insert( cells.at( i ).representativeId );
+
+    QgsFeatureRequest featureRequest = QgsFeatureRequest()
+                                       .setFilterFids( ids )
+                                       .setSubsetOfAttributes( mAttrNames, mFields )
+                                       .setExpressionContext( mContext.expressionContext() );
+    QgsFeatureIterator fit = mSource->getFeatures( featureRequest );
+    fit.setInterruptionChecker( mInterruptionChecker.get() );
+
+    QgsFeature fet;
+    while ( fit.nextFeature( fet ) )
+    {
+      if ( mContext.renderingStopped() )
+        break;
+
+      if ( !fet.hasGeometry() || fet.geometry().isEmpty() )
+        continue;
+
+      mContext.expressionContext().setFeature( fet );
+      try
+      {
+        mRenderer->renderAggregatedFeature( fet, counts.value( fet.id(), 1 ), mContext );
+      }
+      catch ( const QgsCsException &cse )
+      {
+        Q_UNUSED( cse )
+        QgsDebugMsg( QStringLiteral( "Failed to transform a point while drawing a feature with ID '%1'. Ignoring this feature. %2" )
+                     .arg( fet.id() ).arg( cse.what() ) );
+      }
+    }
+
+    if ( !fit.isValid() )
+    {
+      mErrors.append( QStringLiteral( "Data source invalid" ) );
+      break;
+    }
+  }
+
+  delete mContext.expressionContext().popScope();
+
+  stopRenderer( nullptr );
+  return true;
+}
+
 void QgsVectorLayerRenderer::prepareLabeling( QgsVectorLayer *layer, QSet<QString> &attributeNames )
 {
   // TODO: add attributes for geometry generator
@@ -45,6 +45,7 @@ typedef QList<int> QgsAttributeList;
 
 class QgsVectorLayerLabelProvider;
 class QgsVectorLayerDiagramProvider;
+class QgsPointPyramid;
 
 /**
  * \ingroup core
@@ -80,6 +81,18 @@ class QgsVectorLayerRenderer : public QgsMapLayerRenderer
 
     bool render() override;
 
+    /**
+     * Sets whether the bounding boxes of the features drawn by render() are collected.
+     * \see renderedFeatureBounds()
+     */
+    void setCollectFeatureBounds( bool collect ) { mCollectFeatureBounds = collect; }
+
+    /**
+     * Returns the bounding boxes (in layer CRS) of the features drawn by render(), by feature ID.
+     * \see setCollectFeatureBounds()
+     */
+    QMap< QgsFeatureId, QgsRectangle > renderedFeatureBounds() const { return mRenderedFeatureBounds; }
+
   private:
 
     /**
@@ -103,6 +116,13 @@ class QgsVectorLayerRenderer : public QgsMapLayerRenderer
     //! Stop version 2 renderer and selected renderer (if required)
     void stopRenderer( QgsSingleSymbolRenderer *selRenderer );
 
+    /**
+     * Draws the layer from its aggregated point pyramid, if it has been built.
+     * QgsFeatureRenderer::startRender() needs to be called before using this method.
+     * Returns FALSE if nothing was drawn, and the layer must be drawn normally.
+     */
+    bool drawAggregatedPoints( const QString &rendererFilter );
+
 
   protected:
 
@@ -151,6 +171,14 @@ class QgsVectorLayerRenderer : public QgsMapLayerRenderer
 
     QgsVectorSimplifyMethod mSimplifyMethod;
     bool mSimplifyGeometry;
+
+    //! Point pyramid of the layer, or NULLPTR if the layer is not rendered from a point pyramid
+    std::shared_ptr< const QgsPointPyramid > mPointPyramid;
+
+    //! TRUE if the bounding boxes of drawn features are collected
+    bool mCollectFeatureBounds = false;
+    //! Bounding boxes of drawn features, if collected
+    QMap< QgsFeatureId, QgsRectangle > mRenderedFeatureBounds;
 };
 
 
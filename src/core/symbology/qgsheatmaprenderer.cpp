@@ -31,6 +31,17 @@
 
 #include <QDomDocument>
 #include <QDomElement>
+#include <QThread>
+#include <QtConcurrent>
+
+///@cond PRIVATE
+
+//! Maximum number of points queued before their kernels are added to the heatmap values
+static const int MAX_PENDING_POINTS = 1 << 20;
+//! Minimum number of queued points for their kernels to be added using multiple threads
+static const int MIN_POINTS_FOR_PARALLEL_ACCUMULATION = 1000;
+
+///@endcond
 
 QgsHeatmapRenderer::QgsHeatmapRenderer()
   : QgsFeatureRenderer( QStringLiteral( "heatmapRenderer" ) )
@@ -51,6 +62,19 @@ void QgsHeatmapRenderer::initializeValues( QgsRenderContext &context )
   mFeaturesRendered = 0;
   mRadiusPixels = std::round( context.convertToPainterUnits( mRadius, mRadiusUnit, mRadiusMapUnitScale ) / mRenderQuality );
   mRadiusSquared = mRadiusPixels * mRadiusPixels;
+  mPendingPoints.clear();
+
+  // the kernel only depends on the offset from a point, so evaluate it once per offset
+  const int stampSize = 2 * mRadiusPixels;
+  mKernelStamp.resize( stampSize * stampSize );
+  for ( int dy = -mRadiusPixels; dy < mRadiusPixels; ++dy )
+  {
+    for ( int dx = -mRadiusPixels; dx < mRadiusPixels; ++dx )
+    {
+      const double distanceSquared = dx * dx + dy * dy;
+      mKernelStamp[( dy + mRadiusPixels ) * stampSize + dx + mRadiusPixels ] = distanceSquared > mRadiusSquared ? 0 : quarticKernel( std::sqrt( distanceSquared ), mRadiusPixels );
+    }
+  }
 }
 
 void QgsHeatmapRenderer::startRender( QgsRenderContext &context, const QgsFields &fields )
@@ -127,8 +151,37 @@ bool QgsHeatmapRenderer::renderFeature( const QgsFeature &feature, QgsRenderCont
     }
   }
 
-  int width = context.painter()->device()->width() / mRenderQuality;
-  int height = context.painter()->device()->height() / mRenderQuality;
+  addWeightedFeature( feature, weight, context );
+  return true;
+}
+
+bool QgsHeatmapRenderer::canRenderAggregatedPoints() const
+{
+  // weights would have to be summed over each aggregated cell
+  return mWeightExpressionString.isEmpty();
+}
+
+bool QgsHeatmapRenderer::renderAggregatedFeature( const QgsFeature &feature, int count, QgsRenderContext &context )
+{
+  if ( !context.painter() )
+  {
+    return false;
+  }
+
+  if ( !feature.hasGeometry() || feature.geometry().type() != QgsWkbTypes::PointGeometry )
+  {
+    //can only render point type
+    return false;
+  }
+
+  addWeightedFeature( feature, count, context );
+  return true;
+}
+
+void QgsHeatmapRenderer::addWeightedFeature( const QgsFeature &feature, double weight, QgsRenderContext &context )
+{
+  const int width = context.painter()->device()->width() / mRenderQuality;
+  const int height = context.painter()->device()->height() / mRenderQuality;
 
   //transform geometry if required
   QgsGeometry geom = feature.geometry();
@@ -141,41 +194,21 @@ bool QgsHeatmapRenderer::renderFeature( const QgsFeature &feature, QgsRenderCont
   //convert point to multipoint
   QgsMultiPointXY multiPoint = convertToMultipoint( &geom );
 
-  //loop through all points in multipoint
+  //queue all points in multipoint
   for ( QgsMultiPointXY::const_iterator pointIt = multiPoint.constBegin(); pointIt != multiPoint.constEnd(); ++pointIt )
   {
     QgsPointXY pixel = context.mapToPixel().transform( *pointIt );
     int pointX = pixel.x() / mRenderQuality;
     int pointY = pixel.y() / mRenderQuality;
-    for ( int x = std::max( pointX - mRadiusPixels, 0 ); x < std::min( pointX + mRadiusPixels, width ); ++x )
-    {
-      if ( context.renderingStopped() )
-        break;
+    if ( pointX + mRadiusPixels <= 0 || pointX - mRadiusPixels >= width || pointY + mRadiusPixels <= 0 || pointY - mRadiusPixels >= height )
+      continue;
 
-      for ( int y = std::max( pointY - mRadiusPixels, 0 ); y < std::min( pointY + mRadiusPixels, height ); ++y )
-      {
-        int index = y * width + x;
-        if ( index >= mValues.count() )
-        {
-          continue;
-        }
-        double distanceSquared = std::pow( pointX - x, 2.0 ) + std::pow( pointY - y, 2.0 );
-        if ( distanceSquared > mRadiusSquared )
-        {
-          continue;
-        }
-
-        double score = weight * quarticKernel( std::sqrt( distanceSquared ), mRadiusPixels );
-        double value = mValues.at( index ) + score;
-        if ( value > mCalculatedMaxValue )
-        {
-          mCalculatedMaxValue = value;
-        }
-        mValues[ index ] = value;
-      }
-    }
+    mPendingPoints.append( PendingPoint{ pointX, pointY, weight } );
   }
 
+  if ( mPendingPoints.size() >= MAX_PENDING_POINTS )
+    accumulatePendingPoints( context );
+
   mFeaturesRendered++;
 #if 0
   //TODO - enable progressive rendering
@@ -184,9 +217,87 @@ bool QgsHeatmapRenderer::renderFeature( const QgsFeature &feature, QgsRenderCont
     renderImage( context );
   }
 #endif
-  return true;
 }
 
+void QgsHeatmapRenderer::accumulatePendingPoints( QgsRenderContext &context )
+{
+  const int width = context.painter()->device()->width() / mRenderQuality;
+  const int height = context.painter()->device()->height() / mRenderQuality;
+  if ( mPendingPoints.isEmpty() || mRadiusPixels <= 0 || width <= 0 || height <= 0 || context.renderingStopped() )
+  {
+    mPendingPoints.clear();
+    return;
+  }
+
+  // split the values into bands of rows, so that each band can be accumulated by a separate
+  // thread without locking. Points are still added in their original order within each band,
+  // so the result does not depend on the number of bands.
+  struct Band
+  {
+    int firstRow = 0;
+    int lastRow = 0;
+    QVector< int > points;
+    double maxValue = 0;
+  };
+
+  const int bandCount = mPendingPoints.size() < MIN_POINTS_FOR_PARALLEL_ACCUMULATION ? 1
+                        : std::min( height, 4 * std::max( 1, QThread::idealThreadCount() ) );
+  const int bandHeight = ( height + bandCount - 1 ) / bandCount;
+  QVector< Band > bands( ( height + bandHeight - 1 ) / bandHeight );
+  for ( int i = 0; i < bands.size(); ++i )
+  {
+    bands[i].firstRow = i * bandHeight;
+    bands[i].lastRow = std::min( ( i + 1 ) * bandHeight, height ) - 1;
+  }
+
+  for ( int i = 0; i < mPendingPoints.size(); ++i )
+  {
+    const PendingPoint &point = mPendingPoints.at( i );
+    const int firstRow = std::max( point.y - mRadiusPixels, 0 );
+    const int lastRow = std::min( point.y + mRadiusPixels, height ) - 1;
+    for ( int band = firstRow / bandHeight; band <= lastRow / bandHeight; ++band )
+      bands[band].points << i;
+  }
+
+  double *values = mValues.data();
+  const int stampSize = 2 * mRadiusPixels;
+  auto accumulateBand = [this, values, width, stampSize, &context]( Band &band )
+  {
+    for ( int i : qgis::as_const( band.points ) )
+    {
+      if ( context.renderingStopped() )
+        break;
+
+      const PendingPoint &point = mPendingPoints.at( i );
+      const int x0 = std::max( point.x - mRadiusPixels, 0 );
+      const int x1 = std::min( point.x + mRadiusPixels, width );
+      const int y0 = std::max( point.y - mRadiusPixels, band.firstRow );
+      const int y1 = std::min( point.y + mRadiusPixels, band.lastRow + 1 );
+      for ( int y = y0; y < y1; ++y )
+      {
+        const double *stamp = mKernelStamp.constData() + ( y - point.y + mRadiusPixels ) * stampSize + x0 - point.x + mRadiusPixels;
+        double *row = values + y * width;
+        for ( int x = x0; x < x1; ++x )
+          row[x] += point.weight * *stamp++;
+      }
+    }
+
+    const double *bandValues = values + band.firstRow * width;
+    const int bandSize = ( band.lastRow - band.firstRow + 1 ) * width;
+    for ( int i = 0; i < bandSize; ++i )
+      band.maxValue = std::max( band.maxValue, bandValues[i] );
+  };
+
+  if ( bands.size() == 1 )
+    accumulateBand( bands[0] );
+  else
+    QtConcurrent::blockingMap( bands, accumulateBand );
+
+  for ( const Band &band : qgis::as_const( bands ) )
+    mCalculatedMaxValue = std::max( mCalculatedMaxValue, band.maxValue );
+
+  mPendingPoints.clear();
+}
 
 double QgsHeatmapRenderer::uniformKernel( const double distance, const int bandwidth ) const
 {
@@ -219,6 +330,8 @@ void QgsHeatmapRenderer::stopRender( QgsRenderContext &context )
 {
   QgsFeatureRenderer::stopRender( context );
 
+  if ( context.painter() )
+    accumulatePendingPoints( context );
   renderImage( context );
   mWeightExpression.reset();
 }
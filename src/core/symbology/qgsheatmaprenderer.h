@@ -46,6 +46,8 @@ class CORE_EXPORT QgsHeatmapRenderer : public QgsFeatureRenderer
     QgsHeatmapRenderer *clone() const override SIP_FACTORY;
     void startRender( QgsRenderContext &context, const QgsFields &fields ) override;
     bool renderFeature( const QgsFeature &feature, QgsRenderContext &context, int layer = -1, bool selected = false, bool drawVertexMarker = false ) override SIP_THROW( QgsCsException );
+    bool canRenderAggregatedPoints() const override SIP_SKIP;
+    bool renderAggregatedFeature( const QgsFeature &feature, int count, QgsRenderContext &context ) override SIP_SKIP;
     void stopRender( QgsRenderContext &context ) override;
     //! \note symbolForFeature2 in Python bindings
     QgsSymbol *symbolForFeature( const QgsFeature &feature, QgsRenderContext &context ) const override;
@@ -181,8 +183,22 @@ class CORE_EXPORT QgsHeatmapRenderer : public QgsFeatureRenderer
 
   private:
 
+    //! A point which has not yet been added to the heatmap values, in heatmap pixels
+    struct PendingPoint
+    {
+      int x;
+      int y;
+      double weight;
+    };
+
     QVector<double> mValues;
 
+    //! Kernel values for all pixel offsets from a point, precomputed for the current radius
+    QVector<double> mKernelStamp;
+
+    //! Points waiting to be added to mValues
+    QVector<PendingPoint> mPendingPoints;
+
     double mCalculatedMaxValue = 0;
 
     double mRadius = 10;
@@ -209,6 +225,10 @@ class CORE_EXPORT QgsHeatmapRenderer : public QgsFeatureRenderer
     double triangularKernel( double distance, int bandwidth ) const;
 
     QgsMultiPointXY convertToMultipoint( const QgsGeometry *geom );
+    //! Queues the kernel density of \a feature's points for addition to the heatmap values, with the specified \a weight
+    void addWeightedFeature( const QgsFeature &feature, double weight, QgsRenderContext &context );
+    //! Adds the kernel densities of all pending points to the heatmap values
+    void accumulatePendingPoints( QgsRenderContext &context );
     void initializeValues( QgsRenderContext &context );
     void renderImage( QgsRenderContext &context );
 };
@@ -0,0 +1,129 @@
+/***************************************************************************
+ qgsmarkersymbolatlas.cpp
+ ------------------------
+ begin                : October 2026
+ copyright            : (C) 2026 by agent
+ email                : agent at local
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qgsmarkersymbolatlas.h"
+#include "qgssymbol.h"
+#include "qgssymbollayer.h"
+#include "qgsrendercontext.h"
+#include "qgspainteffect.h"
+
+#include <QPainter>
+#include <cmath>
+
+bool QgsMarkerSymbolAtlas::canUseAtlas( const QgsMarkerSymbol *symbol, const QgsRenderContext &context )
+{
+  if ( context.flags() & QgsRenderContext::ForceVectorOutput )
+    return false;
+
+  if ( !context.painter() || !context.painter()->device() || context.painter()->device()->devType() != QInternal::Image )
+    return false;
+
+  const QgsSymbolLayerList layers = symbol->symbolLayers();
+  bool hasDataDefinedAngle = false;
+  int enabledLayers = 0;
+  for ( const QgsSymbolLayer *layer : layers )
+  {
+    if ( !layer->enabled() )
+      continue;
+
+    enabledLayers++;
+
+    // only layers whose appearance is fully determined by their properties can be rasterized,
+    // e.g. geometry generators and vector fields depend on the feature itself
+    const QString type = layer->layerType();
+    if ( type != QLatin1String( "SimpleMarker" ) && type != QLatin1String( "SvgMarker" )
+         && type != QLatin1String( "FontMarker" ) && type != QLatin1String( "EllipseMarker" ) )
+      return false;
+
+    // effects may draw outside of the marker bounds
+    if ( layer->paintEffect() && layer->paintEffect()->enabled() )
+      return false;
+
+    const QgsPropertyCollection &properties = layer->dataDefinedProperties();
+    const QSet< int > keys = properties.propertyKeys();
+    for ( int key : keys )
+    {
+      if ( !properties.isActive( key ) )
+        continue;
+
+      if ( key != QgsSymbolLayer::PropertyAngle )
+        return false;
+
+      hasDataDefinedAngle = true;
+    }
+  }
+
+  if ( enabledLayers == 0 )
+    return false;
+
+  // simple and svg markers already draw from a cached image when they don't use data defined properties
+  if ( enabledLayers == 1 && !hasDataDefinedAngle )
+  {
+    for ( const QgsSymbolLayer *layer : layers )
+    {
+      if ( layer->enabled() && ( layer->layerType() == QLatin1String( "SimpleMarker" ) || layer->layerType() == QLatin1String( "SvgMarker" ) ) )
+        return false;
+    }
+  }
+
+  return true;
+}
+
+bool QgsMarkerSymbolAtlas::painterSupportsAtlas( const QgsRenderContext &context )
+{
+  // rotated or scaled painters would require resampling the rasterized markers
+  const QPainter *painter = context.painter();
+  return painter && painter->device() && painter->device()->devType() == QInternal::Image
+         && painter->transform().type() <= QTransform::TxTranslate;
+}
+
+QVector<qint64> QgsMarkerSymbolAtlas::markerKey( const QList<QgsSymbolLayer *> &layers, QgsRenderContext &context, int layerIndex, bool selected )
+{
+  QVector< qint64 > key;
+  key.reserve( layers.size() + 2 );
+  key << layerIndex << ( selected ? 1 : 0 );
+
+  for ( int i = 0; i < layers.size(); ++i )
+  {
+    if ( layerIndex >= 0 && i != layerIndex )
+      continue;
+
+    QgsSymbolLayer *layer = layers.at( i );
+    if ( !layer->enabled() || !layer->dataDefinedProperties().isActive( QgsSymbolLayer::PropertyAngle ) )
+      continue;
+
+    double angle = layer->dataDefinedProperties().valueAsDouble( QgsSymbolLayer::PropertyAngle, context.expressionContext(), 0 );
+    angle = std::fmod( angle, 360.0 );
+    if ( angle < 0 )
+      angle += 360;
+    key << static_cast< qint64 >( std::floor( angle / ANGLE_BUCKET_SIZE ) );
+  }
+  return key;
+}
+
+const QgsMarkerSymbolAtlas::Entry *QgsMarkerSymbolAtlas::entry( const QVector<qint64> &key ) const
+{
+  auto it = mEntries.constFind( key );
+  return it != mEntries.constEnd() ? &it.value() : nullptr;
+}
+
+const QgsMarkerSymbolAtlas::Entry *QgsMarkerSymbolAtlas::addEntry( const QVector<qint64> &key, const QImage &image, QPointF origin )
+{
+  Entry entry;
+  entry.image = image;
+  entry.origin = origin;
+  auto it = mEntries.insert( key, entry );
+  return &it.value();
+}
@@ -0,0 +1,114 @@
+/***************************************************************************
+ qgsmarkersymbolatlas.h
+ ----------------------
+ begin                : October 2026
+ copyright            : (C) 2026 by agent
+ email                : agent at local
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef QGSMARKERSYMBOLATLAS_H
+#define QGSMARKERSYMBOLATLAS_H
+
+#define SIP_NO_FILE
+
+#include "qgis_core.h"
+
+#include <QHash>
+#include <QImage>
+#include <QPointF>
+#include <QVector>
+
+class QgsMarkerSymbol;
+class QgsRenderContext;
+class QgsSymbolLayer;
+
+/**
+ * \ingroup core
+ * \class QgsMarkerSymbolAtlas
+ * \brief Stores pre-rasterized images of a marker symbol for the duration of a render.
+ *
+ * When rendering many points to a raster image, each distinct appearance of a marker symbol
+ * (i.e. combination of symbol layer, selection state and data defined rotation) is rendered
+ * once at device resolution and then drawn as an image for all subsequent points.
+ *
+ * Rotations are grouped into buckets of ANGLE_BUCKET_SIZE degrees, so markers may be drawn
+ * with a rotation which differs from the exact data defined rotation by up to this amount.
+ * Markers are always drawn as vectors when rendering to a non-raster device (e.g. PDF or
+ * print output), or when the marker is too large to rasterize accurately.
+ *
+ * \note not available in Python bindings
+ * \since QGIS 3.10
+ */
+class CORE_EXPORT QgsMarkerSymbolAtlas
+{
+  public:
+
+    //! Size of rotation buckets, in degrees
+    static constexpr double ANGLE_BUCKET_SIZE = 0.25;
+
+    //! Maximum width or height of a rasterized marker, in pixels
+    static const int MAX_MARKER_SIZE = 256;
+
+    //! Maximum number of rasterized markers stored by a single atlas
+    static const int MAX_ENTRIES = 4096;
+
+    //! A single rasterized marker
+    struct Entry
+    {
+      //! Rendered marker
+      QImage image;
+      //! Position of the marker's point within the image, in painter units
+      QPointF origin;
+    };
+
+    /**
+     * Returns TRUE if the points of the specified \a symbol can be rendered from an atlas
+     * when rendering using the specified \a context.
+     */
+    static bool canUseAtlas( const QgsMarkerSymbol *symbol, const QgsRenderContext &context );
+
+    /**
+     * Returns TRUE if the current painter for the specified \a context can draw
+     * rasterized markers without loss of accuracy.
+     */
+    static bool painterSupportsAtlas( const QgsRenderContext &context );
+
+    /**
+     * Returns the key identifying the appearance of a marker, for the specified symbol \a layers.
+     * The current feature's data defined rotations are evaluated using the \a context.
+     * \param layers symbol layers being rendered
+     * \param context render context, with the expression context set for the feature being rendered
+     * \param layerIndex index of rendered symbol layer, or -1 if all layers are being rendered
+     * \param selected TRUE if the marker is rendered as selected
+     */
+    static QVector< qint64 > markerKey( const QList< QgsSymbolLayer * > &layers, QgsRenderContext &context, int layerIndex, bool selected );
+
+    /**
+     * Returns the entry with matching \a key, or nullptr if no matching marker has been rasterized.
+     */
+    const Entry *entry( const QVector< qint64 > &key ) const;
+
+    /**
+     * Returns TRUE if the atlas can store additional entries.
+     */
+    bool isFull() const { return mEntries.size() >= MAX_ENTRIES; }
+
+    /**
+     * Stores a rasterized marker \a image for the specified \a key. The \a origin specifies
+     * the marker's point within the image.
+     */
+    const Entry *addEntry( const QVector< qint64 > &key, const QImage &image, QPointF origin );
+
+  private:
+
+    QHash< QVector< qint64 >, Entry > mEntries;
+};
+
+#endif // QGSMARKERSYMBOLATLAS_H
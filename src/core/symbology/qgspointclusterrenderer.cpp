@@ -62,7 +62,7 @@ QgsPointClusterRenderer *QgsPointClusterRenderer::clone() const
 
 void QgsPointClusterRenderer::drawGroup( QPointF centerPoint, QgsRenderContext &context, const ClusteredGroup &group )
 {
-  if ( group.size() > 1 )
+  if ( groupPointCount( group ) > 1 )
   {
     mClusterSymbol->renderPoint( centerPoint, &( group.at( 0 ).feature ), context, -1, false );
   }
@@ -76,6 +76,12 @@ void QgsPointClusterRenderer::drawGroup( QPointF centerPoint, QgsRenderContext &
   }
 }
 
+bool QgsPointClusterRenderer::canRenderAggregatedPoints() const
+{
+  // points within a pixel always fall within the same cluster
+  return true;
+}
+
 void QgsPointClusterRenderer::startRender( QgsRenderContext &context, const QgsFields &fields )
 {
   if ( mClusterSymbol )
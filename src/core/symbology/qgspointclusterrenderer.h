@@ -40,6 +40,7 @@ class CORE_EXPORT QgsPointClusterRenderer: public QgsPointDistanceRenderer
     QDomElement save( QDomDocument &doc, const QgsReadWriteContext &context ) override;
     QSet<QString> usedAttributes( const QgsRenderContext &context ) const override;
     bool accept( QgsStyleEntityVisitorInterface *visitor ) const override;
+    bool canRenderAggregatedPoints() const override SIP_SKIP;
 
     //! Creates a renderer from XML element
     static QgsFeatureRenderer *create( QDomElement &symbologyElem, const QgsReadWriteContext &context ) SIP_FACTORY;
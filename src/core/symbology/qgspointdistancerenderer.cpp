@@ -18,7 +18,6 @@
 #include "qgspointdistancerenderer.h"
 #include "qgsgeometry.h"
 #include "qgssymbollayerutils.h"
-#include "qgsspatialindex.h"
 #include "qgsmultipoint.h"
 #include "qgslogger.h"
 #include "qgsstyleentityvisitor.h"
@@ -28,6 +27,7 @@
 #include <QPainter>
 
 #include <cmath>
+#include <limits>
 
 QgsPointDistanceRenderer::QgsPointDistanceRenderer( const QString &rendererName, const QString &labelAttributeName )
   : QgsFeatureRenderer( rendererName )
@@ -50,9 +50,18 @@ void QgsPointDistanceRenderer::toSld( QDomDocument &doc, QDomElement &element, c
 bool QgsPointDistanceRenderer::renderFeature( const QgsFeature &feature, QgsRenderContext &context, int layer, bool selected, bool drawVertexMarker )
 {
   Q_UNUSED( drawVertexMarker )
-  Q_UNUSED( context )
   Q_UNUSED( layer )
 
+  return addFeatureToGroups( feature, context, selected, 1 );
+}
+
+bool QgsPointDistanceRenderer::renderAggregatedFeature( const QgsFeature &feature, int count, QgsRenderContext &context )
+{
+  return addFeatureToGroups( feature, context, false, count );
+}
+
+bool QgsPointDistanceRenderer::addFeatureToGroups( const QgsFeature &feature, QgsRenderContext &context, bool selected, int count )
+{
   /*
    * IMPORTANT: This algorithm is ported to Python in the processing "Points Displacement" algorithm.
    * Please port any changes/improvements to that algorithm too!
@@ -91,65 +100,79 @@ bool QgsPointDistanceRenderer::renderFeature( const QgsFeature &feature, QgsRend
     transformedFeature.setGeometry( geom );
   }
 
-  double searchDistance = context.convertToMapUnits( mTolerance, mToleranceUnit, mToleranceMapUnitScale );
   QgsPointXY point = transformedFeature.geometry().asPoint();
-  QList<QgsFeatureId> intersectList = mSpatialIndex->intersects( searchRect( point, searchDistance ) );
-  if ( intersectList.empty() )
+
+  // share a single clone of each symbol between all grouped features
+  std::shared_ptr< QgsMarkerSymbol > &symbolClone = mSymbolClones[ symbol ];
+  if ( !symbolClone )
+    symbolClone.reset( symbol->clone() );
+
+  const int groupIdx = closestGroup( point );
+  if ( groupIdx < 0 )
   {
-    mSpatialIndex->addFeature( transformedFeature );
     // create new group
     ClusteredGroup newGroup;
-    newGroup << GroupedFeature( transformedFeature, symbol->clone(), selected, label );
+    newGroup << GroupedFeature( transformedFeature, symbolClone, selected, label );
     mClusteredGroups.push_back( newGroup );
-    // add to group index
-    mGroupIndex.insert( transformedFeature.id(), mClusteredGroups.count() - 1 );
-    mGroupLocations.insert( transformedFeature.id(), point );
+
+    GroupLocation location;
+    location.firstPoint = point;
+    location.centroid = point;
+    location.pointCount = count;
+    mGroupLocations.push_back( location );
+    mGroupGrid[ gridCell( point ) ].append( mClusteredGroups.count() - 1 );
   }
   else
   {
-    // find group with closest location to this point (may be more than one within search tolerance)
-    QgsFeatureId minDistFeatureId = intersectList.at( 0 );
-    double minDist = mGroupLocations.value( minDistFeatureId ).distance( point );
-    for ( int i = 1; i < intersectList.count(); ++i )
-    {
-      QgsFeatureId candidateId = intersectList.at( i );
-      double newDist = mGroupLocations.value( candidateId ).distance( point );
-      if ( newDist < minDist )
-      {
-        minDist = newDist;
-        minDistFeatureId = candidateId;
-      }
-    }
-
-    int groupIdx = mGroupIndex[ minDistFeatureId ];
-    ClusteredGroup &group = mClusteredGroups[groupIdx];
-
     // calculate new centroid of group
-    QgsPointXY oldCenter = mGroupLocations.value( minDistFeatureId );
-    mGroupLocations[ minDistFeatureId ] = QgsPointXY( ( oldCenter.x() * group.size() + point.x() ) / ( group.size() + 1.0 ),
-                                          ( oldCenter.y() * group.size() + point.y() ) / ( group.size() + 1.0 ) );
+    GroupLocation &location = mGroupLocations[ groupIdx ];
+    const double groupCount = location.pointCount;
+    location.centroid = QgsPointXY( ( location.centroid.x() * groupCount + point.x() * count ) / ( groupCount + count ),
+                                    ( location.centroid.y() * groupCount + point.y() * count ) / ( groupCount + count ) );
+    location.pointCount += count;
 
     // add to a group
-    group << GroupedFeature( transformedFeature, symbol->clone(), selected, label );
-    // add to group index
-    mGroupIndex.insert( transformedFeature.id(), groupIdx );
+    mClusteredGroups[ groupIdx ] << GroupedFeature( transformedFeature, symbolClone, selected, label );
   }
 
+  if ( count > 1 )
+    mAggregatedCounts.insert( transformedFeature.id(), count );
+
   return true;
 }
 
 void QgsPointDistanceRenderer::drawGroup( const ClusteredGroup &group, QgsRenderContext &context )
 {
   //calculate centroid of all points, this will be center of group
-  QgsMultiPoint *groupMultiPoint = new QgsMultiPoint();
-  const auto constGroup = group;
-  for ( const GroupedFeature &f : constGroup )
+  QPointF pt;
+  if ( mAggregatedCounts.isEmpty() )
+  {
+    QgsMultiPoint *groupMultiPoint = new QgsMultiPoint();
+    const auto constGroup = group;
+    for ( const GroupedFeature &f : constGroup )
+    {
+      groupMultiPoint->addGeometry( f.feature.geometry().constGet()->clone() );
+    }
+    QgsGeometry groupGeom( groupMultiPoint );
+    QgsGeometry centroid = groupGeom.centroid();
+    pt = centroid.asQPointF();
+  }
+  else
   {
-    groupMultiPoint->addGeometry( f.feature.geometry().constGet()->clone() );
+    // weight aggregated features by the number of points they represent
+    double sumX = 0;
+    double sumY = 0;
+    int pointCount = 0;
+    for ( const GroupedFeature &f : group )
+    {
+      const int count = mAggregatedCounts.value( f.feature.id(), 1 );
+      const QgsPointXY point = f.feature.geometry().asPoint();
+      sumX += point.x() * count;
+      sumY += point.y() * count;
+      pointCount += count;
+    }
+    pt = QPointF( sumX / pointCount, sumY / pointCount );
   }
-  QgsGeometry groupGeom( groupMultiPoint );
-  QgsGeometry centroid = groupGeom.centroid();
-  QPointF pt = centroid.asQPointF();
   context.mapToPixel().transformInPlace( pt.rx(), pt.ry() );
 
   QgsExpressionContextScopePopper scopePopper( context.expressionContext(), createGroupScope( group ) );
@@ -308,9 +331,11 @@ void QgsPointDistanceRenderer::startRender( QgsRenderContext &context, const Qgs
   mRenderer->startRender( context, fields );
 
   mClusteredGroups.clear();
-  mGroupIndex.clear();
   mGroupLocations.clear();
-  mSpatialIndex = new QgsSpatialIndex;
+  mGroupGrid.clear();
+  mSymbolClones.clear();
+  mAggregatedCounts.clear();
+  mSearchDistance = context.convertToMapUnits( mTolerance, mToleranceUnit, mToleranceMapUnitScale );
 
   if ( mLabelAttributeName.isEmpty() )
   {
@@ -347,10 +372,10 @@ void QgsPointDistanceRenderer::stopRender( QgsRenderContext &context )
   }
 
   mClusteredGroups.clear();
-  mGroupIndex.clear();
   mGroupLocations.clear();
-  delete mSpatialIndex;
-  mSpatialIndex = nullptr;
+  mGroupGrid.clear();
+  mSymbolClones.clear();
+  mAggregatedCounts.clear();
 
   mRenderer->stopRender( context );
 }
@@ -364,9 +389,46 @@ QgsLegendSymbolList QgsPointDistanceRenderer::legendSymbolItems() const
   return QgsLegendSymbolList();
 }
 
-QgsRectangle QgsPointDistanceRenderer::searchRect( const QgsPointXY &p, double distance ) const
+int QgsPointDistanceRenderer::closestGroup( const QgsPointXY &point ) const
+{
+  // groups are found by their first point, which lies within the search distance of the point
+  // and so within the neighboring grid cells
+  const QPair< qint64, qint64 > cell = gridCell( point );
+  int closest = -1;
+  double minDist = std::numeric_limits< double >::max();
+  for ( qint64 column = cell.first - 1; column <= cell.first + 1; ++column )
+  {
+    for ( qint64 row = cell.second - 1; row <= cell.second + 1; ++row )
+    {
+      const auto it = mGroupGrid.constFind( qMakePair( column, row ) );
+      if ( it == mGroupGrid.constEnd() )
+        continue;
+
+      for ( int groupIdx : it.value() )
+      {
+        const GroupLocation &location = mGroupLocations.at( groupIdx );
+        if ( std::fabs( location.firstPoint.x() - point.x() ) > mSearchDistance
+             || std::fabs( location.firstPoint.y() - point.y() ) > mSearchDistance )
+          continue;
+
+        // join the group with the closest location (there may be more than one within search tolerance)
+        const double dist = location.centroid.distance( point );
+        if ( dist < minDist || ( qgsDoubleNear( dist, minDist ) && groupIdx < closest ) )
+        {
+          minDist = dist;
+          closest = groupIdx;
+        }
+      }
+    }
+  }
+  return closest;
+}
+
+QPair<qint64, qint64> QgsPointDistanceRenderer::gridCell( const QgsPointXY &point ) const
 {
-  return QgsRectangle( p.x() - distance, p.y() - distance, p.x() + distance, p.y() + distance );
+  const double cellSize = mSearchDistance > 0 ? mSearchDistance : 1.0;
+  return qMakePair( static_cast< qint64 >( std::floor( point.x() / cellSize ) ),
+                    static_cast< qint64 >( std::floor( point.y() / cellSize ) ) );
 }
 
 void QgsPointDistanceRenderer::printGroupInfo() const
@@ -443,10 +505,22 @@ void QgsPointDistanceRenderer::drawLabels( QPointF centerPoint, QgsSymbolRenderC
   }
 }
 
+int QgsPointDistanceRenderer::groupPointCount( const ClusteredGroup &group ) const
+{
+  if ( mAggregatedCounts.isEmpty() )
+    return group.size();
+
+  int count = 0;
+  for ( const GroupedFeature &f : group )
+    count += mAggregatedCounts.value( f.feature.id(), 1 );
+  return count;
+}
+
 QgsExpressionContextScope *QgsPointDistanceRenderer::createGroupScope( const ClusteredGroup &group ) const
 {
   QgsExpressionContextScope *clusterScope = new QgsExpressionContextScope();
-  if ( group.size() > 1 )
+  const int pointCount = groupPointCount( group );
+  if ( pointCount > 1 )
   {
     //scan through symbols to check color, e.g., if all clustered symbols are same color
     QColor groupColor;
@@ -480,7 +554,7 @@ QgsExpressionContextScope *QgsPointDistanceRenderer::createGroupScope( const Clu
       clusterScope->addVariable( QgsExpressionContextScope::StaticVariable( QgsExpressionContext::EXPR_CLUSTER_COLOR, QVariant(), true ) );
     }
 
-    clusterScope->addVariable( QgsExpressionContextScope::StaticVariable( QgsExpressionContext::EXPR_CLUSTER_SIZE, group.size(), true ) );
+    clusterScope->addVariable( QgsExpressionContextScope::StaticVariable( QgsExpressionContext::EXPR_CLUSTER_SIZE, pointCount, true ) );
   }
   if ( !group.empty() )
   {
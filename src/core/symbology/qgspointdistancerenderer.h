@@ -22,8 +22,9 @@
 #include "qgis.h"
 #include "qgsrenderer.h"
 #include <QFont>
+#include <QHash>
+#include <QVector>
 
-class QgsSpatialIndex;
 
 /**
  * \class QgsPointDistanceRenderer
@@ -57,6 +58,22 @@ class CORE_EXPORT QgsPointDistanceRenderer: public QgsFeatureRenderer
           , mSymbol( symbol )
         {}
 
+        /**
+         * Constructor for GroupedFeature, with a \a symbol which may be shared with other grouped features.
+         * \param feature feature
+         * \param symbol base symbol for rendering feature
+         * \param isSelected set to TRUE if feature is selected and should be rendered in a selected state
+         * \param label optional label text, or empty string for no label
+         * \note not available in Python bindings
+         * \since QGIS 3.10
+         */
+        GroupedFeature( const QgsFeature &feature, const std::shared_ptr< QgsMarkerSymbol > &symbol, bool isSelected, const QString &label = QString() ) SIP_SKIP
+          : feature( feature )
+          , isSelected( isSelected )
+          , label( label )
+          , mSymbol( symbol )
+        {}
+
         //! Feature
         QgsFeature feature;
 
@@ -85,6 +102,7 @@ class CORE_EXPORT QgsPointDistanceRenderer: public QgsFeatureRenderer
 
     void toSld( QDomDocument &doc, QDomElement &element, const QgsStringMap &props = QgsStringMap() ) const override;
     bool renderFeature( const QgsFeature &feature, QgsRenderContext &context, int layer = -1, bool selected = false, bool drawVertexMarker = false ) override SIP_THROW( QgsCsException );
+    bool renderAggregatedFeature( const QgsFeature &feature, int count, QgsRenderContext &context ) override SIP_SKIP;
     QSet<QString> usedAttributes( const QgsRenderContext &context ) const override;
     bool filterNeedsGeometry() const override;
     QgsFeatureRenderer::Capabilities capabilities() override;
@@ -258,15 +276,6 @@ class CORE_EXPORT QgsPointDistanceRenderer: public QgsFeatureRenderer
     //! Groups of features that are considered clustered together.
     QList<ClusteredGroup> mClusteredGroups;
 
-    //! Mapping of feature ID to the feature's group index.
-    QMap<QgsFeatureId, int> mGroupIndex;
-
-    //! Mapping of feature ID to approximate group location
-    QMap<QgsFeatureId, QgsPointXY > mGroupLocations;
-
-    //! Spatial index for fast lookup of nearby points.
-    QgsSpatialIndex *mSpatialIndex = nullptr;
-
     /**
      * Renders the labels for a group.
      * \param centerPoint center point of group
@@ -277,6 +286,14 @@ class CORE_EXPORT QgsPointDistanceRenderer: public QgsFeatureRenderer
      */
     void drawLabels( QPointF centerPoint, QgsSymbolRenderContext &context, const QList<QPointF> &labelShifts, const ClusteredGroup &group );
 
+    /**
+     * Returns the number of points in a \a group. This may be larger than the group's
+     * size if the group contains features aggregated from a point pyramid.
+     * \note not available in Python bindings
+     * \since QGIS 3.10
+     */
+    int groupPointCount( const ClusteredGroup &group ) const SIP_SKIP;
+
   private:
 
     /**
@@ -287,9 +304,6 @@ class CORE_EXPORT QgsPointDistanceRenderer: public QgsFeatureRenderer
      */
     virtual void drawGroup( QPointF centerPoint, QgsRenderContext &context, const ClusteredGroup &group ) = 0 SIP_FORCE;
 
-    //! Creates a search rectangle with specified distance tolerance.
-    QgsRectangle searchRect( const QgsPointXY &p, double distance ) const;
-
     //! Debugging function to check the entries in the clustered groups
     void printGroupInfo() const;
 
@@ -313,6 +327,41 @@ class CORE_EXPORT QgsPointDistanceRenderer: public QgsFeatureRenderer
      */
     QgsExpressionContextScope *createGroupScope( const ClusteredGroup &group ) const;
 
+    //! Adds a feature representing \a count points to the clustered groups
+    bool addFeatureToGroups( const QgsFeature &feature, QgsRenderContext &context, bool selected, int count );
+
+    //! Returns the index of the group a point at \a point should be added to, or -1 if it starts a new group
+    int closestGroup( const QgsPointXY &point ) const;
+
+    //! Returns the key of the grid cell containing \a point
+    QPair< qint64, qint64 > gridCell( const QgsPointXY &point ) const;
+
+    //! Location of a clustered group
+    struct GroupLocation
+    {
+      //! Location of the first point in the group, which determines the group's grid cell
+      QgsPointXY firstPoint;
+      //! Approximate group location (the centroid of the group's points)
+      QgsPointXY centroid;
+      //! Number of points in the group
+      int pointCount = 0;
+    };
+
+    //! Locations of the clustered groups, by group index
+    QVector< GroupLocation > mGroupLocations;
+
+    //! Indices of the groups starting within each grid cell. The grid cell size is the search distance.
+    QHash< QPair< qint64, qint64 >, QVector< int > > mGroupGrid;
+
+    //! Distance tolerance in map units, for the current render
+    double mSearchDistance = 0;
+
+    //! Clones of the embedded renderer's symbols, shared between grouped features
+    QHash< const QgsMarkerSymbol *, std::shared_ptr< QgsMarkerSymbol > > mSymbolClones;
+
+    //! Number of aggregated points represented by features, for features representing more than one point
+    QHash< QgsFeatureId, int > mAggregatedCounts;
+
 };
 
 #endif // QGSPOINTDISTANCERENDERER_H
@@ -130,6 +130,17 @@ bool QgsFeatureRenderer::renderFeature( const QgsFeature &feature, QgsRenderCont
   return true;
 }
 
+bool QgsFeatureRenderer::canRenderAggregatedPoints() const
+{
+  return false;
+}
+
+bool QgsFeatureRenderer::renderAggregatedFeature( const QgsFeature &feature, int count, QgsRenderContext &context )
+{
+  Q_UNUSED( count )
+  return renderFeature( feature, context );
+}
+
 void QgsFeatureRenderer::renderFeatureWithSymbol( const QgsFeature &feature, QgsSymbol *symbol, QgsRenderContext &context, int layer, bool selected, bool drawVertexMarker )
 {
   symbol->renderFeature( feature, context, layer, selected, drawVertexMarker, mCurrentVertexMarkerType, mCurrentVertexMarkerSize );
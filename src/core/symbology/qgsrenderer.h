@@ -231,6 +231,33 @@ class CORE_EXPORT QgsFeatureRenderer
      */
     virtual bool renderFeature( const QgsFeature &feature, QgsRenderContext &context, int layer = -1, bool selected = false, bool drawVertexMarker = false ) SIP_THROW( QgsCsException );
 
+    /**
+     * Returns TRUE if the renderer can render point layers from an aggregated point pyramid,
+     * i.e. if rendering a single representative feature (via renderAggregatedFeature())
+     * for all points which fall within the same pixel gives the same result as rendering
+     * each of the points.
+     *
+     * The default implementation returns FALSE.
+     *
+     * \see renderAggregatedFeature()
+     * \note not available in Python bindings
+     * \since QGIS 3.10
+     */
+    virtual bool canRenderAggregatedPoints() const SIP_SKIP;
+
+    /**
+     * Renders a \a feature which represents \a count points aggregated from a point
+     * pyramid. Must be called between startRender() and stopRender() calls, and only
+     * if canRenderAggregatedPoints() returns TRUE.
+     *
+     * The default implementation renders the feature using renderFeature().
+     *
+     * \see canRenderAggregatedPoints()
+     * \note not available in Python bindings
+     * \since QGIS 3.10
+     */
+    virtual bool renderAggregatedFeature( const QgsFeature &feature, int count, QgsRenderContext &context ) SIP_SKIP;
+
     //! Returns debug information about this renderer
     virtual QString dump() const;
 
@@ -16,6 +16,7 @@
 #include "qgsrulebasedrenderer.h"
 #include "qgssymbollayer.h"
 #include "qgsexpression.h"
+#include "qgsexpressionnodeimpl.h"
 #include "qgssymbollayerutils.h"
 #include "qgsrendercontext.h"
 #include "qgsvectorlayer.h"
@@ -285,6 +286,11 @@ bool QgsRuleBasedRenderer::Rule::isFilterOK( const QgsFeature &f, QgsRenderConte
     return true;
 
   context->expressionContext().setFeature( f );
+
+  const int compiledResult = compiledFilterResult( f );
+  if ( compiledResult >= 0 )
+    return compiledResult == 1;
+
   QVariant res = mFilter->evaluate( &context->expressionContext() );
   return res.toBool();
 }
@@ -412,6 +418,8 @@ void QgsRuleBasedRenderer::Rule::toSld( QDomDocument &doc, QDomElement &element,
 bool QgsRuleBasedRenderer::Rule::startRender( QgsRenderContext &context, const QgsFields &fields, QString &filter )
 {
   mActiveChildren.clear();
+  mCompiledFilter = CompiledFilter();
+  mIsDispatched = false;
 
   if ( ! mIsActive )
     return false;
@@ -422,7 +430,10 @@ bool QgsRuleBasedRenderer::Rule::startRender( QgsRenderContext &context, const Q
 
   // init this rule
   if ( mFilter )
+  {
     mFilter->prepare( &context.expressionContext() );
+    compileFilter( fields );
+  }
   if ( mSymbol )
     mSymbol->startRender( context, fields );
 
@@ -441,6 +452,8 @@ bool QgsRuleBasedRenderer::Rule::startRender( QgsRenderContext &context, const Q
     }
   }
 
+  buildDispatchTable();
+
   // subfilters (on the same level) are joined with OR
   // Finally they are joined with their parent (this) with AND
   QString sf;
@@ -573,6 +586,10 @@ QgsRuleBasedRenderer::Rule::RenderResult QgsRuleBasedRenderer::Rule::renderFeatu
 
   bool willrendersomething = false;
 
+  // children with equality filters on the same field are looked up, instead of testing each of their filters
+  RuleList matchedChildren;
+  const bool dispatched = dispatchedChildren( featToRender.feat, matchedChildren );
+
   // process children
   const auto constMChildren = mChildren;
   for ( Rule *rule : constMChildren )
@@ -580,7 +597,9 @@ QgsRuleBasedRenderer::Rule::RenderResult QgsRuleBasedRenderer::Rule::renderFeatu
     // Don't process else rules yet
     if ( !rule->isElse() )
     {
-      RenderResult res = rule->renderFeature( featToRender, context, renderQueue );
+      RenderResult res = Filtered;
+      if ( !dispatched || !rule->mIsDispatched || matchedChildren.contains( rule ) )
+        res = rule->renderFeature( featToRender, context, renderQueue );
       // consider inactive items as "rendered" so the else rule will ignore them
       willrendersomething |= ( res == Rendered || res == Inactive );
       rendered |= ( res == Rendered );
@@ -724,6 +743,341 @@ void QgsRuleBasedRenderer::Rule::stopRender( QgsRenderContext &context )
 
   mActiveChildren.clear();
   mSymbolNormZLevels.clear();
+  mCompiledFilter = CompiledFilter();
+  mDispatchFieldIndex = -1;
+  mDispatchType = CompiledFilter::None;
+  mDispatchStrings.clear();
+  mDispatchIntegers.clear();
+  mIsDispatched = false;
+}
+
+///@cond PRIVATE
+
+//! Returns the literal value and column name of a comparison between a column and a literal
+static bool columnLiteralComparison( const QgsExpressionNodeBinaryOperator *node, QString &column, QVariant &literal, bool &columnOnLeft )
+{
+  const QgsExpressionNode *left = node->opLeft();
+  const QgsExpressionNode *right = node->opRight();
+  if ( left->nodeType() == QgsExpressionNode::ntColumnRef && right->nodeType() == QgsExpressionNode::ntLiteral )
+  {
+    column = static_cast< const QgsExpressionNodeColumnRef * >( left )->name();
+    literal = static_cast< const QgsExpressionNodeLiteral * >( right )->value();
+    columnOnLeft = true;
+    return true;
+  }
+  else if ( left->nodeType() == QgsExpressionNode::ntLiteral && right->nodeType() == QgsExpressionNode::ntColumnRef )
+  {
+    column = static_cast< const QgsExpressionNodeColumnRef * >( right )->name();
+    literal = static_cast< const QgsExpressionNodeLiteral * >( left )->value();
+    columnOnLeft = false;
+    return true;
+  }
+  return false;
+}
+
+//! Integers which are exactly representable as doubles, so that the expression engine's numeric comparisons are exact
+static bool isExactInteger( const QVariant &value )
+{
+  if ( value.type() != QVariant::Int && value.type() != QVariant::LongLong )
+    return false;
+
+  const qlonglong integer = value.toLongLong();
+  return integer > -( 1LL << 52 ) && integer < ( 1LL << 52 );
+}
+
+static bool isNumericLiteral( const QVariant &value )
+{
+  return value.type() == QVariant::Int || value.type() == QVariant::LongLong || value.type() == QVariant::Double;
+}
+
+//! Tightens a numeric range with a comparison, given as "column op literal"
+static bool addRangeComparison( QgsExpressionNodeBinaryOperator::BinaryOperator op, bool columnOnLeft, double value,
+                                double &minimum, bool &minimumInclusive, double &maximum, bool &maximumInclusive )
+{
+  if ( !columnOnLeft )
+  {
+    // "literal op column" is "column reversed-op literal"
+    switch ( op )
+    {
+      case QgsExpressionNodeBinaryOperator::boLT:
+        op = QgsExpressionNodeBinaryOperator::boGT;
+        break;
+      case QgsExpressionNodeBinaryOperator::boLE:
+        op = QgsExpressionNodeBinaryOperator::boGE;
+        break;
+      case QgsExpressionNodeBinaryOperator::boGT:
+        op = QgsExpressionNodeBinaryOperator::boLT;
+        break;
+      case QgsExpressionNodeBinaryOperator::boGE:
+        op = QgsExpressionNodeBinaryOperator::boLE;
+        break;
+      default:
+        return false;
+    }
+  }
+
+  switch ( op )
+  {
+    case QgsExpressionNodeBinaryOperator::boGT:
+    case QgsExpressionNodeBinaryOperator::boGE:
+      if ( value > minimum || ( value == minimum && op == QgsExpressionNodeBinaryOperator::boGT ) )
+      {
+        minimum = value;
+        minimumInclusive = op == QgsExpressionNodeBinaryOperator::boGE;
+      }
+      return true;
+
+    case QgsExpressionNodeBinaryOperator::boLT:
+    case QgsExpressionNodeBinaryOperator::boLE:
+      if ( value < maximum || ( value == maximum && op == QgsExpressionNodeBinaryOperator::boLT ) )
+      {
+        maximum = value;
+        maximumInclusive = op == QgsExpressionNodeBinaryOperator::boLE;
+      }
+      return true;
+
+    default:
+      return false;
+  }
+}
+
+///@endcond
+
+void QgsRuleBasedRenderer::Rule::compileFilter( const QgsFields &fields )
+{
+  mCompiledFilter = CompiledFilter();
+  if ( !mFilter || mElseRule || !mFilter->rootNode() )
+    return;
+
+  // only conditions whose expression results can be exactly reproduced are compiled. Features with
+  // attribute values of an unexpected type are still tested by evaluating the expression.
+  const QgsExpressionNode *root = mFilter->rootNode();
+  CompiledFilter compiled;
+  QString column;
+  if ( root->nodeType() == QgsExpressionNode::ntBinaryOperator )
+  {
+    const QgsExpressionNodeBinaryOperator *op = static_cast< const QgsExpressionNodeBinaryOperator * >( root );
+    QVariant literal;
+    bool columnOnLeft = true;
+    if ( op->op() == QgsExpressionNodeBinaryOperator::boEQ )
+    {
+      if ( !columnLiteralComparison( op, column, literal, columnOnLeft ) )
+        return;
+
+      if ( literal.type() == QVariant::String )
+      {
+        // both sides are strings, so they are compared as strings
+        compiled.type = CompiledFilter::StringEquality;
+        compiled.strings.insert( literal.toString() );
+      }
+      else if ( isExactInteger( literal ) )
+      {
+        compiled.type = CompiledFilter::IntegerEquality;
+        compiled.integers.insert( literal.toLongLong() );
+      }
+      else
+      {
+        return;
+      }
+    }
+    else if ( op->op() == QgsExpressionNodeBinaryOperator::boAnd )
+    {
+      // "column" >= x AND "column" < y
+      if ( op->opLeft()->nodeType() != QgsExpressionNode::ntBinaryOperator || op->opRight()->nodeType() != QgsExpressionNode::ntBinaryOperator )
+        return;
+
+      compiled.type = CompiledFilter::NumericRange;
+      for ( const QgsExpressionNode *node : { op->opLeft(), op->opRight() } )
+      {
+        const QgsExpressionNodeBinaryOperator *comparison = static_cast< const QgsExpressionNodeBinaryOperator * >( node );
+        QString comparisonColumn;
+        if ( !columnLiteralComparison( comparison, comparisonColumn, literal, columnOnLeft ) || !isNumericLiteral( literal )
+             || ( !column.isEmpty() && comparisonColumn != column ) )
+          return;
+
+        column = comparisonColumn;
+        if ( !addRangeComparison( comparison->op(), columnOnLeft, literal.toDouble(), compiled.minimum, compiled.minimumInclusive, compiled.maximum, compiled.maximumInclusive ) )
+          return;
+      }
+    }
+    else
+    {
+      // "column" >= x
+      if ( !columnLiteralComparison( op, column, literal, columnOnLeft ) || !isNumericLiteral( literal ) )
+        return;
+
+      compiled.type = CompiledFilter::NumericRange;
+      if ( !addRangeComparison( op->op(), columnOnLeft, literal.toDouble(), compiled.minimum, compiled.minimumInclusive, compiled.maximum, compiled.maximumInclusive ) )
+        return;
+    }
+  }
+  else if ( root->nodeType() == QgsExpressionNode::ntInOperator )
+  {
+    const QgsExpressionNodeInOperator *in = static_cast< const QgsExpressionNodeInOperator * >( root );
+    if ( in->isNotIn() || in->node()->nodeType() != QgsExpressionNode::ntColumnRef )
+      return;
+
+    column = static_cast< const QgsExpressionNodeColumnRef * >( in->node() )->name();
+    const QList< QgsExpressionNode * > values = in->list()->list();
+    for ( const QgsExpressionNode *valueNode : values )
+    {
+      if ( valueNode->nodeType() != QgsExpressionNode::ntLiteral )
+        return;
+
+      const QVariant literal = static_cast< const QgsExpressionNodeLiteral * >( valueNode )->value();
+      if ( literal.isNull() )
+        continue; // a NULL in the list only turns a FALSE result into NULL
+
+      bool numeric = false;
+      literal.toDouble( &numeric );
+      if ( literal.type() == QVariant::String && !numeric && compiled.type != CompiledFilter::IntegerEquality )
+      {
+        // IN compares numerically whenever both values are numeric, so only non numeric strings can be matched as strings
+        compiled.type = CompiledFilter::StringEquality;
+        compiled.strings.insert( literal.toString() );
+      }
+      else if ( isExactInteger( literal ) && compiled.type != CompiledFilter::StringEquality )
+      {
+        compiled.type = CompiledFilter::IntegerEquality;
+        compiled.integers.insert( literal.toLongLong() );
+      }
+      else
+      {
+        return;
+      }
+    }
+    if ( compiled.type == CompiledFilter::None )
+      return;
+  }
+  else
+  {
+    return;
+  }
+
+  compiled.fieldIndex = fields.lookupField( column );
+  if ( compiled.fieldIndex < 0 )
+    return;
+
+  mCompiledFilter = compiled;
+}
+
+int QgsRuleBasedRenderer::Rule::compiledFilterResult( const QgsFeature &f ) const
+{
+  if ( mCompiledFilter.type == CompiledFilter::None )
+    return -1;
+
+  const QVariant value = f.attribute( mCompiledFilter.fieldIndex );
+  if ( value.isNull() )
+    return 0;
+
+  switch ( mCompiledFilter.type )
+  {
+    case CompiledFilter::StringEquality:
+      if ( value.type() != QVariant::String )
+        return -1;
+      return mCompiledFilter.strings.contains( value.toString() ) ? 1 : 0;
+
+    case CompiledFilter::IntegerEquality:
+      if ( value.type() != QVariant::Int && value.type() != QVariant::UInt && value.type() != QVariant::LongLong )
+        return -1;
+      return mCompiledFilter.integers.contains( value.toLongLong() ) ? 1 : 0;
+
+    case CompiledFilter::NumericRange:
+    {
+      if ( value.type() != QVariant::Int && value.type() != QVariant::UInt && value.type() != QVariant::LongLong
+           && value.type() != QVariant::ULongLong && value.type() != QVariant::Double )
+        return -1;
+
+      const double v = value.toDouble();
+      // same comparisons as the expression engine
+      const double minimumDiff = v - mCompiledFilter.minimum;
+      const double maximumDiff = v - mCompiledFilter.maximum;
+      if ( std::isfinite( mCompiledFilter.minimum ) && ( mCompiledFilter.minimumInclusive ? !( minimumDiff >= 0 ) : !( minimumDiff > 0 ) ) )
+        return 0;
+      if ( std::isfinite( mCompiledFilter.maximum ) && ( mCompiledFilter.maximumInclusive ? !( maximumDiff <= 0 ) : !( maximumDiff < 0 ) ) )
+        return 0;
+      return 1;
+    }
+
+    case CompiledFilter::None:
+      break;
+  }
+  return -1;
+}
+
+void QgsRuleBasedRenderer::Rule::buildDispatchTable()
+{
+  mDispatchFieldIndex = -1;
+  mDispatchType = CompiledFilter::None;
+  mDispatchStrings.clear();
+  mDispatchIntegers.clear();
+
+  // find the most common field and type of the children's equality filters
+  QHash< QPair< int, int >, int > equalityCounts;
+  for ( const Rule *rule : qgis::as_const( mActiveChildren ) )
+  {
+    if ( rule->mCompiledFilter.type == CompiledFilter::StringEquality || rule->mCompiledFilter.type == CompiledFilter::IntegerEquality )
+      equalityCounts[ qMakePair( rule->mCompiledFilter.fieldIndex, static_cast< int >( rule->mCompiledFilter.type ) ) ]++;
+  }
+
+  QPair< int, int > dispatchKey( -1, CompiledFilter::None );
+  int dispatchCount = 0;
+  for ( auto it = equalityCounts.constBegin(); it != equalityCounts.constEnd(); ++it )
+  {
+    if ( it.value() > dispatchCount )
+    {
+      dispatchKey = it.key();
+      dispatchCount = it.value();
+    }
+  }
+
+  // testing a few compiled filters is as fast as a lookup
+  if ( dispatchCount < 8 )
+    return;
+
+  mDispatchFieldIndex = dispatchKey.first;
+  mDispatchType = static_cast< CompiledFilter::Type >( dispatchKey.second );
+  for ( Rule *rule : qgis::as_const( mActiveChildren ) )
+  {
+    if ( rule->mCompiledFilter.fieldIndex != mDispatchFieldIndex || rule->mCompiledFilter.type != mDispatchType )
+      continue;
+
+    for ( const QString &value : qgis::as_const( rule->mCompiledFilter.strings ) )
+      mDispatchStrings[ value ].append( rule );
+    for ( qlonglong value : qgis::as_const( rule->mCompiledFilter.integers ) )
+      mDispatchIntegers[ value ].append( rule );
+    rule->mIsDispatched = true;
+  }
+}
+
+bool QgsRuleBasedRenderer::Rule::dispatchedChildren( const QgsFeature &f, RuleList &children ) const
+{
+  if ( mDispatchFieldIndex < 0 )
+    return false;
+
+  const QVariant value = f.attribute( mDispatchFieldIndex );
+  if ( value.isNull() )
+    return true;
+
+  switch ( mDispatchType )
+  {
+    case CompiledFilter::StringEquality:
+      if ( value.type() != QVariant::String )
+        return false;
+      children = mDispatchStrings.value( value.toString() );
+      return true;
+
+    case CompiledFilter::IntegerEquality:
+      if ( value.type() != QVariant::Int && value.type() != QVariant::UInt && value.type() != QVariant::LongLong )
+        return false;
+      children = mDispatchIntegers.value( value.toLongLong() );
+      return true;
+
+    case CompiledFilter::NumericRange:
+    case CompiledFilter::None:
+      break;
+  }
+  return false;
 }
 
 QgsRuleBasedRenderer::Rule *QgsRuleBasedRenderer::Rule::create( QDomElement &ruleElem, QgsSymbolMap &symbolMap )
@@ -24,6 +24,10 @@
 
 #include "qgsrenderer.h"
 
+#include <QHash>
+#include <QSet>
+#include <limits>
+
 class QgsExpression;
 
 class QgsCategorizedSymbolRenderer;
@@ -465,6 +469,62 @@ class CORE_EXPORT QgsRuleBasedRenderer : public QgsFeatureRenderer
         QSet<int> mSymbolNormZLevels;
         RuleList mActiveChildren;
 
+        /**
+         * A simple condition on a single field, compiled from the rule's filter expression so
+         * that it can be tested without evaluating the expression.
+         */
+        struct CompiledFilter
+        {
+          enum Type
+          {
+            None, //!< Filter must be evaluated
+            StringEquality, //!< Field equals one of a set of strings
+            IntegerEquality, //!< Field equals one of a set of integers
+            NumericRange, //!< Field lies within a numeric range
+          };
+
+          Type type = None;
+          int fieldIndex = -1;
+          QSet< QString > strings;
+          QSet< qlonglong > integers;
+          double minimum = -std::numeric_limits< double >::infinity();
+          bool minimumInclusive = true;
+          double maximum = std::numeric_limits< double >::infinity();
+          bool maximumInclusive = true;
+        };
+
+        // temporary while rendering
+        CompiledFilter mCompiledFilter;
+
+        // temporary while rendering: lookup table for active children with equality filters on the same field
+        int mDispatchFieldIndex = -1;
+        CompiledFilter::Type mDispatchType = CompiledFilter::None;
+        QHash< QString, RuleList > mDispatchStrings;
+        QHash< qlonglong, RuleList > mDispatchIntegers;
+        bool mIsDispatched = false; // whether this rule is found via its parent's lookup table
+
+        /**
+         * Compiles the (prepared) filter expression into a simple condition, if possible.
+         */
+        void compileFilter( const QgsFields &fields );
+
+        /**
+         * Tests the compiled filter against a feature. Returns 1 if the feature passes the filter,
+         * 0 if it does not or -1 if the filter expression must be evaluated instead.
+         */
+        int compiledFilterResult( const QgsFeature &f ) const;
+
+        /**
+         * Builds the lookup table for the active children, if enough of them have equality filters on the same field.
+         */
+        void buildDispatchTable();
+
+        /**
+         * Looks up the dispatched children whose filters a feature passes. Returns FALSE if
+         * the lookup table can't be used for this feature.
+         */
+        bool dispatchedChildren( const QgsFeature &f, RuleList &children ) const;
+
         /**
          * Check which child rules are else rules and update the internal list of else rules
          *
@@ -91,6 +91,12 @@ bool QgsSingleSymbolRenderer::accept( QgsStyleEntityVisitorInterface *visitor )
   return true;
 }
 
+bool QgsSingleSymbolRenderer::canRenderAggregatedPoints() const
+{
+  // all points within a pixel are drawn with the same symbol, so drawing one is enough
+  return true;
+}
+
 QgsSymbol *QgsSingleSymbolRenderer::symbol() const
 {
   return mSymbol.get();
@@ -44,6 +44,7 @@ class CORE_EXPORT QgsSingleSymbolRenderer : public QgsFeatureRenderer
     void stopRender( QgsRenderContext &context ) override;
     QSet<QString> usedAttributes( const QgsRenderContext &context ) const override;
     bool accept( QgsStyleEntityVisitorInterface *visitor ) const override;
+    bool canRenderAggregatedPoints() const override SIP_SKIP;
 
     /**
      * Returns the symbol which will be rendered for every feature.
@@ -441,6 +441,9 @@ void QgsSymbol::startRender( QgsRenderContext &context, const QgsFields &fields
     layer->prepareExpressions( symbolContext );
     layer->startRender( symbolContext );
   }
+
+  if ( mType == Marker && QgsMarkerSymbolAtlas::canUseAtlas( static_cast< QgsMarkerSymbol * >( this ), context ) )
+    mSymbolRenderContext->mMarkerAtlas = qgis::make_unique< QgsMarkerSymbolAtlas >();
 }
 
 void QgsSymbol::stopRender( QgsRenderContext &context )
@@ -1625,6 +1628,14 @@ void QgsMarkerSymbol::renderPoint( QPointF point, const QgsFeature *f, QgsRender
   symbolContext.setGeometryPartCount( symbolRenderContext()->geometryPartCount() );
   symbolContext.setGeometryPartNum( symbolRenderContext()->geometryPartNum() );
 
+  if ( symbolRenderContext()->mMarkerAtlas && renderPointFromAtlas( point, f, symbolContext, layerIdx ) )
+    return;
+
+  renderPointLayers( point, symbolContext, layerIdx );
+}
+
+void QgsMarkerSymbol::renderPointLayers( QPointF point, QgsSymbolRenderContext &context, int layerIdx )
+{
   if ( layerIdx != -1 )
   {
     QgsSymbolLayer *symbolLayer = mLayers.value( layerIdx );
@@ -1633,10 +1644,10 @@ void QgsMarkerSymbol::renderPoint( QPointF point, const QgsFeature *f, QgsRender
       if ( symbolLayer->type() == QgsSymbol::Marker )
       {
         QgsMarkerSymbolLayer *markerLayer = static_cast<QgsMarkerSymbolLayer *>( symbolLayer );
-        renderPointUsingLayer( markerLayer, point, symbolContext );
+        renderPointUsingLayer( markerLayer, point, context );
       }
       else
-        renderUsingLayer( symbolLayer, symbolContext );
+        renderUsingLayer( symbolLayer, context );
     }
     return;
   }
@@ -1644,7 +1655,7 @@ void QgsMarkerSymbol::renderPoint( QPointF point, const QgsFeature *f, QgsRender
   const auto constMLayers = mLayers;
   for ( QgsSymbolLayer *symbolLayer : constMLayers )
   {
-    if ( context.renderingStopped() )
+    if ( context.renderContext().renderingStopped() )
       break;
 
     if ( !symbolLayer->enabled() )
@@ -1653,11 +1664,65 @@ void QgsMarkerSymbol::renderPoint( QPointF point, const QgsFeature *f, QgsRender
     if ( symbolLayer->type() == QgsSymbol::Marker )
     {
       QgsMarkerSymbolLayer *markerLayer = static_cast<QgsMarkerSymbolLayer *>( symbolLayer );
-      renderPointUsingLayer( markerLayer, point, symbolContext );
+      renderPointUsingLayer( markerLayer, point, context );
     }
     else
-      renderUsingLayer( symbolLayer, symbolContext );
+      renderUsingLayer( symbolLayer, context );
+  }
+}
+
+bool QgsMarkerSymbol::renderPointFromAtlas( QPointF point, const QgsFeature *f, QgsSymbolRenderContext &context, int layerIdx )
+{
+  QgsRenderContext &renderContext = context.renderContext();
+  if ( !QgsMarkerSymbolAtlas::painterSupportsAtlas( renderContext ) )
+    return false;
+
+  QgsMarkerSymbolAtlas *atlas = symbolRenderContext()->mMarkerAtlas.get();
+  const QVector< qint64 > key = QgsMarkerSymbolAtlas::markerKey( mLayers, renderContext, layerIdx, context.selected() );
+  const QgsMarkerSymbolAtlas::Entry *entry = atlas->entry( key );
+  if ( !entry )
+  {
+    if ( atlas->isFull() )
+      return false;
+
+    const QRectF markerBounds = bounds( QPointF( 0, 0 ), renderContext, f ? *f : QgsFeature() );
+    if ( markerBounds.isEmpty() || markerBounds.width() > QgsMarkerSymbolAtlas::MAX_MARKER_SIZE
+         || markerBounds.height() > QgsMarkerSymbolAtlas::MAX_MARKER_SIZE )
+    {
+      // store an empty entry, so that the bounds are not calculated again for this marker
+      entry = atlas->addEntry( key, QImage(), QPointF() );
+    }
+    else
+    {
+      // bounds are approximate, so leave a margin around the marker
+      const int left = static_cast< int >( std::floor( markerBounds.left() ) ) - 2;
+      const int top = static_cast< int >( std::floor( markerBounds.top() ) ) - 2;
+      const int width = static_cast< int >( std::ceil( markerBounds.right() ) ) + 2 - left;
+      const int height = static_cast< int >( std::ceil( markerBounds.bottom() ) ) + 2 - top;
+      const QPointF origin( -left, -top );
+
+      QPainter *painter = renderContext.painter();
+      const qreal devicePixelRatio = painter->device()->devicePixelRatioF();
+      QImage image( static_cast< int >( std::ceil( width * devicePixelRatio ) ), static_cast< int >( std::ceil( height * devicePixelRatio ) ), QImage::Format_ARGB32_Premultiplied );
+      image.setDevicePixelRatio( devicePixelRatio );
+      image.fill( Qt::transparent );
+
+      QPainter imagePainter( &image );
+      imagePainter.setRenderHints( painter->renderHints() );
+      renderContext.setPainter( &imagePainter );
+      renderPointLayers( origin, context, layerIdx );
+      renderContext.setPainter( painter );
+      imagePainter.end();
+
+      entry = atlas->addEntry( key, image, origin );
+    }
   }
+
+  if ( entry->image.isNull() )
+    return false;
+
+  renderContext.painter()->drawImage( point - entry->origin, entry->image );
+  return true;
 }
 
 QRectF QgsMarkerSymbol::bounds( QPointF point, QgsRenderContext &context, const QgsFeature &feature ) const
@@ -24,6 +24,7 @@
 #include "qgsfields.h"
 #include "qgsrendercontext.h"
 #include "qgsproperty.h"
+#include "qgsmarkersymbolatlas.h"
 
 class QColor;
 class QImage;
@@ -843,6 +844,12 @@ class CORE_EXPORT QgsSymbolRenderContext
     int mGeometryPartCount;
     int mGeometryPartNum;
     QgsWkbTypes::GeometryType mOriginalGeometryType = QgsWkbTypes::UnknownGeometry;
+
+    //! Rasterized markers, valid between QgsSymbol::startRender() and stopRender()
+    std::unique_ptr< QgsMarkerSymbolAtlas > mMarkerAtlas;
+
+    friend class QgsSymbol;
+    friend class QgsMarkerSymbol;
 };
 
 
@@ -1047,6 +1054,15 @@ class CORE_EXPORT QgsMarkerSymbol : public QgsSymbol
 
     void renderPointUsingLayer( QgsMarkerSymbolLayer *layer, QPointF point, QgsSymbolRenderContext &context );
 
+    //! Renders the point using all symbol layers, or only the layer at \a layerIdx if it is not -1
+    void renderPointLayers( QPointF point, QgsSymbolRenderContext &context, int layerIdx );
+
+    /**
+     * Attempts to render the point from the current render's marker atlas, rasterizing the marker
+     * if required. Returns FALSE if the point must be rendered as a vector instead.
+     */
+    bool renderPointFromAtlas( QPointF point, const QgsFeature *f, QgsSymbolRenderContext &context, int layerIdx );
+
 };
 
 
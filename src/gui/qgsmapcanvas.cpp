@@ -56,6 +56,7 @@ email                : sherman at mrcc.com
 #include "qgsmaptopixel.h"
 #include "qgsmapoverviewcanvas.h"
 #include "qgsmaprenderercache.h"
+#include "qgslabelplacementcache.h"
 #include "qgsmaprenderercustompainterjob.h"
 #include "qgsmaprendererparalleljob.h"
 #include "qgsmaprenderersequentialjob.h"
@@ -248,6 +249,7 @@ QgsMapCanvas::~QgsMapCanvas()
   mScene->deleteLater();  // crashes in python tests on windows
 
   delete mCache;
+  delete mLabelPlacementCache;
   delete mLabelingResults;
 }
 
@@ -434,11 +436,14 @@ void QgsMapCanvas::setCachingEnabled( bool enabled )
   if ( enabled )
   {
     mCache = new QgsMapRendererCache;
+    mLabelPlacementCache = new QgsLabelPlacementCache;
   }
   else
   {
     delete mCache;
     mCache = nullptr;
+    delete mLabelPlacementCache;
+    mLabelPlacementCache = nullptr;
   }
 }
 
@@ -451,6 +456,8 @@ void QgsMapCanvas::clearCache()
 {
   if ( mCache )
     mCache->clear();
+  if ( mLabelPlacementCache )
+    mLabelPlacementCache->clear();
 }
 
 void QgsMapCanvas::setParallelRenderingEnabled( bool enabled )
@@ -556,6 +563,7 @@ void QgsMapCanvas::refreshMap()
     mJob = new QgsMapRendererSequentialJob( mSettings );
   connect( mJob, &QgsMapRendererJob::finished, this, &QgsMapCanvas::rendererJobFinished );
   mJob->setCache( mCache );
+  mJob->setLabelPlacementCache( mLabelPlacementCache );
 
   mJob->start();
 
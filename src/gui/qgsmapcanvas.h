@@ -56,6 +56,7 @@ class QgsVectorLayer;
 
 class QgsLabelingResults;
 class QgsMapRendererCache;
+class QgsLabelPlacementCache;
 class QgsMapRendererQImageJob;
 class QgsMapSettings;
 class QgsMapCanvasMap;
@@ -987,6 +988,9 @@ class GUI_EXPORT QgsMapCanvas : public QGraphicsView
     //! Optionally use cache with rendered map layers for the current map settings
     QgsMapRendererCache *mCache = nullptr;
 
+    //! Optionally reuse label placements between renders, used whenever the rendered map cache is enabled
+    QgsLabelPlacementCache *mLabelPlacementCache = nullptr;
+
     QTimer *mResizeTimer = nullptr;
     QTimer *mRefreshTimer = nullptr;
 
@@ -986,6 +986,7 @@ void QgsAmsTiledImageDownloadHandler::tileReplyFinished()
 {
   QNetworkReply *reply = qobject_cast<QNetworkReply *>( sender() );
 
+  QDateTime tileExpiry;
   if ( QgsNetworkAccessManager::instance()->cache() )
   {
     QNetworkCacheMetaData cmd = QgsNetworkAccessManager::instance()->cache()->metaData( reply->request().url() );
@@ -1005,6 +1006,7 @@ void QgsAmsTiledImageDownloadHandler::tileReplyFinished()
       QgsSettings s;
       cmd.setExpirationDate( QDateTime::currentDateTime().addSecs( s.value( QStringLiteral( "qgis/defaultTileExpiry" ), "24" ).toInt() * 60 * 60 ) );
     }
+    tileExpiry = cmd.expirationDate();
 
     QgsNetworkAccessManager::instance()->cache()->updateMetaData( cmd );
   }
@@ -1124,7 +1126,8 @@ void QgsAmsTiledImageDownloadHandler::tileReplyFinished()
     {
       QgsDebugMsg( QStringLiteral( "tile reply: length %1" ).arg( reply->bytesAvailable() ) );
 
-      QImage myLocalImage = QImage::fromData( reply->readAll() );
+      const QByteArray imageData = reply->readAll();
+      QImage myLocalImage = QImage::fromData( imageData );
 
       if ( !myLocalImage.isNull() )
       {
@@ -1136,7 +1139,7 @@ void QgsAmsTiledImageDownloadHandler::tileReplyFinished()
         p.drawImage( r, myLocalImage );
         p.end();
 
-        QgsTileCache::insertTile( reply->url(), myLocalImage );
+        QgsTileCache::insertTile( reply->url(), myLocalImage, imageData, tileExpiry );
 
         if ( mFeedback )
           mFeedback->onNewData();
@@ -529,6 +529,7 @@ QgsDelimitedTextFeatureSource::QgsDelimitedTextFeatureSource( const QgsDelimited
 
   mFile.reset( new QgsDelimitedTextFile() );
   mFile->setFromUrl( url );
+  mFile->copyLineOffsets( *p->mFile );
 
   mExpressionContext << QgsExpressionContextUtils::globalScope()
                      << QgsExpressionContextUtils::projectScope( QgsProject::instance() );
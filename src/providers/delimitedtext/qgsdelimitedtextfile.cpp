@@ -29,6 +29,28 @@
 #include <QRegExp>
 #include <QUrl>
 
+#include <algorithm>
+#include <cstring>
+
+// Size of the blocks read from the file
+static const int READ_BLOCK_SIZE = 256 * 1024;
+
+// Returns true if a newline in text encoded with codec is always a single '\n' byte
+static bool newlineIsSingleByte( QTextCodec *codec )
+{
+  switch ( codec->mibEnum() )
+  {
+    case 1013: // UTF-16BE
+    case 1014: // UTF-16LE
+    case 1015: // UTF-16
+    case 1017: // UTF-32
+    case 1018: // UTF-32BE
+    case 1019: // UTF-32LE
+      return false;
+    default:
+      return true;
+  }
+}
 
 QgsDelimitedTextFile::QgsDelimitedTextFile( const QString &url )
   : mFileName( QString() )
@@ -59,6 +81,8 @@ void QgsDelimitedTextFile::close()
     delete mFile;
     mFile = nullptr;
   }
+  mCodec = nullptr;
+  mBuffer.clear();
   if ( mWatcher )
   {
     delete mWatcher;
@@ -85,12 +109,41 @@ bool QgsDelimitedTextFile::open()
     }
     if ( mFile )
     {
-      mStream = new QTextStream( mFile );
+      QTextCodec *codec = nullptr;
       if ( ! mEncoding.isEmpty() )
+        codec = QTextCodec::codecForName( mEncoding.toLatin1() );
+      if ( ! codec )
+        codec = QTextCodec::codecForLocale();
+
+      // A unicode byte order mark overrides the encoding, as it would for a QTextStream
+      const QByteArray head = mFile->peek( 4 );
+      const bool hasUtf16Or32Bom = head.startsWith( "\xFE\xFF" ) || head.startsWith( "\xFF\xFE" ) || head.startsWith( QByteArray( "\x00\x00\xFE\xFF", 4 ) );
+      if ( hasUtf16Or32Bom || ! newlineIsSingleByte( codec ) )
       {
-        QTextCodec *codec = QTextCodec::codecForName( mEncoding.toLatin1() );
+        mStream = new QTextStream( mFile );
         mStream->setCodec( codec );
       }
+      else
+      {
+        mContentStart = 0;
+        if ( head.startsWith( "\xEF\xBB\xBF" ) )
+        {
+          codec = QTextCodec::codecForMib( 106 );
+          mContentStart = 3;
+        }
+        mCodec = codec;
+        mCodecIsUtf8 = codec->mibEnum() == 106;
+      }
+
+      // Line offsets recorded for a different version of the file are useless
+      QFileInfo fileInfo( mFileName );
+      if ( fileInfo.size() != mLineOffsetsFileSize || fileInfo.lastModified() != mLineOffsetsFileModified || mStream )
+      {
+        mLineOffsets.clear();
+        mLineOffsetsFileSize = fileInfo.size();
+        mLineOffsetsFileModified = fileInfo.lastModified();
+      }
+
       if ( mUseWatcher )
       {
         mWatcher = new QFileSystemWatcher();
@@ -112,6 +165,7 @@ void QgsDelimitedTextFile::updateFile()
 void QgsDelimitedTextFile::resetDefinition()
 {
   close();
+  mLineOffsets.clear();
   mFieldNames.clear();
   mMaxFieldCount = 0;
 }
@@ -494,6 +548,51 @@ bool QgsDelimitedTextFile::setNextRecordId( long nextRecordId )
   return setNextLineNumber( nextRecordId );
 }
 
+void QgsDelimitedTextFile::copyLineOffsets( const QgsDelimitedTextFile &other )
+{
+  if ( other.mFileName != mFileName )
+    return;
+
+  mLineOffsets = other.mLineOffsets;
+  mLineOffsetsFileSize = other.mLineOffsetsFileSize;
+  mLineOffsetsFileModified = other.mLineOffsetsFileModified;
+}
+
+bool QgsDelimitedTextFile::setScanRange( qint64 startOffset, qint64 endOffset )
+{
+  if ( ! isValid() || ! open() || mStream ) return false;
+
+  seek( startOffset );
+  mLineNumber = 0;
+  mRecordNumber = 0;
+  mMaxRecordNumber = 0;
+  mRecordLineNumber = -1;
+  mHoldCurrentRecord = false;
+  mScanLimit = endOffset;
+  mReachedScanLimit = false;
+  mRecordOffset = -1;
+  mLineOffsets.clear();
+  mLineOffsets.append( qMakePair( 0L, mPosition ) );
+  return true;
+}
+
+void QgsDelimitedTextFile::mergeScanState( const QgsDelimitedTextFile &other, long lineNumberOffset )
+{
+  if ( other.mMaxFieldCount > mMaxFieldCount ) mMaxFieldCount = other.mMaxFieldCount;
+  if ( other.mMaxRecordNumber > 0 )
+    mMaxRecordNumber = std::max( mMaxRecordNumber, 0L ) + other.mMaxRecordNumber;
+
+  if ( other.mFileName != mFileName || other.mLineOffsetsFileSize != mLineOffsetsFileSize || other.mLineOffsetsFileModified != mLineOffsetsFileModified )
+    return;
+
+  for ( const QPair<long, qint64> &offset : other.mLineOffsets )
+  {
+    const long lineNumber = offset.first + lineNumberOffset;
+    if ( mLineOffsets.isEmpty() || lineNumber > mLineOffsets.last().first )
+      mLineOffsets.append( qMakePair( lineNumber, offset.second ) );
+  }
+}
+
 QgsDelimitedTextFile::Status QgsDelimitedTextFile::nextRecord( QStringList &record )
 {
 
@@ -514,6 +613,16 @@ QgsDelimitedTextFile::Status QgsDelimitedTextFile::nextRecord( QStringList &reco
     status = nextLine( buffer, true );
     if ( status != RecordOk ) return RecordEOF;
 
+    mRecordOffset = mLineStart;
+    if ( mScanLimit >= 0 && mLineStart >= mScanLimit )
+    {
+      // Leave the record to the parser reading the following range of the file
+      mPosition = mLineStart;
+      mLineNumber--;
+      mReachedScanLimit = true;
+      return RecordEOF;
+    }
+
     mCurrentRecord.clear();
     mRecordLineNumber = mLineNumber;
     if ( mRecordNumber >= 0 )
@@ -537,16 +646,20 @@ QgsDelimitedTextFile::Status  QgsDelimitedTextFile::reset()
   if ( ! isValid() || ! open() ) return InvalidDefinition;
 
   // Reset the file pointer
-  mStream->seek( 0 );
+  seek( 0 );
   mLineNumber = 0;
   mRecordNumber = -1;
   mRecordLineNumber = -1;
+  mScanLimit = -1;
+  mReachedScanLimit = false;
+  mRecordOffset = -1;
+  if ( mLineOffsets.isEmpty() && ! mStream ) mLineOffsets.append( qMakePair( 0L, mPosition ) );
 
   // Skip header lines
+  QString buffer;
   for ( int i = mSkipLines; i-- > 0; )
   {
-    if ( mStream->readLine().isNull() ) return RecordEOF;
-    mLineNumber++;
+    if ( ! readLine( buffer ) ) return RecordEOF;
   }
   // Read the column names
   Status result = RecordOk;
@@ -562,17 +675,14 @@ QgsDelimitedTextFile::Status  QgsDelimitedTextFile::reset()
 
 QgsDelimitedTextFile::Status QgsDelimitedTextFile::nextLine( QString &buffer, bool skipBlank )
 {
-  if ( ! mStream )
+  if ( ! mFile )
   {
     Status status = reset();
     if ( status != RecordOk ) return status;
   }
 
-  while ( ! mStream->atEnd() )
+  while ( readLine( buffer ) )
   {
-    buffer = mStream->readLine();
-    if ( buffer.isNull() ) break;
-    mLineNumber++;
     if ( skipBlank && buffer.isEmpty() ) continue;
     return RecordOk;
   }
@@ -583,20 +693,102 @@ QgsDelimitedTextFile::Status QgsDelimitedTextFile::nextLine( QString &buffer, bo
 
 bool QgsDelimitedTextFile::setNextLineNumber( long nextLineNumber )
 {
-  if ( ! mStream ) return false;
-  if ( mLineNumber > nextLineNumber - 1 )
+  if ( ! mFile ) return false;
+  const long linesBefore = std::max( nextLineNumber - 1, 0L );
+  if ( ! mLineOffsets.isEmpty() )
+  {
+    // Jump to the closest recorded line offset, unless the current position is closer
+    auto offset = std::upper_bound( mLineOffsets.constBegin(), mLineOffsets.constEnd(), linesBefore,
+                                    []( long lineNumber, const QPair<long, qint64> &entry ) { return lineNumber < entry.first; } );
+    if ( offset != mLineOffsets.constBegin() ) --offset;
+    const long offsetLineNumber = offset->first;
+    if ( mLineNumber > linesBefore || mLineNumber < offsetLineNumber )
+    {
+      mRecordNumber = -1;
+      seek( offset->second );
+      mLineNumber = offsetLineNumber;
+    }
+  }
+  else if ( mLineNumber > linesBefore )
   {
     mRecordNumber = -1;
-    mStream->seek( 0 );
+    seek( 0 );
     mLineNumber = 0;
   }
   QString buffer;
-  while ( mLineNumber < nextLineNumber - 1 )
+  while ( mLineNumber < linesBefore )
+  {
+    if ( ! readLine( buffer ) ) return false;
+  }
+  return true;
+
+}
+
+bool QgsDelimitedTextFile::readLine( QString &buffer )
+{
+  if ( mStream )
+  {
+    if ( mStream->atEnd() ) return false;
+    buffer = mStream->readLine();
+    if ( buffer.isNull() ) return false;
+    mLineNumber++;
+    return true;
+  }
+
+  // Find the end of the line, reading more of the file as required
+  const char *lineEnd = nullptr;
+  while ( true )
+  {
+    const qint64 start = mPosition - mBufferStart;
+    if ( start < mBuffer.size() )
+      lineEnd = static_cast<const char *>( std::memchr( mBuffer.constData() + start, '\n', static_cast<size_t>( mBuffer.size() - start ) ) );
+    if ( lineEnd || ! readBlock() ) break;
+  }
+
+  const qint64 start = mPosition - mBufferStart;
+  if ( start >= mBuffer.size() ) return false;
+
+  const char *line = mBuffer.constData() + start;
+  mLineStart = mPosition;
+  int length = static_cast<int>( lineEnd ? lineEnd - line : mBuffer.size() - start );
+  mPosition += lineEnd ? length + 1 : length;
+  if ( length > 0 && line[length - 1] == '\r' ) length--;
+  buffer = mCodecIsUtf8 ? QString::fromUtf8( line, length ) : mCodec->toUnicode( line, length );
+
+  mLineNumber++;
+  if ( mLineNumber % LINE_OFFSET_INTERVAL == 0 && ( mLineOffsets.isEmpty() || mLineNumber > mLineOffsets.last().first ) )
   {
-    if ( nextLine( buffer, false ) != RecordOk ) return false;
+    mLineOffsets.append( qMakePair( mLineNumber, mPosition ) );
   }
   return true;
+}
+
+bool QgsDelimitedTextFile::readBlock()
+{
+  if ( mFile->atEnd() ) return false;
+
+  // Discard the part of the buffer which has already been read
+  mBuffer.remove( 0, static_cast<int>( mPosition - mBufferStart ) );
+  mBufferStart = mPosition;
+
+  const QByteArray block = mFile->read( READ_BLOCK_SIZE );
+  if ( block.isEmpty() ) return false;
+  mBuffer.append( block );
+  return true;
+}
+
+void QgsDelimitedTextFile::seek( qint64 offset )
+{
+  if ( mStream )
+  {
+    mStream->seek( offset );
+    return;
+  }
 
+  mPosition = std::max( offset, mContentStart );
+  mBufferStart = mPosition;
+  mBuffer.clear();
+  mFile->seek( mPosition );
 }
 
 void QgsDelimitedTextFile::appendField( QStringList &record, QString field, bool quoted )
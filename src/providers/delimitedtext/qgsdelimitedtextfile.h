@@ -22,21 +22,25 @@
 #include <QRegExp>
 #include <QUrl>
 #include <QObject>
+#include <QDateTime>
+#include <QVector>
+#include <QPair>
 
 class QgsFeature;
 class QgsField;
 class QFile;
 class QFileSystemWatcher;
+class QTextCodec;
 class QTextStream;
 
 
 /**
 \class QgsDelimitedTextFile
-\brief Delimited text file parser extracts records from a QTextStream as a QStringList.
+\brief Delimited text file parser extracts records from a text file as a QStringList.
 *
 *
 * The delimited text parser is used by the QgsDelimitedTextProvider to parse
-* a QTextStream into records of QStringList.  It provides a number of variants
+* a text file into records of QStringList.  It provides a number of variants
 * for parsing each record.  The following options are supported:
 * - Basic whitespace parsing.  Each line in the file is treated as a record.
 *   Extracts all contiguous sequences of non-whitespace
@@ -65,6 +69,16 @@ class QTextStream;
 *   The field is ignored for csv and whitespace
 * - quoteChar, optional, a single character used for quoting plain fields
 * - escapeChar, optional, a single character used for escaping (may be the same as quoteChar)
+*
+* Files in encodings where a newline is always stored as a single '\\n' byte (such as
+* UTF-8 and the single byte encodings) are read in large blocks, and only the bytes
+* of each line are decoded. The byte offset of every LINE_OFFSET_INTERVAL th line is
+* recorded as the file is read, so that records can later be located without
+* rereading the start of the file. Other encodings are read through a QTextStream.
+*
+* In block reading mode the parser can also be restricted to a byte range of the
+* file with setScanRange(), so that several parsers can scan different parts of a
+* file concurrently. Their results are combined with mergeScanState().
 */
 
 // Note: this has been implemented as a single class rather than a set of classes based
@@ -94,6 +108,9 @@ class QgsDelimitedTextFile : public QObject
       DelimTypeRegexp
     };
 
+    //! Number of lines between recorded line offsets
+    static const int LINE_OFFSET_INTERVAL = 64;
+
     explicit QgsDelimitedTextFile( const QString &url = QString() );
 
     ~QgsDelimitedTextFile() override;
@@ -291,6 +308,57 @@ class QgsDelimitedTextFile : public QObject
      */
     bool setNextRecordId( long nextRecordId );
 
+    /**
+     * Copies the line offsets recorded by \a other, which must be a parser
+     * for the same file, so that this parser can seek directly to records which
+     * \a other has already read. The offsets are discarded if the file has
+     * been modified since they were recorded.
+     */
+    void copyLineOffsets( const QgsDelimitedTextFile &other );
+
+    /**
+     * Restricts the parser to the records starting in a byte range of the file, without
+     * reading the header. Reading starts at \a startOffset, which must be the start of a
+     * line, and nextRecord() returns RecordEOF for the first record starting at or after
+     * \a endOffset (or at the end of the file if \a endOffset is -1). That record is
+     * left unread. Line numbers and record ids are counted from the start of the range.
+     *
+     * Returns false if the file cannot be read in blocks, e.g. for UTF-16 encoded files.
+     */
+    bool setScanRange( qint64 startOffset, qint64 endOffset );
+
+    /**
+     * Returns true if the last call to nextRecord() stopped at the end of the range set
+     * with setScanRange(), rather than at the end of the file.
+     */
+    bool reachedScanLimit() const { return mReachedScanLimit; }
+
+    /**
+     * Returns the byte offset of the first line of the last record read, or of the record
+     * at which the scan range ended. Returns -1 if no record has been read, or if the file
+     * is read through a QTextStream.
+     */
+    qint64 recordOffset() const { return mRecordOffset; }
+
+    /**
+     * Returns the byte offset of the next line to be read, or -1 if the file is
+     * not open or is read through a QTextStream.
+     */
+    qint64 position() const { return mFile && ! mStream ? mPosition : -1; }
+
+    /**
+     * Returns the number of lines read since the start of the file or scan range.
+     */
+    long lineNumber() const { return mLineNumber; }
+
+    /**
+     * Merges the state gathered by \a other while scanning part of the same file
+     * with setScanRange() into this parser: the number of records and fields read, and
+     * the line offsets. \a lineNumberOffset is the number of lines in the file before
+     * the start of the scan range of \a other. Ranges must be merged in file order.
+     */
+    void mergeScanState( const QgsDelimitedTextFile &other, long lineNumberOffset );
+
     /**
      * Number record number of records visited. After scanning the file
      *  serves as a record count.
@@ -390,6 +458,22 @@ class QgsDelimitedTextFile : public QObject
      */
     bool setNextLineNumber( long nextLineNumber );
 
+    /**
+     * Reads the next line from the file into \a buffer, without any end of line
+     * characters. Returns false at the end of the file.
+     */
+    bool readLine( QString &buffer );
+
+    /**
+     * Reads the next block of the file into the read buffer. Returns false at the end of the file.
+     */
+    bool readBlock();
+
+    /**
+     * Moves the read position to a byte \a offset in the file.
+     */
+    void seek( qint64 offset );
+
     /**
      * Utility routine to add a field to a record, accounting for trimming
      *  and discarding, and maximum field count
@@ -403,9 +487,30 @@ class QgsDelimitedTextFile : public QObject
     QString mEncoding;
     QFile *mFile = nullptr;
     QTextStream *mStream = nullptr;
+    QTextCodec *mCodec = nullptr;
+    bool mCodecIsUtf8 = false;
     bool mUseWatcher = false;
     QFileSystemWatcher *mWatcher = nullptr;
 
+    // Block reading state, used when mStream is not
+    QByteArray mBuffer;
+    qint64 mBufferStart = 0;
+    qint64 mPosition = 0;
+    qint64 mContentStart = 0;
+
+    qint64 mLineStart = -1;
+
+    // Limit of the range set with setScanRange, -1 if none
+    qint64 mScanLimit = -1;
+    bool mReachedScanLimit = false;
+    qint64 mRecordOffset = -1;
+
+    // Byte offsets after every LINE_OFFSET_INTERVAL th line, as (line count, offset) pairs
+    // sorted by line count, and the file state they apply to
+    QVector<QPair<long, qint64>> mLineOffsets;
+    qint64 mLineOffsetsFileSize = -1;
+    QDateTime mLineOffsetsFileModified;
+
     // Parameters common to parsers
     bool mDefinitionValid = false;
     DelimiterType mType;
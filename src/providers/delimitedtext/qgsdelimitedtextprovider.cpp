@@ -27,6 +27,11 @@
 #include <QRegExp>
 #include <QUrl>
 #include <QUrlQuery>
+#include <QThread>
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <vector>
 
 #include "qgsapplication.h"
 #include "qgsdataprovider.h"
@@ -55,6 +60,14 @@ const QString QgsDelimitedTextProvider::TEXT_PROVIDER_DESCRIPTION = QStringLiter
 
 static const int SUBSET_ID_THRESHOLD_FACTOR = 10;
 
+// Files with more data than this are split into byte ranges which are scanned concurrently
+static const qint64 PARALLEL_SCAN_MIN_SIZE = 16 * 1024 * 1024;
+// Minimum size of each range scanned concurrently, and number of ranges per thread
+static const qint64 PARALLEL_SCAN_MIN_RANGE_SIZE = 4 * 1024 * 1024;
+static const int PARALLEL_SCAN_RANGES_PER_THREAD = 2;
+// Size of the blocks read while looking for the line boundaries between ranges
+static const int PARALLEL_SCAN_BOUNDARY_BLOCK_SIZE = 64 * 1024;
+
 QRegExp QgsDelimitedTextProvider::sWktPrefixRegexp( "^\\s*(?:\\d+\\s+|SRID\\=\\d+\\;)", Qt::CaseInsensitive );
 QRegExp QgsDelimitedTextProvider::sCrdDmsRegexp( "^\\s*(?:([-+nsew])\\s*)?(\\d{1,3})(?:[^0-9.]+([0-5]?\\d))?[^0-9.]+([0-5]?\\d(?:\\.\\d+)?)[^0-9.]*([-+nsew])?\\s*$", Qt::CaseInsensitive );
 
@@ -359,228 +372,36 @@ void QgsDelimitedTextProvider::scanFile( bool buildIndexes )
   //
   // Also build subset and spatial indexes.
 
-  QStringList parts;
-  long nEmptyRecords = 0;
-  long nBadFormatRecords = 0;
-  long nIncompatibleGeometry = 0;
-  long nInvalidGeometry = 0;
-  long nEmptyGeometry = 0;
-  mNumberFeatures = 0;
-  mExtent = QgsRectangle();
+  ScanResult result;
+  result.wkbType = mWkbType;
+  result.geometryType = mGeometryType;
+  result.wktHasPrefix = mWktHasPrefix;
 
-  QList<bool> isEmpty;
-  QList<bool> couldBeInt;
-  QList<bool> couldBeLongLong;
-  QList<bool> couldBeDouble;
-  bool foundFirstGeometry = false;
-
-  while ( true )
+  if ( ! scanFileInParallel( result, buildSpatialIndex, buildSubsetIndex ) )
   {
-    QgsDelimitedTextFile::Status status = mFile->nextRecord( parts );
-    if ( status == QgsDelimitedTextFile::RecordEOF )
-      break;
-    if ( status != QgsDelimitedTextFile::RecordOk )
-    {
-      nBadFormatRecords++;
-      recordInvalidLine( tr( "Invalid record format at line %1" ) );
-      continue;
-    }
-    // Skip over empty records
-    if ( recordIsEmpty( parts ) )
-    {
-      nEmptyRecords++;
-      continue;
-    }
-
-    // Check geometries are valid
-    bool geomValid = true;
-
-    if ( mGeomRep == GeomAsWkt )
-    {
-      if ( mWktFieldIndex >= parts.size() || parts[mWktFieldIndex].isEmpty() )
-      {
-        nEmptyGeometry++;
-        mNumberFeatures++;
-      }
-      else
-      {
-        // Get the wkt - confirm it is valid, get the type, and
-        // if compatible with the rest of file, add to the extents
-
-        QString sWkt = parts[mWktFieldIndex];
-        QgsGeometry geom;
-        if ( !mWktHasPrefix && sWkt.indexOf( sWktPrefixRegexp ) >= 0 )
-          mWktHasPrefix = true;
-        geom = geomFromWkt( sWkt, mWktHasPrefix );
-
-        if ( !geom.isNull() )
-        {
-          QgsWkbTypes::Type type = geom.wkbType();
-          if ( type != QgsWkbTypes::NoGeometry )
-          {
-            if ( mGeometryType == QgsWkbTypes::UnknownGeometry || geom.type() == mGeometryType )
-            {
-              mGeometryType = geom.type();
-              if ( !foundFirstGeometry )
-              {
-                mNumberFeatures++;
-                mWkbType = type;
-                mExtent = geom.boundingBox();
-                foundFirstGeometry = true;
-              }
-              else
-              {
-                mNumberFeatures++;
-                if ( geom.isMultipart() )
-                  mWkbType = type;
-                QgsRectangle bbox( geom.boundingBox() );
-                mExtent.combineExtentWith( bbox );
-              }
-              if ( buildSpatialIndex )
-              {
-                QgsFeature f;
-                f.setId( mFile->recordId() );
-                f.setGeometry( geom );
-                mSpatialIndex->addFeature( f );
-              }
-            }
-            else
-            {
-              nIncompatibleGeometry++;
-              geomValid = false;
-            }
-          }
-        }
-        else
-        {
-          geomValid = false;
-          nInvalidGeometry++;
-          recordInvalidLine( tr( "Invalid WKT at line %1" ) );
-        }
-      }
-    }
-    else if ( mGeomRep == GeomAsXy )
-    {
-      // Get the x and y values, first checking to make sure they
-      // aren't null.
+    if ( buildSpatialIndex )
+      result.spatialIndex = mSpatialIndex.get();
 
-      QString sX = mXFieldIndex < parts.size() ? parts[mXFieldIndex] : QString();
-      QString sY = mYFieldIndex < parts.size() ? parts[mYFieldIndex] : QString();
-      if ( sX.isEmpty() && sY.isEmpty() )
-      {
-        nEmptyGeometry++;
-        mNumberFeatures++;
-      }
-      else
-      {
-        QgsPointXY pt;
-        bool ok = pointFromXY( sX, sY, pt, mDecimalPoint, mXyDms );
-
-        if ( ok )
-        {
-          if ( foundFirstGeometry )
-          {
-            mExtent.combineExtentWith( pt.x(), pt.y() );
-          }
-          else
-          {
-            // Extent for the first point is just the first point
-            mExtent.set( pt.x(), pt.y(), pt.x(), pt.y() );
-            mWkbType = QgsWkbTypes::Point;
-            mGeometryType = QgsWkbTypes::PointGeometry;
-            foundFirstGeometry = true;
-          }
-          mNumberFeatures++;
-          if ( buildSpatialIndex && std::isfinite( pt.x() ) && std::isfinite( pt.y() ) )
-          {
-            QgsFeature f;
-            f.setId( mFile->recordId() );
-            f.setGeometry( QgsGeometry::fromPointXY( pt ) );
-            mSpatialIndex->addFeature( f );
-          }
-        }
-        else
-        {
-          geomValid = false;
-          nInvalidGeometry++;
-          recordInvalidLine( tr( "Invalid X or Y fields at line %1" ) );
-        }
-      }
-    }
-    else
+    QStringList parts;
+    while ( true )
     {
-      mWkbType = QgsWkbTypes::NoGeometry;
-      mNumberFeatures++;
-    }
-
-    if ( !geomValid )
-      continue;
-
-    if ( buildSubsetIndex )
-      mSubsetIndex.append( mFile->recordId() );
-
-
-    // If we are going to use this record, then assess the potential types of each column
-
-    for ( int i = 0; i < parts.size(); i++ )
-    {
-
-      QString &value = parts[i];
-      // Ignore empty fields - spreadsheet generated CSV files often
-      // have random empty fields at the end of a row
-      if ( value.isEmpty() )
-        continue;
-
-      // Expand the columns to include this non empty field if necessary
-
-      while ( couldBeInt.size() <= i )
-      {
-        isEmpty.append( true );
-        couldBeInt.append( false );
-        couldBeLongLong.append( false );
-        couldBeDouble.append( false );
-      }
-
-      // If this column has been empty so far then initiallize it
-      // for possible types
-
-      if ( isEmpty[i] )
-      {
-        isEmpty[i] = false;
-        couldBeInt[i] = true;
-        couldBeLongLong[i] = true;
-        couldBeDouble[i] = true;
-      }
-
-      if ( ! mDetectTypes )
-      {
-        continue;
-      }
-
-      // Now test for still valid possible types for the field
-      // Types are possible until first record which cannot be parsed
-
-      if ( couldBeInt[i] )
-      {
-        value.toInt( &couldBeInt[i] );
-      }
-
-      if ( couldBeLongLong[i] && ! couldBeInt[i] )
-      {
-        value.toLongLong( &couldBeLongLong[i] );
-      }
-
-      if ( couldBeDouble[i] && ! couldBeLongLong[i] )
-      {
-        if ( ! mDecimalPoint.isEmpty() )
-        {
-          value.replace( mDecimalPoint, QLatin1String( "." ) );
-        }
-        value.toDouble( &couldBeDouble[i] );
-      }
+      QgsDelimitedTextFile::Status status = mFile->nextRecord( parts );
+      if ( status == QgsDelimitedTextFile::RecordEOF )
+        break;
+      scanRecord( status, parts, mFile->recordId(), result, buildSpatialIndex, buildSubsetIndex );
     }
   }
 
+  mNumberFeatures = result.numberFeatures;
+  mExtent = result.extent;
+  mWkbType = result.wkbType;
+  mGeometryType = result.geometryType;
+  mWktHasPrefix = result.wktHasPrefix;
+  mSubsetIndex = result.subsetIndex;
+  for ( const QPair< QString, long > &invalidLine : qgis::as_const( result.invalidLines ) )
+    recordInvalidLine( invalidLine.first, invalidLine.second );
+  mNExtraInvalidLines += result.extraInvalidLines;
+
   // Now create the attribute fields.  Field types are integer by preference,
   // failing that double, failing that text.
 
@@ -606,17 +427,17 @@ void QgsDelimitedTextProvider::scanFile( bool buildIndexes )
     {
       typeName = csvtTypes[i];
     }
-    else if ( mDetectTypes && i < couldBeInt.size() )
+    else if ( mDetectTypes && i < result.couldBeInt.size() )
     {
-      if ( couldBeInt[i] )
+      if ( result.couldBeInt[i] )
       {
         typeName = QStringLiteral( "integer" );
       }
-      else if ( couldBeLongLong[i] )
+      else if ( result.couldBeLongLong[i] )
       {
         typeName = QStringLiteral( "longlong" );
       }
-      else if ( couldBeDouble[i] )
+      else if ( result.couldBeDouble[i] )
       {
         typeName = QStringLiteral( "double" );
       }
@@ -649,14 +470,14 @@ void QgsDelimitedTextProvider::scanFile( bool buildIndexes )
   QStringList warnings;
   if ( ! csvtMessage.isEmpty() )
     warnings.append( csvtMessage );
-  if ( nBadFormatRecords > 0 )
-    warnings.append( tr( "%1 records discarded due to invalid format" ).arg( nBadFormatRecords ) );
-  if ( nEmptyGeometry > 0 )
-    warnings.append( tr( "%1 records have missing geometry definitions" ).arg( nEmptyGeometry ) );
-  if ( nInvalidGeometry > 0 )
-    warnings.append( tr( "%1 records discarded due to invalid geometry definitions" ).arg( nInvalidGeometry ) );
-  if ( nIncompatibleGeometry > 0 )
-    warnings.append( tr( "%1 records discarded due to incompatible geometry types" ).arg( nIncompatibleGeometry ) );
+  if ( result.badFormatRecords > 0 )
+    warnings.append( tr( "%1 records discarded due to invalid format" ).arg( result.badFormatRecords ) );
+  if ( result.emptyGeometry > 0 )
+    warnings.append( tr( "%1 records have missing geometry definitions" ).arg( result.emptyGeometry ) );
+  if ( result.invalidGeometry > 0 )
+    warnings.append( tr( "%1 records discarded due to invalid geometry definitions" ).arg( result.invalidGeometry ) );
+  if ( result.incompatibleGeometry > 0 )
+    warnings.append( tr( "%1 records discarded due to incompatible geometry types" ).arg( result.incompatibleGeometry ) );
 
   reportErrors( warnings );
 
@@ -682,6 +503,431 @@ void QgsDelimitedTextProvider::scanFile( bool buildIndexes )
   connect( mFile.get(), &QgsDelimitedTextFile::fileUpdated, this, &QgsDelimitedTextProvider::onFileUpdated );
 }
 
+void QgsDelimitedTextProvider::scanRecord( QgsDelimitedTextFile::Status status, QStringList &parts, long recordId, ScanResult &result, bool buildSpatialIndex, bool buildSubsetIndex ) const
+{
+  if ( status != QgsDelimitedTextFile::RecordOk )
+  {
+    result.badFormatRecords++;
+    result.addInvalidLine( tr( "Invalid record format at line %1" ), recordId, mMaxInvalidLines );
+    return;
+  }
+  // Skip over empty records
+  if ( recordIsEmpty( parts ) )
+  {
+    result.emptyRecords++;
+    return;
+  }
+
+  // Check geometries are valid
+  bool geomValid = true;
+
+  if ( mGeomRep == GeomAsWkt )
+  {
+    if ( mWktFieldIndex >= parts.size() || parts[mWktFieldIndex].isEmpty() )
+    {
+      result.emptyGeometry++;
+      result.numberFeatures++;
+    }
+    else
+    {
+      // Get the wkt - confirm it is valid, get the type, and
+      // if compatible with the rest of file, add to the extents
+
+      QString sWkt = parts[mWktFieldIndex];
+      QgsGeometry geom;
+      if ( !result.wktHasPrefix && sWkt.indexOf( sWktPrefixRegexp ) >= 0 )
+        result.wktHasPrefix = true;
+      geom = geomFromWkt( sWkt, result.wktHasPrefix );
+
+      if ( !geom.isNull() )
+      {
+        QgsWkbTypes::Type type = geom.wkbType();
+        if ( type != QgsWkbTypes::NoGeometry )
+        {
+          if ( result.geometryType == QgsWkbTypes::UnknownGeometry || geom.type() == result.geometryType )
+          {
+            result.geometryType = geom.type();
+            if ( !result.foundFirstGeometry )
+            {
+              result.numberFeatures++;
+              result.wkbType = type;
+              result.extent = geom.boundingBox();
+              result.foundFirstGeometry = true;
+            }
+            else
+            {
+              result.numberFeatures++;
+              if ( geom.isMultipart() )
+                result.wkbType = type;
+              QgsRectangle bbox( geom.boundingBox() );
+              result.extent.combineExtentWith( bbox );
+            }
+            if ( buildSpatialIndex )
+              result.addToSpatialIndex( recordId, geom.boundingBox() );
+          }
+          else
+          {
+            result.incompatibleGeometry++;
+            geomValid = false;
+          }
+        }
+      }
+      else
+      {
+        geomValid = false;
+        result.invalidGeometry++;
+        result.addInvalidLine( tr( "Invalid WKT at line %1" ), recordId, mMaxInvalidLines );
+      }
+    }
+  }
+  else if ( mGeomRep == GeomAsXy )
+  {
+    // Get the x and y values, first checking to make sure they
+    // aren't null.
+
+    QString sX = mXFieldIndex < parts.size() ? parts[mXFieldIndex] : QString();
+    QString sY = mYFieldIndex < parts.size() ? parts[mYFieldIndex] : QString();
+    if ( sX.isEmpty() && sY.isEmpty() )
+    {
+      result.emptyGeometry++;
+      result.numberFeatures++;
+    }
+    else
+    {
+      QgsPointXY pt;
+      bool ok = pointFromXY( sX, sY, pt, mDecimalPoint, mXyDms );
+
+      if ( ok )
+      {
+        if ( result.foundFirstGeometry )
+        {
+          result.extent.combineExtentWith( pt.x(), pt.y() );
+        }
+        else
+        {
+          // Extent for the first point is just the first point
+          result.extent.set( pt.x(), pt.y(), pt.x(), pt.y() );
+          result.wkbType = QgsWkbTypes::Point;
+          result.geometryType = QgsWkbTypes::PointGeometry;
+          result.foundFirstGeometry = true;
+        }
+        result.numberFeatures++;
+        if ( buildSpatialIndex && std::isfinite( pt.x() ) && std::isfinite( pt.y() ) )
+          result.addToSpatialIndex( recordId, QgsRectangle( pt.x(), pt.y(), pt.x(), pt.y() ) );
+      }
+      else
+      {
+        geomValid = false;
+        result.invalidGeometry++;
+        result.addInvalidLine( tr( "Invalid X or Y fields at line %1" ), recordId, mMaxInvalidLines );
+      }
+    }
+  }
+  else
+  {
+    result.wkbType = QgsWkbTypes::NoGeometry;
+    result.numberFeatures++;
+  }
+
+  if ( !geomValid )
+    return;
+
+  if ( buildSubsetIndex )
+    result.subsetIndex.append( recordId );
+
+
+  // If we are going to use this record, then assess the potential types of each column
+
+  for ( int i = 0; i < parts.size(); i++ )
+  {
+
+    QString &value = parts[i];
+    // Ignore empty fields - spreadsheet generated CSV files often
+    // have random empty fields at the end of a row
+    if ( value.isEmpty() )
+      continue;
+
+    // Expand the columns to include this non empty field if necessary
+
+    while ( result.couldBeInt.size() <= i )
+    {
+      result.isEmpty.append( true );
+      result.couldBeInt.append( false );
+      result.couldBeLongLong.append( false );
+      result.couldBeDouble.append( false );
+    }
+
+    // If this column has been empty so far then initiallize it
+    // for possible types
+
+    if ( result.isEmpty[i] )
+    {
+      result.isEmpty[i] = false;
+      result.couldBeInt[i] = true;
+      result.couldBeLongLong[i] = true;
+      result.couldBeDouble[i] = true;
+    }
+
+    if ( ! mDetectTypes )
+    {
+      continue;
+    }
+
+    // Now test for still valid possible types for the field
+    // Types are possible until first record which cannot be parsed
+
+    if ( result.couldBeInt[i] )
+    {
+      value.toInt( &result.couldBeInt[i] );
+    }
+
+    if ( result.couldBeLongLong[i] && ! result.couldBeInt[i] )
+    {
+      value.toLongLong( &result.couldBeLongLong[i] );
+    }
+
+    if ( result.couldBeDouble[i] && ! result.couldBeLongLong[i] )
+    {
+      if ( ! mDecimalPoint.isEmpty() )
+      {
+        value.replace( mDecimalPoint, QLatin1String( "." ) );
+      }
+      value.toDouble( &result.couldBeDouble[i] );
+    }
+  }
+}
+
+void QgsDelimitedTextProvider::ScanResult::addToSpatialIndex( QgsFeatureId id, const QgsRectangle &bounds )
+{
+  if ( spatialIndex )
+    spatialIndex->addFeature( id, bounds );
+  else
+    spatialIndexEntries.append( qMakePair( id, bounds ) );
+}
+
+void QgsDelimitedTextProvider::ScanResult::addInvalidLine( const QString &message, long lineNumber, int maxInvalidLines )
+{
+  if ( invalidLines.size() < maxInvalidLines )
+    invalidLines.append( qMakePair( message, lineNumber ) );
+  else
+    extraInvalidLines++;
+}
+
+void QgsDelimitedTextProvider::ScanResult::merge( const ScanResult &other, long lineNumberOffset )
+{
+  numberFeatures += other.numberFeatures;
+  emptyRecords += other.emptyRecords;
+  badFormatRecords += other.badFormatRecords;
+  incompatibleGeometry += other.incompatibleGeometry;
+  invalidGeometry += other.invalidGeometry;
+  emptyGeometry += other.emptyGeometry;
+
+  if ( other.foundFirstGeometry )
+  {
+    if ( foundFirstGeometry )
+    {
+      extent.combineExtentWith( other.extent );
+    }
+    else
+    {
+      extent = other.extent;
+      wkbType = other.wkbType;
+      geometryType = other.geometryType;
+      foundFirstGeometry = true;
+    }
+  }
+
+  // A type is only possible for a column if all of its values in every part of the file could be parsed
+  for ( int i = 0; i < other.isEmpty.size(); i++ )
+  {
+    if ( other.isEmpty.at( i ) )
+      continue;
+
+    while ( couldBeInt.size() <= i )
+    {
+      isEmpty.append( true );
+      couldBeInt.append( false );
+      couldBeLongLong.append( false );
+      couldBeDouble.append( false );
+    }
+
+    if ( isEmpty.at( i ) )
+    {
+      isEmpty[i] = false;
+      couldBeInt[i] = other.couldBeInt.at( i );
+      couldBeLongLong[i] = other.couldBeLongLong.at( i );
+      couldBeDouble[i] = other.couldBeDouble.at( i );
+    }
+    else
+    {
+      couldBeInt[i] = couldBeInt.at( i ) && other.couldBeInt.at( i );
+      couldBeLongLong[i] = couldBeLongLong.at( i ) && other.couldBeLongLong.at( i );
+      couldBeDouble[i] = couldBeDouble.at( i ) && other.couldBeDouble.at( i );
+    }
+  }
+
+  subsetIndex.reserve( subsetIndex.size() + other.subsetIndex.size() );
+  for ( quintptr id : other.subsetIndex )
+    subsetIndex.append( id + static_cast< quintptr >( lineNumberOffset ) );
+  for ( const QPair< QgsFeatureId, QgsRectangle > &entry : other.spatialIndexEntries )
+    addToSpatialIndex( entry.first + lineNumberOffset, entry.second );
+  for ( const QPair< QString, long > &invalidLine : other.invalidLines )
+    invalidLines.append( qMakePair( invalidLine.first, invalidLine.second + lineNumberOffset ) );
+  extraInvalidLines += other.extraInvalidLines;
+}
+
+// Returns the offset of the first line in file which starts at or after offset
+static qint64 lineStartAtOrAfter( QFile &file, qint64 offset )
+{
+  if ( offset <= 0 )
+    return 0;
+
+  qint64 position = offset - 1;
+  if ( ! file.seek( position ) )
+    return file.size();
+  while ( true )
+  {
+    const QByteArray block = file.read( PARALLEL_SCAN_BOUNDARY_BLOCK_SIZE );
+    if ( block.isEmpty() )
+      return file.size();
+    const int newline = block.indexOf( '\n' );
+    if ( newline >= 0 )
+      return position + newline + 1;
+    position += block.size();
+  }
+}
+
+bool QgsDelimitedTextProvider::scanFileInParallel( ScanResult &result, bool buildSpatialIndex, bool buildSubsetIndex )
+{
+  // The geometry type of a WKT layer is taken from the first valid geometry
+  // in the file, so WKT files are always scanned serially
+  if ( mGeomRep == GeomAsWkt )
+    return false;
+
+  const int threadCount = QThread::idealThreadCount();
+  if ( threadCount < 2 )
+    return false;
+
+  // Only files which are read in blocks can be split, and the header must be read first
+  if ( mFile->reset() != QgsDelimitedTextFile::RecordOk )
+    return false;
+  const qint64 dataStart = mFile->position();
+  const qint64 dataSize = QFileInfo( mFile->fileName() ).size() - dataStart;
+  if ( dataStart < 0 || dataSize < PARALLEL_SCAN_MIN_SIZE )
+    return false;
+
+  // Split the file into ranges starting at line boundaries. Records can span several lines,
+  // so a range may start within a record - this is checked once the ranges have been scanned.
+  QFile file( mFile->fileName() );
+  if ( ! file.open( QIODevice::ReadOnly ) )
+    return false;
+  const qint64 rangeCount = std::min( static_cast< qint64 >( threadCount ) * PARALLEL_SCAN_RANGES_PER_THREAD, dataSize / PARALLEL_SCAN_MIN_RANGE_SIZE );
+  QVector< qint64 > rangeStarts;
+  rangeStarts << dataStart;
+  for ( qint64 i = 1; i < rangeCount; ++i )
+  {
+    const qint64 start = lineStartAtOrAfter( file, dataStart + i * dataSize / rangeCount );
+    if ( start > rangeStarts.last() && start < dataStart + dataSize )
+      rangeStarts << start;
+  }
+  file.close();
+  if ( rangeStarts.size() < 2 )
+    return false;
+
+  struct ScanRange
+  {
+    std::unique_ptr< QgsDelimitedTextFile > file;
+    ScanResult result;
+    // Offset of the first record found in the range, and number of lines in the range before it
+    qint64 firstRecordOffset = -1;
+    long firstRecordLinesBefore = 0;
+    // Offset of the record following the range, and number of lines in the range before it.
+    // The offset is -1 if the range extends to the end of the file.
+    qint64 nextRecordOffset = -1;
+    long nextRecordLinesBefore = 0;
+  };
+
+  QUrl url = mFile->url();
+  url.removeQueryItem( QStringLiteral( "watchFile" ) );
+  const ScanResult emptyResult = result;
+  auto startRange = [ &url, &emptyResult ]( ScanRange & range, qint64 start, qint64 end )
+  {
+    range.file = qgis::make_unique< QgsDelimitedTextFile >();
+    range.file->setFromUrl( url );
+    range.result = emptyResult;
+    range.firstRecordOffset = -1;
+    range.nextRecordOffset = -1;
+    return range.file->setScanRange( start, end );
+  };
+
+  auto scanRange = [ this, buildSpatialIndex, buildSubsetIndex ]( ScanRange & range )
+  {
+    QgsDelimitedTextFile &file = *range.file;
+    QStringList parts;
+    while ( true )
+    {
+      QgsDelimitedTextFile::Status status = file.nextRecord( parts );
+      if ( range.firstRecordOffset < 0 && file.recordOffset() >= 0 )
+      {
+        range.firstRecordOffset = file.recordOffset();
+        range.firstRecordLinesBefore = file.reachedScanLimit() ? file.lineNumber() : file.recordId() - 1;
+      }
+      if ( status == QgsDelimitedTextFile::RecordEOF )
+        break;
+      scanRecord( status, parts, file.recordId(), range.result, buildSpatialIndex, buildSubsetIndex );
+    }
+    if ( file.reachedScanLimit() )
+    {
+      range.nextRecordOffset = file.recordOffset();
+      range.nextRecordLinesBefore = file.lineNumber();
+    }
+  };
+
+  std::vector< ScanRange > ranges( static_cast< size_t >( rangeStarts.size() ) );
+  for ( int i = 0; i < rangeStarts.size(); ++i )
+  {
+    if ( ! startRange( ranges[i], rangeStarts.at( i ), i + 1 < rangeStarts.size() ? rangeStarts.at( i + 1 ) : -1 ) )
+      return false;
+  }
+
+  QtConcurrent::blockingMap( ranges, scanRange );
+
+  // A range which did not start at the record following the previous range started
+  // within a record, so it is scanned again from that record. Ranges following one which
+  // extended to the end of the file only contained the continuation of its last record.
+  for ( size_t i = 1; i < ranges.size(); ++i )
+  {
+    const qint64 expectedOffset = ranges[i - 1].nextRecordOffset;
+    if ( expectedOffset < 0 )
+    {
+      ranges.resize( i );
+      break;
+    }
+    if ( ranges[i].firstRecordOffset != expectedOffset )
+    {
+      if ( ! startRange( ranges[i], expectedOffset, i + 1 < ranges.size() ? rangeStarts.at( static_cast< int >( i + 1 ) ) : -1 ) )
+        return false;
+      scanRange( ranges[i] );
+    }
+  }
+
+  if ( buildSpatialIndex )
+    result.spatialIndex = mSpatialIndex.get();
+
+  // Record ids are line numbers, so the ids from each range are offset by the number of lines before it
+  long lineNumberOffset = mFile->lineNumber();
+  for ( size_t i = 0; i < ranges.size(); ++i )
+  {
+    if ( i > 0 )
+      lineNumberOffset += ranges[i - 1].nextRecordLinesBefore - ranges[i].firstRecordLinesBefore;
+    result.merge( ranges[i].result, lineNumberOffset );
+    mFile->mergeScanState( *ranges[i].file, lineNumberOffset );
+  }
+
+  QgsDebugMsg( QStringLiteral( "Scanned delimited text file in %1 ranges" ).arg( ranges.size() ) );
+  return true;
+}
+
 // rescanFile.  Called if something has changed file definition, such as
 // selecting a subset, the file has been changed by another program, etc
 
@@ -904,11 +1150,11 @@ bool QgsDelimitedTextProvider::recordIsEmpty( QStringList &record )
   return true;
 }
 
-void QgsDelimitedTextProvider::recordInvalidLine( const QString &message )
+void QgsDelimitedTextProvider::recordInvalidLine( const QString &message, long lineNumber )
 {
   if ( mInvalidLines.size() < mMaxInvalidLines )
   {
-    mInvalidLines.append( message.arg( mFile->recordId() ) );
+    mInvalidLines.append( message.arg( lineNumber ) );
   }
   else
   {
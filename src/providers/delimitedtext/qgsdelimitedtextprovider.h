@@ -197,14 +197,68 @@ class QgsDelimitedTextProvider : public QgsVectorDataProvider
 
   private:
 
+    //! Information gathered by scanning the records of the file, or of a part of it
+    struct ScanResult
+    {
+      long numberFeatures = 0;
+      long emptyRecords = 0;
+      long badFormatRecords = 0;
+      long incompatibleGeometry = 0;
+      long invalidGeometry = 0;
+      long emptyGeometry = 0;
+
+      bool foundFirstGeometry = false;
+      QgsRectangle extent;
+      QgsWkbTypes::Type wkbType = QgsWkbTypes::NoGeometry;
+      QgsWkbTypes::GeometryType geometryType = QgsWkbTypes::UnknownGeometry;
+      bool wktHasPrefix = false;
+
+      // Possible types of each column
+      QList<bool> isEmpty;
+      QList<bool> couldBeInt;
+      QList<bool> couldBeLongLong;
+      QList<bool> couldBeDouble;
+
+      QList<quintptr> subsetIndex;
+
+      //! Index to which features are added, if not set they are collected in spatialIndexEntries
+      QgsSpatialIndex *spatialIndex = nullptr;
+      QVector< QPair< QgsFeatureId, QgsRectangle > > spatialIndexEntries;
+
+      //! Messages for invalid lines, with the line number still to be substituted
+      QList< QPair< QString, long > > invalidLines;
+      long extraInvalidLines = 0;
+
+      void addToSpatialIndex( QgsFeatureId id, const QgsRectangle &bounds );
+      void addInvalidLine( const QString &message, long lineNumber, int maxInvalidLines );
+
+      /**
+       * Merges the result of scanning the following part of the file. Line numbers and record
+       * ids of \a other are offset by \a lineNumberOffset.
+       */
+      void merge( const ScanResult &other, long lineNumberOffset );
+    };
+
     void scanFile( bool buildIndexes );
 
+    /**
+     * Adds a record read from the file with the specified \a status to a scan \a result.
+     */
+    void scanRecord( QgsDelimitedTextFile::Status status, QStringList &parts, long recordId, ScanResult &result, bool buildSpatialIndex, bool buildSubsetIndex ) const;
+
+    /**
+     * Scans large files by splitting them into byte ranges aligned to line boundaries, which
+     * are scanned concurrently. Returns false if the file is not suitable for a parallel scan,
+     * in which case \a result is unchanged and the file should be scanned serially.
+     */
+    bool scanFileInParallel( ScanResult &result, bool buildSpatialIndex, bool buildSubsetIndex );
+
     //some of these methods const, as they need to be called from const methods such as extent()
     void rescanFile() const;
     void resetCachedSubset() const;
     void resetIndexes() const;
     void clearInvalidLines() const;
-    void recordInvalidLine( const QString &message );
+    void recordInvalidLine( const QString &message, long lineNumber );
     void reportErrors( const QStringList &messages = QStringList(), bool showDialog = false ) const;
     static bool recordIsEmpty( QStringList &record );
     void setUriParameter( const QString &parameter, const QString &value );
@@ -139,6 +139,7 @@ void QgsMssqlFeatureIterator::BuildStatement( const QgsFeatureRequest &request )
        && mSource->isSpatial() )
   {
     mStatement += QStringLiteral( ",[%1]" ).arg( mSource->mGeometryColName );
+    mGeometryCol = mAttributesToFetch.count();
   }
 
   mStatement += QStringLiteral( " FROM [%1].[%2]" ).arg( mSource->mSchemaName, mSource->mTableName );
@@ -374,7 +375,7 @@ bool QgsMssqlFeatureIterator::fetchFeature( QgsFeature &feature )
     for ( int i = 0; i < mAttributesToFetch.count(); i++ )
     {
       const QVariant originalValue = mQuery->value( i );
-      QgsField fld = mSource->mFields.at( mAttributesToFetch.at( i ) );
+      const QgsField &fld = mSource->mFields.at( mAttributesToFetch.at( i ) );
       QVariant v = originalValue;
       if ( v.type() != fld.type() )
         v = QgsVectorDataProvider::convertValue( fld.type(), originalValue.toString() );
@@ -398,15 +399,17 @@ bool QgsMssqlFeatureIterator::fetchFeature( QgsFeature &feature )
       feature.setAttribute( mAttributesToFetch.at( i ), v );
     }
 
-    feature.setId( mQuery->record().value( mSource->mFidColName ).toLongLong() );
+    // read values by column position -- QSqlQuery::record() would fetch every column of the row each time
+    feature.setId( mQuery->value( 0 ).toLongLong() );
 
     feature.clearGeometry();
-    if ( mSource->isSpatial() )
+    if ( mGeometryCol >= 0 )
     {
-      QByteArray ar = mQuery->record().value( mSource->mGeometryColName ).toByteArray();
+      // parse the geometry straight from the fetched blob, without detaching it
+      const QByteArray ar = mQuery->value( mGeometryCol ).toByteArray();
       if ( !ar.isEmpty() )
       {
-        std::unique_ptr<QgsAbstractGeometry> geom = mParser.parseSqlGeometry( reinterpret_cast< unsigned char * >( ar.data() ), ar.size() );
+        std::unique_ptr<QgsAbstractGeometry> geom = mParser.parseSqlGeometry( reinterpret_cast< const unsigned char * >( ar.constData() ), ar.size() );
         if ( geom )
         {
           feature.setGeometry( QgsGeometry( std::move( geom ) ) );
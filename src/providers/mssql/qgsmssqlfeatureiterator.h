@@ -113,6 +113,9 @@ class QgsMssqlFeatureIterator : public QgsAbstractFeatureIteratorFromSource<QgsM
     // Field index of FID column
     int mFidCol = -1;
 
+    // Position of the geometry column in the query results, or -1 if geometry is not fetched
+    int mGeometryCol = -1;
+
     // List of attribute indices to fetch with nextFeature calls
     QgsAttributeList mAttributesToFetch;
 
@@ -137,11 +137,11 @@ SegmentType (1 byte)
 #define SMT_FIRSTLINE 2
 #define SMT_FIRSTARC 3
 
-#define ReadInt32(nPos) (*((unsigned int*)(mData + (nPos))))
+#define ReadInt32(nPos) (*((const unsigned int*)(mData + (nPos))))
 
 #define ReadByte(nPos) (mData[nPos])
 
-#define ReadDouble(nPos) (*((double*)(mData + (nPos))))
+#define ReadDouble(nPos) (*((const double*)(mData + (nPos))))
 
 #define ParentOffset(iShape) (ReadInt32(mShapePos + (iShape) * 9 ))
 #define FigureOffset(iShape) (ReadInt32(mShapePos + (iShape) * 9 + 4))
@@ -163,7 +163,7 @@ QgsMssqlGeometryParser::QgsMssqlGeometryParser()
 {
 }
 
-void QgsMssqlGeometryParser::DumpMemoryToLog( const char *pszMsg, unsigned char *pszInput, int nLen )
+void QgsMssqlGeometryParser::DumpMemoryToLog( const char *pszMsg, const unsigned char *pszInput, int nLen )
 {
 #if 0
   char buf[55];
@@ -599,7 +599,7 @@ std::unique_ptr< QgsGeometryCollection > QgsMssqlGeometryParser::readGeometryCol
   return poGeomColl;
 }
 
-std::unique_ptr<QgsAbstractGeometry> QgsMssqlGeometryParser::parseSqlGeometry( unsigned char *pszInput, int nLen )
+std::unique_ptr<QgsAbstractGeometry> QgsMssqlGeometryParser::parseSqlGeometry( const unsigned char *pszInput, int nLen )
 {
   if ( nLen < 10 )
   {
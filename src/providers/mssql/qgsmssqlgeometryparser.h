@@ -41,7 +41,7 @@ class QgsMssqlGeometryParser
 {
 
   protected:
-    unsigned char *mData = nullptr;
+    const unsigned char *mData = nullptr;
     /* version information */
     char mVersion = 0;
     /* serialization properties */
@@ -81,9 +81,9 @@ class QgsMssqlGeometryParser
 
   public:
     QgsMssqlGeometryParser();
-    std::unique_ptr<QgsAbstractGeometry> parseSqlGeometry( unsigned char *pszInput, int nLen );
+    std::unique_ptr<QgsAbstractGeometry> parseSqlGeometry( const unsigned char *pszInput, int nLen );
     int GetSRSId() { return mSRSId; }
-    void DumpMemoryToLog( const char *pszMsg, unsigned char *pszInput, int nLen );
+    void DumpMemoryToLog( const char *pszMsg, const unsigned char *pszInput, int nLen );
     /* sql geo type */
     bool mIsGeography = false;
 };
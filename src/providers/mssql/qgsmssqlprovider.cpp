@@ -772,8 +772,8 @@ void QgsMssqlProvider::UpdateStatistics( bool estimate ) const
   // We have to read all the geometry if readAllGeography is true.
   while ( query.next() )
   {
-    QByteArray ar = query.value( 0 ).toByteArray();
-    std::unique_ptr<QgsAbstractGeometry> geom = mParser.parseSqlGeometry( reinterpret_cast< unsigned char * >( ar.data() ), ar.size() );
+    const QByteArray ar = query.value( 0 ).toByteArray();
+    std::unique_ptr<QgsAbstractGeometry> geom = mParser.parseSqlGeometry( reinterpret_cast< const unsigned char * >( ar.constData() ), ar.size() );
     if ( geom )
     {
       QgsRectangle rect = geom->boundingBox();
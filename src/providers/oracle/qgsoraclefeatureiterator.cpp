@@ -366,7 +366,7 @@ bool QgsOracleFeatureIterator::fetchFeature( QgsFeature &feature )
         {
           Q_FOREACH ( int idx, mSource->mPrimaryKeyAttrs )
           {
-            QgsField fld = mSource->mFields.at( idx );
+            const QgsField &fld = mSource->mFields.at( idx );
 
             QVariant v = mQry.value( col );
             if ( v.type() != fld.type() )
@@ -403,7 +403,7 @@ bool QgsOracleFeatureIterator::fetchFeature( QgsFeature &feature )
       if ( mSource->mPrimaryKeyAttrs.contains( idx ) )
         continue;
 
-      QgsField fld = mSource->mFields.at( idx );
+      const QgsField &fld = mSource->mFields.at( idx );
 
       QVariant v = mQry.value( col );
       if ( fld.type() == QVariant::ByteArray && fld.typeName().endsWith( QStringLiteral( ".SDO_GEOMETRY" ) ) )
@@ -35,10 +35,12 @@
 #include "qgssqliteutils.h"
 
 #include <algorithm>
+#include <map>
 #include <QDir>
 #include <QProgressDialog>
 #include <QTimer>
 #include <QStyle>
+#include <QtConcurrent>
 
 #include <sqlite3.h>
 
@@ -84,6 +86,65 @@ QString QgsWFSFeatureHitsAsyncRequest::errorMessageWithReason( const QString &re
 
 // -------------------------
 
+QgsWFSFeaturePageRequest::QgsWFSFeaturePageRequest( const QgsWFSDataSourceURI &uri, const QUrl &url, QgsGmlStreamingParser *parser )
+  : QgsWfsRequest( uri )
+  , mUrl( url )
+  , mParser( parser )
+{
+  connect( this, &QgsWfsRequest::downloadFinished, this, &QgsWFSFeaturePageRequest::pageReplyFinished );
+}
+
+QgsWFSFeaturePageRequest::~QgsWFSFeaturePageRequest()
+{
+  // the parser must not be destroyed while it is still in use
+  mParsing.waitForFinished();
+}
+
+void QgsWFSFeaturePageRequest::launch()
+{
+  sendGET( mUrl,
+           false, /* synchronous */
+           true, /* forceRefresh */
+           false /* cache */ );
+}
+
+void QgsWFSFeaturePageRequest::pageReplyFinished()
+{
+  mFinished = true;
+  if ( mErrorCode != NoError || !mParser )
+    return;
+
+  const QByteArray data = mResponse;
+  mResponse.clear();
+  QgsGmlStreamingParser *parser = mParser.get();
+  QString *errorMessage = &mParsingErrorMessage;
+  mParsing = QtConcurrent::run( [parser, data, errorMessage]
+  {
+    return parser->processData( data, true, *errorMessage );
+  } );
+}
+
+bool QgsWFSFeaturePageRequest::waitForParsing()
+{
+  if ( !mFinished || mErrorCode != NoError || !mParser )
+    return false;
+
+  mParsing.waitForFinished();
+  if ( !mParsing.result() )
+  {
+    QgsDebugMsg( QStringLiteral( "Error when parsing page %1: %2" ).arg( mUrl.toDisplayString(), mParsingErrorMessage ) );
+    return false;
+  }
+  return true;
+}
+
+QString QgsWFSFeaturePageRequest::errorMessageWithReason( const QString &reason )
+{
+  return tr( "Download of features failed: %1" ).arg( reason );
+}
+
+// -------------------------
+
 QgsWFSFeatureDownloader::QgsWFSFeatureDownloader( QgsWFSSharedData *shared )
   : QgsWfsRequest( shared->mURI )
   , mShared( shared )
@@ -496,6 +557,53 @@ void QgsWFSFeatureDownloader::run( bool serializeFeatures, int maxFeatures )
   {
     maxTotalFeatures = mShared->mMaxFeatures;
   }
+
+  auto pageFeatureCount = [this, maxTotalFeatures]( qint64 startIndex )
+  {
+    int featureCount = static_cast<int>(
+                         std::min( maxTotalFeatures - startIndex,
+                                   static_cast<qint64>( std::numeric_limits<int>::max() ) ) );
+    if ( mShared->mPageSize > 0 )
+    {
+      if ( featureCount > 0 )
+      {
+        featureCount = std::min( featureCount, mShared->mPageSize );
+      }
+      else
+      {
+        featureCount = mShared->mPageSize;
+      }
+    }
+    return featureCount;
+  };
+
+  // Once the first page has been received, the following pages are requested in
+  // advance, so that several pages are downloaded (and parsed) concurrently. They
+  // are still processed, and thus cached, in order.
+  const int maxConcurrentPageRequests = s.value( QStringLiteral( "wfs/max_concurrent_page_requests" ), 4 ).toInt();
+  std::map< qint64, std::unique_ptr< QgsWFSFeaturePageRequest > > prefetchedPages;
+  auto prefetchPages = [&]()
+  {
+    if ( mStop || maxConcurrentPageRequests <= 1 || mShared->mPageSize <= 0 )
+      return;
+
+    for ( int i = 0; i < maxConcurrentPageRequests; ++i )
+    {
+      const qint64 startIndex = mTotalDownloadedFeatureCount + i * static_cast<qint64>( mShared->mPageSize );
+      if ( ( maxTotalFeatures > 0 && startIndex >= maxTotalFeatures ) ||
+           ( mNumberMatched > 0 && startIndex >= mNumberMatched ) )
+        break;
+      if ( prefetchedPages.count( startIndex ) )
+        continue;
+
+      std::unique_ptr< QgsWFSFeaturePageRequest > page = qgis::make_unique< QgsWFSFeaturePageRequest >(
+            mShared->mURI, buildURL( startIndex, pageFeatureCount( startIndex ), false ), mShared->createParser() );
+      connect( page.get(), &QgsWfsRequest::downloadFinished, &loop, &QEventLoop::quit );
+      page->launch();
+      prefetchedPages[ startIndex ] = std::move( page );
+    }
+  };
+
   // Top level loop to do feature paging in WFS 2.0
   while ( true )
   {
@@ -506,40 +614,60 @@ void QgsWFSFeatureDownloader::run( bool serializeFeatures, int maxFeatures )
     {
       break;
     }
-    int maxFeaturesThisRequest = static_cast<int>(
-                                   std::min( maxTotalFeatures - mTotalDownloadedFeatureCount,
-                                       static_cast<qint64>( std::numeric_limits<int>::max() ) ) );
-    if ( mShared->mPageSize > 0 )
+    QUrl url( buildURL( mTotalDownloadedFeatureCount,
+                        pageFeatureCount( mTotalDownloadedFeatureCount ), false ) );
+
+    // Small hack for testing purposes
+    if ( retryIter > 0 && url.toString().contains( QLatin1String( "fake_qgis_http_endpoint" ) ) )
     {
-      if ( maxFeaturesThisRequest > 0 )
+      url.addQueryItem( QStringLiteral( "RETRY" ), QString::number( retryIter ) );
+    }
+
+    // Use the page if it has been requested in advance and successfully parsed,
+    // otherwise issue the request now
+    std::unique_ptr< QgsWFSFeaturePageRequest > prefetchedPage;
+    auto prefetched = prefetchedPages.find( mTotalDownloadedFeatureCount );
+    if ( prefetched != prefetchedPages.end() )
+    {
+      prefetchedPage = std::move( prefetched->second );
+      prefetchedPages.erase( prefetched );
+      while ( prefetchedPage->url() == url && !prefetchedPage->isFinished() && !mStop )
+      {
+        loop.exec( QEventLoop::ExcludeUserInputEvents );
+      }
+      if ( prefetchedPage->url() == url && !mStop && prefetchedPage->waitForParsing() )
       {
-        maxFeaturesThisRequest = std::min( maxFeaturesThisRequest, mShared->mPageSize );
+        delete parser;
+        parser = prefetchedPage->takeParser();
       }
       else
       {
-        maxFeaturesThisRequest = mShared->mPageSize;
+        prefetchedPage.reset();
       }
     }
-    QUrl url( buildURL( mTotalDownloadedFeatureCount,
-                        maxFeaturesThisRequest, false ) );
 
-    // Small hack for testing purposes
-    if ( retryIter > 0 && url.toString().contains( QLatin1String( "fake_qgis_http_endpoint" ) ) )
+    if ( mStop )
     {
-      url.addQueryItem( QStringLiteral( "RETRY" ), QString::number( retryIter ) );
+      interrupted = true;
+      success = false;
+      delete parser;
+      break;
     }
 
-    sendGET( url,
-             false, /* synchronous */
-             true, /* forceRefresh */
-             false /* cache */ );
+    if ( !prefetchedPage )
+    {
+      sendGET( url,
+               false, /* synchronous */
+               true, /* forceRefresh */
+               false /* cache */ );
+    }
 
     int featureCountForThisResponse = 0;
     bool bytesStillAvailableInReply = false;
     // Loop until there is no data coming from the current request
     while ( true )
     {
-      if ( !bytesStillAvailableInReply )
+      if ( !bytesStillAvailableInReply && !prefetchedPage )
       {
         loop.exec( QEventLoop::ExcludeUserInputEvents );
       }
@@ -549,7 +677,7 @@ void QgsWFSFeatureDownloader::run( bool serializeFeatures, int maxFeatures )
         success = false;
         break;
       }
-      if ( mErrorCode != NoError )
+      if ( !prefetchedPage && mErrorCode != NoError )
       {
         success = false;
         break;
@@ -557,7 +685,12 @@ void QgsWFSFeatureDownloader::run( bool serializeFeatures, int maxFeatures )
 
       QByteArray data;
       bool finished = false;
-      if ( mReply )
+      if ( prefetchedPage )
+      {
+        // already parsed
+        finished = true;
+      }
+      else if ( mReply )
       {
         // Limit the number of bytes to process at once, to avoid the GML parser to
         // create too many objects.
@@ -571,7 +704,7 @@ void QgsWFSFeatureDownloader::run( bool serializeFeatures, int maxFeatures )
       }
       // Parse the received chunk of data
       QString gmlProcessErrorMsg;
-      if ( !parser->processData( data, finished, gmlProcessErrorMsg ) )
+      if ( !prefetchedPage && !parser->processData( data, finished, gmlProcessErrorMsg ) )
       {
         success = false;
         mErrorMessage = tr( "Error when parsing GetFeature response" ) + " : " + gmlProcessErrorMsg;
@@ -838,8 +971,14 @@ void QgsWFSFeatureDownloader::run( bool serializeFeatures, int maxFeatures )
       {
         mShared->mMaxFeatures = 0;
       }
+      prefetchedPages.clear();
+    }
+    else
+    {
+      prefetchPages();
     }
   }
+  prefetchedPages.clear();
 
   {
     QMutexLocker locker( &mMutexCreateProgressDialog );
@@ -27,6 +27,7 @@
 #include <QPushButton>
 #include <QMutex>
 #include <QWaitCondition>
+#include <QFuture>
 
 class QgsWFSProvider;
 class QgsWFSSharedData;
@@ -62,6 +63,51 @@ class QgsWFSFeatureHitsAsyncRequest: public QgsWfsRequest
 };
 
 
+/**
+ * Utility class for QgsWFSFeatureDownloader, to download a page of a paged
+    GetFeature request in advance. Once downloaded, the page is parsed
+    in a worker thread, so that several pages can be downloaded and parsed
+    while the downloader processes the previous ones. */
+class QgsWFSFeaturePageRequest: public QgsWfsRequest
+{
+    Q_OBJECT
+  public:
+    //! Constructor. Takes ownership of \a parser
+    QgsWFSFeaturePageRequest( const QgsWFSDataSourceURI &uri, const QUrl &url, QgsGmlStreamingParser *parser );
+    ~QgsWFSFeaturePageRequest() override;
+
+    //! Issues the GetFeature request
+    void launch();
+
+    //! Returns the URL of the request
+    QUrl url() const { return mUrl; }
+
+    //! Returns whether the download is finished (successful or not)
+    bool isFinished() const { return mFinished; }
+
+    /**
+     * Waits for the downloaded page to be parsed. Returns false if the page could not be
+        downloaded or parsed. */
+    bool waitForParsing();
+
+    //! Returns the parser, and transfers its ownership to the caller
+    QgsGmlStreamingParser *takeParser() { return mParser.release(); }
+
+  protected:
+    QString errorMessageWithReason( const QString &reason ) override;
+
+  private slots:
+    void pageReplyFinished();
+
+  private:
+    QUrl mUrl;
+    std::unique_ptr< QgsGmlStreamingParser > mParser;
+    bool mFinished = false;
+    QFuture< bool > mParsing;
+    QString mParsingErrorMessage;
+};
+
+
 //! Utility class for QgsWFSFeatureDownloader
 class QgsWFSProgressDialog: public QProgressDialog
 {
@@ -752,7 +752,8 @@ bool QgsWFSProvider::setSubsetString( const QString &theSQL, bool updateFeatureC
   QString errorMsg;
   if ( !mShared->computeFilter( errorMsg ) )
     QgsMessageLog::logMessage( errorMsg, tr( "WFS" ) );
-  reloadData();
+  // The cache has already been invalidated above. Don't call reloadData(), which
+  // would also discard the persistent cache entry matching the new filter
   if ( updateFeatureCount )
     featureCount();
 
@@ -772,6 +773,8 @@ QgsAbstractFeatureSource *QgsWFSProvider::featureSource() const
 
 void QgsWFSProvider::reloadData()
 {
+  // An explicit reload must fetch fresh features from the server
+  mShared->discardPersistentCache();
   mShared->invalidateCache();
   QgsVectorDataProvider::reloadData();
 }
@@ -931,6 +934,7 @@ bool QgsWFSProvider::addFeatures( QgsFeatureList &flist, Flags flags )
       serializedFeatureList.push_back( QgsWFSFeatureGmlIdPair( *featureIt, *idIt ) );
     }
     mShared->serializeFeatures( serializedFeatureList );
+    mShared->discardPersistentCache();
 
     if ( !( flags & QgsFeatureSink::FastInsert ) )
     {
@@ -1009,6 +1013,7 @@ bool QgsWFSProvider::deleteFeatures( const QgsFeatureIds &id )
   if ( transactionSuccess( serverResponse ) )
   {
     mShared->deleteFeatures( id );
+    mShared->discardPersistentCache();
     return true;
   }
   else
@@ -1082,6 +1087,7 @@ bool QgsWFSProvider::changeGeometryValues( const QgsGeometryMap &geometry_map )
   if ( transactionSuccess( serverResponse ) )
   {
     mShared->changeGeometryValues( geometry_map );
+    mShared->discardPersistentCache();
     return true;
   }
   else
@@ -1189,6 +1195,7 @@ bool QgsWFSProvider::changeAttributeValues( const QgsChangedAttributesMap &attr_
   if ( transactionSuccess( serverResponse ) )
   {
     mShared->changeAttributeValues( attr_map );
+    mShared->discardPersistentCache();
     return true;
   }
   else
@@ -28,6 +28,7 @@
 #include "qgsproviderregistry.h"
 #include "qgslogger.h"
 #include "qgsspatialiteutils.h"
+#include "qgssettings.h"
 
 #include <cpl_vsi.h>
 #include <cpl_conv.h>
@@ -35,6 +36,10 @@
 
 #include <set>
 
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QTemporaryFile>
+
 #include <sqlite3.h>
 
 QgsWFSSharedData::QgsWFSSharedData( const QString &uri )
@@ -265,9 +270,83 @@ bool QgsWFSSharedData::createCache()
   if ( mDistinctSelect )
     cacheFields.append( QgsField( QgsWFSConstants::FIELD_MD5, QVariant::String, QStringLiteral( "string" ) ) );
 
-  bool ogrWaySuccessful = false;
   QString fidName( QStringLiteral( "__ogc_fid" ) );
   QString geometryFieldname( QStringLiteral( "__spatialite_geometry" ) );
+  const bool restoredFromPersistentCache = restorePersistentCache();
+  if ( restoredFromPersistentCache )
+  {
+    mCacheTablename = QStringLiteral( "features" );
+  }
+  else if ( !createCacheDatabase( cacheFields, fidName, geometryFieldname ) )
+  {
+    return false;
+  }
+
+  // Some pragmas to speed-up writing. We don't need much integrity guarantee
+  // regarding crashes, since this is a temporary DB
+  QgsDataSourceUri dsURI;
+  dsURI.setDatabase( mCacheDbname );
+  dsURI.setDataSource( QString(), mCacheTablename, geometryFieldname, QString(), fidName );
+  QStringList pragmas;
+  pragmas << QStringLiteral( "synchronous=OFF" );
+  pragmas << QStringLiteral( "journal_mode=WAL" ); // WAL is needed to avoid reader to block writers
+  dsURI.setParam( QStringLiteral( "pragma" ), pragmas );
+
+  QgsDataProvider::ProviderOptions providerOptions;
+  mCacheDataProvider = ( QgsVectorDataProvider * )( QgsProviderRegistry::instance()->createProvider(
+                         QStringLiteral( "spatialite" ), dsURI.uri(), providerOptions ) );
+  if ( mCacheDataProvider && !mCacheDataProvider->isValid() )
+  {
+    delete mCacheDataProvider;
+    mCacheDataProvider = nullptr;
+  }
+  if ( !mCacheDataProvider )
+  {
+    QgsMessageLog::logMessage( tr( "Cannot connect to temporary SpatiaLite cache" ), tr( "WFS" ) );
+    return false;
+  }
+
+  // The id_cache should be generated once for the lifetime of QgsWFSConstants
+  // to ensure consistency of the ids returned to the user.
+  if ( mCacheIdDbname.isEmpty() )
+  {
+    mCacheIdDbname = QDir( cacheDirectory ).filePath( QStringLiteral( "wfs_id_cache_%1.sqlite" ).arg( tmpCounter ) );
+    Q_ASSERT( !QFile::exists( mCacheIdDbname ) );
+    if ( mCacheIdDb.open( mCacheIdDbname ) != SQLITE_OK )
+    {
+      QgsMessageLog::logMessage( tr( "Cannot create temporary id cache" ), tr( "WFS" ) );
+      return false;
+    }
+    QString errorMsg;
+    bool ok = mCacheIdDb.exec( QStringLiteral( "PRAGMA synchronous=OFF" ), errorMsg ) == SQLITE_OK;
+    // WAL is needed to avoid reader to block writers
+    ok &= mCacheIdDb.exec( QStringLiteral( "PRAGMA journal_mode=WAL" ), errorMsg ) == SQLITE_OK;
+    // gmlid is the gmlid or fid attribute coming from the GML GetFeature response
+    // qgisId is the feature id of the features returned to QGIS. That one should remain the same for a given gmlid even after a layer reload
+    // dbId is the feature id of the Spatialite feature in mCacheDataProvider. It might change for a given gmlid after a layer reload
+    ok &= mCacheIdDb.exec( QStringLiteral( "CREATE TABLE id_cache(gmlid TEXT, dbId INTEGER, qgisId INTEGER)" ), errorMsg ) == SQLITE_OK;
+    ok &= mCacheIdDb.exec( QStringLiteral( "CREATE INDEX idx_gmlid ON id_cache(gmlid)" ), errorMsg ) == SQLITE_OK;
+    ok &= mCacheIdDb.exec( QStringLiteral( "CREATE INDEX idx_dbId ON id_cache(dbId)" ), errorMsg ) == SQLITE_OK;
+    ok &= mCacheIdDb.exec( QStringLiteral( "CREATE INDEX idx_qgisId ON id_cache(qgisId)" ), errorMsg ) == SQLITE_OK;
+    if ( !ok )
+    {
+      QgsDebugMsg( errorMsg );
+      return false;
+    }
+  }
+
+  if ( restoredFromPersistentCache )
+  {
+    mComputedExtent = mCacheDataProvider->extent();
+    registerRestoredFeatureIds();
+  }
+
+  return true;
+}
+
+bool QgsWFSSharedData::createCacheDatabase( const QgsFields &cacheFields, const QString &fidName, const QString &geometryFieldname )
+{
+  bool ogrWaySuccessful = false;
 #ifdef USE_OGR_FOR_DB_CREATION
   // Only GDAL >= 2.0 can use an alternate geometry or FID field name
   // but QgsVectorFileWriter will refuse anyway to create a ogc_fid, so we will
@@ -457,62 +536,254 @@ bool QgsWFSSharedData::createCache()
     return false;
   }
 
-  // Some pragmas to speed-up writing. We don't need much integrity guarantee
-  // regarding crashes, since this is a temporary DB
-  QgsDataSourceUri dsURI;
-  dsURI.setDatabase( mCacheDbname );
-  dsURI.setDataSource( QString(), mCacheTablename, geometryFieldname, QString(), fidName );
-  QStringList pragmas;
-  pragmas << QStringLiteral( "synchronous=OFF" );
-  pragmas << QStringLiteral( "journal_mode=WAL" ); // WAL is needed to avoid reader to block writers
-  dsURI.setParam( QStringLiteral( "pragma" ), pragmas );
+  return true;
+}
 
-  QgsDataProvider::ProviderOptions providerOptions;
-  mCacheDataProvider = ( QgsVectorDataProvider * )( QgsProviderRegistry::instance()->createProvider(
-                         QStringLiteral( "spatialite" ), dsURI.uri(), providerOptions ) );
-  if ( mCacheDataProvider && !mCacheDataProvider->isValid() )
+QString QgsWFSSharedData::persistentCacheFilename()
+{
+  QgsSettings settings;
+  if ( !settings.value( QStringLiteral( "wfs/persistent_cache_enabled" ), false ).toBool() )
+    return QString();
+
+  // The persistent cache is keyed by everything that determines the content
+  // of the downloaded features, so that it can be shared by all layers (and
+  // sessions) requesting the same features
+  QStringList keyParts;
+  keyParts << mURI.baseURL( false ).toString()
+           << mURI.auth().mUserName
+           << mURI.auth().mAuthCfg
+           << mURI.typeName()
+           << mURI.sql()
+           << mWFSVersion
+           << srsName()
+           << mWFSFilter
+           << mSortBy
+           << mGeometryAttribute
+           << QString::number( mMaxFeatures )
+           << QString::number( mDistinctSelect );
+  for ( const QgsField &field : qgis::as_const( mFields ) )
+    keyParts << QStringLiteral( "%1:%2" ).arg( field.name() ).arg( field.type() );
+
+  const QByteArray key = QCryptographicHash::hash( keyParts.join( '\n' ).toUtf8(), QCryptographicHash::Md5 ).toHex();
+  return QDir( QgsWFSUtils::persistentCacheDirectory() ).filePath( QStringLiteral( "wfs_cache_%1.sqlite" ).arg( QString::fromLatin1( key ) ) );
+}
+
+bool QgsWFSSharedData::restorePersistentCache()
+{
+  const QString filename = persistentCacheFilename();
+  if ( filename.isEmpty() || !QFile::exists( filename ) )
+    return false;
+
+  qint64 timestamp = 0;
+  int featureCount = 0;
+  bool complete = false;
+  QVector< QgsFeature > regions;
   {
-    delete mCacheDataProvider;
-    mCacheDataProvider = nullptr;
+    sqlite3_database_unique_ptr database;
+    if ( database.open_v2( filename, SQLITE_OPEN_READONLY, nullptr ) != SQLITE_OK )
+      return false;
+
+    int resultCode;
+    sqlite3_statement_unique_ptr stmt = database.prepare( QStringLiteral( "SELECT timestamp, feature_count, complete FROM wfs_persistent_cache" ), resultCode );
+    if ( resultCode != SQLITE_OK || stmt.step() != SQLITE_ROW )
+      return false;
+    timestamp = stmt.columnAsInt64( 0 );
+    featureCount = static_cast< int >( stmt.columnAsInt64( 1 ) );
+    complete = stmt.columnAsInt64( 2 ) != 0;
+
+    stmt = database.prepare( QStringLiteral( "SELECT xmin, ymin, xmax, ymax, download_limit FROM wfs_persistent_cache_regions" ), resultCode );
+    while ( resultCode == SQLITE_OK && stmt.step() == SQLITE_ROW )
+    {
+      QgsFeature f;
+      f.setGeometry( QgsGeometry::fromRect( QgsRectangle( stmt.columnAsDouble( 0 ), stmt.columnAsDouble( 1 ),
+                     stmt.columnAsDouble( 2 ), stmt.columnAsDouble( 3 ) ) ) );
+      f.setId( regions.size() );
+      f.initAttributes( 1 );
+      f.setAttribute( 0, QVariant( stmt.columnAsInt64( 4 ) != 0 ) );
+      regions.push_back( f );
+    }
   }
-  if ( !mCacheDataProvider )
+
+  QgsSettings settings;
+  const double maxAgeHours = settings.value( QStringLiteral( "wfs/persistent_cache_max_age_hours" ), 24 * 7 ).toDouble();
+  if ( maxAgeHours > 0 && QDateTime::currentMSecsSinceEpoch() - timestamp > maxAgeHours * 3600 * 1000 )
   {
-    QgsMessageLog::logMessage( tr( "Cannot connect to temporary SpatiaLite cache" ), tr( "WFS" ) );
+    QgsDebugMsgLevel( QStringLiteral( "Persistent cache %1 has expired" ).arg( filename ), 4 );
+    QFile::remove( filename );
     return false;
   }
 
-  // The id_cache should be generated once for the lifetime of QgsWFSConstants
-  // to ensure consistency of the ids returned to the user.
-  if ( mCacheIdDbname.isEmpty() )
+  // Revalidate a complete cache against the number of features currently
+  // reported by the server. If the server can't be reached, the cache is used as is.
+  if ( complete && mCaps.supportsHits )
   {
-    mCacheIdDbname = QDir( cacheDirectory ).filePath( QStringLiteral( "wfs_id_cache_%1.sqlite" ).arg( tmpCounter ) );
-    Q_ASSERT( !QFile::exists( mCacheIdDbname ) );
-    if ( mCacheIdDb.open( mCacheIdDbname ) != SQLITE_OK )
+    QgsWFSFeatureHitsRequest request( mURI );
+    const int serverFeatureCount = request.getFeatureCount( mWFSVersion, mWFSFilter, mCaps );
+    if ( serverFeatureCount >= 0 && serverFeatureCount != featureCount )
     {
-      QgsMessageLog::logMessage( tr( "Cannot create temporary id cache" ), tr( "WFS" ) );
+      QgsDebugMsgLevel( QStringLiteral( "Persistent cache %1 is stale: %2 features cached, %3 on server" ).arg( filename ).arg( featureCount ).arg( serverFeatureCount ), 4 );
+      QFile::remove( filename );
       return false;
     }
+    mGetFeatureHitsIssued = true;
+  }
+
+  if ( !QFile::copy( filename, mCacheDbname ) )
+    return false;
+
+  // Features of the previous session must be visible to all iterators,
+  // whatever their generation counter
+  {
+    sqlite3_database_unique_ptr database;
     QString errorMsg;
-    bool ok = mCacheIdDb.exec( QStringLiteral( "PRAGMA synchronous=OFF" ), errorMsg ) == SQLITE_OK;
-    // WAL is needed to avoid reader to block writers
-    ok &= mCacheIdDb.exec( QStringLiteral( "PRAGMA journal_mode=WAL" ), errorMsg ) == SQLITE_OK;
-    // gmlid is the gmlid or fid attribute coming from the GML GetFeature response
-    // qgisId is the feature id of the features returned to QGIS. That one should remain the same for a given gmlid even after a layer reload
-    // dbId is the feature id of the Spatialite feature in mCacheDataProvider. It might change for a given gmlid after a layer reload
-    ok &= mCacheIdDb.exec( QStringLiteral( "CREATE TABLE id_cache(gmlid TEXT, dbId INTEGER, qgisId INTEGER)" ), errorMsg ) == SQLITE_OK;
-    ok &= mCacheIdDb.exec( QStringLiteral( "CREATE INDEX idx_gmlid ON id_cache(gmlid)" ), errorMsg ) == SQLITE_OK;
-    ok &= mCacheIdDb.exec( QStringLiteral( "CREATE INDEX idx_dbId ON id_cache(dbId)" ), errorMsg ) == SQLITE_OK;
-    ok &= mCacheIdDb.exec( QStringLiteral( "CREATE INDEX idx_qgisId ON id_cache(qgisId)" ), errorMsg ) == SQLITE_OK;
-    if ( !ok )
+    if ( database.open( mCacheDbname ) != SQLITE_OK ||
+         database.exec( QStringLiteral( "UPDATE features SET %1 = 0" ).arg( quotedIdentifier( QgsWFSConstants::FIELD_GEN_COUNTER ) ), errorMsg ) != SQLITE_OK )
     {
       QgsDebugMsg( errorMsg );
+      database.reset();
+      QFile::remove( mCacheDbname );
       return false;
     }
   }
 
+  QgsDebugMsgLevel( QStringLiteral( "Restored %1 features from persistent cache %2" ).arg( featureCount ).arg( filename ), 4 );
+  mPersistentCacheRestored = true;
+  mPersistentCacheComplete = complete;
+  mDownloadFinished = true;
+  mFeatureCount = featureCount;
+  mFeatureCountExact = complete;
+  mTotalFeaturesAttemptedToBeCached = featureCount;
+  mRegions = regions;
+  mCachedRegions = QgsSpatialIndex();
+  for ( QgsFeature &f : mRegions )
+    mCachedRegions.addFeature( f );
   return true;
 }
 
+void QgsWFSSharedData::registerRestoredFeatureIds()
+{
+  // The dbIds of a previous cache database are no longer valid
+  QString errorMsg;
+  if ( mCacheIdDb.exec( QStringLiteral( "UPDATE id_cache SET dbId = NULL" ), errorMsg ) != SQLITE_OK )
+  {
+    QgsMessageLog::logMessage( tr( "Problem when updating WFS id cache: %1" ).arg( errorMsg ), tr( "WFS" ) );
+    return;
+  }
+
+  QgsFeatureRequest request;
+  request.setFlags( QgsFeatureRequest::NoGeometry );
+  request.setSubsetOfAttributes( QStringList() << QgsWFSConstants::FIELD_GMLID, mCacheDataProvider->fields() );
+  QgsFeatureIterator iter( mCacheDataProvider->getFeatures( request ) );
+
+  ( void )mCacheIdDb.exec( QStringLiteral( "BEGIN" ), errorMsg );
+  QgsFeature f;
+  while ( iter.nextFeature( f ) )
+  {
+    const QString gmlId = f.attribute( QgsWFSConstants::FIELD_GMLID ).toString();
+    if ( gmlId.isEmpty() )
+      continue;
+
+    // Keep the qgisId of features that were already known before a reload
+    int resultCode;
+    QString sql = QgsSqlite3Mprintf( "SELECT qgisId FROM id_cache WHERE gmlid = '%q'", gmlId.toUtf8().constData() );
+    sqlite3_statement_unique_ptr stmt = mCacheIdDb.prepare( sql, resultCode );
+    if ( resultCode == SQLITE_OK && stmt.step() == SQLITE_ROW )
+    {
+      sql = QgsSqlite3Mprintf( "UPDATE id_cache SET dbId = %lld WHERE gmlid = '%q'", f.id(), gmlId.toUtf8().constData() );
+    }
+    else
+    {
+      sql = QgsSqlite3Mprintf( "INSERT INTO id_cache (gmlid, dbId, qgisId) VALUES ('%q', %lld, %lld)",
+                               gmlId.toUtf8().constData(), f.id(), mNextCachedIdQgisId );
+      mNextCachedIdQgisId ++;
+    }
+    if ( mCacheIdDb.exec( sql, errorMsg ) != SQLITE_OK )
+    {
+      QgsMessageLog::logMessage( tr( "Problem when updating WFS id cache: %1 -> %2" ).arg( sql ).arg( errorMsg ), tr( "WFS" ) );
+    }
+  }
+  ( void )mCacheIdDb.exec( QStringLiteral( "COMMIT" ), errorMsg );
+}
+
+void QgsWFSSharedData::savePersistentCache( bool complete )
+{
+  const QString filename = persistentCacheFilename();
+  if ( filename.isEmpty() || mCacheDbname.isEmpty() )
+    return;
+
+  // Write into a temporary file first, so that other sessions never see a
+  // partially written cache. The file name must be unique, since layers sharing
+  // the same entry can finish their download at the same time
+  QString tmpFilename;
+  {
+    QTemporaryFile tmpFile( QStringLiteral( "%1.XXXXXX.tmp" ).arg( filename ) );
+    tmpFile.setAutoRemove( false );
+    if ( !tmpFile.open() )
+    {
+      QgsMessageLog::logMessage( tr( "Cannot write persistent WFS cache %1" ).arg( filename ), tr( "WFS" ) );
+      return;
+    }
+    tmpFilename = tmpFile.fileName();
+  }
+
+  bool ok = false;
+  {
+    sqlite3_database_unique_ptr source;
+    sqlite3_database_unique_ptr destination;
+    if ( source.open_v2( mCacheDbname, SQLITE_OPEN_READONLY, nullptr ) == SQLITE_OK &&
+         destination.open( tmpFilename ) == SQLITE_OK )
+    {
+      // The backup API gives a consistent copy, even though the cache is in WAL mode
+      sqlite3_backup *backup = sqlite3_backup_init( destination.get(), "main", source.get(), "main" );
+      if ( backup )
+      {
+        ( void )sqlite3_backup_step( backup, -1 );
+        ok = sqlite3_backup_finish( backup ) == SQLITE_OK;
+      }
+    }
+    source.reset();
+
+    if ( ok )
+    {
+      QString sql = QStringLiteral( "PRAGMA journal_mode=DELETE;"
+                                    "CREATE TABLE wfs_persistent_cache(timestamp INTEGER, feature_count INTEGER, complete INTEGER);"
+                                    "CREATE TABLE wfs_persistent_cache_regions(xmin REAL, ymin REAL, xmax REAL, ymax REAL, download_limit INTEGER);" );
+      sql += QStringLiteral( "INSERT INTO wfs_persistent_cache VALUES (%1, %2, %3);" )
+             .arg( QDateTime::currentMSecsSinceEpoch() ).arg( mFeatureCount ).arg( complete ? 1 : 0 );
+      for ( const QgsFeature &region : qgis::as_const( mRegions ) )
+      {
+        const QgsRectangle rect = region.geometry().boundingBox();
+        sql += QStringLiteral( "INSERT INTO wfs_persistent_cache_regions VALUES (%1, %2, %3, %4, %5);" )
+               .arg( qgsDoubleToString( rect.xMinimum() ), qgsDoubleToString( rect.yMinimum() ),
+                     qgsDoubleToString( rect.xMaximum() ), qgsDoubleToString( rect.yMaximum() ) )
+               .arg( region.attributes().value( 0 ).toBool() ? 1 : 0 );
+      }
+      QString errorMsg;
+      ok = destination.exec( sql, errorMsg ) == SQLITE_OK;
+      if ( !ok )
+        QgsDebugMsg( errorMsg );
+    }
+  }
+
+  if ( ok )
+  {
+    QFile::remove( filename );
+    ok = QFile::rename( tmpFilename, filename );
+  }
+  if ( !ok )
+  {
+    QFile::remove( tmpFilename );
+    QgsMessageLog::logMessage( tr( "Cannot write persistent WFS cache %1" ).arg( filename ), tr( "WFS" ) );
+  }
+}
+
+void QgsWFSSharedData::discardPersistentCache()
+{
+  const QString filename = persistentCacheFilename();
+  if ( !filename.isEmpty() )
+    QFile::remove( filename );
+}
+
 int QgsWFSSharedData::registerToCache( QgsWFSFeatureIterator *iterator, int limit, const QgsRectangle &rect )
 {
   // This locks prevents 2 readers to register at the same time (and particularly
@@ -540,37 +811,46 @@ int QgsWFSSharedData::registerToCache( QgsWFSFeatureIterator *iterator, int limi
   // when "Only request features overlapping the view extent" : the offline editor
   // want to request all features whereas the map renderer only the view)
   bool newDownloadNeeded = false;
-  if ( !rect.isEmpty() && mRect != rect && !( mDownloader && mRect.isEmpty() ) )
+  auto cachedRegionsCover = [this]( const QgsRectangle & requestRect )
   {
-    QList<QgsFeatureId> intersectingRequests = mCachedRegions.intersects( rect );
-    newDownloadNeeded = true;
-    const auto constIntersectingRequests = intersectingRequests;
-    for ( QgsFeatureId id : constIntersectingRequests )
+    const QList<QgsFeatureId> intersectingRequests = mCachedRegions.intersects( requestRect );
+    for ( QgsFeatureId id : intersectingRequests )
     {
       Q_ASSERT( id >= 0 && id < mRegions.size() ); // by construction, but doesn't hurt to be checked
 
       // If the requested bbox is inside an already cached rect that didn't
       // hit the download limit, then we can reuse the cached features without
       // issuing a new request.
-      if ( mRegions[id].geometry().boundingBox().contains( rect ) &&
+      if ( mRegions[id].geometry().boundingBox().contains( requestRect ) &&
            !mRegions[id].attributes().value( 0 ).toBool() )
       {
         QgsDebugMsgLevel( QStringLiteral( "Cached features already cover this area of interest" ), 4 );
-        newDownloadNeeded = false;
-        break;
+        return true;
       }
 
       // On the other hand, if the requested bbox is inside an already cached rect,
       // that hit the download limit, our larger bbox will hit it too, so no need
       // to re-issue a new request either.
-      if ( rect.contains( mRegions[id].geometry().boundingBox() ) &&
+      if ( requestRect.contains( mRegions[id].geometry().boundingBox() ) &&
            mRegions[id].attributes().value( 0 ).toBool() )
       {
         QgsDebugMsgLevel( QStringLiteral( "Current request is larger than a smaller request that hit the download limit, so no server download needed." ), 4 );
-        newDownloadNeeded = false;
-        break;
+        return true;
       }
     }
+    return false;
+  };
+
+  // Features restored from the persistent cache are used as long as they
+  // cover the request. Otherwise the requested area is downloaded, and
+  // merged into the cache.
+  if ( mPersistentCacheRestored && !mDownloader )
+  {
+    newDownloadNeeded = !mPersistentCacheComplete && ( rect.isEmpty() || !cachedRegionsCover( rect ) );
+  }
+  else if ( !rect.isEmpty() && mRect != rect && !( mDownloader && mRect.isEmpty() ) )
+  {
+    newDownloadNeeded = !cachedRegionsCover( rect );
   }
   // If there's a ongoing download with a BBOX and we request a new download
   // without it, then we need a new download.
@@ -585,7 +865,7 @@ int QgsWFSSharedData::registerToCache( QgsWFSFeatureIterator *iterator, int limi
     newDownloadNeeded = true;
   }
 
-  if ( newDownloadNeeded || !mDownloader )
+  if ( newDownloadNeeded || ( !mDownloader && !mPersistentCacheRestored ) )
   {
     mRect = rect;
     mRequestLimit = ( limit > 0 && !( mWFSVersion.startsWith( QLatin1String( "1.0" ) ) ) ) ? limit : 0;
@@ -1222,6 +1502,12 @@ void QgsWFSSharedData::endOfDownload( bool success, int featureCount,
     }
   }
 
+  if ( success && !interrupted && mRequestLimit == 0 )
+  {
+    mPersistentCacheComplete = mPersistentCacheComplete || ( mRect.isEmpty() && !bDownloadLimit );
+    savePersistentCache( mPersistentCacheComplete );
+  }
+
   if ( bDownloadLimit )
   {
     QString msg( tr( "%1: The download limit has been reached." ).arg( mURI.typeName() ) );
@@ -1257,6 +1543,8 @@ void QgsWFSSharedData::invalidateCache()
   mFeatureCount = 0;
   mFeatureCountExact = false;
   mTotalFeaturesAttemptedToBeCached = 0;
+  mPersistentCacheRestored = false;
+  mPersistentCacheComplete = false;
   if ( !mCacheDbname.isEmpty() && mCacheDataProvider )
   {
     // We need to invalidate connections pointing to the cache, so as to
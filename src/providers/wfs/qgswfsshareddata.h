@@ -78,6 +78,12 @@ class QgsWFSSharedData : public QObject
         all the caching state, so that a new request results in fresh download */
     void invalidateCache();
 
+    /**
+     * Removes the persistent cache entry matching the current request, so that
+        it is not reused by the next sessions or layers. Used by QgsWFSProvider::reloadData()
+        and after WFS-T edits */
+    void discardPersistentCache();
+
     //! Give a feature id, find the correspond fid/gml.id. Used by WFS-T
     QString findGmlId( QgsFeatureId fid );
 
@@ -270,6 +276,12 @@ class QgsWFSSharedData : public QObject
     //! Next value for qgisId column
     QgsFeatureId mNextCachedIdQgisId = 1;
 
+    //! Whether the on-disk cache has been restored from the persistent cache
+    bool mPersistentCacheRestored = false;
+
+    //! Whether the persistent cache holds all the features of the layer (and not only some regions)
+    bool mPersistentCacheComplete = false;
+
     /**
      * Returns the set of gmlIds that have already been downloaded and
         cached, so as to avoid to cache duplicates. */
@@ -283,6 +295,25 @@ class QgsWFSSharedData : public QObject
     //! Create the on-disk cache and connect to it
     bool createCache();
 
+    //! Create the SpatiaLite database of the on-disk cache
+    bool createCacheDatabase( const QgsFields &cacheFields, const QString &fidName, const QString &geometryFieldname );
+
+    /**
+     * Returns the filename of the persistent cache entry for the current request,
+        or an empty string if the persistent cache is disabled */
+    QString persistentCacheFilename();
+
+    /**
+     * Copies a valid persistent cache entry into the on-disk cache, and
+        restores the downloaded regions. Returns false if there is no usable entry */
+    bool restorePersistentCache();
+
+    //! Assigns qgisIds to the features restored from the persistent cache
+    void registerRestoredFeatureIds();
+
+    //! Saves the on-disk cache as the persistent cache entry for the current request
+    void savePersistentCache( bool complete );
+
     //! Log error to QgsMessageLog and raise it to the provider
     void pushError( const QString &errorMsg );
 };
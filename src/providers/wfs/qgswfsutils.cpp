@@ -116,6 +116,18 @@ void QgsWFSUtils::releaseCacheDirectory()
   }
 }
 
+QString QgsWFSUtils::persistentCacheDirectory()
+{
+  QString baseDirectory( getBaseCacheDirectory( true ) );
+  QMutexLocker locker( &sMutex );
+  if ( !QDir( baseDirectory ).exists( QStringLiteral( "persistent" ) ) )
+  {
+    QgsDebugMsg( QStringLiteral( "Creating persistent cache dir %1/persistent" ).arg( baseDirectory ) );
+    QDir( baseDirectory ).mkpath( QStringLiteral( "persistent" ) );
+  }
+  return QDir( baseDirectory ).filePath( QStringLiteral( "persistent" ) );
+}
+
 bool QgsWFSUtils::removeDir( const QString &dirName )
 {
   QDir dir( dirName );
@@ -34,6 +34,9 @@ class QgsWFSUtils
     //! To be called when a temporary file is removed from the directory
     static void releaseCacheDirectory();
 
+    //! Returns the name of the directory holding the cache kept across sessions. It is created if needed.
+    static QString persistentCacheDirectory();
+
     //! Initial cleanup.
     static void init();
 
@@ -474,6 +474,8 @@ enum QgsWmsTileAttribute
   TileIndex = QNetworkRequest::User + 1,
   TileRect  = QNetworkRequest::User + 2,
   TileRetry = QNetworkRequest::User + 3,
+  TileSharedKey = QNetworkRequest::User + 4,
+  TileUrl = QNetworkRequest::User + 5,
 };
 
 enum QgsWmsDpiMode
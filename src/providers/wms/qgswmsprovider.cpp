@@ -3714,6 +3714,8 @@ void QgsWmsImageDownloadHandler::canceled()
 
 // ----------
 
+QHash<QString, QgsWmsTiledImageDownloadHandler::InFlightTile> QgsWmsTiledImageDownloadHandler::sInFlightTiles;
+QMutex QgsWmsTiledImageDownloadHandler::sInFlightTilesMutex;
 
 QgsWmsTiledImageDownloadHandler::QgsWmsTiledImageDownloadHandler( const QString &providerUri, const QgsWmsAuthorization &auth, int tileReqNo, const QgsWmsProvider::TileRequests &requests, QImage *image, const QgsRectangle &viewExtent, bool smoothPixmapTransform, QgsRasterBlockFeedback *feedback )
   : mProviderUri( providerUri )
@@ -3735,39 +3737,196 @@ QgsWmsTiledImageDownloadHandler::QgsWmsTiledImageDownloadHandler( const QString
       return;
   }
 
+  QgsSettings s;
+  mAllowHttp2 = s.value( QStringLiteral( "qgis/defaultTileAllowHttp2" ), true ).toBool();
+
   const auto constRequests = requests;
   for ( const QgsWmsProvider::TileRequest &r : constRequests )
   {
-    QNetworkRequest request( r.url );
-    QgsSetRequestInitiatorClass( request, QStringLiteral( "QgsWmsTiledImageDownloadHandler" ) );
-    auth.setAuthorization( request );
-    request.setAttribute( QNetworkRequest::CacheLoadControlAttribute, QNetworkRequest::PreferCache );
-    request.setAttribute( QNetworkRequest::CacheSaveControlAttribute, true );
-    request.setAttribute( static_cast<QNetworkRequest::Attribute>( TileReqNo ), mTileReqNo );
-    request.setAttribute( static_cast<QNetworkRequest::Attribute>( TileIndex ), r.index );
-    request.setAttribute( static_cast<QNetworkRequest::Attribute>( TileRect ), r.rect );
-    request.setAttribute( static_cast<QNetworkRequest::Attribute>( TileRetry ), 0 );
-
-    QNetworkReply *reply = QgsNetworkAccessManager::instance()->get( request );
-    connect( reply, &QNetworkReply::finished, this, &QgsWmsTiledImageDownloadHandler::tileReplyFinished );
-
-    mReplies << reply;
+    // tiles requested with the same credentials are shared between handlers, so that when several
+    // layers or map renders need the same tile at once it is only downloaded a single time
+    const QString key = QStringLiteral( "%1|%2|%3" ).arg( auth.mAuthCfg, auth.mUserName, r.url.toString() );
+    if ( claimTile( key, r ) )
+      sendTileRequest( r, key );
   }
 }
 
 QgsWmsTiledImageDownloadHandler::~QgsWmsTiledImageDownloadHandler()
 {
+  {
+    QMutexLocker locker( &sInFlightTilesMutex );
+    for ( auto it = sInFlightTiles.begin(); it != sInFlightTiles.end(); )
+    {
+      it->waiters.removeAll( this );
+      if ( it->owner == this )
+      {
+        // let other handlers know they need to fetch the tile themselves
+        const auto waiters = it->waiters;
+        for ( QgsWmsTiledImageDownloadHandler *waiter : waiters )
+          QMetaObject::invokeMethod( waiter, "sharedTileFinished", Qt::QueuedConnection, Q_ARG( QString, it.key() ) );
+        it = sInFlightTiles.erase( it );
+      }
+      else
+      {
+        ++it;
+      }
+    }
+  }
+
   delete mEventLoop;
 }
 
+bool QgsWmsTiledImageDownloadHandler::claimTile( const QString &key, const QgsWmsProvider::TileRequest &request )
+{
+  QMutexLocker locker( &sInFlightTilesMutex );
+  InFlightTile &tile = sInFlightTiles[ key ];
+  if ( !tile.owner || tile.owner == this )
+  {
+    tile.owner = this;
+    return true;
+  }
+
+  if ( !tile.waiters.contains( this ) )
+    tile.waiters << this;
+  mSharedTiles.insert( key, request );
+  return false;
+}
+
+void QgsWmsTiledImageDownloadHandler::releaseTile( const QString &key )
+{
+  QMutexLocker locker( &sInFlightTilesMutex );
+  auto it = sInFlightTiles.find( key );
+  if ( it == sInFlightTiles.end() || it->owner != this )
+    return;
+
+  const auto waiters = it->waiters;
+  for ( QgsWmsTiledImageDownloadHandler *waiter : waiters )
+    QMetaObject::invokeMethod( waiter, "sharedTileFinished", Qt::QueuedConnection, Q_ARG( QString, key ) );
+  sInFlightTiles.erase( it );
+}
+
+void QgsWmsTiledImageDownloadHandler::sharedTileFinished( const QString &key )
+{
+  auto it = mSharedTiles.find( key );
+  if ( it == mSharedTiles.end() )
+    return; // we are not waiting for this tile anymore
+
+  const QgsWmsProvider::TileRequest r = it.value();
+  mSharedTiles.erase( it );
+
+  QImage image;
+  if ( QgsTileCache::tile( r.url, image ) )
+  {
+    drawTile( r.index, r.rect, image );
+  }
+  else if ( !( mFeedback && mFeedback->isCanceled() ) )
+  {
+    // the other handler could not fetch the tile (or its request was canceled), so try ourselves
+    if ( claimTile( key, r ) )
+      sendTileRequest( r, key );
+  }
+
+  finishIfDone();
+}
+
+void QgsWmsTiledImageDownloadHandler::sendTileRequest( const QgsWmsProvider::TileRequest &r, const QString &key, const QUrl &tileUrl )
+{
+  QNetworkRequest request( r.url );
+  QgsSetRequestInitiatorClass( request, QStringLiteral( "QgsWmsTiledImageDownloadHandler" ) );
+  mAuth.setAuthorization( request );
+  request.setAttribute( QNetworkRequest::CacheLoadControlAttribute, QNetworkRequest::PreferCache );
+  request.setAttribute( QNetworkRequest::CacheSaveControlAttribute, true );
+#if QT_VERSION >= QT_VERSION_CHECK(5, 8, 0)
+  // let all the tiles of a view be multiplexed over a single connection, if the server supports it
+  request.setAttribute( QNetworkRequest::HTTP2AllowedAttribute, mAllowHttp2 );
+#endif
+  request.setAttribute( static_cast<QNetworkRequest::Attribute>( TileReqNo ), mTileReqNo );
+  request.setAttribute( static_cast<QNetworkRequest::Attribute>( TileIndex ), r.index );
+  request.setAttribute( static_cast<QNetworkRequest::Attribute>( TileRect ), r.rect );
+  request.setAttribute( static_cast<QNetworkRequest::Attribute>( TileRetry ), 0 );
+  request.setAttribute( static_cast<QNetworkRequest::Attribute>( TileSharedKey ), key );
+  request.setAttribute( static_cast<QNetworkRequest::Attribute>( TileUrl ), tileUrl.isEmpty() ? r.url : tileUrl );
+
+  QNetworkReply *reply = QgsNetworkAccessManager::instance()->get( request );
+  connect( reply, &QNetworkReply::finished, this, &QgsWmsTiledImageDownloadHandler::tileReplyFinished );
+
+  mReplies << reply;
+}
+
+void QgsWmsTiledImageDownloadHandler::removeReply( QNetworkReply *reply )
+{
+  const QString key = reply->request().attribute( static_cast<QNetworkRequest::Attribute>( TileSharedKey ) ).toString();
+
+  mReplies.removeOne( reply );
+  reply->deleteLater();
+
+  // a redirected or repeated request for the same tile keeps it claimed
+  bool stillRequested = false;
+  for ( QNetworkReply *other : qgis::as_const( mReplies ) )
+  {
+    if ( other->request().attribute( static_cast<QNetworkRequest::Attribute>( TileSharedKey ) ).toString() == key )
+    {
+      stillRequested = true;
+      break;
+    }
+  }
+  if ( !stillRequested )
+    releaseTile( key );
+
+  finishIfDone();
+}
+
+void QgsWmsTiledImageDownloadHandler::finishIfDone()
+{
+  if ( mReplies.isEmpty() && mSharedTiles.isEmpty() )
+    finish();
+}
+
+void QgsWmsTiledImageDownloadHandler::drawTile( int tileNo, const QRectF &r, const QImage &image )
+{
+  Q_UNUSED( tileNo ) // only used in debugging code
+
+  double cr = mViewExtent.width() / mImage->width();
+
+  QRectF dst( ( r.left() - mViewExtent.xMinimum() ) / cr,
+              ( mViewExtent.yMaximum() - r.bottom() ) / cr,
+              r.width() / cr,
+              r.height() / cr );
+
+  QPainter p( mImage );
+  // if image size is "close enough" to destination size, don't smooth it out. Instead try for pixel-perfect placement!
+  const bool disableSmoothing = ( qgsDoubleNear( dst.width(), image.width(), 2 ) && qgsDoubleNear( dst.height(), image.height(), 2 ) );
+  if ( !disableSmoothing && mSmoothPixmapTransform )
+    p.setRenderHint( QPainter::SmoothPixmapTransform, true );
+  p.drawImage( dst, image );
+  p.end();
+#if 0
+  image.save( QString( "%1/%2-tile-%3.png" ).arg( QDir::tempPath() ).arg( mTileReqNo ).arg( tileNo ) );
+  p.drawRect( dst ); // show tile bounds
+  p.drawText( dst, Qt::AlignCenter, QString( "(%1)\n%2,%3\n%4,%5\n%6x%7" )
+              .arg( tileNo )
+              .arg( r.left() ).arg( r.bottom() )
+              .arg( r.right() ).arg( r.top() )
+              .arg( r.width() ).arg( r.height() ) );
+#endif
+
+  if ( mFeedback )
+    mFeedback->onNewData();
+}
+
 void QgsWmsTiledImageDownloadHandler::downloadBlocking()
 {
   if ( mFeedback && mFeedback->isCanceled() )
     return; // nothing to do
 
+  // tiles may already have been received while another handler was downloading in this thread
+  if ( mReplies.isEmpty() && mSharedTiles.isEmpty() )
+    return;
+
   mEventLoop->exec( QEventLoop::ExcludeUserInputEvents );
 
   Q_ASSERT( mReplies.isEmpty() );
+  Q_ASSERT( mSharedTiles.isEmpty() );
 }
 
 
@@ -3794,6 +3953,7 @@ void QgsWmsTiledImageDownloadHandler::tileReplyFinished()
   }
 #endif
 
+  QDateTime tileExpiry;
   if ( QgsNetworkAccessManager::instance()->cache() )
   {
     QNetworkCacheMetaData cmd = QgsNetworkAccessManager::instance()->cache()->metaData( reply->request().url() );
@@ -3813,6 +3973,7 @@ void QgsWmsTiledImageDownloadHandler::tileReplyFinished()
       QgsSettings s;
       cmd.setExpirationDate( QDateTime::currentDateTime().addSecs( s.value( QStringLiteral( "qgis/defaultTileExpiry" ), "24" ).toInt() * 60 * 60 ) );
     }
+    tileExpiry = cmd.expirationDate();
 
     QgsNetworkAccessManager::instance()->cache()->updateMetaData( cmd );
   }
@@ -3837,25 +3998,12 @@ void QgsWmsTiledImageDownloadHandler::tileReplyFinished()
     QVariant redirect = reply->attribute( QNetworkRequest::RedirectionTargetAttribute );
     if ( !redirect.isNull() )
     {
-      QNetworkRequest request( redirect.toUrl() );
-      QgsSetRequestInitiatorClass( request, QStringLiteral( "QgsWmsTiledImageDownloadHandler" ) );
-      mAuth.setAuthorization( request );
-      request.setAttribute( QNetworkRequest::CacheLoadControlAttribute, QNetworkRequest::PreferCache );
-      request.setAttribute( QNetworkRequest::CacheSaveControlAttribute, true );
-      request.setAttribute( static_cast<QNetworkRequest::Attribute>( TileReqNo ), tileReqNo );
-      request.setAttribute( static_cast<QNetworkRequest::Attribute>( TileIndex ), tileNo );
-      request.setAttribute( static_cast<QNetworkRequest::Attribute>( TileRect ), r );
-      request.setAttribute( static_cast<QNetworkRequest::Attribute>( TileRetry ), 0 );
-
-      mReplies.removeOne( reply );
-      reply->deleteLater();
-
       QgsDebugMsg( QStringLiteral( "redirected gettile: %1" ).arg( redirect.toString() ) );
-      reply = QgsNetworkAccessManager::instance()->get( request );
-      mReplies << reply;
-
-      connect( reply, &QNetworkReply::finished, this, &QgsWmsTiledImageDownloadHandler::tileReplyFinished );
+      const QString key = reply->request().attribute( static_cast<QNetworkRequest::Attribute>( TileSharedKey ) ).toString();
+      const QUrl tileUrl = reply->request().attribute( static_cast<QNetworkRequest::Attribute>( TileUrl ) ).toUrl();
+      sendTileRequest( QgsWmsProvider::TileRequest( redirect.toUrl(), r, tileNo ), key, tileUrl );
 
+      removeReply( reply );
       return;
     }
 
@@ -3866,12 +4014,7 @@ void QgsWmsTiledImageDownloadHandler::tileReplyFinished()
 
       QgsWmsProvider::showMessageBox( tr( "Tile request error" ), tr( "Status: %1\nReason phrase: %2" ).arg( status.toInt() ).arg( phrase.toString() ) );
 
-      mReplies.removeOne( reply );
-      reply->deleteLater();
-
-      if ( mReplies.isEmpty() )
-        finish();
-
+      removeReply( reply );
       return;
     }
 
@@ -3905,52 +4048,26 @@ void QgsWmsTiledImageDownloadHandler::tileReplyFinished()
 #endif
       }
 
-      mReplies.removeOne( reply );
-      reply->deleteLater();
-
-      if ( mReplies.isEmpty() )
-        finish();
-
+      removeReply( reply );
       return;
     }
 
     // only take results from current request number
     if ( mTileReqNo == tileReqNo )
     {
-      double cr = mViewExtent.width() / mImage->width();
-
-      QRectF dst( ( r.left() - mViewExtent.xMinimum() ) / cr,
-                  ( mViewExtent.yMaximum() - r.bottom() ) / cr,
-                  r.width() / cr,
-                  r.height() / cr );
-
       QgsDebugMsg( QStringLiteral( "tile reply: length %1" ).arg( reply->bytesAvailable() ) );
 
-      QImage myLocalImage = QImage::fromData( reply->readAll() );
+      const QByteArray imageData = reply->readAll();
+      QImage myLocalImage = QImage::fromData( imageData );
 
       if ( !myLocalImage.isNull() )
       {
-        QPainter p( mImage );
-        // if image size is "close enough" to destination size, don't smooth it out. Instead try for pixel-perfect placement!
-        const bool disableSmoothing = ( qgsDoubleNear( dst.width(), myLocalImage.width(), 2 ) && qgsDoubleNear( dst.height(), myLocalImage.height(), 2 ) );
-        if ( !disableSmoothing && mSmoothPixmapTransform )
-          p.setRenderHint( QPainter::SmoothPixmapTransform, true );
-        p.drawImage( dst, myLocalImage );
-        p.end();
-#if 0
-        myLocalImage.save( QString( "%1/%2-tile-%3.png" ).arg( QDir::tempPath() ).arg( mTileReqNo ).arg( tileNo ) );
-        p.drawRect( dst ); // show tile bounds
-        p.drawText( dst, Qt::AlignCenter, QString( "(%1)\n%2,%3\n%4,%5\n%6x%7" )
-                    .arg( tileNo )
-                    .arg( r.left() ).arg( r.bottom() )
-                    .arg( r.right() ).arg( r.top() )
-                    .arg( r.width() ).arg( r.height() ) );
-#endif
-
-        QgsTileCache::insertTile( reply->url(), myLocalImage );
-
-        if ( mFeedback )
-          mFeedback->onNewData();
+        QgsTileCache::insertTile( reply->url(), myLocalImage, imageData, tileExpiry );
+        // handlers waiting for the tile look it up by the URL they requested, not the redirected one
+        const QUrl tileUrl = reply->request().attribute( static_cast<QNetworkRequest::Attribute>( TileUrl ) ).toUrl();
+        if ( !tileUrl.isEmpty() && tileUrl != reply->url() )
+          QgsTileCache::insertTile( tileUrl, myLocalImage, imageData, tileExpiry );
+        drawTile( tileNo, r, myLocalImage );
       }
       else
       {
@@ -3963,12 +4080,7 @@ void QgsWmsTiledImageDownloadHandler::tileReplyFinished()
       QgsDebugMsg( QStringLiteral( "Reply too late [%1]" ).arg( reply->url().toString() ) );
     }
 
-    mReplies.removeOne( reply );
-    reply->deleteLater();
-
-    if ( mReplies.isEmpty() )
-      finish();
-
+    removeReply( reply );
   }
   else
   {
@@ -3986,11 +4098,7 @@ void QgsWmsTiledImageDownloadHandler::tileReplyFinished()
       }
     }
 
-    mReplies.removeOne( reply );
-    reply->deleteLater();
-
-    if ( mReplies.isEmpty() )
-      finish();
+    removeReply( reply );
   }
 
 #if 0
@@ -4012,6 +4120,22 @@ void QgsWmsTiledImageDownloadHandler::canceled()
     QgsDebugMsg( QStringLiteral( "Aborting tiled network request" ) );
     reply->abort();
   }
+
+  // stop waiting for tiles being downloaded by other handlers
+  if ( !mSharedTiles.isEmpty() )
+  {
+    {
+      QMutexLocker locker( &sInFlightTilesMutex );
+      for ( auto it = mSharedTiles.constBegin(); it != mSharedTiles.constEnd(); ++it )
+      {
+        auto tileIt = sInFlightTiles.find( it.key() );
+        if ( tileIt != sInFlightTiles.end() )
+          tileIt->waiters.removeAll( this );
+      }
+    }
+    mSharedTiles.clear();
+    finishIfDone();
+  }
 }
 
 
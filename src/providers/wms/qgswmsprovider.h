@@ -33,6 +33,7 @@
 #include <QMap>
 #include <QVector>
 #include <QUrl>
+#include <QMutex>
 
 class QgsCoordinateTransform;
 class QgsNetworkAccessManager;
@@ -517,12 +518,48 @@ class QgsWmsTiledImageDownloadHandler : public QObject
 
     void downloadBlocking();
 
+    /**
+     * Called (through a queued invocation) when a tile which this handler was waiting
+     * for has been downloaded by another handler. If the tile did not make it into the
+     * tile cache, it is requested again by this handler.
+     */
+    Q_INVOKABLE void sharedTileFinished( const QString &key );
+
   protected slots:
     void tileReplyFinished();
     void canceled();
 
   protected:
 
+    /**
+     * Registers a tile request with the \a key in the list of tiles being downloaded.
+     *
+     * Returns TRUE if this handler should download the tile itself, or FALSE if the tile
+     * is already being downloaded by another handler, in which case the handler waits for it.
+     */
+    bool claimTile( const QString &key, const QgsWmsProvider::TileRequest &request );
+
+    /**
+     * Removes the tile with the \a key from the list of tiles being downloaded, and lets any handlers
+     * waiting for the same tile know that it is finished.
+     */
+    void releaseTile( const QString &key );
+
+    /**
+     * Sends a network request for a tile. \a tileUrl is the URL the tile was originally
+     * requested with, if the request follows a redirect.
+     */
+    void sendTileRequest( const QgsWmsProvider::TileRequest &request, const QString &key, const QUrl &tileUrl = QUrl() );
+
+    //! Removes a finished \a reply, releasing its tile unless it is still being requested
+    void removeReply( QNetworkReply *reply );
+
+    //! Draws a downloaded tile \a image over the tile's map rectangle \a rect
+    void drawTile( int tileNo, const QRectF &rect, const QImage &image );
+
+    //! Quits the event loop if there are no more running or shared tile requests
+    void finishIfDone();
+
     /**
      * \brief Relaunch tile request cloning previous request parameters and managing max repeat
      *
@@ -546,9 +583,26 @@ class QgsWmsTiledImageDownloadHandler : public QObject
     int mTileReqNo;
     bool mSmoothPixmapTransform;
 
+    //! Whether tile requests may use HTTP/2
+    bool mAllowHttp2 = true;
+
     //! Running tile requests
     QList<QNetworkReply *> mReplies;
 
+    //! Tiles being downloaded by other handlers which this handler is waiting for, by shared key
+    QHash<QString, QgsWmsProvider::TileRequest> mSharedTiles;
+
+    //! Handlers downloading and waiting for a tile
+    struct InFlightTile
+    {
+      QgsWmsTiledImageDownloadHandler *owner = nullptr;
+      QList<QgsWmsTiledImageDownloadHandler *> waiters;
+    };
+
+    //! Tiles currently being downloaded by any handler (in any thread), by shared key
+    static QHash<QString, InFlightTile> sInFlightTiles;
+    static QMutex sInFlightTilesMutex;
+
     QgsRasterBlockFeedback *mFeedback = nullptr;
 };
 
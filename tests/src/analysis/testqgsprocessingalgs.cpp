@@ -26,6 +26,7 @@
 #include "qgsalgorithmimportphotos.h"
 #include "qgsalgorithmtransform.h"
 #include "qgsalgorithmkmeansclustering.h"
+#include "qgsalgorithmdissolve.h"
 #include "qgsvectorlayer.h"
 #include "qgscategorizedsymbolrenderer.h"
 #include "qgssinglesymbolrenderer.h"
@@ -73,6 +74,9 @@ class TestQgsProcessingAlgs: public QObject
     void featureFilterAlg();
     void transformAlg();
     void kmeansCluster();
+    void cascadedDissolve();
+    void dissolveAlg();
+    void extractByLocationPoints();
     void categorizeByStyle();
     void extractBinary();
 
@@ -573,6 +577,214 @@ void TestQgsProcessingAlgs::kmeansCluster()
   QCOMPARE( features[ 2 ].cluster, -1 );
 }
 
+void TestQgsProcessingAlgs::cascadedDissolve()
+{
+  const std::function< QgsGeometry( const QVector< QgsGeometry > & ) > collector = []( const QVector< QgsGeometry > &parts )->QgsGeometry
+  {
+    return QgsGeometry::unaryUnion( parts );
+  };
+
+  // no groups, no crash
+  QVERIFY( QgsCollectorAlgorithm::cascadedCollect( QVector< QVector< QgsGeometry > >(), collector, nullptr ).isEmpty() );
+
+  // two groups of 10x20 adjacent squares each, plus an empty group. The small block size forces
+  // several levels of reduction
+  QVector< QVector< QgsGeometry > > groups( 3 );
+  for ( int x = 0; x < 20; ++x )
+  {
+    for ( int y = 0; y < 20; ++y )
+    {
+      groups[ x < 10 ? 0 : 1 ] << QgsGeometry::fromRect( QgsRectangle( x, y, x + 1, y + 1 ) );
+    }
+  }
+
+  const QVector< QgsGeometry > results = QgsCollectorAlgorithm::cascadedCollect( groups, collector, nullptr, 8 );
+  QCOMPARE( results.size(), 3 );
+  QCOMPARE( results.at( 0 ).area(), 200.0 );
+  QCOMPARE( results.at( 0 ).constGet()->partCount(), 1 );
+  QCOMPARE( results.at( 0 ).boundingBox(), QgsRectangle( 0, 0, 10, 20 ) );
+  QCOMPARE( results.at( 1 ).area(), 200.0 );
+  QCOMPARE( results.at( 1 ).constGet()->partCount(), 1 );
+  QCOMPARE( results.at( 1 ).boundingBox(), QgsRectangle( 10, 0, 20, 20 ) );
+  QVERIFY( results.at( 2 ).isNull() );
+
+  // single geometry group
+  groups.clear();
+  groups << ( QVector< QgsGeometry >() << QgsGeometry::fromRect( QgsRectangle( 0, 0, 1, 1 ) ) );
+  const QVector< QgsGeometry > single = QgsCollectorAlgorithm::cascadedCollect( groups, collector, nullptr, 8 );
+  QCOMPARE( single.size(), 1 );
+  QCOMPARE( single.at( 0 ).area(), 1.0 );
+
+  // block sizes below 2 are clamped, rather than never reducing
+  groups.clear();
+  groups << ( QVector< QgsGeometry >() << QgsGeometry::fromRect( QgsRectangle( 0, 0, 1, 1 ) ) << QgsGeometry::fromRect( QgsRectangle( 1, 0, 2, 1 ) ) << QgsGeometry::fromRect( QgsRectangle( 2, 0, 3, 1 ) ) );
+  const QVector< QgsGeometry > smallBlock = QgsCollectorAlgorithm::cascadedCollect( groups, collector, nullptr, 1 );
+  QCOMPARE( smallBlock.size(), 1 );
+  QCOMPARE( smallBlock.at( 0 ).area(), 3.0 );
+}
+
+void TestQgsProcessingAlgs::dissolveAlg()
+{
+  std::unique_ptr< QgsProcessingAlgorithm > alg( QgsApplication::processingRegistry()->createAlgorithmById( QStringLiteral( "native:dissolve" ) ) );
+  QVERIFY( alg != nullptr );
+
+  std::unique_ptr< QgsProcessingContext > context = qgis::make_unique< QgsProcessingContext >();
+  QgsProject p;
+  context->setProject( &p );
+
+  QgsProcessingFeedback feedback;
+
+  // 20x20 adjacent squares, in two groups of 10x20 squares
+  QgsVectorLayer *layer = new QgsVectorLayer( QStringLiteral( "Polygon?crs=EPSG:3857&field=group:integer" ), QStringLiteral( "squares" ), QStringLiteral( "memory" ) );
+  QVERIFY( layer->isValid() );
+  QgsFeatureList features;
+  for ( int x = 0; x < 20; ++x )
+  {
+    for ( int y = 0; y < 20; ++y )
+    {
+      QgsFeature f( layer->fields() );
+      f.setAttributes( QgsAttributes() << ( x < 10 ? 1 : 2 ) );
+      f.setGeometry( QgsGeometry::fromRect( QgsRectangle( x, y, x + 1, y + 1 ) ) );
+      features << f;
+    }
+  }
+  QVERIFY( layer->dataProvider()->addFeatures( features ) );
+  p.addMapLayer( layer );
+
+  // dissolve by field
+  QVariantMap parameters;
+  parameters.insert( QStringLiteral( "INPUT" ), QStringLiteral( "squares" ) );
+  parameters.insert( QStringLiteral( "FIELD" ), QStringLiteral( "group" ) );
+  parameters.insert( QStringLiteral( "OUTPUT" ), QStringLiteral( "memory:" ) );
+  bool ok = false;
+  QVariantMap results = alg->run( parameters, *context, &feedback, &ok );
+  QVERIFY( ok );
+
+  QgsVectorLayer *output = qobject_cast< QgsVectorLayer * >( context->getMapLayer( results.value( QStringLiteral( "OUTPUT" ) ).toString() ) );
+  QVERIFY( output );
+  QCOMPARE( output->featureCount(), 2L );
+  QgsFeature f;
+  QgsFeatureIterator it = output->getFeatures();
+  while ( it.nextFeature( f ) )
+  {
+    QCOMPARE( f.geometry().area(), 200.0 );
+    QCOMPARE( f.geometry().constGet()->partCount(), 1 );
+    QCOMPARE( f.geometry().boundingBox(), f.attribute( 0 ).toInt() == 1 ? QgsRectangle( 0, 0, 10, 20 ) : QgsRectangle( 10, 0, 20, 20 ) );
+  }
+
+  // dissolve all
+  parameters.remove( QStringLiteral( "FIELD" ) );
+  ok = false;
+  results = alg->run( parameters, *context, &feedback, &ok );
+  QVERIFY( ok );
+
+  output = qobject_cast< QgsVectorLayer * >( context->getMapLayer( results.value( QStringLiteral( "OUTPUT" ) ).toString() ) );
+  QVERIFY( output );
+  QCOMPARE( output->featureCount(), 1L );
+  it = output->getFeatures();
+  QVERIFY( it.nextFeature( f ) );
+  QCOMPARE( f.geometry().area(), 400.0 );
+  QCOMPARE( f.geometry().constGet()->partCount(), 1 );
+  QCOMPARE( f.geometry().boundingBox(), QgsRectangle( 0, 0, 20, 20 ) );
+}
+
+void TestQgsProcessingAlgs::extractByLocationPoints()
+{
+  std::unique_ptr< QgsProcessingAlgorithm > alg( QgsApplication::processingRegistry()->createAlgorithmById( QStringLiteral( "native:extractbylocation" ) ) );
+  QVERIFY( alg != nullptr );
+
+  std::unique_ptr< QgsProcessingContext > context = qgis::make_unique< QgsProcessingContext >();
+  QgsProject p;
+  context->setProject( &p );
+
+  QgsProcessingFeedback feedback;
+
+  // square with a square hole
+  QgsVectorLayer *polygonLayer = new QgsVectorLayer( QStringLiteral( "Polygon?crs=EPSG:3857" ), QStringLiteral( "polygons" ), QStringLiteral( "memory" ) );
+  QVERIFY( polygonLayer->isValid() );
+  QgsFeature polygon( polygonLayer->fields() );
+  polygon.setGeometry( QgsGeometry::fromWkt( QStringLiteral( "Polygon((0 0, 10 0, 10 10, 0 10, 0 0),(4 4, 6 4, 6 6, 4 6, 4 4))" ) ) );
+  QVERIFY( polygonLayer->dataProvider()->addFeature( polygon ) );
+  p.addMapLayer( polygonLayer );
+
+  // id attribute holds the point's role, to keep the expected results readable
+  QgsVectorLayer *pointLayer = new QgsVectorLayer( QStringLiteral( "Point?crs=EPSG:3857&field=id:integer" ), QStringLiteral( "points" ), QStringLiteral( "memory" ) );
+  QVERIFY( pointLayer->isValid() );
+  const QList< QPair< int, QString > > points
+  {
+    { 1, QStringLiteral( "Point(2 2)" ) }, // interior
+    { 2, QStringLiteral( "Point(12 2)" ) }, // exterior
+    { 3, QStringLiteral( "Point(0 5)" ) }, // exterior ring edge
+    { 4, QStringLiteral( "Point(10 10)" ) }, // exterior ring vertex
+    { 5, QStringLiteral( "Point(5 5)" ) }, // inside the hole
+    { 6, QStringLiteral( "Point(4 5)" ) }, // hole edge
+    { 7, QStringLiteral( "Point(6 6)" ) }, // hole vertex
+    { 8, QStringLiteral( "Point(8 5)" ) }, // interior, level with the hole
+  };
+  QgsFeatureList features;
+  for ( const auto &point : points )
+  {
+    QgsFeature f( pointLayer->fields() );
+    f.setAttributes( QgsAttributes() << point.first );
+    f.setGeometry( QgsGeometry::fromWkt( point.second ) );
+    features << f;
+  }
+  QVERIFY( pointLayer->dataProvider()->addFeatures( features ) );
+  p.addMapLayer( pointLayer );
+
+  auto extract = [&]( int predicate ) -> QSet< int >
+  {
+    QVariantMap parameters;
+    parameters.insert( QStringLiteral( "INPUT" ), QStringLiteral( "points" ) );
+    parameters.insert( QStringLiteral( "PREDICATE" ), QVariantList() << predicate );
+    parameters.insert( QStringLiteral( "INTERSECT" ), QStringLiteral( "polygons" ) );
+    parameters.insert( QStringLiteral( "OUTPUT" ), QStringLiteral( "memory:" ) );
+    bool ok = false;
+    QVariantMap results = alg->run( parameters, *context, &feedback, &ok );
+    if ( !ok )
+      return QSet< int >() << -1;
+
+    QgsVectorLayer *output = qobject_cast< QgsVectorLayer * >( context->getMapLayer( results.value( QStringLiteral( "OUTPUT" ) ).toString() ) );
+    if ( !output )
+      return QSet< int >() << -1;
+
+    QSet< int > ids;
+    QgsFeature f;
+    QgsFeatureIterator it = output->getFeatures();
+    while ( it.nextFeature( f ) )
+      ids << f.attribute( 0 ).toInt();
+    return ids;
+  };
+
+  // the fast point in polygon path must agree with GEOS
+  auto expected = [&]( const std::function< bool( const QgsGeometry & ) > &predicate ) -> QSet< int >
+  {
+    QSet< int > ids;
+    for ( const auto &point : points )
+    {
+      if ( predicate( QgsGeometry::fromWkt( point.second ) ) )
+        ids << point.first;
+    }
+    return ids;
+  };
+  const QgsGeometry polygonGeometry = polygon.geometry();
+
+  // intersect
+  QSet< int > ids = extract( 0 );
+  QCOMPARE( ids, QSet< int >() << 1 << 3 << 4 << 6 << 7 << 8 );
+  QCOMPARE( ids, expected( [&]( const QgsGeometry & g ) { return g.intersects( polygonGeometry ); } ) );
+
+  // disjoint
+  ids = extract( 2 );
+  QCOMPARE( ids, QSet< int >() << 2 << 5 );
+  QCOMPARE( ids, expected( [&]( const QgsGeometry & g ) { return g.disjoint( polygonGeometry ); } ) );
+
+  // are within
+  ids = extract( 6 );
+  QCOMPARE( ids, QSet< int >() << 1 << 8 );
+  QCOMPARE( ids, expected( [&]( const QgsGeometry & g ) { return g.within( polygonGeometry ); } ) );
+}
+
 void TestQgsProcessingAlgs::categorizeByStyle()
 {
   std::unique_ptr< QgsProcessingAlgorithm > alg( QgsApplication::processingRegistry()->createAlgorithmById( QStringLiteral( "native:categorizeusingstyle" ) ) );
@@ -0,0 +1,161 @@
+/***************************************************************************
+     testqgsallocationpool.cpp
+     --------------------------------------
+    Date                 : October 2026
+    Copyright            : (C) 2026 by agent
+    Email                : agent at local
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#include "qgstest.h"
+
+#include <QtConcurrent>
+#include <numeric>
+
+//qgis includes...
+#include "qgsallocationpool.h"
+#include "qgsfeature.h"
+#include "qgsgeometry.h"
+#include "qgslinestring.h"
+#include "qgspoint.h"
+
+class TestQgsAllocationPool : public QObject
+{
+    Q_OBJECT
+
+  private slots:
+    void initTestCase();// will be called before the first testfunction is executed.
+    void cleanupTestCase();// will be called after the last testfunction was executed.
+    void scope();
+    void recycle();
+    void largeBlocks();
+    void geometries();
+    void threads();
+};
+
+void TestQgsAllocationPool::initTestCase()
+{
+  QgsApplication::init();
+  QgsApplication::initQgis();
+}
+
+void TestQgsAllocationPool::cleanupTestCase()
+{
+  QgsApplication::exitQgis();
+}
+
+void TestQgsAllocationPool::scope()
+{
+  QVERIFY( !QgsAllocationPool::isActive() );
+  {
+    QgsAllocationPoolScope scope;
+    QVERIFY( QgsAllocationPool::isActive() );
+    {
+      QgsAllocationPoolScope nested;
+      QVERIFY( QgsAllocationPool::isActive() );
+    }
+    QVERIFY( QgsAllocationPool::isActive() );
+  }
+  QVERIFY( !QgsAllocationPool::isActive() );
+}
+
+void TestQgsAllocationPool::recycle()
+{
+  QgsAllocationPoolScope scope;
+
+  void *block = QgsAllocationPool::allocate( 40 );
+  QVERIFY( block );
+  QgsAllocationPool::deallocate( block, 40 );
+
+  // blocks are recycled within the same size class
+  void *recycled = QgsAllocationPool::allocate( 33 );
+  QCOMPARE( recycled, block );
+
+  void *other = QgsAllocationPool::allocate( 40 );
+  QVERIFY( other != recycled );
+
+  QgsAllocationPool::deallocate( recycled, 33 );
+  QgsAllocationPool::deallocate( other, 40 );
+}
+
+void TestQgsAllocationPool::largeBlocks()
+{
+  QgsAllocationPoolScope scope;
+
+  // large blocks bypass the pool
+  char *block = static_cast< char * >( QgsAllocationPool::allocate( 10000 ) );
+  QVERIFY( block );
+  block[9999] = 'x';
+  QgsAllocationPool::deallocate( block, 10000 );
+
+  QgsAllocationPool::deallocate( nullptr, 8 );
+}
+
+void TestQgsAllocationPool::geometries()
+{
+  QgsGeometry outlived;
+  QgsFeature outlivedFeature;
+  {
+    QgsAllocationPoolScope scope;
+    for ( int i = 0; i < 1000; ++i )
+    {
+      QgsFeature f( i );
+      f.setGeometry( QgsGeometry( new QgsLineString( QVector< QgsPoint >() << QgsPoint( i, 0 ) << QgsPoint( i, 1 ) ) ) );
+      if ( i == 500 )
+      {
+        outlived = f.geometry();
+        outlivedFeature = f;
+      }
+    }
+  }
+
+  // objects created inside a scope remain valid after it ends
+  QCOMPARE( outlived.asWkt(), QStringLiteral( "LineString (500 0, 500 1)" ) );
+  QCOMPARE( outlivedFeature.id(), 500LL );
+  QCOMPARE( outlivedFeature.geometry().asWkt(), QStringLiteral( "LineString (500 0, 500 1)" ) );
+
+  // and can be freed outside it
+  outlived = QgsGeometry();
+  outlivedFeature = QgsFeature();
+
+  // placement construction must still be possible
+  QVector< QgsPoint > points;
+  points.resize( 10 );
+  QCOMPARE( points.at( 9 ).wkbType(), QgsWkbTypes::Point );
+}
+
+void TestQgsAllocationPool::threads()
+{
+  QVector< int > jobs( 8 );
+  std::iota( jobs.begin(), jobs.end(), 0 );
+
+  // geometries created in one thread's pool are destroyed by another thread
+  QVector< QgsGeometry > shared( 8 );
+  QtConcurrent::blockingMap( jobs, [&shared]( int &job )
+  {
+    QgsAllocationPoolScope scope;
+    for ( int i = 0; i < 1000; ++i )
+    {
+      QgsGeometry g( new QgsPoint( job, i ) );
+      if ( i == 999 )
+        shared[job] = g;
+    }
+  } );
+
+  QtConcurrent::blockingMap( jobs, [&shared]( int &job )
+  {
+    QgsAllocationPoolScope scope;
+    shared[( job + 1 ) % shared.size()] = QgsGeometry();
+  } );
+
+  for ( const QgsGeometry &g : qgis::as_const( shared ) )
+    QVERIFY( g.isNull() );
+}
+
+QGSTEST_MAIN( TestQgsAllocationPool )
+#include "testqgsallocationpool.moc"
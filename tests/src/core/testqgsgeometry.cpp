@@ -26,6 +26,7 @@
 #include <QVector>
 #include <QPointF>
 #include <QImage>
+#include <QtConcurrent>
 #include <QPainter>
 
 //qgis includes...
@@ -125,6 +126,7 @@ class TestQgsGeometry : public QObject
 
     void intersectionCheck1();
     void intersectionCheck2();
+    void cachedPreparedGeometry();
     void translateCheck1();
     void rotateCheck1();
     void unionCheck1();
@@ -16573,6 +16575,82 @@ void TestQgsGeometry::intersectionCheck2()
   QVERIFY( !mpPolygonGeometryA.intersects( mpPolygonGeometryC ) );
 }
 
+void TestQgsGeometry::cachedPreparedGeometry()
+{
+  QgsGeometry poly = QgsGeometry::fromWkt( QStringLiteral( "Polygon ((0 0, 10 0, 10 10, 0 10, 0 0))" ) );
+  QVERIFY( !poly.cachePreparedGeometry() );
+  poly.setCachePreparedGeometry( true );
+  QVERIFY( poly.cachePreparedGeometry() );
+
+  const QgsGeometry inside = QgsGeometry::fromWkt( QStringLiteral( "Point (5 5)" ) );
+  const QgsGeometry outside = QgsGeometry::fromWkt( QStringLiteral( "Point (15 5)" ) );
+  const QgsGeometry crossing = QgsGeometry::fromWkt( QStringLiteral( "LineString (5 5, 15 5)" ) );
+
+  QVERIFY( poly.intersects( inside ) );
+  QVERIFY( !poly.intersects( outside ) );
+  QVERIFY( poly.contains( inside ) );
+  QVERIFY( !poly.contains( crossing ) );
+  QVERIFY( poly.disjoint( outside ) );
+  QVERIFY( crossing.crosses( poly ) );
+  QgsPointXY pt( 5, 5 );
+  QVERIFY( poly.contains( &pt ) );
+
+  // reversed predicates use the cache of the other geometry
+  QVERIFY( inside.intersects( poly ) );
+  QVERIFY( inside.within( poly ) );
+  QVERIFY( !outside.within( poly ) );
+  QVERIFY( !crossing.within( poly ) );
+
+  // copies share the cache setting
+  QgsGeometry copy = poly;
+  QVERIFY( copy.cachePreparedGeometry() );
+
+  // ...but changing the setting only affects the geometry it is changed on
+  QgsGeometry uncachedCopy = poly;
+  uncachedCopy.setCachePreparedGeometry( false );
+  QVERIFY( !uncachedCopy.cachePreparedGeometry() );
+  QVERIFY( poly.cachePreparedGeometry() );
+  QgsGeometry other = QgsGeometry::fromWkt( QStringLiteral( "Polygon ((0 0, 1 0, 1 1, 0 1, 0 0))" ) );
+  QgsGeometry otherCopy = other;
+  other.setCachePreparedGeometry( true );
+  QVERIFY( !otherCopy.cachePreparedGeometry() );
+  QVERIFY( other.intersects( inside ) == otherCopy.intersects( inside ) );
+
+  // modifying the geometry must invalidate the cache
+  poly.translate( 100, 0 );
+  QVERIFY( poly.cachePreparedGeometry() );
+  QVERIFY( !poly.intersects( inside ) );
+  QVERIFY( poly.intersects( QgsGeometry::fromPointXY( QgsPointXY( 105, 5 ) ) ) );
+  // ...but not the copy's
+  QVERIFY( copy.intersects( inside ) );
+  QVERIFY( !copy.intersects( QgsGeometry::fromPointXY( QgsPointXY( 105, 5 ) ) ) );
+
+  // resetting the geometry must also invalidate the cache
+  copy.set( new QgsPoint( 50, 50 ) );
+  QVERIFY( !copy.intersects( inside ) );
+  QVERIFY( copy.intersects( QgsGeometry::fromPointXY( QgsPointXY( 50, 50 ) ) ) );
+
+  copy.setCachePreparedGeometry( false );
+  QVERIFY( !copy.cachePreparedGeometry() );
+  QVERIFY( copy.intersects( QgsGeometry::fromPointXY( QgsPointXY( 50, 50 ) ) ) );
+
+  // concurrent predicate tests against the same cached geometry
+  QgsGeometry shared = QgsGeometry::fromWkt( QStringLiteral( "Polygon ((0 0, 10 0, 10 10, 0 10, 0 0))" ) );
+  shared.setCachePreparedGeometry( true );
+  QVector< QgsGeometry > points;
+  for ( int i = 0; i < 1000; ++i )
+    points << QgsGeometry::fromPointXY( QgsPointXY( i % 20, 5 ) );
+  const QVector< bool > intersecting = QtConcurrent::blockingMapped< QVector< bool > >( points, [shared]( const QgsGeometry & point ) { return shared.intersects( point ); } );
+  for ( int i = 0; i < 1000; ++i )
+    QCOMPARE( intersecting.at( i ), i % 20 <= 10 );
+
+  // null geometries
+  QgsGeometry nullGeom;
+  nullGeom.setCachePreparedGeometry( true );
+  QVERIFY( !nullGeom.intersects( inside ) );
+  QVERIFY( !inside.intersects( nullGeom ) );
+}
+
 void TestQgsGeometry::translateCheck1()
 {
   QString wkt = QStringLiteral( "LineString (0 0, 10 0, 10 10)" );
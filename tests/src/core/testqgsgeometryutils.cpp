@@ -62,6 +62,8 @@ class TestQgsGeometryUtils: public QObject
     void testClosestPoint();
     void testlinesIntersection3D();
     void testSegmentIntersection();
+    void testSegmentsIntersect();
+    void testSegmentIntersectsRectangle();
     void testLineCircleIntersection();
     void testCircleCircleIntersection();
     void testTangentPointAndCircle();
@@ -896,6 +898,34 @@ void TestQgsGeometryUtils::testSegmentIntersection()
   QVERIFY( inter == QgsPoint( 0, 0 ) );
 }
 
+void TestQgsGeometryUtils::testSegmentsIntersect()
+{
+  // proper intersection
+  QVERIFY( QgsGeometryUtils::segmentsIntersect( 0, -5, 0, 5, 2, 0, -1, 0 ) );
+  // disjoint
+  QVERIFY( !QgsGeometryUtils::segmentsIntersect( 0, 0, 0, 1, 1, 1, 1, 0 ) );
+  QVERIFY( !QgsGeometryUtils::segmentsIntersect( 0, 0, 1, 1, 2, 0, 3, 2 ) );
+  // touching end points
+  QVERIFY( QgsGeometryUtils::segmentsIntersect( 0, 0, 0, 5, 0, 5, 1, 5 ) );
+  // end point on other segment
+  QVERIFY( QgsGeometryUtils::segmentsIntersect( 0, 0, 0, 5, 0, 2, 1, 5 ) );
+  // collinear
+  QVERIFY( QgsGeometryUtils::segmentsIntersect( 0, 0, 5, 0, 3, 0, 8, 0 ) );
+  QVERIFY( !QgsGeometryUtils::segmentsIntersect( 0, 0, 5, 0, 6, 0, 8, 0 ) );
+}
+
+void TestQgsGeometryUtils::testSegmentIntersectsRectangle()
+{
+  const QgsRectangle rect( 0, 0, 10, 10 );
+  QVERIFY( QgsGeometryUtils::segmentIntersectsRectangle( 1, 1, 2, 2, rect ) );
+  QVERIFY( QgsGeometryUtils::segmentIntersectsRectangle( -5, 5, 15, 5, rect ) );
+  QVERIFY( QgsGeometryUtils::segmentIntersectsRectangle( 10, 10, 15, 15, rect ) );
+  QVERIFY( QgsGeometryUtils::segmentIntersectsRectangle( -5, 15, 15, -5, rect ) );
+  QVERIFY( !QgsGeometryUtils::segmentIntersectsRectangle( -5, 14, 14, -5, QgsRectangle( 0, 0, 1, 1 ) ) );
+  QVERIFY( !QgsGeometryUtils::segmentIntersectsRectangle( 11, 0, 11, 10, rect ) );
+  QVERIFY( !QgsGeometryUtils::segmentIntersectsRectangle( -5, -1, 15, -1, rect ) );
+}
+
 void TestQgsGeometryUtils::testLineCircleIntersection()
 {
   QgsPointXY center = QgsPoint( 2, 2 );
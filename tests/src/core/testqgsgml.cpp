@@ -81,6 +81,7 @@ class TestQgsGML : public QObject
     void testThroughOGRGeometry_urn_EPSG_4326();
     void testAccents();
     void testSameTypeameAsGeomName();
+    void testCoordinateParsing();
 };
 
 const QString data1( "<myns:FeatureCollection "
@@ -1272,5 +1273,55 @@ void TestQgsGML::testSameTypeameAsGeomName()
   delete features[0].first;
 }
 
+void TestQgsGML::testCoordinateParsing()
+{
+  QgsFields fields;
+  QgsGmlStreamingParser gmlParser( QStringLiteral( "mytypename" ), QStringLiteral( "mygeom" ), fields );
+  QCOMPARE( gmlParser.processData( QByteArray( "<myns:FeatureCollection "
+                                   "xmlns:myns='http://myns' "
+                                   "xmlns:gml='http://www.opengis.net/gml'>"
+                                   "<gml:featureMember>"
+                                   "<myns:mytypename fid='mytypename.1'>"
+                                   "<myns:mygeom>"
+                                   "<gml:LineString srsName='EPSG:27700'>"
+                                   "<gml:posList srsDimension='3'>\n"
+                                   "  -0.1 +2.5e3 1\t123456.789012345678 1E-2 2\r\n"
+                                   "  0.30000000000000004 1e300 3 foo 5 4 -7. .5 5"
+                                   "</gml:posList>"
+                                   "</gml:LineString>"
+                                   "</myns:mygeom>"
+                                   "</myns:mytypename>"
+                                   "</gml:featureMember>"
+                                   "<gml:featureMember>"
+                                   "<myns:mytypename fid='mytypename.2'>"
+                                   "<myns:mygeom>"
+                                   "<gml:LineString srsName='EPSG:27700'>"
+                                   "<gml:coordinates cs=';' ts='|'>10;20;30||-1.5;;2e1|bar;1|3;4</gml:coordinates>"
+                                   "</gml:LineString>"
+                                   "</myns:mygeom>"
+                                   "</myns:mytypename>"
+                                   "</gml:featureMember>"
+                                   "</myns:FeatureCollection>" ), true ), true );
+  QVector<QgsGmlStreamingParser::QgsGmlFeaturePtrGmlIdPair> features = gmlParser.getAndStealReadyFeatures();
+  QCOMPARE( features.size(), 2 );
+
+  QgsPolylineXY line = features[0].first->geometry().asPolyline();
+  QCOMPARE( line.size(), 4 );
+  QCOMPARE( line[0], QgsPointXY( -0.1, 2500 ) );
+  QCOMPARE( line[1].x(), 123456.789012345678 );
+  QCOMPARE( line[1].y(), 0.01 );
+  QCOMPARE( line[2].x(), 0.30000000000000004 );
+  QCOMPARE( line[2].y(), 1e300 );
+  QCOMPARE( line[3], QgsPointXY( -7, 0.5 ) );
+  delete features[0].first;
+
+  line = features[1].first->geometry().asPolyline();
+  QCOMPARE( line.size(), 3 );
+  QCOMPARE( line[0], QgsPointXY( 10, 20 ) );
+  QCOMPARE( line[1], QgsPointXY( -1.5, 20 ) );
+  QCOMPARE( line[2], QgsPointXY( 3, 4 ) );
+  delete features[1].first;
+}
+
 QGSTEST_MAIN( TestQgsGML )
 #include "testqgsgml.moc"
@@ -17,6 +17,9 @@
 //qgis includes...
 #include "qgsinternalgeometryengine.h"
 #include "qgslinesegment.h"
+#include "qgsgeometry.h"
+#include "qgspolygon.h"
+#include "qgslinestring.h"
 
 class TestQgsInternalGeometryEngine : public QObject
 {
@@ -33,6 +36,8 @@ class TestQgsInternalGeometryEngine : public QObject
     void testLineSegmentDistanceComparer_data();
     void testLineSegmentDistanceComparer();
     void clockwiseAngleComparer();
+    void intersectsRectangle();
+    void polygonPointLocator();
 
 };
 
@@ -193,5 +198,120 @@ void TestQgsInternalGeometryEngine::clockwiseAngleComparer()
   QVERIFY( !cmp( QgsPointXY( 0, 0 ), QgsPointXY( 0, 0 ) ) );
 }
 
+void TestQgsInternalGeometryEngine::intersectsRectangle()
+{
+  const QgsRectangle rect( 0, 0, 10, 10 );
+
+  // points
+  QVERIFY( QgsInternalGeometryEngine( QgsGeometry::fromWkt( QStringLiteral( "Point (5 5)" ) ) ).intersects( rect ) );
+  QVERIFY( QgsInternalGeometryEngine( QgsGeometry::fromWkt( QStringLiteral( "Point (10 5)" ) ) ).intersects( rect ) );
+  QVERIFY( !QgsInternalGeometryEngine( QgsGeometry::fromWkt( QStringLiteral( "Point (11 5)" ) ) ).intersects( rect ) );
+  QVERIFY( QgsInternalGeometryEngine( QgsGeometry::fromWkt( QStringLiteral( "MultiPoint ((20 20), (5 5))" ) ) ).intersects( rect ) );
+
+  // lines
+  QVERIFY( QgsInternalGeometryEngine( QgsGeometry::fromWkt( QStringLiteral( "LineString (-5 5, 15 5)" ) ) ).intersects( rect ) );
+  QVERIFY( QgsInternalGeometryEngine( QgsGeometry::fromWkt( QStringLiteral( "LineString (1 1, 2 2)" ) ) ).intersects( rect ) );
+  QVERIFY( QgsInternalGeometryEngine( QgsGeometry::fromWkt( QStringLiteral( "LineString (-5 15, 15 -5)" ) ) ).intersects( rect ) );
+  // bounding box intersects, but line misses the rectangle
+  QVERIFY( !QgsInternalGeometryEngine( QgsGeometry::fromWkt( QStringLiteral( "LineString (-5 14, 14 -5)" ) ) ).intersects( QgsRectangle( 0, 0, 1, 1 ) ) );
+  QVERIFY( QgsInternalGeometryEngine( QgsGeometry::fromWkt( QStringLiteral( "LineString (-5 25, 15 5)" ) ) ).intersects( rect ) );
+  QVERIFY( !QgsInternalGeometryEngine( QgsGeometry::fromWkt( QStringLiteral( "CircularString (-5 12, 5 22, 15 12)" ) ) ).intersects( rect ) );
+  QVERIFY( QgsInternalGeometryEngine( QgsGeometry::fromWkt( QStringLiteral( "CircularString (-5 0, 5 10, 15 0)" ) ) ).intersects( rect ) );
+
+  // polygons
+  QVERIFY( QgsInternalGeometryEngine( QgsGeometry::fromWkt( QStringLiteral( "Polygon ((2 2, 4 2, 4 4, 2 2))" ) ) ).intersects( rect ) );
+  QVERIFY( QgsInternalGeometryEngine( QgsGeometry::fromWkt( QStringLiteral( "Polygon ((-20 -20, 20 -20, 20 20, -20 20, -20 -20))" ) ) ).intersects( rect ) );
+  QVERIFY( !QgsInternalGeometryEngine( QgsGeometry::fromWkt( QStringLiteral( "Polygon ((-20 -20, 20 -20, 20 20, -20 20, -20 -20),(-15 -15, 15 -15, 15 15, -15 15, -15 -15))" ) ) ).intersects( rect ) );
+  QVERIFY( QgsInternalGeometryEngine( QgsGeometry::fromWkt( QStringLiteral( "Polygon ((10 10, 20 10, 20 20, 10 10))" ) ) ).intersects( rect ) );
+  QVERIFY( !QgsInternalGeometryEngine( QgsGeometry::fromWkt( QStringLiteral( "Polygon ((-5 14, 14 -5, 20 20, -5 14))" ) ) ).intersects( QgsRectangle( 0, 0, 1, 1 ) ) );
+  QVERIFY( QgsInternalGeometryEngine( QgsGeometry::fromWkt( QStringLiteral( "MultiPolygon (((20 20, 30 20, 30 30, 20 20)),((-5 -5, 5 -5, 5 5, -5 -5)))" ) ) ).intersects( rect ) );
+
+  // null geometry
+  QVERIFY( !QgsInternalGeometryEngine( QgsGeometry() ).intersects( rect ) );
+}
+
+void TestQgsInternalGeometryEngine::polygonPointLocator()
+{
+  // not a polygon
+  QgsPolygonPointLocator invalid( QgsGeometry::fromWkt( QStringLiteral( "LineString (0 0, 10 10)" ) ).constGet() );
+  QVERIFY( !invalid.isValid() );
+  QCOMPARE( invalid.locate( 5, 5 ), QgsPolygonPointLocator::Exterior );
+
+  const QgsGeometry polygon = QgsGeometry::fromWkt( QStringLiteral( "MultiPolygon (((0 0, 10 0, 10 10, 0 10, 0 0),(2 2, 4 2, 4 4, 2 4, 2 2)),((20 0, 30 0, 25 10, 20 0)))" ) );
+  QgsPolygonPointLocator locator( polygon.constGet() );
+  QVERIFY( locator.isValid() );
+
+  QCOMPARE( locator.locate( 5, 5 ), QgsPolygonPointLocator::Interior );
+  QCOMPARE( locator.locate( 3, 3 ), QgsPolygonPointLocator::Exterior );
+  QCOMPARE( locator.locate( 2, 3 ), QgsPolygonPointLocator::Boundary );
+  QCOMPARE( locator.locate( 0, 0 ), QgsPolygonPointLocator::Boundary );
+  QCOMPARE( locator.locate( 10, 5 ), QgsPolygonPointLocator::Boundary );
+  QCOMPARE( locator.locate( 15, 5 ), QgsPolygonPointLocator::Exterior );
+  QCOMPARE( locator.locate( 25, 5 ), QgsPolygonPointLocator::Interior );
+  QCOMPARE( locator.locate( 25, 10 ), QgsPolygonPointLocator::Boundary );
+  QCOMPARE( locator.locate( 21, 9 ), QgsPolygonPointLocator::Exterior );
+  QCOMPARE( locator.locate( -1, 5 ), QgsPolygonPointLocator::Exterior );
+  QVERIFY( locator.intersects( 2, 3 ) );
+  QVERIFY( !locator.contains( 2, 3 ) );
+  QVERIFY( locator.contains( 5, 5 ) );
+
+  // results must match GEOS for a polygon with many edges, and therefore many bands
+  const QgsGeometry circle = QgsGeometry::fromPointXY( QgsPointXY( 0, 0 ) ).buffer( 100, 200 );
+  QgsPolygonPointLocator circleLocator( circle.constGet() );
+  for ( int x = -110; x <= 110; x += 7 )
+  {
+    for ( int y = -110; y <= 110; y += 7 )
+    {
+      QCOMPARE( circleLocator.intersects( x, y ), circle.intersects( QgsGeometry::fromPointXY( QgsPointXY( x, y ) ) ) );
+    }
+  }
+
+  // a few long edges (the sides) combined with many short edges (the teeth along the top), so that the long
+  // edges are tested separately rather than duplicated in every band
+  QgsPointSequence comb;
+  comb << QgsPoint( 0, 0 ) << QgsPoint( 1000, 0 );
+  for ( int i = 1000; i > 0; i -= 2 )
+    comb << QgsPoint( i, 1000 ) << QgsPoint( i - 1, 990 );
+  comb << QgsPoint( 0, 1000 ) << QgsPoint( 0, 0 );
+  QgsPolygon *combPolygon = new QgsPolygon();
+  combPolygon->setExteriorRing( new QgsLineString( comb ) );
+  const QgsGeometry combGeometry( combPolygon );
+  QgsPolygonPointLocator combLocator( combGeometry.constGet() );
+  for ( double x = -5; x <= 1005; x += 13.3 )
+  {
+    for ( double y = -5; y <= 1005; y += 6.1 )
+    {
+      QCOMPARE( combLocator.intersects( x, y ), combGeometry.intersects( QgsGeometry::fromPointXY( QgsPointXY( x, y ) ) ) );
+    }
+  }
+
+  // a star whose edges all span most of its height, which can't be usefully split into bands
+  QgsPointSequence star;
+  for ( int i = 0; i < 400; ++i )
+  {
+    const double angle = 2 * M_PI * i / 400;
+    const double radius = i % 2 ? 1 : 100;
+    star << QgsPoint( radius * std::cos( angle ), radius * std::sin( angle ) );
+  }
+  star << star.at( 0 );
+  QgsPolygon *starPolygon = new QgsPolygon();
+  starPolygon->setExteriorRing( new QgsLineString( star ) );
+  const QgsGeometry starGeometry( starPolygon );
+  QgsPolygonPointLocator starLocator( starGeometry.constGet() );
+  QVERIFY( starLocator.isValid() );
+  for ( double x = -105; x <= 105; x += 3.7 )
+  {
+    for ( double y = -105; y <= 105; y += 3.1 )
+    {
+      QCOMPARE( starLocator.intersects( x, y ), starGeometry.intersects( QgsGeometry::fromPointXY( QgsPointXY( x, y ) ) ) );
+    }
+  }
+
+  // curved polygon
+  QgsPolygonPointLocator curveLocator( QgsGeometry::fromWkt( QStringLiteral( "CurvePolygon (CircularString (0 0, 10 10, 20 0, 10 -10, 0 0))" ) ).constGet() );
+  QCOMPARE( curveLocator.locate( 10, 0 ), QgsPolygonPointLocator::Interior );
+  QCOMPARE( curveLocator.locate( 10, 11 ), QgsPolygonPointLocator::Exterior );
+}
+
 QGSTEST_MAIN( TestQgsInternalGeometryEngine )
 #include "testqgsinternalgeometryengine.moc"
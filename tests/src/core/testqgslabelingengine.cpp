@@ -28,6 +28,7 @@
 #include "qgsrenderchecker.h"
 #include "qgsfontutils.h"
 #include "qgsnullsymbolrenderer.h"
+#include "qgslabelplacementcache.h"
 #include "pointset.h"
 
 class TestQgsLabelingEngine : public QObject
@@ -68,6 +69,9 @@ class TestQgsLabelingEngine : public QObject
     void testLabelRotationWithReprojection();
     void drawUnplaced();
     void labelingResults();
+    void labelPlacementCache();
+    void partitionedSolve();
+    void partitionedSolveRotated();
     void pointsetExtend();
     void curvedOverrun();
     void parallelOverrun();
@@ -1806,6 +1810,280 @@ void TestQgsLabelingEngine::labelingResults()
   QCOMPARE( labels.count(), 0 );
 }
 
+void TestQgsLabelingEngine::labelPlacementCache()
+{
+  // test that label placements are reused between renders of overlapping extents
+  QgsPalLayerSettings settings;
+  setDefaultLabelParams( settings );
+  settings.fieldName = QStringLiteral( "\"id\"" );
+  settings.isExpression = true;
+  settings.placement = QgsPalLayerSettings::AroundPoint;
+
+  std::unique_ptr< QgsVectorLayer> vl2( new QgsVectorLayer( QStringLiteral( "Point?crs=epsg:3857&field=id:integer" ), QStringLiteral( "vl" ), QStringLiteral( "memory" ) ) );
+  vl2->setRenderer( new QgsNullSymbolRenderer() );
+
+  QgsFeatureList features;
+  for ( int i = 0; i < 20; ++i )
+  {
+    QgsFeature f;
+    f.setAttributes( QgsAttributes() << i );
+    f.setGeometry( QgsGeometry::fromPointXY( QgsPointXY( 1000 + ( i % 5 ) * 1500, 1000 + ( i / 5 ) * 1500 ) ) );
+    features << f;
+  }
+  QVERIFY( vl2->dataProvider()->addFeatures( features ) );
+  vl2->updateExtents();
+
+  vl2->setLabeling( new QgsVectorLayerSimpleLabeling( settings ) );
+  vl2->setLabelsEnabled( true );
+
+  QgsMapSettings mapSettings;
+  mapSettings.setDestinationCrs( vl2->crs() );
+  mapSettings.setOutputSize( QSize( 600, 600 ) );
+  mapSettings.setExtent( QgsRectangle( 0, 0, 8000, 8000 ) );
+  mapSettings.setLayers( QList<QgsMapLayer *>() << vl2.get() );
+  mapSettings.setOutputDpi( 96 );
+
+  QgsLabelPlacementCache cache;
+
+  auto render = [&mapSettings, &cache]() -> QgsLabelingResults *
+  {
+    QgsMapRendererSequentialJob job( mapSettings );
+    job.setLabelPlacementCache( &cache );
+    job.start();
+    job.waitForFinished();
+    return job.takeLabelingResults();
+  };
+
+  std::unique_ptr< QgsLabelingResults > results( render() );
+  const QList< QgsLabelPosition > initialLabels = results->labelsWithinRect( mapSettings.extent() );
+  QVERIFY( !initialLabels.isEmpty() );
+
+  QgsRectangle cachedExtent;
+  QHash< QString, QgsLabelPlacementCache::ProviderPlacements > placements = cache.placements( QStringLiteral( "invalid" ), cachedExtent );
+  QVERIFY( placements.isEmpty() );
+
+  // pan the map slightly - labels still fully visible must not move
+  const QgsRectangle pannedExtent( 500, 300, 8500, 8300 );
+  mapSettings.setExtent( pannedExtent );
+  results.reset( render() );
+
+  const QgsRectangle overlap = pannedExtent.intersect( QgsRectangle( 0, 0, 8000, 8000 ) );
+  int reused = 0;
+  for ( const QgsLabelPosition &label : initialLabels )
+  {
+    if ( !overlap.contains( label.labelRect ) )
+      continue;
+
+    const QList< QgsLabelPosition > panned = results->labelsWithinRect( label.labelRect );
+    bool found = false;
+    for ( const QgsLabelPosition &pannedLabel : panned )
+    {
+      if ( pannedLabel.featureId == label.featureId )
+      {
+        QGSCOMPARENEAR( pannedLabel.labelRect.xMinimum(), label.labelRect.xMinimum(), 0.0001 );
+        QGSCOMPARENEAR( pannedLabel.labelRect.yMinimum(), label.labelRect.yMinimum(), 0.0001 );
+        found = true;
+      }
+    }
+    QVERIFY( found );
+    reused++;
+  }
+  QVERIFY( reused > 0 );
+
+  // a cached placement is only the preferred candidate, so a label can move away from a new obstacle
+  const QgsLabelPosition &movedLabel = initialLabels.at( 0 );
+  const QgsPointXY obstaclePoint = movedLabel.labelRect.center();
+  std::unique_ptr< QgsVectorLayer> obstacleLayer( new QgsVectorLayer( QStringLiteral( "Point?crs=epsg:3857" ), QStringLiteral( "obstacles" ), QStringLiteral( "memory" ) ) );
+  obstacleLayer->setRenderer( new QgsNullSymbolRenderer() );
+  QgsFeature obstacle;
+  obstacle.setGeometry( QgsGeometry::fromPointXY( obstaclePoint ) );
+  QVERIFY( obstacleLayer->dataProvider()->addFeature( obstacle ) );
+  QgsPalLayerSettings obstacleSettings;
+  setDefaultLabelParams( obstacleSettings );
+  obstacleSettings.fieldName = QStringLiteral( "'x'" );
+  obstacleSettings.isExpression = true;
+  obstacleSettings.drawLabels = false;
+  obstacleSettings.obstacle = true;
+  obstacleLayer->setLabeling( new QgsVectorLayerSimpleLabeling( obstacleSettings ) );
+  obstacleLayer->setLabelsEnabled( true );
+
+  mapSettings.setExtent( QgsRectangle( 0, 0, 8000, 8000 ) );
+  results.reset( render() );
+  mapSettings.setLayers( QList<QgsMapLayer *>() << vl2.get() << obstacleLayer.get() );
+  results.reset( render() );
+  bool moved = false;
+  const QList< QgsLabelPosition > labelsWithObstacle = results->labelsWithinRect( mapSettings.extent() );
+  for ( const QgsLabelPosition &label : labelsWithObstacle )
+  {
+    if ( label.layerID == vl2->id() && label.featureId == movedLabel.featureId )
+    {
+      QVERIFY( !label.labelRect.contains( obstaclePoint ) );
+      moved = true;
+    }
+  }
+  QVERIFY( moved );
+  mapSettings.setLayers( QList<QgsMapLayer *>() << vl2.get() );
+
+  // repainting a layer must discard its placements
+  QgsLabelPlacementCache::ProviderPlacements providerPlacements;
+  providerPlacements[ 1 ] << QgsLabelPlacementCache::Placement();
+  QHash< QString, QgsLabelPlacementCache::ProviderPlacements > newPlacements;
+  newPlacements.insert( QStringLiteral( "provider" ), providerPlacements );
+  QHash< QString, QgsMapLayer * > providerLayers;
+  providerLayers.insert( QStringLiteral( "provider" ), vl2.get() );
+  cache.setPlacements( QStringLiteral( "key" ), QgsRectangle( 0, 0, 10, 10 ), newPlacements, providerLayers );
+  placements = cache.placements( QStringLiteral( "key" ), cachedExtent );
+  QCOMPARE( placements.size(), 1 );
+  QCOMPARE( cachedExtent, QgsRectangle( 0, 0, 10, 10 ) );
+  QVERIFY( cache.placements( QStringLiteral( "other key" ), cachedExtent ).isEmpty() );
+  vl2->triggerRepaint();
+  QVERIFY( cache.placements( QStringLiteral( "key" ), cachedExtent ).isEmpty() );
+
+  cache.setPlacements( QStringLiteral( "key" ), QgsRectangle( 0, 0, 10, 10 ), newPlacements, providerLayers );
+  cache.clear();
+  QVERIFY( cache.placements( QStringLiteral( "key" ), cachedExtent ).isEmpty() );
+}
+
+void TestQgsLabelingEngine::partitionedSolve()
+{
+  // large problems are split into independent parts, make sure all labels are still placed
+  QgsPalLayerSettings settings;
+  setDefaultLabelParams( settings );
+  settings.fieldName = QStringLiteral( "\"id\"" );
+  settings.isExpression = true;
+  settings.placement = QgsPalLayerSettings::AroundPoint;
+
+  std::unique_ptr< QgsVectorLayer> vl2( new QgsVectorLayer( QStringLiteral( "Point?crs=epsg:3857&field=id:integer" ), QStringLiteral( "vl" ), QStringLiteral( "memory" ) ) );
+  vl2->setRenderer( new QgsNullSymbolRenderer() );
+
+  // pairs of nearby points, so that the conflict graph has many small components
+  QgsFeatureList features;
+  for ( int i = 0; i < 1200; ++i )
+  {
+    QgsFeature f;
+    f.setAttributes( QgsAttributes() << i );
+    const int pair = i / 2;
+    f.setGeometry( QgsGeometry::fromPointXY( QgsPointXY( ( pair % 30 ) * 10000 + ( i % 2 ) * 200, ( pair / 30 ) * 10000 ) ) );
+    features << f;
+  }
+  QVERIFY( vl2->dataProvider()->addFeatures( features ) );
+  vl2->updateExtents();
+
+  vl2->setLabeling( new QgsVectorLayerSimpleLabeling( settings ) );
+  vl2->setLabelsEnabled( true );
+
+  QgsMapSettings mapSettings;
+  mapSettings.setDestinationCrs( vl2->crs() );
+  mapSettings.setOutputSize( QSize( 6000, 4000 ) );
+  mapSettings.setExtent( QgsRectangle( -10000, -10000, 310000, 210000 ) );
+  mapSettings.setLayers( QList<QgsMapLayer *>() << vl2.get() );
+  mapSettings.setOutputDpi( 96 );
+
+  QgsLabelingEngineSettings engineSettings = mapSettings.labelingEngineSettings();
+  engineSettings.setFlag( QgsLabelingEngineSettings::DrawLabelRectOnly, true );
+  mapSettings.setLabelingEngineSettings( engineSettings );
+
+  QgsMapRendererSequentialJob job( mapSettings );
+  job.start();
+  job.waitForFinished();
+
+  std::unique_ptr< QgsLabelingResults > results( job.takeLabelingResults() );
+  QVERIFY( results );
+  const QList< QgsLabelPosition > labels = results->labelsWithinRect( mapSettings.extent() );
+  QCOMPARE( labels.count(), 1200 );
+
+  // results must not depend on the order in which the parts are solved
+  QgsMapRendererSequentialJob job2( mapSettings );
+  job2.start();
+  job2.waitForFinished();
+  std::unique_ptr< QgsLabelingResults > results2( job2.takeLabelingResults() );
+  QList< QgsLabelPosition > labels2 = results2->labelsWithinRect( mapSettings.extent() );
+  QCOMPARE( labels2.count(), labels.count() );
+  QSet< QString > positions;
+  for ( const QgsLabelPosition &label : labels )
+    positions.insert( QStringLiteral( "%1:%2" ).arg( label.featureId ).arg( label.labelRect.toString() ) );
+  for ( const QgsLabelPosition &label : qgis::as_const( labels2 ) )
+    QVERIFY( positions.contains( QStringLiteral( "%1:%2" ).arg( label.featureId ).arg( label.labelRect.toString() ) ) );
+}
+
+void TestQgsLabelingEngine::partitionedSolveRotated()
+{
+  // rotated labels in a large problem, so that the partitioned solve runs the GEOS based conflict checks
+  QgsPalLayerSettings settings;
+  setDefaultLabelParams( settings );
+  settings.fieldName = QStringLiteral( "\"id\"" );
+  settings.isExpression = true;
+  settings.placement = QgsPalLayerSettings::AroundPoint;
+  settings.angleOffset = 30;
+
+  std::unique_ptr< QgsVectorLayer> vl2( new QgsVectorLayer( QStringLiteral( "Point?crs=epsg:3857&field=id:integer" ), QStringLiteral( "vl" ), QStringLiteral( "memory" ) ) );
+  vl2->setRenderer( new QgsNullSymbolRenderer() );
+
+  // pairs of nearby points, so that the labels of each pair conflict with each other only
+  QgsFeatureList features;
+  for ( int i = 0; i < 1200; ++i )
+  {
+    QgsFeature f;
+    f.setAttributes( QgsAttributes() << i );
+    const int pair = i / 2;
+    f.setGeometry( QgsGeometry::fromPointXY( QgsPointXY( ( pair % 30 ) * 10000 + ( i % 2 ) * 200, ( pair / 30 ) * 10000 ) ) );
+    features << f;
+  }
+  QVERIFY( vl2->dataProvider()->addFeatures( features ) );
+  vl2->updateExtents();
+
+  vl2->setLabeling( new QgsVectorLayerSimpleLabeling( settings ) );
+  vl2->setLabelsEnabled( true );
+
+  QgsMapSettings mapSettings;
+  mapSettings.setDestinationCrs( vl2->crs() );
+  mapSettings.setOutputSize( QSize( 6000, 4000 ) );
+  mapSettings.setExtent( QgsRectangle( -10000, -10000, 310000, 210000 ) );
+  mapSettings.setLayers( QList<QgsMapLayer *>() << vl2.get() );
+  mapSettings.setOutputDpi( 96 );
+
+  QgsLabelingEngineSettings engineSettings = mapSettings.labelingEngineSettings();
+  engineSettings.setFlag( QgsLabelingEngineSettings::DrawLabelRectOnly, true );
+  mapSettings.setLabelingEngineSettings( engineSettings );
+
+  QgsMapRendererSequentialJob job( mapSettings );
+  job.start();
+  job.waitForFinished();
+
+  std::unique_ptr< QgsLabelingResults > results( job.takeLabelingResults() );
+  QVERIFY( results );
+  const QList< QgsLabelPosition > labels = results->labelsWithinRect( mapSettings.extent() );
+  QCOMPARE( labels.count(), 1200 );
+
+  QHash< QgsFeatureId, QgsGeometry > labelGeometries;
+  for ( const QgsLabelPosition &label : labels )
+  {
+    QVERIFY( !qgsDoubleNear( label.rotation, 0.0 ) );
+    labelGeometries.insert( label.featureId, label.labelGeometry );
+  }
+
+  // the two labels of each pair must have been placed clear of each other
+  for ( QgsFeatureId id = 1; id <= 1200; id += 2 )
+  {
+    QVERIFY( labelGeometries.contains( id ) );
+    QVERIFY( labelGeometries.contains( id + 1 ) );
+    QVERIFY( !labelGeometries.value( id ).intersects( labelGeometries.value( id + 1 ) ) );
+  }
+
+  // results must not depend on the order in which the parts are solved
+  QgsMapRendererSequentialJob job2( mapSettings );
+  job2.start();
+  job2.waitForFinished();
+  std::unique_ptr< QgsLabelingResults > results2( job2.takeLabelingResults() );
+  QList< QgsLabelPosition > labels2 = results2->labelsWithinRect( mapSettings.extent() );
+  QCOMPARE( labels2.count(), labels.count() );
+  QSet< QString > positions;
+  for ( const QgsLabelPosition &label : labels )
+    positions.insert( QStringLiteral( "%1:%2" ).arg( label.featureId ).arg( label.labelRect.toString() ) );
+  for ( const QgsLabelPosition &label : qgis::as_const( labels2 ) )
+    QVERIFY( positions.contains( QStringLiteral( "%1:%2" ).arg( label.featureId ).arg( label.labelRect.toString() ) ) );
+}
+
 void TestQgsLabelingEngine::pointsetExtend()
 {
   // test extending pointsets by distance
@@ -0,0 +1,247 @@
+/***************************************************************************
+     testqgspointpyramid.cpp
+     --------------------------------------
+    Date                 : October 2026
+    Copyright            : (C) 2026 by agent
+    Email                : agent at local
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#include "qgstest.h"
+
+//qgis includes...
+#include "qgspointpyramid.h"
+#include "qgsfeedback.h"
+#include "qgsgeometry.h"
+#include "qgsvectorlayer.h"
+#include "qgsvectorlayerfeatureiterator.h"
+#include "qgsmapsettings.h"
+#include "qgsmaprenderersequentialjob.h"
+#include "qgssinglesymbolrenderer.h"
+#include "qgssymbol.h"
+
+class TestQgsPointPyramid : public QObject
+{
+    Q_OBJECT
+
+  private slots:
+    void initTestCase();// will be called before the first testfunction is executed.
+    void cleanupTestCase();// will be called after the last testfunction was executed.
+    void build();
+    void sparse();
+    void canceled();
+    void store();
+    void backgroundBuild();
+    void render();
+
+  private:
+    std::unique_ptr< QgsVectorLayer > pointLayer( int columns, int rows, int pointsPerLocation );
+    QImage renderLayer( QgsVectorLayer *layer );
+};
+
+void TestQgsPointPyramid::initTestCase()
+{
+  QgsApplication::init();
+  QgsApplication::initQgis();
+}
+
+void TestQgsPointPyramid::cleanupTestCase()
+{
+  QgsApplication::exitQgis();
+}
+
+std::unique_ptr<QgsVectorLayer> TestQgsPointPyramid::pointLayer( int columns, int rows, int pointsPerLocation )
+{
+  std::unique_ptr< QgsVectorLayer > layer = qgis::make_unique< QgsVectorLayer >( QStringLiteral( "Point?crs=EPSG:3857" ), QStringLiteral( "points" ), QStringLiteral( "memory" ) );
+  QgsFeatureList features;
+  for ( int column = 0; column < columns; ++column )
+  {
+    for ( int row = 0; row < rows; ++row )
+    {
+      for ( int i = 0; i < pointsPerLocation; ++i )
+      {
+        QgsFeature f;
+        f.setGeometry( QgsGeometry::fromPointXY( QgsPointXY( column * 10.0, row * 10.0 ) ) );
+        features << f;
+      }
+    }
+  }
+  layer->dataProvider()->addFeatures( features );
+  layer->updateExtents();
+  return layer;
+}
+
+void TestQgsPointPyramid::build()
+{
+  std::unique_ptr< QgsVectorLayer > layer = pointLayer( 11, 11, 4 );
+  QCOMPARE( layer->featureCount(), 484LL );
+
+  QgsFeatureIterator it = layer->getFeatures( QgsFeatureRequest().setNoAttributes() );
+  std::unique_ptr< QgsPointPyramid > pyramid = QgsPointPyramid::build( it, layer->extent() );
+  QVERIFY( pyramid );
+  QCOMPARE( pyramid->pointCount(), 484 );
+  QVERIFY( pyramid->levelCount() > 0 );
+
+  // levels double in cell size
+  for ( int level = 1; level < pyramid->levelCount(); ++level )
+    QGSCOMPARENEAR( pyramid->cellSize( level ), pyramid->cellSize( level - 1 ) * 2, 0.0000001 );
+
+  QCOMPARE( pyramid->levelForCellSize( pyramid->cellSize( 0 ) / 2 ), -1 );
+  QCOMPARE( pyramid->levelForCellSize( pyramid->cellSize( 0 ) ), 0 );
+  QCOMPARE( pyramid->levelForCellSize( 1000000 ), pyramid->levelCount() - 1 );
+
+  // every level must account for all points
+  for ( int level = 0; level < pyramid->levelCount(); ++level )
+  {
+    const QVector< QgsPointPyramid::Cell > cells = pyramid->cells( level, layer->extent() );
+    int count = 0;
+    for ( const QgsPointPyramid::Cell &cell : cells )
+      count += cell.count;
+    QCOMPARE( count, 484 );
+  }
+
+  // finest level has one cell per location
+  QCOMPARE( pyramid->cells( 0, layer->extent() ).size(), 121 );
+  const QVector< QgsPointPyramid::Cell > cells = pyramid->cells( 0, QgsRectangle( -1, -1, 1, 1 ) );
+  QCOMPARE( cells.size(), 1 );
+  QCOMPARE( cells.at( 0 ).count, 4 );
+  QCOMPARE( layer->getFeature( cells.at( 0 ).representativeId ).geometry().asPoint(), QgsPointXY( 0, 0 ) );
+
+  // coarsest level has a single cell
+  QCOMPARE( pyramid->cells( pyramid->levelCount() - 1, layer->extent() ).size(), 1 );
+
+  // outside of pyramid
+  QVERIFY( pyramid->cells( 0, QgsRectangle( 1000, 1000, 1100, 1100 ) ).isEmpty() );
+  QVERIFY( pyramid->cells( -1, layer->extent() ).isEmpty() );
+  QVERIFY( pyramid->cells( pyramid->levelCount(), layer->extent() ).isEmpty() );
+}
+
+void TestQgsPointPyramid::sparse()
+{
+  // one point per location, so only levels which merge locations are kept
+  std::unique_ptr< QgsVectorLayer > layer = pointLayer( 11, 11, 1 );
+  QgsFeatureIterator it = layer->getFeatures( QgsFeatureRequest().setNoAttributes() );
+  std::unique_ptr< QgsPointPyramid > pyramid = QgsPointPyramid::build( it, layer->extent() );
+  QVERIFY( pyramid );
+  QVERIFY( pyramid->levelCount() > 0 );
+  QVERIFY( pyramid->cellSize( 0 ) > 10 );
+  QCOMPARE( pyramid->levelForCellSize( 1 ), -1 );
+
+  // empty extent
+  it = layer->getFeatures( QgsFeatureRequest().setNoAttributes() );
+  QVERIFY( !QgsPointPyramid::build( it, QgsRectangle() ) );
+}
+
+void TestQgsPointPyramid::canceled()
+{
+  std::unique_ptr< QgsVectorLayer > layer = pointLayer( 11, 11, 4 );
+  QgsFeatureIterator it = layer->getFeatures( QgsFeatureRequest().setNoAttributes() );
+  QgsFeedback feedback;
+  feedback.cancel();
+  QVERIFY( !QgsPointPyramid::build( it, layer->extent(), &feedback ) );
+}
+
+void TestQgsPointPyramid::store()
+{
+  std::unique_ptr< QgsVectorLayer > layer = pointLayer( 11, 11, 4 );
+  QgsPointPyramidStore store;
+  int generation = -1;
+  QVERIFY( !store.pyramid( generation ) );
+
+  QgsFeatureIterator it = layer->getFeatures( QgsFeatureRequest().setNoAttributes() );
+  std::shared_ptr< const QgsPointPyramid > pyramid = QgsPointPyramid::build( it, layer->extent() );
+  store.setPyramid( pyramid, generation );
+  int newGeneration = -1;
+  QCOMPARE( store.pyramid( newGeneration ).get(), pyramid.get() );
+  QCOMPARE( newGeneration, generation );
+
+  // pyramids built from stale data must be discarded
+  store.invalidate();
+  QVERIFY( !store.pyramid( newGeneration ) );
+  QVERIFY( newGeneration != generation );
+  store.setPyramid( pyramid, generation );
+  QVERIFY( !store.pyramid( newGeneration ) );
+  store.setPyramid( pyramid, newGeneration );
+  QVERIFY( store.pyramid( newGeneration ) );
+}
+
+void TestQgsPointPyramid::backgroundBuild()
+{
+  std::unique_ptr< QgsVectorLayer > layer = pointLayer( 11, 11, 4 );
+  std::shared_ptr< QgsPointPyramidStore > store = std::make_shared< QgsPointPyramidStore >();
+  int generation = -1;
+  store->buildInBackground( new QgsVectorLayerFeatureSource( layer.get() ), layer->extent() );
+  store->waitForBuild();
+  std::shared_ptr< const QgsPointPyramid > pyramid = store->pyramid( generation );
+  QVERIFY( pyramid );
+  QCOMPARE( pyramid->pointCount(), 484 );
+
+  // an up to date pyramid is not rebuilt
+  store->buildInBackground( new QgsVectorLayerFeatureSource( layer.get() ), layer->extent() );
+  store->waitForBuild();
+  QCOMPARE( store->pyramid( generation ).get(), pyramid.get() );
+
+  // builds started before the data changed are discarded
+  store->invalidate();
+  store->buildInBackground( new QgsVectorLayerFeatureSource( layer.get() ), layer->extent() );
+  store->invalidate();
+  store->waitForBuild();
+  QVERIFY( !store->pyramid( generation ) );
+}
+
+QImage TestQgsPointPyramid::renderLayer( QgsVectorLayer *layer )
+{
+  QgsMapSettings settings;
+  settings.setLayers( QList< QgsMapLayer * >() << layer );
+  settings.setDestinationCrs( layer->crs() );
+  settings.setOutputSize( QSize( 220, 220 ) );
+  settings.setExtent( QgsRectangle( -5, -5, 105, 105 ) );
+  settings.setBackgroundColor( Qt::white );
+  QgsMapRendererSequentialJob job( settings );
+  job.start();
+  job.waitForFinished();
+  return job.renderedImage();
+}
+
+void TestQgsPointPyramid::render()
+{
+  // with a semi transparent marker, the points sharing a location are only drawn once from the pyramid
+  QgsStringMap props;
+  props.insert( QStringLiteral( "color" ), QStringLiteral( "255,0,0,100" ) );
+  props.insert( QStringLiteral( "outline_style" ), QStringLiteral( "no" ) );
+  props.insert( QStringLiteral( "size" ), QStringLiteral( "3" ) );
+  std::unique_ptr< QgsVectorLayer > layer = pointLayer( 11, 11, 4 );
+  layer->setRenderer( new QgsSingleSymbolRenderer( QgsMarkerSymbol::createSimple( props ) ) );
+  std::unique_ptr< QgsVectorLayer > singleLayer = pointLayer( 11, 11, 1 );
+  singleLayer->setRenderer( new QgsSingleSymbolRenderer( QgsMarkerSymbol::createSimple( props ) ) );
+
+  const QImage allPoints = renderLayer( layer.get() );
+  const QImage representativePoints = renderLayer( singleLayer.get() );
+  QVERIFY( allPoints != representativePoints );
+
+  // the first render beyond the aggregation scale draws all points, while the pyramid is built
+  layer->setPointAggregationScale( 1 );
+  QCOMPARE( renderLayer( layer.get() ), allPoints );
+  layer->mPointPyramidStore->waitForBuild();
+  QCOMPARE( renderLayer( layer.get() ), representativePoints );
+
+  // not beyond the aggregation scale
+  layer->setPointAggregationScale( 100000 );
+  QCOMPARE( renderLayer( layer.get() ), allPoints );
+  layer->setPointAggregationScale( 1 );
+  QCOMPARE( renderLayer( layer.get() ), representativePoints );
+
+  // the pyramid is rebuilt after the data has changed
+  layer->mPointPyramidStore->invalidate();
+  QCOMPARE( renderLayer( layer.get() ), allPoints );
+  layer->mPointPyramidStore->waitForBuild();
+  QCOMPARE( renderLayer( layer.get() ), representativePoints );
+}
+
+QGSTEST_MAIN( TestQgsPointPyramid )
+#include "testqgspointpyramid.moc"
@@ -0,0 +1,279 @@
+/***************************************************************************
+     testqgsprefetchingfeatureiterator.cpp
+     --------------------
+    Date                 : October 2026
+    Copyright            : (C) 2026 by agent
+    Email                : agent at local
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#include "qgstest.h"
+#include <QObject>
+#include "qgsprefetchingfeatureiterator.h"
+#include "qgsvectorlayer.h"
+#include "qgsvectorlayerfeatureiterator.h"
+#include "qgsapplication.h"
+#include "qgsfeedback.h"
+#include "qgsexception.h"
+
+#include <QAtomicPointer>
+
+/**
+ * A feature iterator returning \a featureCount features with increasing ids, which throws
+ * an exception if it is asked for more than \a throwAfter features, and records the last
+ * interruption checker set on it.
+ */
+class TestFeatureIterator : public QgsAbstractFeatureIterator
+{
+  public:
+    TestFeatureIterator( const QgsFeatureRequest &request, int featureCount, int throwAfter, QAtomicPointer< QgsFeedback > *interruptionChecker )
+      : QgsAbstractFeatureIterator( request )
+      , mFeatureCount( featureCount )
+      , mThrowAfter( throwAfter )
+      , mInterruptionChecker( interruptionChecker )
+    {}
+
+    bool rewind() override
+    {
+      mCount = 0;
+      return true;
+    }
+
+    bool close() override
+    {
+      mClosed = true;
+      return true;
+    }
+
+    void setInterruptionChecker( QgsFeedback *interruptionChecker ) override
+    {
+      mInterruptionChecker->storeRelease( interruptionChecker );
+    }
+
+  protected:
+    bool fetchFeature( QgsFeature &feature ) override
+    {
+      if ( mThrowAfter >= 0 && mCount >= mThrowAfter )
+        throw QgsException( QStringLiteral( "source failure" ) );
+      if ( mCount >= mFeatureCount )
+        return false;
+
+      feature = QgsFeature( mCount++ );
+      feature.setValid( true );
+      return true;
+    }
+
+  private:
+    int mFeatureCount = 0;
+    int mThrowAfter = -1;
+    int mCount = 0;
+    QAtomicPointer< QgsFeedback > *mInterruptionChecker = nullptr;
+};
+
+class TestFeatureSource : public QgsAbstractFeatureSource
+{
+  public:
+    TestFeatureSource( int featureCount, int throwAfter, QAtomicPointer< QgsFeedback > *interruptionChecker )
+      : mFeatureCount( featureCount )
+      , mThrowAfter( throwAfter )
+      , mInterruptionChecker( interruptionChecker )
+    {}
+
+    QgsFeatureIterator getFeatures( const QgsFeatureRequest &request ) override
+    {
+      return QgsFeatureIterator( new TestFeatureIterator( request, mFeatureCount, mThrowAfter, mInterruptionChecker ) );
+    }
+
+  private:
+    int mFeatureCount = 0;
+    int mThrowAfter = -1;
+    QAtomicPointer< QgsFeedback > *mInterruptionChecker = nullptr;
+};
+
+/**
+ * \ingroup UnitTests
+ * This is a unit test for QgsPrefetchingFeatureIterator.
+ */
+class TestQgsPrefetchingFeatureIterator : public QObject
+{
+    Q_OBJECT
+
+  private slots:
+    void initTestCase();// will be called before the first testfunction is executed.
+    void cleanupTestCase();// will be called after the last testfunction was executed.
+    void iterate();
+    void iterateRequest();
+    void rewind();
+    void closeEarly();
+    void sourceException();
+    void interruptionChecker();
+
+  private:
+
+    QgsFeatureIterator prefetchingIterator( const QgsFeatureRequest &request = QgsFeatureRequest(), int batchSize = 7, int maxQueuedBatches = 2 );
+    static QList< QgsFeatureId > ids( QgsFeatureIterator it );
+
+    std::unique_ptr< QgsVectorLayer > mLayer;
+};
+
+void TestQgsPrefetchingFeatureIterator::initTestCase()
+{
+  QgsApplication::init();
+  QgsApplication::initQgis();
+
+  mLayer = qgis::make_unique< QgsVectorLayer >( QStringLiteral( "Point?field=value:integer" ), QStringLiteral( "layer" ), QStringLiteral( "memory" ) );
+  QVERIFY( mLayer->isValid() );
+
+  QgsFeatureList features;
+  for ( int i = 0; i < 1000; ++i )
+  {
+    QgsFeature feature( mLayer->fields() );
+    feature.setAttributes( QgsAttributes() << i );
+    feature.setGeometry( QgsGeometry::fromPointXY( QgsPointXY( i, i ) ) );
+    features << feature;
+  }
+  QVERIFY( mLayer->dataProvider()->addFeatures( features ) );
+}
+
+void TestQgsPrefetchingFeatureIterator::cleanupTestCase()
+{
+  mLayer.reset();
+  QgsApplication::exitQgis();
+}
+
+QgsFeatureIterator TestQgsPrefetchingFeatureIterator::prefetchingIterator( const QgsFeatureRequest &request, int batchSize, int maxQueuedBatches )
+{
+  return QgsFeatureIterator( new QgsPrefetchingFeatureIterator( new QgsVectorLayerFeatureSource( mLayer.get() ), true, request, batchSize, maxQueuedBatches ) );
+}
+
+QList< QgsFeatureId > TestQgsPrefetchingFeatureIterator::ids( QgsFeatureIterator it )
+{
+  QList< QgsFeatureId > result;
+  QgsFeature feature;
+  while ( it.nextFeature( feature ) )
+  {
+    if ( !feature.isValid() )
+      return QList< QgsFeatureId >();
+    result << feature.id();
+  }
+  return result;
+}
+
+void TestQgsPrefetchingFeatureIterator::iterate()
+{
+  const QList< QgsFeatureId > expected = ids( mLayer->getFeatures() );
+  QCOMPARE( expected.count(), 1000 );
+
+  QCOMPARE( ids( prefetchingIterator() ), expected );
+  // batch size larger than the number of features
+  QCOMPARE( ids( prefetchingIterator( QgsFeatureRequest(), 5000, 1 ) ), expected );
+  // batch size matching the number of features
+  QCOMPARE( ids( prefetchingIterator( QgsFeatureRequest(), 1000, 1 ) ), expected );
+
+  // attributes and geometries are passed through
+  QgsFeatureIterator it = prefetchingIterator();
+  QgsFeature feature;
+  int count = 0;
+  while ( it.nextFeature( feature ) )
+  {
+    QCOMPARE( feature.attribute( 0 ).toInt(), static_cast< int >( feature.geometry().asPoint().x() ) );
+    count++;
+  }
+  QCOMPARE( count, 1000 );
+}
+
+void TestQgsPrefetchingFeatureIterator::iterateRequest()
+{
+  // filters, ordering and limits are applied by the source's iterator
+  QgsFeatureRequest request;
+  request.setFilterExpression( QStringLiteral( "value % 3 = 0" ) );
+  request.addOrderBy( QStringLiteral( "value" ), false );
+  request.setLimit( 50 );
+
+  const QList< QgsFeatureId > expected = ids( mLayer->getFeatures( request ) );
+  QCOMPARE( expected.count(), 50 );
+  QCOMPARE( ids( prefetchingIterator( request ) ), expected );
+
+  request = QgsFeatureRequest().setFilterRect( QgsRectangle( 100.5, 100.5, 200.5, 200.5 ) );
+  QCOMPARE( ids( prefetchingIterator( request ) ), ids( mLayer->getFeatures( request ) ) );
+}
+
+void TestQgsPrefetchingFeatureIterator::rewind()
+{
+  const QList< QgsFeatureId > expected = ids( mLayer->getFeatures() );
+
+  QgsFeatureIterator it = prefetchingIterator();
+  QgsFeature feature;
+  for ( int i = 0; i < 20; ++i )
+    QVERIFY( it.nextFeature( feature ) );
+  QCOMPARE( feature.id(), expected.at( 19 ) );
+
+  QVERIFY( it.rewind() );
+  QCOMPARE( ids( it ), expected );
+
+  // rewinding after the end
+  QVERIFY( it.rewind() );
+  QCOMPARE( ids( it ), expected );
+}
+
+void TestQgsPrefetchingFeatureIterator::closeEarly()
+{
+  QgsFeatureIterator it = prefetchingIterator( QgsFeatureRequest(), 10, 1 );
+  QgsFeature feature;
+  QVERIFY( it.nextFeature( feature ) );
+
+  // the background fetch is blocked on the full queue, and must be stopped
+  QVERIFY( it.close() );
+  QVERIFY( !it.nextFeature( feature ) );
+
+  // destroying an iterator which was never read
+  {
+    QgsFeatureIterator unused = prefetchingIterator();
+  }
+}
+
+void TestQgsPrefetchingFeatureIterator::sourceException()
+{
+  // an exception thrown by the source's iterator ends the iteration, instead of blocking it
+  QAtomicPointer< QgsFeedback > interruptionChecker;
+  QgsFeatureIterator it( new QgsPrefetchingFeatureIterator( new TestFeatureSource( 100, 25, &interruptionChecker ), true, QgsFeatureRequest(), 10, 1 ) );
+  const QList< QgsFeatureId > fetched = ids( it );
+  QCOMPARE( fetched.count(), 20 );
+  QCOMPARE( fetched.first(), 0LL );
+  QCOMPARE( fetched.last(), 19LL );
+
+  // closing must not rethrow the exception
+  QVERIFY( it.rewind() );
+  QCOMPARE( ids( it ).count(), 20 );
+  it.close();
+}
+
+void TestQgsPrefetchingFeatureIterator::interruptionChecker()
+{
+  QAtomicPointer< QgsFeedback > sourceInterruptionChecker;
+  QgsFeatureIterator it( new QgsPrefetchingFeatureIterator( new TestFeatureSource( 100, -1, &sourceInterruptionChecker ), true, QgsFeatureRequest(), 10, 1 ) );
+
+  // set before iterating
+  QgsFeedback feedback1;
+  it.setInterruptionChecker( &feedback1 );
+  QgsFeature feature;
+  QVERIFY( it.nextFeature( feature ) );
+  QCOMPARE( sourceInterruptionChecker.loadAcquire(), &feedback1 );
+
+  // set while prefetching: the source's iterator gets it before fetching the next features
+  QgsFeedback feedback2;
+  it.setInterruptionChecker( &feedback2 );
+  int count = 1;
+  while ( it.nextFeature( feature ) )
+    count++;
+  QCOMPARE( count, 100 );
+  QCOMPARE( sourceInterruptionChecker.loadAcquire(), &feedback2 );
+}
+
+QGSTEST_MAIN( TestQgsPrefetchingFeatureIterator )
+#include "testqgsprefetchingfeatureiterator.moc"
@@ -31,6 +31,7 @@
 #include "qgsfillsymbollayer.h"
 #include "qgssinglesymbolrenderer.h"
 #include "qgsmarkersymbollayer.h"
+#include "qgsmarkersymbolatlas.h"
 
 #include "qgsstyle.h"
 
@@ -70,6 +71,8 @@ class TestQgsSymbol : public QObject
     void testParseColor();
     void testParseColorList();
     void symbolProperties();
+    void markerAtlas();
+    void markerAtlasRender();
 };
 
 TestQgsSymbol::TestQgsSymbol() = default;
@@ -453,5 +456,132 @@ void TestQgsSymbol::symbolProperties()
   delete fillSymbol2;
 }
 
+void TestQgsSymbol::markerAtlas()
+{
+  QgsMarkerSymbol symbol;
+  symbol.appendSymbolLayer( new QgsSimpleMarkerSymbolLayer( QgsSimpleMarkerSymbolLayerBase::Triangle, 4 ) );
+  symbol.symbolLayer( 1 )->setDataDefinedProperty( QgsSymbolLayer::PropertyAngle, QgsProperty::fromExpression( QStringLiteral( "\"angle\"" ) ) );
+
+  QImage image( 100, 100, QImage::Format_ARGB32_Premultiplied );
+  image.fill( Qt::transparent );
+  QPainter painter( &image );
+  QgsRenderContext context = QgsRenderContext::fromQPainter( &painter );
+  QVERIFY( QgsMarkerSymbolAtlas::canUseAtlas( &symbol, context ) );
+  QVERIFY( QgsMarkerSymbolAtlas::painterSupportsAtlas( context ) );
+
+  // must always render vectors when requested
+  context.setFlag( QgsRenderContext::ForceVectorOutput, true );
+  QVERIFY( !QgsMarkerSymbolAtlas::canUseAtlas( &symbol, context ) );
+  context.setFlag( QgsRenderContext::ForceVectorOutput, false );
+
+  // data defined properties other than rotation can't be rasterized
+  symbol.symbolLayer( 0 )->setDataDefinedProperty( QgsSymbolLayer::PropertySize, QgsProperty::fromValue( 5 ) );
+  QVERIFY( !QgsMarkerSymbolAtlas::canUseAtlas( &symbol, context ) );
+  symbol.symbolLayer( 0 )->setDataDefinedProperty( QgsSymbolLayer::PropertySize, QgsProperty() );
+  QVERIFY( QgsMarkerSymbolAtlas::canUseAtlas( &symbol, context ) );
+
+  // markers can't be drawn from images by a rotated painter
+  painter.rotate( 45 );
+  QVERIFY( !QgsMarkerSymbolAtlas::painterSupportsAtlas( context ) );
+  painter.resetTransform();
+
+  // rotations are bucketed
+  QgsFields fields;
+  fields.append( QgsField( QStringLiteral( "angle" ), QVariant::Double ) );
+  QgsFeature f( fields );
+  QgsExpressionContextScope *scope = new QgsExpressionContextScope();
+  context.expressionContext().appendScope( scope );
+  f.setAttributes( QgsAttributes() << 10.0 );
+  scope->setFeature( f );
+  const QVector< qint64 > key = QgsMarkerSymbolAtlas::markerKey( symbol.symbolLayers(), context, -1, false );
+  f.setAttributes( QgsAttributes() << 10.1 );
+  scope->setFeature( f );
+  QCOMPARE( QgsMarkerSymbolAtlas::markerKey( symbol.symbolLayers(), context, -1, false ), key );
+  QVERIFY( QgsMarkerSymbolAtlas::markerKey( symbol.symbolLayers(), context, -1, true ) != key );
+  QVERIFY( QgsMarkerSymbolAtlas::markerKey( symbol.symbolLayers(), context, 0, false ) != key );
+  f.setAttributes( QgsAttributes() << 370.0 );
+  scope->setFeature( f );
+  QCOMPARE( QgsMarkerSymbolAtlas::markerKey( symbol.symbolLayers(), context, -1, false ), key );
+  f.setAttributes( QgsAttributes() << 11.0 );
+  scope->setFeature( f );
+  QVERIFY( QgsMarkerSymbolAtlas::markerKey( symbol.symbolLayers(), context, -1, false ) != key );
+
+  // rendering from the atlas must draw the marker at each point
+  symbol.startRender( context, fields );
+  symbol.renderPoint( QPointF( 20, 20 ), &f, context );
+  symbol.renderPoint( QPointF( 80, 80 ), &f, context );
+  symbol.stopRender( context );
+  painter.end();
+
+  QVERIFY( qAlpha( image.pixel( 20, 20 ) ) > 0 );
+  QVERIFY( qAlpha( image.pixel( 80, 80 ) ) > 0 );
+  QCOMPARE( qAlpha( image.pixel( 50, 50 ) ), 0 );
+  QCOMPARE( image.copy( 10, 10, 20, 20 ), image.copy( 70, 70, 20, 20 ) );
+}
+
+void TestQgsSymbol::markerAtlasRender()
+{
+  // markers drawn from the atlas must look the same as markers rendered as vectors
+  QgsMarkerSymbol symbol;
+  symbol.symbolLayer( 0 )->setDataDefinedProperty( QgsSymbolLayer::PropertyAngle, QgsProperty::fromExpression( QStringLiteral( "\"angle\" / 2" ) ) );
+  QgsSimpleMarkerSymbolLayer *triangle = new QgsSimpleMarkerSymbolLayer( QgsSimpleMarkerSymbolLayerBase::Triangle, 4 );
+  triangle->setColor( QColor( 0, 0, 255, 150 ) );
+  triangle->setDataDefinedProperty( QgsSymbolLayer::PropertyAngle, QgsProperty::fromExpression( QStringLiteral( "\"angle\"" ) ) );
+  symbol.appendSymbolLayer( triangle );
+  static_cast< QgsSimpleMarkerSymbolLayer * >( symbol.symbolLayer( 0 ) )->setShape( QgsSimpleMarkerSymbolLayerBase::Star );
+
+  QgsFields fields;
+  fields.append( QgsField( QStringLiteral( "angle" ), QVariant::Double ) );
+
+  auto render = [&symbol, &fields]( bool forceVector ) -> QImage
+  {
+    QImage image( 200, 200, QImage::Format_ARGB32_Premultiplied );
+    image.fill( Qt::white );
+    QPainter painter( &image );
+    painter.setRenderHint( QPainter::Antialiasing, true );
+    QgsRenderContext context = QgsRenderContext::fromQPainter( &painter );
+    context.setFlag( QgsRenderContext::Antialiasing, true );
+    context.setFlag( QgsRenderContext::ForceVectorOutput, forceVector );
+    QgsExpressionContextScope *scope = new QgsExpressionContextScope();
+    context.expressionContext().appendScope( scope );
+
+    symbol.startRender( context, fields );
+    QgsFeature f( fields );
+    for ( int i = 0; i < 81; ++i )
+    {
+      // repeating rotations, so that most markers are drawn from existing atlas entries
+      f.setAttributes( QgsAttributes() << ( i % 7 ) * 45.0 );
+      scope->setFeature( f );
+      symbol.renderPoint( QPointF( 20 + ( i % 9 ) * 20, 20 + ( i / 9 ) * 20 ), &f, context );
+    }
+    symbol.stopRender( context );
+    painter.end();
+    return image;
+  };
+
+  const QImage vectorImage = render( true );
+  const QImage atlasImage = render( false );
+  QCOMPARE( atlasImage.size(), vectorImage.size() );
+
+  // allow for rounding differences from compositing the markers in a separate image
+  int maxDifference = 0;
+  for ( int y = 0; y < vectorImage.height(); ++y )
+  {
+    for ( int x = 0; x < vectorImage.width(); ++x )
+    {
+      const QRgb p1 = vectorImage.pixel( x, y );
+      const QRgb p2 = atlasImage.pixel( x, y );
+      maxDifference = std::max( { maxDifference, std::abs( qRed( p1 ) - qRed( p2 ) ), std::abs( qGreen( p1 ) - qGreen( p2 ) ),
+                                  std::abs( qBlue( p1 ) - qBlue( p2 ) ), std::abs( qAlpha( p1 ) - qAlpha( p2 ) )
+                                } );
+    }
+  }
+  QVERIFY2( maxDifference <= 3, QStringLiteral( "Maximum pixel difference %1" ).arg( maxDifference ).toLocal8Bit().constData() );
+
+  // and markers were actually drawn
+  QVERIFY( atlasImage.pixel( 20, 20 ) != qRgb( 255, 255, 255 ) );
+  QCOMPARE( atlasImage.pixel( 30, 30 ), qRgb( 255, 255, 255 ) );
+}
+
 QGSTEST_MAIN( TestQgsSymbol )
 #include "testqgssymbol.moc"
@@ -0,0 +1,175 @@
+/***************************************************************************
+     testqgstextpathcache.cpp
+     ------------------------
+    Date                 : October 2026
+    Copyright            : (C) 2026 by agent
+    Email                : agent at local
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#include "qgstest.h"
+#include <QObject>
+#include <QFont>
+#include <QFontMetricsF>
+#include <QPainterPath>
+#include "qgstextrenderer_p.h"
+#include "qgsapplication.h"
+#include "qgsfontutils.h"
+
+/**
+ * \ingroup UnitTests
+ * This is a unit test for QgsTextPathCache.
+ */
+class TestQgsTextPathCache : public QObject
+{
+    Q_OBJECT
+
+  private slots:
+    void initTestCase();// will be called before the first testfunction is executed.
+    void cleanupTestCase();// will be called after the last testfunction was executed.
+    void init();// will be called before each testfunction is executed.
+    void horizontalPaths();
+    void verticalPaths();
+
+  private:
+
+    //! Returns the outline of \a text in \a font, without using the cache
+    static QPainterPath uncachedPath( const QFont &font, const QString &text );
+
+    //! Compares two paths element by element
+    static bool pathsEqual( const QPainterPath &path1, const QPainterPath &path2 );
+
+    QFont mFont;
+};
+
+void TestQgsTextPathCache::initTestCase()
+{
+  QgsApplication::init();
+  QgsApplication::initQgis();
+  QgsFontUtils::loadStandardTestFonts( QStringList() << QStringLiteral( "Bold" ) );
+  mFont = QgsFontUtils::getStandardTestFont( QStringLiteral( "Bold" ) );
+  mFont.setPixelSize( 20 );
+}
+
+void TestQgsTextPathCache::cleanupTestCase()
+{
+  QgsApplication::exitQgis();
+}
+
+void TestQgsTextPathCache::init()
+{
+  QgsTextPathCache::clear();
+}
+
+QPainterPath TestQgsTextPathCache::uncachedPath( const QFont &font, const QString &text )
+{
+  QPainterPath path;
+  path.setFillRule( Qt::WindingFill );
+  path.addText( 0, 0, font, text );
+  return path;
+}
+
+bool TestQgsTextPathCache::pathsEqual( const QPainterPath &path1, const QPainterPath &path2 )
+{
+  if ( path1.elementCount() != path2.elementCount() )
+    return false;
+
+  for ( int i = 0; i < path1.elementCount(); ++i )
+  {
+    const QPainterPath::Element e1 = path1.elementAt( i );
+    const QPainterPath::Element e2 = path2.elementAt( i );
+    if ( e1.type != e2.type || !qgsDoubleNear( e1.x, e2.x ) || !qgsDoubleNear( e1.y, e2.y ) )
+      return false;
+  }
+  return true;
+}
+
+void TestQgsTextPathCache::horizontalPaths()
+{
+  const QString text = QStringLiteral( "abc def" );
+
+  // cached paths must be identical to the path created without the cache
+  QVERIFY( pathsEqual( QgsTextPathCache::horizontalTextPath( mFont, text ), uncachedPath( mFont, text ) ) );
+  QVERIFY( pathsEqual( QgsTextPathCache::horizontalTextPath( mFont, text ), uncachedPath( mFont, text ) ) );
+  QVERIFY( !pathsEqual( QgsTextPathCache::horizontalTextPath( mFont, QStringLiteral( "abc" ) ), uncachedPath( mFont, text ) ) );
+
+  // every font property which affects the outline must be part of the key, so that a path cached for one
+  // font is never returned for another
+  QFont font = mFont;
+  font.setPixelSize( 30 );
+  QVERIFY( pathsEqual( QgsTextPathCache::horizontalTextPath( font, text ), uncachedPath( font, text ) ) );
+
+  font = mFont;
+  font.setLetterSpacing( QFont::AbsoluteSpacing, 5 );
+  const QPainterPath spacedPath = QgsTextPathCache::horizontalTextPath( font, text );
+  QVERIFY( pathsEqual( spacedPath, uncachedPath( font, text ) ) );
+  QVERIFY( spacedPath.boundingRect().width() > QgsTextPathCache::horizontalTextPath( mFont, text ).boundingRect().width() );
+
+  font.setLetterSpacing( QFont::PercentageSpacing, 150 );
+  QVERIFY( pathsEqual( QgsTextPathCache::horizontalTextPath( font, text ), uncachedPath( font, text ) ) );
+
+  font = mFont;
+  font.setWordSpacing( 10 );
+  QVERIFY( pathsEqual( QgsTextPathCache::horizontalTextPath( font, text ), uncachedPath( font, text ) ) );
+
+  font = mFont;
+  font.setCapitalization( QFont::AllUppercase );
+  const QPainterPath upperPath = QgsTextPathCache::horizontalTextPath( font, text );
+  QVERIFY( pathsEqual( upperPath, uncachedPath( font, text ) ) );
+  QVERIFY( !pathsEqual( upperPath, QgsTextPathCache::horizontalTextPath( mFont, text ) ) );
+
+  font.setCapitalization( QFont::SmallCaps );
+  QVERIFY( pathsEqual( QgsTextPathCache::horizontalTextPath( font, text ), uncachedPath( font, text ) ) );
+
+  font = mFont;
+  font.setStretch( 150 );
+  QVERIFY( pathsEqual( QgsTextPathCache::horizontalTextPath( font, text ), uncachedPath( font, text ) ) );
+
+  // after clearing the cache paths are still correct
+  QgsTextPathCache::clear();
+  QVERIFY( pathsEqual( QgsTextPathCache::horizontalTextPath( mFont, text ), uncachedPath( mFont, text ) ) );
+
+  // long text is not cached, but must still be rendered
+  const QString longText = QString( 300, 'x' );
+  QVERIFY( pathsEqual( QgsTextPathCache::horizontalTextPath( mFont, longText ), uncachedPath( mFont, longText ) ) );
+}
+
+void TestQgsTextPathCache::verticalPaths()
+{
+  const QString text = QStringLiteral( "abc" );
+  const QFontMetricsF metrics( mFont );
+  const QPainterPath path = QgsTextPathCache::verticalTextPath( mFont, text, metrics );
+  QVERIFY( !path.isEmpty() );
+  // graphemes are stacked vertically
+  QVERIFY( path.boundingRect().height() > 2 * metrics.ascent() );
+  QVERIFY( pathsEqual( QgsTextPathCache::verticalTextPath( mFont, text, metrics ), path ) );
+
+  // the layout depends on the metrics, which may come from a different paint device than the font's
+  QFont largerFont = mFont;
+  largerFont.setPixelSize( 40 );
+  const QFontMetricsF largerMetrics( largerFont );
+  const QPainterPath largerPath = QgsTextPathCache::verticalTextPath( mFont, text, largerMetrics );
+  QVERIFY( largerPath.boundingRect().height() > path.boundingRect().height() );
+
+  // letter spacing changes the vertical distance between the graphemes
+  QFont spacedFont = mFont;
+  spacedFont.setLetterSpacing( QFont::AbsoluteSpacing, 10 );
+  const QPainterPath spacedPath = QgsTextPathCache::verticalTextPath( spacedFont, text, QFontMetricsF( spacedFont ) );
+  QVERIFY( spacedPath.boundingRect().height() > path.boundingRect().height() );
+
+  // capitalization
+  QFont upperFont = mFont;
+  upperFont.setCapitalization( QFont::AllUppercase );
+  QVERIFY( !pathsEqual( QgsTextPathCache::verticalTextPath( upperFont, text, QFontMetricsF( upperFont ) ), path ) );
+
+  // horizontal and vertical paths for the same font and text must not collide
+  QVERIFY( !pathsEqual( QgsTextPathCache::horizontalTextPath( mFont, text ), path ) );
+}
+
+QGSTEST_MAIN( TestQgsTextPathCache )
+#include "testqgstextpathcache.moc"
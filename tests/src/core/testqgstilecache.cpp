@@ -0,0 +1,227 @@
+/***************************************************************************
+     testqgstilecache.cpp
+     --------------------
+    Date                 : October 2026
+    Copyright            : (C) 2026 by agent
+    Email                : agent at local
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#include "qgstest.h"
+#include <QObject>
+#include <QBuffer>
+#include <QDateTime>
+#include <QImage>
+#include <QTemporaryDir>
+#include <QUrl>
+#include "qgstilecache.h"
+#include "qgsapplication.h"
+
+/**
+ * \ingroup UnitTests
+ * This is a unit test for QgsTileCache.
+ */
+class TestQgsTileCache : public QObject
+{
+    Q_OBJECT
+
+  private slots:
+    void initTestCase();// will be called before the first testfunction is executed.
+    void cleanupTestCase();// will be called after the last testfunction was executed.
+    void init();// will be called before each testfunction is executed.
+    void memoryCache();
+    void compressedCache();
+    void diskCache();
+    void diskCacheExpiry();
+    void diskCachePruning();
+
+  private:
+
+    static QImage tileImage( const QColor &color );
+    //! Returns a tile filled with noise, which does not compress well
+    static QImage noiseImage( int seed );
+    static QByteArray encode( const QImage &image );
+
+    //! Fills the decoded image cache with other tiles, so that previously inserted tiles are evicted
+    static void evictDecodedTiles();
+
+    QTemporaryDir mTempDir;
+};
+
+void TestQgsTileCache::initTestCase()
+{
+  QgsApplication::init();
+  QgsApplication::initQgis();
+}
+
+void TestQgsTileCache::cleanupTestCase()
+{
+  QgsApplication::exitQgis();
+}
+
+void TestQgsTileCache::init()
+{
+  // room for four 256x256 ARGB tiles
+  QgsTileCache::setMaxCost( 1024 );
+  QgsTileCache::setMaxCompressedCost( 0 );
+  QgsTileCache::setDiskCache( QString(), 0 );
+}
+
+QImage TestQgsTileCache::tileImage( const QColor &color )
+{
+  QImage image( 256, 256, QImage::Format_ARGB32 );
+  image.fill( color );
+  return image;
+}
+
+QImage TestQgsTileCache::noiseImage( int seed )
+{
+  QImage image( 256, 256, QImage::Format_ARGB32 );
+  quint32 value = static_cast< quint32 >( seed ) * 2654435761u + 1;
+  for ( int y = 0; y < image.height(); ++y )
+  {
+    for ( int x = 0; x < image.width(); ++x )
+    {
+      value = value * 1664525u + 1013904223u;
+      image.setPixel( x, y, value | 0xff000000 );
+    }
+  }
+  return image;
+}
+
+QByteArray TestQgsTileCache::encode( const QImage &image )
+{
+  QByteArray data;
+  QBuffer buffer( &data );
+  buffer.open( QIODevice::WriteOnly );
+  image.save( &buffer, "PNG" );
+  return data;
+}
+
+void TestQgsTileCache::evictDecodedTiles()
+{
+  for ( int i = 0; i < 5; ++i )
+    QgsTileCache::insertTile( QUrl( QStringLiteral( "http://qgis.org/evict/%1.png" ).arg( i ) ), tileImage( Qt::black ) );
+}
+
+void TestQgsTileCache::memoryCache()
+{
+  const QUrl url( QStringLiteral( "http://qgis.org/memory/1.png" ) );
+  QgsTileCache::insertTile( url, tileImage( Qt::red ) );
+  QCOMPARE( QgsTileCache::totalCost(), 256 );
+
+  QImage image;
+  QVERIFY( QgsTileCache::tile( url, image ) );
+  QCOMPARE( image.pixelColor( 10, 10 ), QColor( Qt::red ) );
+
+  // without encoded data, an evicted tile is lost
+  evictDecodedTiles();
+  QVERIFY( QgsTileCache::totalCost() <= QgsTileCache::maxCost() );
+  QVERIFY( !QgsTileCache::tile( url, image ) );
+}
+
+void TestQgsTileCache::compressedCache()
+{
+  QgsTileCache::setMaxCompressedCost( 1024 );
+
+  const QUrl url( QStringLiteral( "http://qgis.org/compressed/1.png" ) );
+  const QImage tile = tileImage( Qt::green );
+  QgsTileCache::insertTile( url, tile, encode( tile ) );
+
+  evictDecodedTiles();
+
+  QImage image;
+  QVERIFY( QgsTileCache::tile( url, image ) );
+  QCOMPARE( image.pixelColor( 10, 10 ), QColor( Qt::green ) );
+
+  // without the compressed cache, the tile is lost
+  QgsTileCache::setMaxCompressedCost( 0 );
+  evictDecodedTiles();
+  QVERIFY( !QgsTileCache::tile( url, image ) );
+}
+
+void TestQgsTileCache::diskCache()
+{
+  const QString path = mTempDir.filePath( QStringLiteral( "tilecache.sqlite" ) );
+  QgsTileCache::setDiskCache( path, 1 );
+
+  const QUrl url( QStringLiteral( "http://qgis.org/disk/1.png" ) );
+  const QImage tile = tileImage( Qt::blue );
+  QgsTileCache::insertTile( url, tile, encode( tile ) );
+
+  evictDecodedTiles();
+
+  QImage image;
+  QVERIFY( QgsTileCache::tile( url, image ) );
+  QCOMPARE( image.pixelColor( 10, 10 ), QColor( Qt::blue ) );
+
+  // tiles are kept when the disk cache is reopened
+  QgsTileCache::setDiskCache( path, 1 );
+  evictDecodedTiles();
+  QVERIFY( QgsTileCache::tile( url, image ) );
+  QCOMPARE( image.pixelColor( 10, 10 ), QColor( Qt::blue ) );
+
+  // disabling the disk cache loses the tile
+  QgsTileCache::setDiskCache( QString(), 0 );
+  evictDecodedTiles();
+  QVERIFY( !QgsTileCache::tile( url, image ) );
+}
+
+void TestQgsTileCache::diskCacheExpiry()
+{
+  const QString path = mTempDir.filePath( QStringLiteral( "tilecache_expiry.sqlite" ) );
+  QgsTileCache::setDiskCache( path, 1 );
+
+  const QUrl expiredUrl( QStringLiteral( "http://qgis.org/expiry/expired.png" ) );
+  const QUrl validUrl( QStringLiteral( "http://qgis.org/expiry/valid.png" ) );
+  const QUrl defaultUrl( QStringLiteral( "http://qgis.org/expiry/default.png" ) );
+  const QImage tile = tileImage( Qt::yellow );
+  QgsTileCache::insertTile( expiredUrl, tile, encode( tile ), QDateTime::currentDateTime().addSecs( -60 ) );
+  QgsTileCache::insertTile( validUrl, tile, encode( tile ), QDateTime::currentDateTime().addSecs( 3600 ) );
+  // without an expiry date, tiles expire after the default expiry
+  QgsTileCache::insertTile( defaultUrl, tile, encode( tile ) );
+
+  evictDecodedTiles();
+
+  QImage image;
+  QVERIFY( !QgsTileCache::tile( expiredUrl, image ) );
+  QVERIFY( QgsTileCache::tile( validUrl, image ) );
+  QCOMPARE( image.pixelColor( 10, 10 ), QColor( Qt::yellow ) );
+  QVERIFY( QgsTileCache::tile( defaultUrl, image ) );
+
+  // expired tiles are not kept when the disk cache is reopened either
+  QgsTileCache::setDiskCache( path, 1 );
+  evictDecodedTiles();
+  QVERIFY( !QgsTileCache::tile( expiredUrl, image ) );
+  QVERIFY( QgsTileCache::tile( validUrl, image ) );
+}
+
+void TestQgsTileCache::diskCachePruning()
+{
+  const QString path = mTempDir.filePath( QStringLiteral( "tilecache_pruning.sqlite" ) );
+  QgsTileCache::setDiskCache( path, 1 );
+
+  // each tile is more than 256 KB, so the 1 MB cache can't hold them all
+  const int tileCount = 8;
+  for ( int i = 0; i < tileCount; ++i )
+  {
+    const QImage tile = noiseImage( i );
+    QgsTileCache::insertTile( QUrl( QStringLiteral( "http://qgis.org/pruning/%1.png" ).arg( i ) ), tile, encode( tile ) );
+  }
+
+  evictDecodedTiles();
+
+  // the least recently used tiles have been removed, the last ones are kept
+  QImage image;
+  QVERIFY( !QgsTileCache::tile( QUrl( QStringLiteral( "http://qgis.org/pruning/0.png" ) ), image ) );
+  QVERIFY( QgsTileCache::tile( QUrl( QStringLiteral( "http://qgis.org/pruning/%1.png" ).arg( tileCount - 1 ) ), image ) );
+  QCOMPARE( image.pixel( 10, 10 ), noiseImage( tileCount - 1 ).pixel( 10, 10 ) );
+}
+
+QGSTEST_MAIN( TestQgsTileCache )
+#include "testqgstilecache.moc"
@@ -0,0 +1,211 @@
+/***************************************************************************
+     testqgswkbgeometryview.cpp
+     --------------------------------------
+    Date                 : October 2026
+    Copyright            : (C) 2026 by agent
+    Email                : agent at local
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#include "qgstest.h"
+
+#include <QDataStream>
+
+//qgis includes...
+#include "qgswkbgeometryview.h"
+#include "qgsgeometry.h"
+#include "qgsabstractgeometry.h"
+#include "qgspoint.h"
+
+class TestQgsWkbGeometryView : public QObject
+{
+    Q_OBJECT
+
+  private slots:
+    void initTestCase();// will be called before the first testfunction is executed.
+    void cleanupTestCase();// will be called after the last testfunction was executed.
+    void matchesGeometry_data();
+    void matchesGeometry();
+    void invalid();
+    void trailingBytes();
+    void visitVertices();
+    void bigEndian();
+    void lazyGeometry();
+};
+
+void TestQgsWkbGeometryView::initTestCase()
+{
+  QgsApplication::init();
+  QgsApplication::initQgis();
+}
+
+void TestQgsWkbGeometryView::cleanupTestCase()
+{
+  QgsApplication::exitQgis();
+}
+
+void TestQgsWkbGeometryView::matchesGeometry_data()
+{
+  QTest::addColumn<QString>( "wkt" );
+
+  QTest::newRow( "point" ) << QStringLiteral( "Point (1 2)" );
+  QTest::newRow( "point zm" ) << QStringLiteral( "PointZM (1 2 3 4)" );
+  QTest::newRow( "linestring" ) << QStringLiteral( "LineString (1 2, 5 -3, -4 8)" );
+  QTest::newRow( "linestring z" ) << QStringLiteral( "LineStringZ (1 2 3, 5 -3 4, -4 8 5)" );
+  QTest::newRow( "empty linestring" ) << QStringLiteral( "LineString EMPTY" );
+  QTest::newRow( "polygon" ) << QStringLiteral( "Polygon ((0 0, 10 0, 10 10, 0 10, 0 0),(2 2, 3 2, 3 3, 2 2))" );
+  QTest::newRow( "polygon m" ) << QStringLiteral( "PolygonM ((0 0 1, 10 0 2, 10 10 3, 0 0 1))" );
+  QTest::newRow( "empty polygon" ) << QStringLiteral( "Polygon EMPTY" );
+  QTest::newRow( "multipoint" ) << QStringLiteral( "MultiPoint ((1 2),(-3 7))" );
+  QTest::newRow( "multilinestring z" ) << QStringLiteral( "MultiLineStringZ ((1 2 3, 4 5 6),(-1 -2 -3, 0 0 0))" );
+  QTest::newRow( "multipolygon" ) << QStringLiteral( "MultiPolygon (((0 0, 1 0, 1 1, 0 0)),((5 5, 8 5, 8 9, 5 5)))" );
+  QTest::newRow( "empty multipolygon" ) << QStringLiteral( "MultiPolygon EMPTY" );
+  QTest::newRow( "collection" ) << QStringLiteral( "GeometryCollection (Point (1 2),LineString (3 4, 5 6),MultiPolygon (((0 0, -1 0, -1 -1, 0 0))))" );
+}
+
+void TestQgsWkbGeometryView::matchesGeometry()
+{
+  QFETCH( QString, wkt );
+
+  const QgsGeometry geom = QgsGeometry::fromWkt( wkt );
+  QVERIFY( !geom.isNull() );
+  const QByteArray wkb = geom.asWkb();
+
+  QgsWkbGeometryView view( wkb );
+  QVERIFY( view.isValid() );
+  QVERIFY( view.isNativeEndian() );
+  QCOMPARE( view.wkbSize(), wkb.size() );
+  QCOMPARE( view.wkb(), wkb );
+  QCOMPARE( view.wkbType(), geom.constGet()->wkbType() );
+  QCOMPARE( view.vertexCount(), geom.constGet()->nCoordinates() );
+  QCOMPARE( view.boundingBox(), geom.constGet()->boundingBox() );
+
+  std::unique_ptr< QgsAbstractGeometry > materialized = view.toGeometry();
+  QVERIFY( materialized );
+  QCOMPARE( materialized->asWkt(), geom.constGet()->asWkt() );
+}
+
+void TestQgsWkbGeometryView::invalid()
+{
+  QVERIFY( !QgsWkbGeometryView().isValid() );
+  QVERIFY( !QgsWkbGeometryView( QByteArray() ).isValid() );
+  QCOMPARE( QgsWkbGeometryView().wkb(), QByteArray() );
+
+  // truncated
+  QByteArray wkb = QgsGeometry::fromWkt( QStringLiteral( "LineString (1 2, 3 4)" ) ).asWkb();
+  QVERIFY( !QgsWkbGeometryView( wkb.left( wkb.size() - 1 ) ).isValid() );
+  QVERIFY( !QgsWkbGeometryView( wkb.left( 3 ) ).isValid() );
+
+  // bad byte order marker
+  wkb[0] = 5;
+  QVERIFY( !QgsWkbGeometryView( wkb ).isValid() );
+
+  // curves are not supported
+  QVERIFY( !QgsWkbGeometryView( QgsGeometry::fromWkt( QStringLiteral( "CircularString (0 0, 1 1, 2 0)" ) ).asWkb() ).isValid() );
+  QVERIFY( !QgsWkbGeometryView( QgsGeometry::fromWkt( QStringLiteral( "GeometryCollection (Point (1 2), CircularString (0 0, 1 1, 2 0))" ) ).asWkb() ).isValid() );
+
+  // multi types with 25D parts change type when parsed, so must not be handled by the view
+  QByteArray multi25D;
+  QDataStream stream( &multi25D, QIODevice::WriteOnly );
+  stream.setByteOrder( QDataStream::BigEndian );
+  stream << static_cast< quint8 >( QgsApplication::XDR ) << static_cast< quint32 >( QgsWkbTypes::MultiPoint25D ) << static_cast< quint32 >( 1 )
+         << static_cast< quint8 >( QgsApplication::XDR ) << static_cast< quint32 >( QgsWkbTypes::Point25D ) << 1.0 << 2.0 << 3.0;
+  QVERIFY( !QgsWkbGeometryView( multi25D ).isValid() );
+  QgsGeometry geom;
+  geom.fromWkb( multi25D );
+  QCOMPARE( geom.wkbType(), QgsWkbTypes::MultiPointZ );
+}
+
+void TestQgsWkbGeometryView::trailingBytes()
+{
+  const QByteArray wkb = QgsGeometry::fromWkt( QStringLiteral( "Point (1 2)" ) ).asWkb();
+  QgsWkbGeometryView view( wkb + QByteArray( 5, 'x' ) );
+  QVERIFY( view.isValid() );
+  QCOMPARE( view.wkbSize(), wkb.size() );
+  QCOMPARE( view.wkb(), wkb );
+}
+
+void TestQgsWkbGeometryView::visitVertices()
+{
+  QgsWkbGeometryView view( QgsGeometry::fromWkt( QStringLiteral( "GeometryCollection (PointZ (1 2 3),Polygon ((0 0, 1 0, 1 1, 0 0)))" ) ).asWkb() );
+  QVERIFY( view.isValid() );
+
+  QVector< QgsPointXY > vertices;
+  view.visitVertices( [&vertices]( double x, double y ) { vertices << QgsPointXY( x, y ); } );
+  QCOMPARE( vertices.size(), view.vertexCount() );
+  QCOMPARE( vertices, QVector< QgsPointXY >() << QgsPointXY( 1, 2 ) << QgsPointXY( 0, 0 ) << QgsPointXY( 1, 0 ) << QgsPointXY( 1, 1 ) << QgsPointXY( 0, 0 ) );
+}
+
+void TestQgsWkbGeometryView::bigEndian()
+{
+  QByteArray wkb;
+  QDataStream stream( &wkb, QIODevice::WriteOnly );
+  stream.setByteOrder( QDataStream::BigEndian );
+  stream << static_cast< quint8 >( QgsApplication::XDR ) << static_cast< quint32 >( QgsWkbTypes::LineString ) << static_cast< quint32 >( 2 )
+         << 1.0 << 2.0 << -3.0 << 4.0;
+
+  QgsWkbGeometryView view( wkb );
+  QVERIFY( view.isValid() );
+  QCOMPARE( view.isNativeEndian(), QgsApplication::endian() == QgsApplication::XDR );
+  QCOMPARE( view.wkbType(), QgsWkbTypes::LineString );
+  QCOMPARE( view.boundingBox(), QgsRectangle( -3, 2, 1, 4 ) );
+
+  // geometry must always return native endian WKB
+  QgsGeometry geom;
+  geom.fromWkb( wkb );
+  QCOMPARE( geom.boundingBox(), QgsRectangle( -3, 2, 1, 4 ) );
+  QCOMPARE( geom.asWkb(), QgsGeometry::fromWkt( QStringLiteral( "LineString (1 2, -3 4)" ) ).asWkb() );
+}
+
+void TestQgsWkbGeometryView::lazyGeometry()
+{
+  const QByteArray wkb = QgsGeometry::fromWkt( QStringLiteral( "Polygon ((0 0, 10 0, 10 10, 0 10, 0 0))" ) ).asWkb();
+
+  QgsGeometry geom;
+  geom.fromWkb( wkb );
+  QVERIFY( !geom.isNull() );
+  QCOMPARE( geom.wkbType(), QgsWkbTypes::Polygon );
+  QCOMPARE( geom.type(), QgsWkbTypes::PolygonGeometry );
+  QVERIFY( !geom.isMultipart() );
+  QCOMPARE( geom.boundingBox(), QgsRectangle( 0, 0, 10, 10 ) );
+  QVERIFY( geom.boundingBoxIntersects( QgsRectangle( 5, 5, 15, 15 ) ) );
+  QCOMPARE( geom.asWkb(), wkb );
+  QCOMPARE( geom.asWkt(), QStringLiteral( "Polygon ((0 0, 10 0, 10 10, 0 10, 0 0))" ) );
+
+  // modifying a copy must not affect the original, and must invalidate the copy's WKB
+  QgsGeometry copy = geom;
+  QVERIFY( copy.moveVertex( 20, 20, 2 ) );
+  QCOMPARE( copy.boundingBox(), QgsRectangle( 0, 0, 20, 20 ) );
+  QCOMPARE( copy.asWkt(), QStringLiteral( "Polygon ((0 0, 10 0, 20 20, 0 10, 0 0))" ) );
+  QCOMPARE( geom.boundingBox(), QgsRectangle( 0, 0, 10, 10 ) );
+  QCOMPARE( geom.asWkb(), wkb );
+
+  // modifying in place
+  QVERIFY( geom.moveVertex( -5, 0, 0 ) );
+  QCOMPARE( geom.boundingBox(), QgsRectangle( -5, 0, 10, 10 ) );
+  QVERIFY( geom.asWkb() != wkb );
+
+  geom.fromWkb( wkb );
+  geom.get()->transform( QTransform::fromTranslate( 100, 0 ) );
+  QCOMPARE( geom.boundingBox(), QgsRectangle( 100, 0, 110, 10 ) );
+
+  // invalid WKB still results in the same geometry as before
+  geom.fromWkb( QByteArray( "xx" ) );
+  QVERIFY( geom.isNull() );
+  geom.fromWkb( QgsGeometry::fromWkt( QStringLiteral( "CircularString (0 0, 1 1, 2 0)" ) ).asWkb() );
+  QCOMPARE( geom.wkbType(), QgsWkbTypes::CircularString );
+
+  QgsGeometry fromRaw;
+  unsigned char *buffer = new unsigned char[wkb.size()];
+  memcpy( buffer, wkb.constData(), wkb.size() );
+  fromRaw.fromWkb( buffer, wkb.size() );
+  QCOMPARE( fromRaw.asWkt(), QStringLiteral( "Polygon ((0 0, 10 0, 10 10, 0 10, 0 0))" ) );
+}
+
+QGSTEST_MAIN( TestQgsWkbGeometryView )
+#include "testqgswkbgeometryview.moc"
@@ -14,9 +14,73 @@
  ***************************************************************************/
 #include <QFile>
 #include <QObject>
+#include <QBuffer>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QUuid>
 #include "qgstest.h"
 #include <qgswmsprovider.h>
 #include <qgsapplication.h>
+#include <qgsnetworkaccessmanager.h>
+
+/**
+ * Minimal HTTP server, answering any request with a red PNG tile. Requests
+ * to paths starting with "/redirect" are redirected to the same path without
+ * that prefix.
+ */
+class TestTileServer
+{
+  public:
+    TestTileServer()
+    {
+      QImage tile( 256, 256, QImage::Format_ARGB32 );
+      tile.fill( Qt::red );
+      QBuffer buffer( &mTile );
+      buffer.open( QIODevice::WriteOnly );
+      tile.save( &buffer, "PNG" );
+
+      QObject::connect( &mServer, &QTcpServer::newConnection, &mServer, [ = ]
+      {
+        while ( QTcpSocket *socket = mServer.nextPendingConnection() )
+        {
+          QObject::connect( socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater );
+          QObject::connect( socket, &QTcpSocket::readyRead, socket, [ = ]
+          {
+            if ( !socket->peek( socket->bytesAvailable() ).contains( "\r\n\r\n" ) )
+              return; // wait for the complete request headers
+
+            const QList<QByteArray> requestLine = socket->readAll().split( '\n' ).at( 0 ).split( ' ' );
+            const QString path = requestLine.value( 1 );
+            QByteArray response;
+            if ( path.startsWith( QLatin1String( "/redirect" ) ) )
+            {
+              response = "HTTP/1.1 302 Found\r\nLocation: " + url( path.mid( 9 ) ).toEncoded() + "\r\nContent-Length: 0\r\n";
+            }
+            else
+            {
+              response = "HTTP/1.1 200 OK\r\nContent-Type: image/png\r\nContent-Length: " + QByteArray::number( mTile.size() ) + "\r\n";
+            }
+            response += "Cache-Control: no-store\r\nConnection: close\r\n\r\n";
+            if ( !path.startsWith( QLatin1String( "/redirect" ) ) )
+              response += mTile;
+            socket->write( response );
+            socket->disconnectFromHost();
+          } );
+        }
+      } );
+      mServer.listen( QHostAddress::LocalHost );
+    }
+
+    //! Returns the URL of the tile with the specified \a path, which must start with a slash
+    QUrl url( const QString &path ) const
+    {
+      return QUrl( QStringLiteral( "http://127.0.0.1:%1%2" ).arg( mServer.serverPort() ).arg( path ) );
+    }
+
+  private:
+    QTcpServer mServer;
+    QByteArray mTile;
+};
 
 /**
  * \ingroup UnitTests
@@ -87,7 +151,87 @@ class TestQgsWmsProvider: public QObject
                                          "STYLES=&FORMAT=&TRANSPARENT=TRUE" ) );
     }
 
+    void sharedTileDownload()
+    {
+      // two handlers needing the same tile at once must only issue a single request
+      TestTileServer server;
+      const QUrl tileUrl = server.url( QStringLiteral( "/shared/%1.png" ).arg( QUuid::createUuid().toString( QUuid::WithoutBraces ) ) );
+      int requestCount = 0;
+      QMetaObject::Connection connection = connect( QgsNetworkAccessManager::instance(), qgis::overload< QgsNetworkRequestParameters >::of( &QgsNetworkAccessManager::requestAboutToBeCreated ), this,
+                                           [&requestCount]( const QgsNetworkRequestParameters & ) { requestCount++; } );
+
+      const QgsWmsProvider::TileRequests requests = QgsWmsProvider::TileRequests() << QgsWmsProvider::TileRequest( tileUrl, QRectF( 0, 0, 256, 256 ), 0 );
+      QImage image1 = blankImage();
+      QImage image2 = blankImage();
+      QgsWmsTiledImageDownloadHandler handler1( QString(), QgsWmsAuthorization(), 1, requests, &image1, QgsRectangle( 0, 0, 256, 256 ), false, nullptr );
+      QgsWmsTiledImageDownloadHandler handler2( QString(), QgsWmsAuthorization(), 1, requests, &image2, QgsRectangle( 0, 0, 256, 256 ), false, nullptr );
+      handler2.downloadBlocking();
+      handler1.downloadBlocking();
+      disconnect( connection );
+
+      QCOMPARE( requestCount, 1 );
+      QCOMPARE( image1.pixel( 128, 128 ), QColor( Qt::red ).rgb() );
+      QCOMPARE( image2.pixel( 128, 128 ), QColor( Qt::red ).rgb() );
+    }
+
+    void sharedTileDownloadOwnerCanceled()
+    {
+      // if the handler downloading a tile is canceled, the handler waiting for it must fetch the tile itself
+      TestTileServer server;
+      const QUrl tileUrl = server.url( QStringLiteral( "/canceled/%1.png" ).arg( QUuid::createUuid().toString( QUuid::WithoutBraces ) ) );
+      int requestCount = 0;
+      QMetaObject::Connection connection = connect( QgsNetworkAccessManager::instance(), qgis::overload< QgsNetworkRequestParameters >::of( &QgsNetworkAccessManager::requestAboutToBeCreated ), this,
+                                           [&requestCount]( const QgsNetworkRequestParameters & ) { requestCount++; } );
+
+      const QgsWmsProvider::TileRequests requests = QgsWmsProvider::TileRequests() << QgsWmsProvider::TileRequest( tileUrl, QRectF( 0, 0, 256, 256 ), 0 );
+      QImage image1 = blankImage();
+      QImage image2 = blankImage();
+      QgsRasterBlockFeedback feedback1;
+      QgsWmsTiledImageDownloadHandler handler1( QString(), QgsWmsAuthorization(), 1, requests, &image1, QgsRectangle( 0, 0, 256, 256 ), false, &feedback1 );
+      QgsWmsTiledImageDownloadHandler handler2( QString(), QgsWmsAuthorization(), 1, requests, &image2, QgsRectangle( 0, 0, 256, 256 ), false, nullptr );
+      QCOMPARE( requestCount, 1 );
+      feedback1.cancel();
+      handler2.downloadBlocking();
+      disconnect( connection );
+
+      QCOMPARE( requestCount, 2 );
+      QCOMPARE( image1.pixel( 128, 128 ), 0u );
+      QCOMPARE( image2.pixel( 128, 128 ), QColor( Qt::red ).rgb() );
+    }
+
+    void sharedTileDownloadRedirected()
+    {
+      // a handler waiting for a tile must find it in the tile cache even if the download was redirected
+      TestTileServer server;
+      const QString path = QStringLiteral( "/redirected/%1.png" ).arg( QUuid::createUuid().toString( QUuid::WithoutBraces ) );
+      const QUrl tileUrl = server.url( QStringLiteral( "/redirect" ) + path );
+      int requestCount = 0;
+      QMetaObject::Connection connection = connect( QgsNetworkAccessManager::instance(), qgis::overload< QgsNetworkRequestParameters >::of( &QgsNetworkAccessManager::requestAboutToBeCreated ), this,
+                                           [&requestCount]( const QgsNetworkRequestParameters & ) { requestCount++; } );
+
+      const QgsWmsProvider::TileRequests requests = QgsWmsProvider::TileRequests() << QgsWmsProvider::TileRequest( tileUrl, QRectF( 0, 0, 256, 256 ), 0 );
+      QImage image1 = blankImage();
+      QImage image2 = blankImage();
+      QgsWmsTiledImageDownloadHandler handler1( QString(), QgsWmsAuthorization(), 1, requests, &image1, QgsRectangle( 0, 0, 256, 256 ), false, nullptr );
+      QgsWmsTiledImageDownloadHandler handler2( QString(), QgsWmsAuthorization(), 1, requests, &image2, QgsRectangle( 0, 0, 256, 256 ), false, nullptr );
+      handler2.downloadBlocking();
+      handler1.downloadBlocking();
+      disconnect( connection );
+
+      // the original request and the redirected one
+      QCOMPARE( requestCount, 2 );
+      QCOMPARE( image1.pixel( 128, 128 ), QColor( Qt::red ).rgb() );
+      QCOMPARE( image2.pixel( 128, 128 ), QColor( Qt::red ).rgb() );
+    }
+
   private:
+    static QImage blankImage()
+    {
+      QImage image( 256, 256, QImage::Format_ARGB32_Premultiplied );
+      image.fill( 0 );
+      return image;
+    }
+
     QgsWmsCapabilities *mCapabilities = nullptr;
 };
 
@@ -115,15 +115,9 @@ class TestPyQgsMemoryProvider(unittest.TestCase, ProviderTestCase):
     def getEditableLayer(self):
         return self.createLayer()
 
-    def testGetFeaturesSubsetAttributes2(self):
-        """ Override and skip this test for memory provider, as it's actually more efficient for the memory provider to return
-        its features as direct copies (due to implicit sharing of QgsFeature)
-        """
-        pass
-
     def testGetFeaturesNoGeometry(self):
         """ Override and skip this test for memory provider, as it's actually more efficient for the memory provider to return
-        its features as direct copies (due to implicit sharing of QgsFeature)
+        its geometries as direct copies (due to implicit sharing of QgsGeometry)
         """
         pass
 
@@ -226,6 +220,53 @@ class TestPyQgsMemoryProvider(unittest.TestCase, ProviderTestCase):
 
             assert compareWkt(str(geom.asWkt()), "Point (10 10)"), myMessage
 
+    def testDeleteFeatures(self):
+        """
+        Test deleting features, including enough features to compact the provider's storage
+        """
+        layer = QgsVectorLayer('Point?crs=epsg:4326&field=f1:integer', 'test', 'memory')
+        provider = layer.dataProvider()
+
+        features = []
+        for i in range(1000):
+            f = QgsFeature()
+            f.setAttributes([i])
+            f.setGeometry(QgsGeometry.fromPointXY(QgsPointXY(i, i)))
+            features.append(f)
+        self.assertTrue(provider.addFeatures(features)[0])
+        self.assertEqual(provider.featureCount(), 1000)
+
+        # an iterator started before the deletion keeps returning the original features
+        it = provider.getFeatures()
+        self.assertTrue(provider.deleteFeatures([fid for fid in range(1, 1001) if fid % 10 != 0]))
+        self.assertEqual(len([f for f in it]), 1000)
+
+        self.assertEqual(provider.featureCount(), 100)
+        self.assertEqual([f.id() for f in provider.getFeatures()], list(range(10, 1001, 10)))
+        self.assertEqual([f['f1'] for f in provider.getFeatures()], list(range(9, 1000, 10)))
+        self.assertEqual(provider.extent(), QgsRectangle(9, 9, 999, 999))
+
+        f = next(provider.getFeatures(QgsFeatureRequest(500)))
+        self.assertEqual(f['f1'], 499)
+        self.assertEqual(f.geometry().asWkt(), 'Point (499 499)')
+        self.assertFalse(list(provider.getFeatures(QgsFeatureRequest(501))))
+        self.assertEqual(sorted([f.id() for f in provider.getFeatures(QgsFeatureRequest().setFilterFids([20, 21, 30]))]), [20, 30])
+        self.assertEqual([f.id() for f in provider.getFeatures(QgsFeatureRequest().setFilterRect(QgsRectangle(15, 15, 45, 45)))], [20, 30, 40, 50])
+
+        # new features get new ids after the compaction
+        f = QgsFeature()
+        f.setAttributes([1000])
+        self.assertTrue(provider.addFeatures([f])[0])
+        self.assertEqual(provider.featureCount(), 101)
+        self.assertEqual(next(provider.getFeatures(QgsFeatureRequest(1001)))['f1'], 1000)
+
+        self.assertTrue(provider.changeAttributeValues({500: {0: -1}}))
+        self.assertEqual(next(provider.getFeatures(QgsFeatureRequest(500)))['f1'], -1)
+
+        self.assertTrue(provider.deleteFeatures([f.id() for f in provider.getFeatures()]))
+        self.assertEqual(provider.featureCount(), 0)
+        self.assertFalse(list(provider.getFeatures()))
+
     def testClone(self):
         """
         Test that cloning a memory layer also clones features
@@ -705,15 +746,9 @@ class TestPyQgsMemoryProviderIndexed(unittest.TestCase, ProviderTestCase):
     def tearDownClass(cls):
         """Run after all tests"""
 
-    def testGetFeaturesSubsetAttributes2(self):
-        """ Override and skip this test for memory provider, as it's actually more efficient for the memory provider to return
-        its features as direct copies (due to implicit sharing of QgsFeature)
-        """
-        pass
-
     def testGetFeaturesNoGeometry(self):
         """ Override and skip this test for memory provider, as it's actually more efficient for the memory provider to return
-        its features as direct copies (due to implicit sharing of QgsFeature)
+        its geometries as direct copies (due to implicit sharing of QgsGeometry)
         """
         pass
 
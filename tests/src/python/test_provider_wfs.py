@@ -35,6 +35,8 @@ from qgis.core import (
     QgsExpression,
     QgsExpressionContextUtils,
     QgsExpressionContext,
+    QgsNetworkAccessManager,
+    QgsNetworkRequestParameters,
 )
 from qgis.testing import (start_app,
                           unittest
@@ -726,6 +728,97 @@ class TestPyQgsWFSProvider(unittest.TestCase, ProviderTestCase):
         got = got_f[0].geometry().constGet()
         self.assertEqual((got.x(), got.y()), (3.0, 4.0))
 
+    def testPersistentCache(self):
+        """Test that downloaded features are reused by other layers through the persistent cache"""
+
+        endpoint = self.__class__.basetestpath + '/fake_qgis_http_endpoint_persistent_cache'
+
+        with open(sanitize(endpoint, '?SERVICE=WFS?REQUEST=GetCapabilities?VERSION=1.0.0'), 'wb') as f:
+            f.write("""
+<WFS_Capabilities version="1.0.0" xmlns="http://www.opengis.net/wfs" xmlns:ogc="http://www.opengis.net/ogc">
+  <FeatureTypeList>
+    <FeatureType>
+      <Name>my:typename</Name>
+      <Title>Title</Title>
+      <Abstract>Abstract</Abstract>
+      <SRS>EPSG:32631</SRS>
+      <LatLongBoundingBox minx="400000" miny="5400000" maxx="450000" maxy="5500000"/>
+    </FeatureType>
+  </FeatureTypeList>
+</WFS_Capabilities>""".encode('UTF-8'))
+
+        with open(sanitize(endpoint, '?SERVICE=WFS&REQUEST=DescribeFeatureType&VERSION=1.0.0&TYPENAME=my:typename'), 'wb') as f:
+            f.write("""
+<xsd:schema xmlns:my="http://my" xmlns:gml="http://www.opengis.net/gml" xmlns:xsd="http://www.w3.org/2001/XMLSchema" elementFormDefault="qualified" targetNamespace="http://my">
+  <xsd:import namespace="http://www.opengis.net/gml"/>
+  <xsd:complexType name="typenameType">
+    <xsd:complexContent>
+      <xsd:extension base="gml:AbstractFeatureType">
+        <xsd:sequence>
+          <xsd:element maxOccurs="1" minOccurs="0" name="intfield" nillable="true" type="xsd:int"/>
+          <xsd:element maxOccurs="1" minOccurs="0" name="geometryProperty" nillable="true" type="gml:PointPropertyType"/>
+        </xsd:sequence>
+      </xsd:extension>
+    </xsd:complexContent>
+  </xsd:complexType>
+  <xsd:element name="typename" substitutionGroup="gml:_Feature" type="my:typenameType"/>
+</xsd:schema>
+""".encode('UTF-8'))
+
+        get_feature = sanitize(endpoint, '?SERVICE=WFS&REQUEST=GetFeature&VERSION=1.0.0&TYPENAME=my:typename&SRSNAME=EPSG:32631')
+        with open(get_feature, 'wb') as f:
+            f.write("""
+<wfs:FeatureCollection
+                       xmlns:wfs="http://www.opengis.net/wfs"
+                       xmlns:gml="http://www.opengis.net/gml"
+                       xmlns:my="http://my">
+  <gml:boundedBy><gml:null>unknown</gml:null></gml:boundedBy>
+  <gml:featureMember>
+    <my:typename fid="typename.0">
+      <my:geometryProperty><gml:Point><gml:coordinates>426858,5427937</gml:coordinates></gml:Point></my:geometryProperty>
+      <my:intfield>1</my:intfield>
+    </my:typename>
+  </gml:featureMember>
+  <gml:featureMember>
+    <my:typename fid="typename.1">
+      <my:geometryProperty><gml:Point><gml:coordinates>426859,5427938</gml:coordinates></gml:Point></my:geometryProperty>
+      <my:intfield>2</my:intfield>
+    </my:typename>
+  </gml:featureMember>
+</wfs:FeatureCollection>""".encode('UTF-8'))
+
+        uri = "url='http://" + endpoint + "' typename='my:typename' version='1.0.0'"
+        # Don't leave persistent cache entries in the user cache directory
+        cache_directory = tempfile.mkdtemp()
+        QgsSettings().setValue('cache/directory', cache_directory)
+        QgsSettings().setValue('wfs/persistent_cache_enabled', True)
+        try:
+            vl = QgsVectorLayer(uri, 'test', 'WFS')
+            self.assertTrue(vl.isValid())
+            values = [f['intfield'] for f in vl.getFeatures()]
+            self.assertEqual(values, [1, 2])
+
+            # Suppress GetFeature response to demonstrate that a new layer uses the persistent cache
+            os.unlink(get_feature)
+
+            vl2 = QgsVectorLayer(uri, 'test', 'WFS')
+            self.assertTrue(vl2.isValid())
+            features = [f for f in vl2.getFeatures()]
+            self.assertEqual([f['intfield'] for f in features], [1, 2])
+            self.assertEqual(features[0].geometry().asWkt(), 'Point (426858 5427937)')
+            self.assertEqual(vl2.featureCount(), 2)
+
+            # An explicit reload discards the persistent cache
+            vl2.dataProvider().reloadData()
+            values = [f['intfield'] for f in vl2.getFeatures()]
+            self.assertEqual(values, [])
+            del vl
+            del vl2
+        finally:
+            QgsSettings().remove('wfs/persistent_cache_enabled')
+            QgsSettings().remove('cache/directory')
+            shutil.rmtree(cache_directory, True)
+
     def testWFS10_latlongboundingbox_in_WGS84(self):
         """Test WFS 1.0 with non conformatn LatLongBoundingBox"""
 
@@ -1118,6 +1211,112 @@ class TestPyQgsWFSProvider(unittest.TestCase, ProviderTestCase):
 </wfs:FeatureCollection>""".encode('UTF-8'))
         self.assertEqual(vl.featureCount(), 2)
 
+    def testWFS20PagingConcurrentPages(self):
+        """Test WFS 2.0 paging with several pages downloaded concurrently"""
+
+        endpoint = self.__class__.basetestpath + '/fake_qgis_http_endpoint_WFS_2.0_paging_concurrent'
+
+        with open(sanitize(endpoint, '?SERVICE=WFS?REQUEST=GetCapabilities?ACCEPTVERSIONS=2.0.0,1.1.0,1.0.0'), 'wb') as f:
+            f.write("""
+<wfs:WFS_Capabilities version="2.0.0" xmlns="http://www.opengis.net/wfs/2.0" xmlns:wfs="http://www.opengis.net/wfs/2.0" xmlns:ows="http://www.opengis.net/ows/1.1" xmlns:gml="http://schemas.opengis.net/gml/3.2" xmlns:fes="http://www.opengis.net/fes/2.0">
+  <OperationsMetadata>
+    <Operation name="GetFeature">
+      <Constraint name="CountDefault">
+        <NoValues/>
+        <DefaultValue>1</DefaultValue>
+      </Constraint>
+    </Operation>
+    <Constraint name="ImplementsResultPaging">
+      <NoValues/>
+      <DefaultValue>TRUE</DefaultValue>
+    </Constraint>
+  </OperationsMetadata>
+  <FeatureTypeList>
+    <FeatureType>
+      <Name>my:typename</Name>
+      <Title>Title</Title>
+      <Abstract>Abstract</Abstract>
+      <DefaultCRS>urn:ogc:def:crs:EPSG::4326</DefaultCRS>
+      <WGS84BoundingBox>
+        <LowerCorner>-71.123 66.33</LowerCorner>
+        <UpperCorner>-65.32 78.3</UpperCorner>
+      </WGS84BoundingBox>
+    </FeatureType>
+  </FeatureTypeList>
+</wfs:WFS_Capabilities>""".encode('UTF-8'))
+
+        with open(sanitize(endpoint, '?SERVICE=WFS&REQUEST=DescribeFeatureType&VERSION=2.0.0&TYPENAMES=my:typename&TYPENAME=my:typename'), 'wb') as f:
+            f.write("""
+<xsd:schema xmlns:my="http://my" xmlns:gml="http://www.opengis.net/gml/3.2" xmlns:xsd="http://www.w3.org/2001/XMLSchema" elementFormDefault="qualified" targetNamespace="http://my">
+  <xsd:import namespace="http://www.opengis.net/gml/3.2"/>
+  <xsd:complexType name="typenameType">
+    <xsd:complexContent>
+      <xsd:extension base="gml:AbstractFeatureType">
+        <xsd:sequence>
+          <xsd:element maxOccurs="1" minOccurs="0" name="id" nillable="true" type="xsd:int"/>
+          <xsd:element maxOccurs="1" minOccurs="0" name="geometryProperty" nillable="true" type="gml:GeometryPropertyType"/>
+        </xsd:sequence>
+      </xsd:extension>
+    </xsd:complexContent>
+  </xsd:complexType>
+  <xsd:element name="typename" substitutionGroup="gml:_Feature" type="my:typenameType"/>
+</xsd:schema>
+""".encode('UTF-8'))
+
+        feature_count = 6
+        for i in range(feature_count + 1):
+            with open(sanitize(endpoint, '?SERVICE=WFS&REQUEST=GetFeature&VERSION=2.0.0&TYPENAMES=my:typename&TYPENAME=my:typename&STARTINDEX={}&COUNT=1&SRSNAME=urn:ogc:def:crs:EPSG::4326'.format(i)), 'wb') as f:
+                member = ''
+                if i < feature_count:
+                    member = """
+  <wfs:member>
+    <my:typename gml:id="typename.{0}">
+      <my:geometryProperty><gml:Point srsName="urn:ogc:def:crs:EPSG::4326" gml:id="typename.geom.{0}"><gml:pos>66.33 -70.332</gml:pos></gml:Point></my:geometryProperty>
+      <my:id>{1}</my:id>
+    </my:typename>
+  </wfs:member>""".format(i, i + 1)
+                f.write("""
+<wfs:FeatureCollection xmlns:wfs="http://www.opengis.net/wfs/2.0"
+                       xmlns:gml="http://www.opengis.net/gml/3.2"
+                       xmlns:my="http://my"
+                       numberMatched="{}" numberReturned="{}" timeStamp="2016-03-25T14:51:48.998Z">{}
+</wfs:FeatureCollection>""".format(feature_count, 1 if member else 0, member).encode('UTF-8'))
+
+        # track the number of GetFeature requests in flight
+        in_flight = set()
+        max_in_flight = [0]
+
+        def request_created(request):
+            if 'GetFeature' in request.request().url().toString():
+                in_flight.add(request.requestId())
+                max_in_flight[0] = max(max_in_flight[0], len(in_flight))
+
+        def request_finished(reply):
+            in_flight.discard(reply.requestId())
+
+        nam = QgsNetworkAccessManager.instance()
+        nam.requestAboutToBeCreated[QgsNetworkRequestParameters].connect(request_created)
+        nam.finished.connect(request_finished)
+
+        QgsSettings().setValue('wfs/max_concurrent_page_requests', 3)
+        try:
+            vl = QgsVectorLayer("url='http://" + endpoint + "' typename='my:typename'", 'test', 'WFS')
+            self.assertTrue(vl.isValid())
+            self.assertEqual(vl.wkbType(), QgsWkbTypes.Point)
+
+            # features must be returned in order, whatever the order in which pages are received
+            values = [f['id'] for f in vl.getFeatures()]
+            self.assertEqual(values, list(range(1, feature_count + 1)))
+            self.assertEqual(vl.featureCount(), feature_count)
+
+            # signals from the downloader thread are queued
+            QCoreApplication.processEvents()
+            self.assertGreater(max_in_flight[0], 1)
+        finally:
+            nam.requestAboutToBeCreated[QgsNetworkRequestParameters].disconnect(request_created)
+            nam.finished.disconnect(request_finished)
+            QgsSettings().remove('wfs/max_concurrent_page_requests')
+
     def testWFS20PagingPageSizeOverride(self):
         """Test WFS 2.0 paging"""
 
@@ -33,7 +33,7 @@ import collections
 
 rebuildTests = 'REBUILD_DELIMITED_TEXT_TESTS' in os.environ
 
-from qgis.PyQt.QtCore import QCoreApplication, QUrl, QObject
+from qgis.PyQt.QtCore import QCoreApplication, QUrl, QObject, QVariant
 
 from qgis.core import (
     QgsProviderRegistry,
@@ -826,6 +826,77 @@ class TestQgsDelimitedTextProviderOther(unittest.TestCase):
         components = registry.decodeUri('delimitedtext', uri)
         self.assertEqual(components['path'], filename)
 
+    def test_044_random_access(self):
+        # Fetching features by id from a file spanning many line offset intervals
+        (filehandle, filename) = tempfile.mkstemp(suffix='.csv')
+        with os.fdopen(filehandle, 'wb') as f:
+            f.write(b'\xef\xbb\xbfid,name\r\n')
+            for i in range(1, 1001):
+                if i == 500:
+                    f.write(b'500,"multi\r\nline"\r\n')
+                else:
+                    f.write('{},name {}\r\n'.format(i, i).encode())
+
+        uri = '{}?type=csv&geomType=none&detectTypes=no'.format(QUrl.fromLocalFile(filename).toString())
+        layer = QgsVectorLayer(uri, 'test', 'delimitedtext')
+        self.assertTrue(layer.isValid())
+        self.assertEqual(layer.featureCount(), 1000)
+        self.assertEqual(layer.fields().names(), ['id', 'name'])
+
+        # feature ids are line numbers, and the multiline record shifts the following records
+        for fid, expected in [(901, '899'), (2, '1'), (501, '500'), (1002, '1000'), (65, '64'), (66, '65'), (3, '2')]:
+            f = next(layer.getFeatures(QgsFeatureRequest(fid)))
+            self.assertEqual(f['id'], expected)
+        self.assertEqual(next(layer.getFeatures(QgsFeatureRequest(501)))['name'], 'multi\nline')
+        self.assertEqual(next(layer.getFeatures(QgsFeatureRequest(1002)))['name'], 'name 1000')
+        self.assertFalse(list(layer.getFeatures(QgsFeatureRequest(502))))
+
+        self.assertEqual([f['id'] for f in layer.getFeatures()], [str(i) for i in range(1, 1001)])
+        del layer
+        os.remove(filename)
+
+    def test_045_parallel_scan(self):
+        # A file large enough to be scanned in several ranges, with multiline records
+        # and blank lines which ranges may start within
+        (filehandle, filename) = tempfile.mkstemp(suffix='.csv')
+        line_number = 1
+        fids = {}
+        with os.fdopen(filehandle, 'wb') as f:
+            f.write(b'id,x,y,value,note\n')
+            for i in range(250000):
+                line_number += 1
+                fids[i] = line_number
+                value = '2.5' if i == 249990 else str(i)
+                if i % 1001 == 0:
+                    note = '"line 1\n{},1,2,3,\n\nline 4"'.format(i)
+                    line_number += 3
+                else:
+                    note = 'note {}'.format('x' * 60)
+                f.write('{},{},{},{},{}\n'.format(i, i % 500, i // 500, value, note).encode())
+                if i % 777 == 0:
+                    f.write(b'\n')
+                    line_number += 1
+        self.assertGreater(os.path.getsize(filename), 16 * 1024 * 1024)
+
+        uri = '{}?type=csv&xField=x&yField=y&spatialIndex=yes'.format(QUrl.fromLocalFile(filename).toString())
+        layer = QgsVectorLayer(uri, 'test', 'delimitedtext')
+        self.assertTrue(layer.isValid())
+        self.assertEqual(layer.featureCount(), 250000)
+        self.assertEqual(layer.extent(), QgsRectangle(0, 0, 499, 499))
+        self.assertEqual([(field.name(), field.type()) for field in layer.fields()],
+                         [('id', QVariant.Int), ('x', QVariant.Int), ('y', QVariant.Int), ('value', QVariant.Double), ('note', QVariant.String)])
+
+        for i in [0, 1, 1001, 100100, 124999, 125000, 249999]:
+            f = next(layer.getFeatures(QgsFeatureRequest(fids[i])))
+            self.assertEqual(f['id'], i)
+        self.assertEqual(next(layer.getFeatures(QgsFeatureRequest(fids[2002])))['note'], 'line 1\n2002,1,2,3,\n\nline 4')
+
+        request = QgsFeatureRequest().setFilterRect(QgsRectangle(99.5, 199.5, 100.5, 300.5))
+        self.assertEqual(sorted(f['id'] for f in layer.getFeatures(request)), [y * 500 + 100 for y in range(200, 301)])
+        self.assertEqual(sorted(f.id() for f in layer.getFeatures(request)), sorted(fids[y * 500 + 100] for y in range(200, 301)))
+        del layer
+        os.remove(filename)
+
 
 if __name__ == '__main__':
     unittest.main()
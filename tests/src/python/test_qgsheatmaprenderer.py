@@ -0,0 +1,130 @@
+# -*- coding: utf-8 -*-
+
+"""
+***************************************************************************
+    test_qgsheatmaprenderer.py
+    --------------------------
+    Date                 : October 2026
+    Copyright            : (C) 2026 by agent
+    Email                : agent at local
+***************************************************************************
+*                                                                         *
+*   This program is free software; you can redistribute it and/or modify  *
+*   it under the terms of the GNU General Public License as published by  *
+*   the Free Software Foundation; either version 2 of the License, or     *
+*   (at your option) any later version.                                   *
+*                                                                         *
+***************************************************************************
+
+From build dir, run: ctest -R PyQgsHeatmapRenderer -V
+
+"""
+
+__author__ = 'agent'
+__date__ = 'October 2026'
+__copyright__ = '(C) 2026, agent'
+
+import qgis  # NOQA
+
+from qgis.PyQt.QtCore import QSize
+from qgis.PyQt.QtGui import QColor
+
+from qgis.core import (QgsVectorLayer,
+                       QgsFeature,
+                       QgsGeometry,
+                       QgsPointXY,
+                       QgsProject,
+                       QgsRectangle,
+                       QgsMultiRenderChecker,
+                       QgsHeatmapRenderer,
+                       QgsGradientColorRamp,
+                       QgsUnitTypes,
+                       QgsMapSettings
+                       )
+from qgis.testing import start_app, unittest
+
+start_app()
+
+
+class TestQgsHeatmapRenderer(unittest.TestCase):
+
+    def tearDown(self):
+        QgsProject.instance().removeAllMapLayers()
+
+    def createLayer(self, corner_clusters):
+        """ creates a point layer with clusters and sparse points, some of them past the map edges """
+        layer = QgsVectorLayer('Point?field=id:integer', 'points', 'memory')
+        points = []
+        if corner_clusters:
+            # clusters centered just past the top left corner and on the bottom right edge
+            for i in range(400):
+                points.append((-10.5 + (i % 20) * 2, 190.5 - (i // 20) * 2))
+                points.append((380.5 + (i % 20) * 2, 20.5 - (i // 20) * 2))
+        # a looser cluster in the middle
+        for i in range(300):
+            points.append((140.5 + (i % 20) * 6, 70.5 + (i // 20) * 4))
+        # sparse points, some past the edges
+        for i in range(100):
+            points.append((((i * 7919) % 561) - 80 + 0.5, ((i * 104729) % 361) - 80 + 0.5))
+        # far outside the map, these must not contribute
+        points.extend([(-300.5, 100.5), (700.5, 100.5), (200.5, -300.5), (200.5, 600.5)])
+
+        features = []
+        for i, (x, y) in enumerate(points):
+            f = QgsFeature(layer.fields())
+            f.setAttributes([i])
+            f.setGeometry(QgsGeometry.fromPointXY(QgsPointXY(x, y)))
+            features.append(f)
+        self.assertTrue(layer.dataProvider().addFeatures(features))
+        QgsProject.instance().addMapLayer(layer)
+        return layer
+
+    def createMapSettings(self, layer):
+        # one map unit per pixel
+        mapsettings = QgsMapSettings()
+        mapsettings.setOutputSize(QSize(400, 200))
+        mapsettings.setOutputDpi(96)
+        mapsettings.setExtent(QgsRectangle(0, 0, 400, 200))
+        mapsettings.setLayers([layer])
+        return mapsettings
+
+    def createRenderer(self, radius, quality):
+        renderer = QgsHeatmapRenderer()
+        renderer.setColorRamp(QgsGradientColorRamp(QColor(255, 255, 255), QColor(0, 0, 0)))
+        renderer.setRadius(radius)
+        renderer.setRadiusUnit(QgsUnitTypes.RenderPixels)
+        renderer.setRenderQuality(quality)
+        return renderer
+
+    def testRenderBands(self):
+        """ test rendering enough points for the kernels to be accumulated in parallel bands """
+        layer = self.createLayer(True)
+        self.assertGreater(layer.featureCount(), 1000)
+        # at quality 2 the radius is 40 rows, which is taller than the bands of the 100 row heatmap
+        layer.setRenderer(self.createRenderer(80, 2))
+
+        renderchecker = QgsMultiRenderChecker()
+        renderchecker.setMapSettings(self.createMapSettings(layer))
+        renderchecker.setControlPathPrefix('heatmap_renderer')
+        renderchecker.setControlName('expected_heatmap_bands')
+        renderchecker.setColorTolerance(2)
+        result = renderchecker.runTest('heatmap_bands')
+        self.assertTrue(result)
+
+    def testRenderSerial(self):
+        """ test rendering few enough points for the kernels to be accumulated on a single thread """
+        layer = self.createLayer(False)
+        self.assertLess(layer.featureCount(), 1000)
+        layer.setRenderer(self.createRenderer(30, 1))
+
+        renderchecker = QgsMultiRenderChecker()
+        renderchecker.setMapSettings(self.createMapSettings(layer))
+        renderchecker.setControlPathPrefix('heatmap_renderer')
+        renderchecker.setControlName('expected_heatmap_serial')
+        renderchecker.setColorTolerance(2)
+        result = renderchecker.runTest('heatmap_serial')
+        self.assertTrue(result)
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -15,9 +15,22 @@ import qgis  # NOQA
 from qgis.core import (QgsMapRendererCache,
                        QgsRectangle,
                        QgsVectorLayer,
-                       QgsProject)
+                       QgsProject,
+                       QgsFeature,
+                       QgsGeometry,
+                       QgsPointXY,
+                       QgsMapSettings,
+                       QgsRenderContext,
+                       QgsMapRendererSequentialJob,
+                       QgsSingleSymbolRenderer,
+                       QgsCategorizedSymbolRenderer,
+                       QgsHeatmapRenderer,
+                       QgsPointClusterRenderer,
+                       QgsMarkerSymbol,
+                       QgsSymbolLayer,
+                       QgsProperty)
 from qgis.testing import start_app, unittest
-from qgis.PyQt.QtCore import QCoreApplication
+from qgis.PyQt.QtCore import QCoreApplication, QPoint, QSize
 from qgis.PyQt.QtGui import QImage
 from time import sleep
 start_app()
@@ -264,6 +277,179 @@ class TestQgsMapRendererCache(unittest.TestCase):
         # cache should be cleared
         self.assertFalse(cache.hasCacheImage('l1'))
 
+    def testVectorLayerPartialInvalidation(self):
+        """ test that edits only invalidate the affected parts of vector layer images """
+        layer = QgsVectorLayer("Point?crs=EPSG:3857&field=fldtxt:string",
+                               "layer", "memory")
+        f1 = QgsFeature()
+        f1.setGeometry(QgsGeometry.fromPointXY(QgsPointXY(100, 100)))
+        f2 = QgsFeature()
+        f2.setGeometry(QgsGeometry.fromPointXY(QgsPointXY(900, 900)))
+        f3 = QgsFeature()
+        f3.setGeometry(QgsGeometry.fromPointXY(QgsPointXY(900, 500)))
+        success, (f1, f2, f3) = layer.dataProvider().addFeatures([f1, f2, f3])
+        self.assertTrue(success)
+
+        settings = QgsMapSettings()
+        settings.setDestinationCrs(layer.crs())
+        settings.setOutputSize(QSize(1000, 1000))
+        settings.setExtent(QgsRectangle(0, 0, 1000, 1000))
+        context = QgsRenderContext.fromMapSettings(settings)
+
+        cache = QgsMapRendererCache()
+        im = QImage(1000, 1000, QImage.Format_ARGB32_Premultiplied)
+        self.assertTrue(layer.startEditing())
+        cache.setVectorLayerCacheImage('xxx', im, layer, context)
+        # f3 was not drawn into the image
+        cache.addRenderedFeatureBounds(layer, {f1.id(): f1.geometry().boundingBox(),
+                                               f2.id(): f2.geometry().boundingBox()})
+        self.assertTrue(cache.hasCacheImage('xxx'))
+        self.assertTrue(cache.cacheImageDirtyRegion('xxx').isEmpty())
+        cache.setCacheImage('labels', im, [layer])
+
+        # moving a feature must invalidate its old and new location only
+        self.assertTrue(layer.changeGeometry(f1.id(), QgsGeometry.fromPointXY(QgsPointXY(100, 500))))
+        dirty = cache.cacheImageDirtyRegion('xxx')
+        self.assertTrue(dirty.contains(QPoint(100, 900)))
+        self.assertTrue(dirty.contains(QPoint(100, 500)))
+        self.assertFalse(dirty.contains(QPoint(900, 100)))
+        self.assertFalse(dirty.contains(QPoint(900, 900)))
+
+        # the repaint following the edit must keep the partially valid image, but other images must be cleared
+        layer.triggerRepaint()
+        self.assertTrue(cache.hasCacheImage('xxx'))
+        self.assertFalse(cache.hasCacheImage('labels'))
+
+        # moving the feature again must invalidate its edited location
+        cache.setVectorLayerCacheImage('xxx', im, layer, context)
+        self.assertTrue(layer.changeGeometry(f1.id(), QgsGeometry.fromPointXY(QgsPointXY(500, 500))))
+        dirty = cache.cacheImageDirtyRegion('xxx')
+        self.assertTrue(dirty.contains(QPoint(100, 500)))
+        self.assertTrue(dirty.contains(QPoint(500, 500)))
+        self.assertFalse(dirty.contains(QPoint(100, 900)))
+
+        # moving a feature which was not drawn must only invalidate its new location
+        cache.setVectorLayerCacheImage('xxx', im, layer, context)
+        self.assertTrue(layer.changeGeometry(f3.id(), QgsGeometry.fromPointXY(QgsPointXY(500, 900))))
+        dirty = cache.cacheImageDirtyRegion('xxx')
+        self.assertTrue(dirty.contains(QPoint(500, 100)))
+        self.assertFalse(dirty.contains(QPoint(900, 500)))
+
+        # deleting a feature
+        cache.setVectorLayerCacheImage('xxx', im, layer, context)
+        self.assertTrue(layer.deleteFeature(f2.id()))
+        dirty = cache.cacheImageDirtyRegion('xxx')
+        self.assertTrue(dirty.contains(QPoint(900, 100)))
+        self.assertFalse(dirty.contains(QPoint(500, 500)))
+        layer.triggerRepaint()
+        self.assertTrue(cache.hasCacheImage('xxx'))
+
+        # a repaint which doesn't follow an edit must clear the image
+        layer.triggerRepaint()
+        self.assertFalse(cache.hasCacheImage('xxx'))
+
+        # so must changes affecting all features
+        cache.setVectorLayerCacheImage('xxx', im, layer, context)
+        layer.selectAll()
+        self.assertFalse(cache.hasCacheImage('xxx'))
+        cache.setVectorLayerCacheImage('xxx', im, layer, context)
+        layer.rollBack()
+        self.assertFalse(cache.hasCacheImage('xxx'))
+
+        # starting an edit session clears images which don't track edits
+        cache.setCacheImage('yyy', im, [layer])
+        self.assertTrue(layer.startEditing())
+        self.assertFalse(cache.hasCacheImage('yyy'))
+        layer.rollBack()
+
+    def testCanTrackEdits(self):
+        """ test which vector layers support partial invalidation of their images """
+        layer = QgsVectorLayer("Point?crs=EPSG:3857&field=fldint:integer",
+                               "layer", "memory")
+        settings = QgsMapSettings()
+        settings.setDestinationCrs(layer.crs())
+        settings.setOutputSize(QSize(1000, 1000))
+        settings.setExtent(QgsRectangle(0, 0, 1000, 1000))
+        context = QgsRenderContext.fromMapSettings(settings)
+        self.assertTrue(QgsMapRendererCache.canTrackEdits(layer, context))
+
+        # symbols must not extend beyond the neighboring dirty tiles
+        layer.setRenderer(QgsSingleSymbolRenderer(QgsMarkerSymbol.createSimple({'size': '50', 'size_unit': 'Pixel'})))
+        self.assertTrue(QgsMapRendererCache.canTrackEdits(layer, context))
+        layer.setRenderer(QgsSingleSymbolRenderer(QgsMarkerSymbol.createSimple({'size': '200', 'size_unit': 'Pixel'})))
+        self.assertFalse(QgsMapRendererCache.canTrackEdits(layer, context))
+
+        # data defined symbology
+        symbol = QgsMarkerSymbol.createSimple({})
+        symbol.symbolLayer(0).setDataDefinedProperty(QgsSymbolLayer.PropertySize, QgsProperty.fromField('fldint'))
+        layer.setRenderer(QgsSingleSymbolRenderer(symbol))
+        self.assertFalse(QgsMapRendererCache.canTrackEdits(layer, context))
+
+        # renderers drawing features depending on other features
+        layer.setRenderer(QgsHeatmapRenderer())
+        self.assertFalse(QgsMapRendererCache.canTrackEdits(layer, context))
+        layer.setRenderer(QgsPointClusterRenderer())
+        self.assertFalse(QgsMapRendererCache.canTrackEdits(layer, context))
+        layer.setRenderer(QgsCategorizedSymbolRenderer('fldint', []))
+        self.assertTrue(QgsMapRendererCache.canTrackEdits(layer, context))
+        layer.setRenderer(QgsCategorizedSymbolRenderer('maximum("fldint")', []))
+        self.assertFalse(QgsMapRendererCache.canTrackEdits(layer, context))
+
+    def testPartialRedraw(self):
+        """ test that redrawing the edited parts of a cached image matches a full redraw """
+        layer = QgsVectorLayer("Point?crs=EPSG:3857", "layer", "memory")
+        features = []
+        for x in range(25, 1000, 50):
+            for y in range(25, 1000, 50):
+                f = QgsFeature()
+                f.setGeometry(QgsGeometry.fromPointXY(QgsPointXY(x, y)))
+                features.append(f)
+        success, features = layer.dataProvider().addFeatures(features)
+        self.assertTrue(success)
+        # large enough for symbols of neighboring features to overlap
+        layer.setRenderer(QgsSingleSymbolRenderer(QgsMarkerSymbol.createSimple({'size': '80', 'size_unit': 'Pixel'})))
+
+        settings = QgsMapSettings()
+        settings.setLayers([layer])
+        settings.setDestinationCrs(layer.crs())
+        settings.setOutputSize(QSize(1000, 1000))
+        settings.setExtent(QgsRectangle(0, 0, 1000, 1000))
+        settings.setFlag(QgsMapSettings.Antialiasing, True)
+
+        def render(cache):
+            job = QgsMapRendererSequentialJob(settings)
+            job.setCache(cache)
+            job.start()
+            job.waitForFinished()
+            return job.renderedImage()
+
+        cache = QgsMapRendererCache()
+        self.assertTrue(layer.startEditing())
+        render(cache)
+        self.assertTrue(cache.hasCacheImage(layer.id()))
+
+        self.assertTrue(layer.changeGeometry(features[0].id(), QgsGeometry.fromPointXY(QgsPointXY(510, 490))))
+        self.assertTrue(layer.deleteFeature(features[-1].id()))
+        f = QgsFeature()
+        f.setGeometry(QgsGeometry.fromPointXY(QgsPointXY(255, 745)))
+        self.assertTrue(layer.addFeature(f))
+        dirty = cache.cacheImageDirtyRegion(layer.id())
+        self.assertFalse(dirty.isEmpty())
+        self.assertFalse(dirty.contains(QPoint(700, 900)))
+
+        partial = render(cache)
+        self.assertTrue(cache.hasCacheImage(layer.id()))
+        self.assertTrue(cache.cacheImageDirtyRegion(layer.id()).isEmpty())
+        full = render(QgsMapRendererCache())
+        self.assertEqual(partial, full)
+
+        # layers which can't be partially redrawn are fully redrawn on every render
+        layer.setRenderer(QgsHeatmapRenderer())
+        render(cache)
+        self.assertTrue(layer.changeGeometry(features[1].id(), QgsGeometry.fromPointXY(QgsPointXY(490, 510))))
+        self.assertEqual(render(cache), render(QgsMapRendererCache()))
+        layer.rollBack()
+
 
 if __name__ == '__main__':
     unittest.main()
@@ -26,8 +26,8 @@ __copyright__ = '(C) 2016, Nyall Dawson'
 
 import os
 
-from qgis.PyQt.QtCore import QSize
-from qgis.PyQt.QtGui import QColor
+from qgis.PyQt.QtCore import QSize, QThreadPool
+from qgis.PyQt.QtGui import QColor, QImage, QPainter
 from qgis.PyQt.QtXml import QDomDocument
 
 from qgis.core import (QgsVectorLayer,
@@ -44,8 +44,16 @@ from qgis.core import (QgsVectorLayer,
                        QgsMapSettings,
                        QgsProperty,
                        QgsSymbolLayer,
-                       QgsRenderContext
+                       QgsRenderContext,
+                       QgsFeature,
+                       QgsGeometry,
+                       QgsPointXY,
+                       QgsCategorizedSymbolRenderer,
+                       QgsRendererCategory,
+                       QgsMapRendererCustomPainterJob,
+                       QgsExpression
                        )
+from qgis.core import qgsfunction
 from qgis.testing import start_app, unittest
 from utilities import (unitTestDataPath)
 
@@ -54,9 +62,28 @@ from utilities import (unitTestDataPath)
 start_app()
 TEST_DATA_DIR = unitTestDataPath()
 
+# (size, color) of the clusters drawn in a render, filled by the record_cluster expression function
+RENDERED_CLUSTERS = set()
+
+
+@qgsfunction(args='auto', group='testing', register=False, handlesnull=True)
+def record_cluster(size, color, feature, parent):
+    RENDERED_CLUSTERS.add((size, color))
+    return 3
+
 
 class TestQgsPointClusterRenderer(unittest.TestCase):
 
+    @classmethod
+    def setUpClass(cls):
+        QgsExpression.registerFunction(record_cluster)
+
+    @classmethod
+    def tearDownClass(cls):
+        QgsExpression.unregisterFunction('record_cluster')
+        # wait for any point pyramid still being built
+        QThreadPool.globalInstance().waitForDone()
+
     def setUp(self):
         myShpFile = os.path.join(TEST_DATA_DIR, 'points.shp')
         self.layer = QgsVectorLayer(myShpFile, 'Points', 'ogr')
@@ -184,6 +211,92 @@ class TestQgsPointClusterRenderer(unittest.TestCase):
         self.layer.renderer().setClusterSymbol(old_marker)
         self.assertTrue(result)
 
+    def _createLayer(self, points):
+        """ creates a layer from a list of (x, y, class) tuples """
+        layer = QgsVectorLayer('Point?crs=EPSG:3857&field=class:string', 'points', 'memory')
+        features = []
+        for x, y, point_class in points:
+            f = QgsFeature(layer.fields())
+            f.setAttributes([point_class])
+            f.setGeometry(QgsGeometry.fromPointXY(QgsPointXY(x, y)))
+            features.append(f)
+        self.assertTrue(layer.dataProvider().addFeatures(features))
+        return layer
+
+    def _setClusterRenderer(self, layer, tolerance):
+        """ sets a cluster renderer with red and blue points, whose cluster symbol records the drawn clusters """
+        categories = [QgsRendererCategory('red', QgsMarkerSymbol.createSimple({'color': '#ff0000'}), 'red'),
+                      QgsRendererCategory('blue', QgsMarkerSymbol.createSimple({'color': '#0000ff'}), 'blue')]
+        renderer = QgsPointClusterRenderer()
+        renderer.setEmbeddedRenderer(QgsCategorizedSymbolRenderer('class', categories))
+        cluster_symbol = QgsMarkerSymbol.createSimple({'color': '#ffff00', 'size': '3', 'outline_style': 'no'})
+        cluster_symbol.symbolLayer(0).setDataDefinedProperty(QgsSymbolLayer.PropertySize, QgsProperty.fromExpression('record_cluster(@cluster_size, @cluster_color)'))
+        renderer.setClusterSymbol(cluster_symbol)
+        renderer.setTolerance(tolerance)
+        renderer.setToleranceUnit(QgsUnitTypes.RenderMapUnits)
+        layer.setRenderer(renderer)
+
+    def _renderedClusters(self, layer):
+        """ renders the layer and returns the set of (size, color) of the drawn clusters """
+        RENDERED_CLUSTERS.clear()
+        mapsettings = QgsMapSettings()
+        mapsettings.setDestinationCrs(layer.crs())
+        mapsettings.setOutputSize(QSize(200, 200))
+        mapsettings.setOutputDpi(96)
+        mapsettings.setExtent(QgsRectangle(-20, -20, 20, 20))
+        mapsettings.setLayers([layer])
+        image = QImage(mapsettings.outputSize(), QImage.Format_ARGB32_Premultiplied)
+        painter = QPainter(image)
+        job = QgsMapRendererCustomPainterJob(mapsettings, painter)
+        job.renderSynchronously()
+        painter.end()
+        return set(RENDERED_CLUSTERS)
+
+    def testZeroTolerance(self):
+        """ with a zero tolerance, only points at the same location are clustered """
+        layer = self._createLayer([(1, 1, 'red'), (1, 1, 'red'), (1.001, 1, 'blue'),
+                                   (-3, -3, 'blue'), (-3, -3, 'blue'), (-3, -3, 'blue')])
+        self._setClusterRenderer(layer, 0)
+        self.assertEqual(self._renderedClusters(layer), {(2, '255,0,0,255'), (3, '0,0,255,255')})
+
+        # the points close to each other are clustered with a tolerance
+        self._setClusterRenderer(layer, 0.01)
+        self.assertEqual(self._renderedClusters(layer), {(3, None), (3, '0,0,255,255')})
+
+    def testGridCellBorders(self):
+        """ points exactly on the borders of the grouping grid cells, which are as large as the tolerance """
+        # each point is exactly one tolerance away from the previous one along both axes
+        layer = self._createLayer([(-8, -8, 'red'), (-4, -4, 'red'), (0, 0, 'blue'), (4, 4, 'blue')])
+        self._setClusterRenderer(layer, 4)
+        self.assertEqual(self._renderedClusters(layer), {(2, '255,0,0,255'), (2, '0,0,255,255')})
+
+        # just below the distance between the points, nothing is clustered
+        self._setClusterRenderer(layer, 3.999)
+        self.assertEqual(self._renderedClusters(layer), set())
+
+    def testTiedGroups(self):
+        """ a point at the same distance from two groups joins the group created first """
+        layer = self._createLayer([(0, 0, 'red'), (8, 0, 'blue'), (4, 0, 'red')])
+        self._setClusterRenderer(layer, 5)
+        self.assertEqual(self._renderedClusters(layer), {(2, '255,0,0,255')})
+
+        layer = self._createLayer([(8, 0, 'blue'), (0, 0, 'red'), (4, 0, 'red')])
+        self._setClusterRenderer(layer, 5)
+        self.assertEqual(self._renderedClusters(layer), {(2, None)})
+
+    def testAggregatedPoints(self):
+        """ representative points from the point pyramid count as all the points they represent """
+        layer = self._createLayer([(-10, -10, 'red'), (-10, -10, 'red'), (-10, -10, 'red'),
+                                   (10, 10, 'blue'), (10, 10, 'blue'), (0, 0, 'red')])
+        self._setClusterRenderer(layer, 1)
+        layer.setPointAggregationScale(1)
+
+        # the first render draws all the points, while the pyramid is built in the background
+        expected = {(3, '255,0,0,255'), (2, '0,0,255,255')}
+        self.assertEqual(self._renderedClusters(layer), expected)
+        QThreadPool.globalInstance().waitForDone()
+        self.assertEqual(self._renderedClusters(layer), expected)
+
     def testUsedAttributes(self):
         ctx = QgsRenderContext.fromMapSettings(self.mapsettings)
 
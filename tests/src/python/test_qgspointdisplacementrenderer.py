@@ -28,7 +28,7 @@ import qgis  # NOQA
 
 import os
 
-from qgis.PyQt.QtGui import QColor
+from qgis.PyQt.QtGui import QColor, QImage, QPainter
 from qgis.PyQt.QtCore import QSize, QThreadPool, QDir
 from qgis.PyQt.QtXml import QDomDocument
 
@@ -49,8 +49,14 @@ from qgis.core import (QgsVectorLayer,
                        QgsProperty,
                        QgsReadWriteContext,
                        QgsSymbolLayer,
-                       QgsRenderContext
+                       QgsRenderContext,
+                       QgsFeature,
+                       QgsGeometry,
+                       QgsPointXY,
+                       QgsMapRendererCustomPainterJob,
+                       QgsExpression
                        )
+from qgis.core import qgsfunction
 from qgis.testing import start_app, unittest
 from utilities import unitTestDataPath
 
@@ -59,9 +65,22 @@ from utilities import unitTestDataPath
 start_app()
 TEST_DATA_DIR = unitTestDataPath()
 
+# (size, color) of the groups drawn in a render, filled by the record_group expression function
+RENDERED_GROUPS = set()
+
+
+@qgsfunction(args='auto', group='testing', register=False, handlesnull=True)
+def record_group(size, color, feature, parent):
+    RENDERED_GROUPS.add((size, color))
+    return 3
+
 
 class TestQgsPointDisplacementRenderer(unittest.TestCase):
 
+    @classmethod
+    def setUpClass(cls):
+        QgsExpression.registerFunction(record_group)
+
     def setUp(self):
         self.report = "<h1>Python QgsPointDisplacementRenderer Tests</h1>\n"
 
@@ -99,6 +118,7 @@ class TestQgsPointDisplacementRenderer(unittest.TestCase):
 
     @classmethod
     def tearDownClass(cls):
+        QgsExpression.unregisterFunction('record_group')
         # avoid crash on finish, probably related to https://bugreports.qt.io/browse/QTBUG-35760
         QThreadPool.globalInstance().waitForDone()
 
@@ -432,6 +452,91 @@ class TestQgsPointDisplacementRenderer(unittest.TestCase):
         self.assertTrue(res)
         self._tearDown(layer)
 
+    def _createLayer(self, points):
+        """ creates a layer from a list of (x, y, class) tuples """
+        layer = QgsVectorLayer('Point?crs=EPSG:3857&field=class:string', 'points', 'memory')
+        features = []
+        for x, y, point_class in points:
+            f = QgsFeature(layer.fields())
+            f.setAttributes([point_class])
+            f.setGeometry(QgsGeometry.fromPointXY(QgsPointXY(x, y)))
+            features.append(f)
+        self.assertTrue(layer.dataProvider().addFeatures(features))
+        return layer
+
+    def _setDisplacementRenderer(self, layer, tolerance):
+        """ sets a displacement renderer with red and blue points, whose center symbol records the drawn groups """
+        categories = [QgsRendererCategory('red', QgsMarkerSymbol.createSimple({'color': '#ff0000'}), 'red'),
+                      QgsRendererCategory('blue', QgsMarkerSymbol.createSimple({'color': '#0000ff'}), 'blue')]
+        renderer = QgsPointDisplacementRenderer()
+        renderer.setEmbeddedRenderer(QgsCategorizedSymbolRenderer('class', categories))
+        center_symbol = QgsMarkerSymbol.createSimple({'color': '#ffff00', 'size': '3', 'outline_style': 'no'})
+        center_symbol.symbolLayer(0).setDataDefinedProperty(QgsSymbolLayer.PropertySize, QgsProperty.fromExpression('record_group(@cluster_size, @cluster_color)'))
+        renderer.setCenterSymbol(center_symbol)
+        renderer.setTolerance(tolerance)
+        renderer.setToleranceUnit(QgsUnitTypes.RenderMapUnits)
+        layer.setRenderer(renderer)
+
+    def _renderedGroups(self, layer):
+        """ renders the layer and returns the set of (size, color) of the drawn groups """
+        RENDERED_GROUPS.clear()
+        mapsettings = QgsMapSettings()
+        mapsettings.setDestinationCrs(layer.crs())
+        mapsettings.setOutputSize(QSize(200, 200))
+        mapsettings.setOutputDpi(96)
+        mapsettings.setExtent(QgsRectangle(-20, -20, 20, 20))
+        mapsettings.setLayers([layer])
+        image = QImage(mapsettings.outputSize(), QImage.Format_ARGB32_Premultiplied)
+        painter = QPainter(image)
+        job = QgsMapRendererCustomPainterJob(mapsettings, painter)
+        job.renderSynchronously()
+        painter.end()
+        return set(RENDERED_GROUPS)
+
+    def testZeroTolerance(self):
+        """ with a zero tolerance, only points at the same location are displaced """
+        layer = self._createLayer([(1, 1, 'red'), (1, 1, 'red'), (1.001, 1, 'blue'),
+                                   (-3, -3, 'blue'), (-3, -3, 'blue'), (-3, -3, 'blue')])
+        self._setDisplacementRenderer(layer, 0)
+        self.assertEqual(self._renderedGroups(layer), {(2, '255,0,0,255'), (3, '0,0,255,255')})
+
+        # the points close to each other are grouped with a tolerance
+        self._setDisplacementRenderer(layer, 0.01)
+        self.assertEqual(self._renderedGroups(layer), {(3, None), (3, '0,0,255,255')})
+
+    def testGridCellBorders(self):
+        """ points exactly on the borders of the grouping grid cells, which are as large as the tolerance """
+        # each point is exactly one tolerance away from the previous one along both axes
+        layer = self._createLayer([(-8, -8, 'red'), (-4, -4, 'red'), (0, 0, 'blue'), (4, 4, 'blue')])
+        self._setDisplacementRenderer(layer, 4)
+        self.assertEqual(self._renderedGroups(layer), {(2, '255,0,0,255'), (2, '0,0,255,255')})
+
+        # just below the distance between the points, nothing is grouped
+        self._setDisplacementRenderer(layer, 3.999)
+        self.assertEqual(self._renderedGroups(layer), set())
+
+    def testTiedGroups(self):
+        """ a point at the same distance from two groups joins the group created first """
+        layer = self._createLayer([(0, 0, 'red'), (8, 0, 'blue'), (4, 0, 'red')])
+        self._setDisplacementRenderer(layer, 5)
+        self.assertEqual(self._renderedGroups(layer), {(2, '255,0,0,255')})
+
+        layer = self._createLayer([(8, 0, 'blue'), (0, 0, 'red'), (4, 0, 'red')])
+        self._setDisplacementRenderer(layer, 5)
+        self.assertEqual(self._renderedGroups(layer), {(2, None)})
+
+    def testPointAggregation(self):
+        """ every displaced point must be drawn, so the point pyramid is never used """
+        layer = self._createLayer([(-10, -10, 'red'), (-10, -10, 'red'), (-10, -10, 'red'),
+                                   (10, 10, 'blue'), (10, 10, 'blue'), (0, 0, 'red')])
+        self._setDisplacementRenderer(layer, 1)
+        layer.setPointAggregationScale(1)
+
+        expected = {(3, '255,0,0,255'), (2, '0,0,255,255')}
+        self.assertEqual(self._renderedGroups(layer), expected)
+        QThreadPool.globalInstance().waitForDone()
+        self.assertEqual(self._renderedGroups(layer), expected)
+
     def testUsedAttributes(self):
         layer, renderer, mapsettings = self._setUp()
         ctx = QgsRenderContext.fromMapSettings(mapsettings)
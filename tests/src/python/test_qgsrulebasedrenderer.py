@@ -29,7 +29,7 @@ import qgis  # NOQA
 import os
 
 from qgis.PyQt.QtCore import Qt, QSize
-from qgis.PyQt.QtGui import QColor
+from qgis.PyQt.QtGui import QColor, QImage, QPainter
 
 from qgis.core import (QgsVectorLayer,
                        QgsMapSettings,
@@ -46,7 +46,12 @@ from qgis.core import (QgsVectorLayer,
                        QgsRenderContext,
                        QgsSymbolLayer,
                        QgsSimpleMarkerSymbolLayer,
-                       QgsProperty
+                       QgsProperty,
+                       QgsFeature,
+                       QgsGeometry,
+                       QgsPointXY,
+                       QgsExpression,
+                       QgsExpressionContext
                        )
 from qgis.testing import start_app, unittest
 from utilities import unitTestDataPath
@@ -453,6 +458,64 @@ class TestQgsRulebasedRenderer(unittest.TestCase):
 
         QgsProject.instance().removeMapLayer(points_layer)
 
+    def testSimpleFilters(self):
+        """
+        Test that rules with simple filters (which are compiled or dispatched via a lookup table)
+        match the same features as their filter expressions
+        """
+        layer = QgsVectorLayer('Point?field=cat:string&field=code:integer&field=val:double', 'points', 'memory')
+        values = [('a', 1, 0.5), ('b', 2, 1.0), ('c', 3, 1.5), ('5', 5, 2.0), ('5.0', 50, 10.0),
+                  ('h', 8, -3.0), ('x', 100, 3.0), (None, None, None), ('', 0, 0.0)]
+        features = []
+        for cat, code, val in values:
+            f = QgsFeature(layer.fields())
+            f.setAttributes([cat, code, val])
+            f.setGeometry(QgsGeometry.fromPointXY(QgsPointXY(1, 1)))
+            features.append(f)
+        layer.dataProvider().addFeatures(features)
+        features = list(layer.getFeatures())
+
+        filters = ['"cat" = \'{}\''.format(c) for c in 'abcdefgh'] + \
+                  ['"code" = {}'.format(c) for c in range(1, 10)] + \
+                  ['"cat" = \'5\'',
+                   '"cat" IN (\'a\', \'x\', NULL)',
+                   '"cat" IN (\'5\', \'z\')',
+                   '"code" IN (50, 100)',
+                   '"code" = \'5\'',
+                   '"val" >= 1',
+                   '2 > "val"',
+                   '"val" > 0.5 AND "val" <= 2',
+                   '"val" >= 0 AND "code" < 5',
+                   '"cat" >= \'b\'',
+                   '"val" = 1']
+
+        rootrule = QgsRuleBasedRenderer.Rule(None)
+        for filter in filters:
+            rootrule.appendChild(QgsRuleBasedRenderer.Rule(QgsMarkerSymbol(), 0, 0, filter))
+        renderer = QgsRuleBasedRenderer(rootrule)
+
+        image = QImage(10, 10, QImage.Format_ARGB32)
+        painter = QPainter(image)
+        ms = QgsMapSettings()
+        ms.setOutputSize(QSize(10, 10))
+        ms.setExtent(QgsRectangle(0, 0, 2, 2))
+        ctx = QgsRenderContext.fromMapSettings(ms)
+        ctx.setPainter(painter)
+        ctx.expressionContext().appendScope(layer.createExpressionContextScope())
+
+        renderer.startRender(ctx, layer.fields())
+        for f in features:
+            context = QgsExpressionContext()
+            context.setFeature(f)
+            expected = {renderer.rootRule().ruleKey()}
+            for rule in renderer.rootRule().children():
+                if QgsExpression(rule.filterExpression()).evaluate(context):
+                    expected.add(rule.ruleKey())
+            self.assertEqual(renderer.legendKeysForFeature(f, ctx), expected, f.attributes())
+            self.assertEqual(renderer.renderFeature(f, ctx), len(expected) > 1, f.attributes())
+        renderer.stopRender(ctx)
+        painter.end()
+
 
 if __name__ == '__main__':
     unittest.main()